@@ -1,4 +1,6 @@
 #include <glpp/system.hpp>
+#include <algorithm>
+#include <deque>
 #include <fstream>
 #include <glm/gtc/matrix_transform.hpp>
 #include "cube_model.hpp"
@@ -131,6 +133,13 @@ int main(
 	constexpr bool x_direction = true;
 	constexpr bool y_direction = false;
 
+	// The depth under the mouse is read back asynchronously and used once the GPU has copied it,
+	// which is usually one or two frames later. If the GPU falls further behind, frames skip the
+	// readback instead of queueing more of them.
+	constexpr size_t max_depth_readbacks = 3;
+	std::deque<object::pixel_readback_t<float>> depth_readbacks;
+	float depth_in_focus = 1.0f;
+
 	glm::vec2 mouse;
 	window.input_handler().set_mouse_move_action([&](glm::vec2 dst, glm::vec2){
 		mouse = dst;
@@ -170,10 +179,17 @@ int main(
 		// The final pass does the dof calculation
 		// it interpolates between the blurred image and the original scene depending on the difference in the depth-buffer
 		// to the depth under the mouse
+		const auto mouse_x = std::clamp<int>(mouse.x, 0, window.get_width()-1);
+		const auto mouse_y = std::clamp<int>(window.get_height()-mouse.y, 0, window.get_height()-1);
+		while(!depth_readbacks.empty() && depth_readbacks.front().ready()) {
+			depth_in_focus = depth_readbacks.front().get().get(0, 0);
+			depth_readbacks.pop_front();
+		}
+		if(depth_readbacks.size() < max_depth_readbacks) {
+			depth_readbacks.push_back(first_pass.framebuffer.async_depth_read(mouse_x, mouse_y));
+		}
 		object::framebuffer_t::bind_default_framebuffer(object::framebuffer_target_t::write);
-		float f;
-		glReadPixels(mouse.x, window.get_height()-mouse.y, 1, 1, GL_DEPTH_COMPONENT, GL_FLOAT, &f);
-		second_stage_postprocessing.set_uniform(&second_stage_uniform_description_t::depth_in_focus, f);
+		second_stage_postprocessing.set_uniform(&second_stage_uniform_description_t::depth_in_focus, depth_in_focus);
 
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 		second_stage_postprocessing.render(screen_quad);
@@ -0,0 +1,100 @@
+#include <glpp/system/windowless_context.hpp>
+#include <glpp/core.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace glpp::core::object;
+
+/*
+ * Renders headless and publishes the frames to a second process, which reports the latency between
+ * publication and acquisition and the frame rate it receives.
+ */
+
+constexpr size_t width = 1920;
+constexpr size_t height = 1080;
+constexpr size_t frames = 600;
+const std::string socket_path = "/tmp/glpp_shared_frames.sock";
+
+int consume() {
+	// Waits for the producer to create its socket and to accept the consumer.
+	std::unique_ptr<shared_frame_source_t> source;
+	try {
+		source = std::make_unique<shared_frame_source_t>(socket_path, std::chrono::seconds(5));
+	} catch(const std::runtime_error& error) {
+		std::cerr << error.what() << std::endl;
+		return 1;
+	}
+
+	std::vector<std::chrono::nanoseconds> latencies;
+	std::uint64_t first = 0, last = 0, checksum = 0;
+	const auto begin = std::chrono::steady_clock::now();
+	while(source->wait(std::chrono::seconds(1))) {
+		while(auto frame = source->acquire()) {
+			latencies.push_back(frame->age());
+			if(first == 0) first = frame->sequence();
+			last = frame->sequence();
+			// Touches one byte per row, as an encoder would read the frame.
+			for(size_t y = 0; y < frame->height(); ++y) {
+				checksum += static_cast<std::uint8_t>(frame->pixels()[y*frame->width()*4]);
+			}
+		}
+	}
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now()-begin-std::chrono::seconds(1);
+	if(latencies.empty()) {
+		std::cerr << "No frames received." << std::endl;
+		return 1;
+	}
+
+	std::sort(latencies.begin(), latencies.end());
+	const auto percentile = [&](double p) {
+		return std::chrono::duration<double, std::micro>(latencies[static_cast<size_t>(p*(latencies.size()-1))]).count();
+	};
+	std::cout << "Received " << latencies.size() << " of " << last-first+1 << " frames in " << elapsed.count() << "s, "
+		<< latencies.size()/elapsed.count() << " fps, "
+		<< latencies.size()*width*height*4/elapsed.count()/(1 << 30) << " GiB/s" << std::endl;
+	std::cout << "Latency p50 " << percentile(0.5) << "us, p99 " << percentile(0.99) << "us, max " << percentile(1.0) << "us"
+		<< " (checksum " << checksum << ")" << std::endl;
+	return 0;
+}
+
+int main(
+	__attribute__((unused)) int,
+	__attribute__((unused)) char **
+) {
+	// Forked before the context is created, the consumer does not use OpenGL.
+	const auto consumer = fork();
+	if(consumer == 0) {
+		return consume();
+	}
+
+	glpp::system::windowless_context_t context;
+	const texture_t color { width, height, image_format_t::rgba_8 };
+	framebuffer_t framebuffer { { color, attachment_t::color } };
+	shared_frame_sink_t sink { socket_path, width, height };
+	if(sink.accept(std::chrono::seconds(5)) == 0) {
+		std::cerr << "No consumer connected." << std::endl;
+		return 1;
+	}
+
+	const auto begin = std::chrono::steady_clock::now();
+	for(size_t i = 0; i < frames; ++i) {
+		framebuffer.bind();
+		const auto t = static_cast<float>(i)/frames;
+		glClearColor(t, 1.0f-t, 0.5f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		sink.capture(framebuffer);
+	}
+	sink.flush();
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now()-begin;
+	std::cout << "Published " << sink.published() << " frames, dropped " << sink.dropped() << ", "
+		<< frames/elapsed.count() << " fps" << std::endl;
+
+	int status = 0;
+	waitpid(consumer, &status, 0);
+	return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
@@ -3,4 +3,5 @@
 #include "render/mesh_view.hpp"
 #include "render/mesh_renderer.hpp"
 #include "render/scene_view.hpp"
-#include "render/scene_renderer.hpp"
\ No newline at end of file
+#include "render/scene_renderer.hpp"
+#include "render/uber_scene_renderer.hpp"
\ No newline at end of file
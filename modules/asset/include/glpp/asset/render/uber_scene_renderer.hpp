@@ -0,0 +1,88 @@
+#pragma once
+
+#include "scene_view.hpp"
+#include "glpp/asset/shading/material_buffer.hpp"
+#include <glpp/core/render/camera.hpp>
+
+namespace glpp::asset::render {
+
+/*
+ * Renders a whole scene with a single shader program. The ShadingModel has to provide a material
+ * independent renderer() and select the material through the material_id uniform, like
+ * shading::flat_uber_t does.
+ */
+template<class ShadingModel>
+class uber_scene_renderer_t {
+public:
+	using material_key_t = size_t;
+	using renderer_t = typename ShadingModel::renderer_t;
+	using uniform_description_t = typename ShadingModel::uniform_description_t;
+
+	uber_scene_renderer_t(const ShadingModel& model, const scene_t& scene);
+
+	template <class AllocPolicy>
+	void update_texture_binding(const core::object::texture_atlas_slot_t<AllocPolicy>& texture_slots);
+	void update_materials(const scene_t& scene);
+
+	void render(const scene_view_t& view);
+	void render(const scene_view_t& view, const glpp::core::render::camera_t& camera);
+
+	renderer_t& renderer();
+	const renderer_t& renderer() const;
+
+private:
+	ShadingModel m_shading_model;
+	renderer_t m_renderer;
+	shading::material_buffer_t m_materials;
+};
+
+template<class ShadingModel>
+uber_scene_renderer_t<ShadingModel>::uber_scene_renderer_t(const ShadingModel& model, const scene_t& scene) :
+	m_shading_model(model),
+	m_renderer(model.renderer()),
+	m_materials(scene.materials)
+{}
+
+template<class ShadingModel>
+template <class AllocPolicy>
+void uber_scene_renderer_t<ShadingModel>::update_texture_binding(const core::object::texture_atlas_slot_t<AllocPolicy>& texture_slots) {
+	m_shading_model.set_up(m_renderer, texture_slots);
+}
+
+template<class ShadingModel>
+void uber_scene_renderer_t<ShadingModel>::update_materials(const scene_t& scene) {
+	m_materials.update(scene.materials);
+}
+
+template<class ShadingModel>
+void uber_scene_renderer_t<ShadingModel>::render(const scene_view_t& view) {
+	m_materials.bind();
+	const auto materials = std::min(view.materials(), m_materials.size());
+	for(auto i = 0u; i < materials; ++i) {
+		const auto& meshes = view.meshes_by_material(i);
+		if(meshes.empty()) continue;
+		m_renderer.set_uniform(&uniform_description_t::material_id, static_cast<GLint>(i));
+		for(const auto& mesh : meshes) {
+			m_renderer.set_uniform(&uniform_description_t::model_matrix, mesh.model_matrix);
+			m_renderer.render(mesh.view());
+		}
+	}
+}
+
+template<class ShadingModel>
+void uber_scene_renderer_t<ShadingModel>::render(const scene_view_t& view, const glpp::core::render::camera_t& camera) {
+	m_renderer.set_uniform(&uniform_description_t::view_projection, camera.mvp());
+	render(view);
+}
+
+template<class ShadingModel>
+typename uber_scene_renderer_t<ShadingModel>::renderer_t& uber_scene_renderer_t<ShadingModel>::renderer() {
+	return m_renderer;
+}
+
+template<class ShadingModel>
+const typename uber_scene_renderer_t<ShadingModel>::renderer_t& uber_scene_renderer_t<ShadingModel>::renderer() const {
+	return m_renderer;
+}
+
+}
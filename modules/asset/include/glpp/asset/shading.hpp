@@ -2,5 +2,7 @@
 
 #include "shading/normal.hpp"
 #include "shading/flat.hpp"
+#include "shading/flat_uber.hpp"
+#include "shading/material_buffer.hpp"
 #include "shading/depth.hpp"
 // #include "shading/blinn_phong.hpp"
@@ -3,7 +3,7 @@
 #include "glpp/asset/material.hpp"
 #include "glpp/asset/mesh.hpp"
 #include "glpp/core/object/texture_atlas.hpp"
-#include "glpp/core/object/shader_factory.hpp"
+#include "glpp/core/object/shader_template.hpp"
 
 namespace glpp::asset::shading {
 
@@ -51,10 +51,9 @@ flat_t<AllocPolicy>::flat_t(const core::object::texture_atlas_t<AllocPolicy>& te
 	m_source(source)
 {}
 
-template <class AllocPolicy>
-std::string flat_t<AllocPolicy>::vertex_shader_code(const material_t&) const  {
-	constexpr auto code =
-	R"(
+namespace detail {
+constexpr std::string_view flat_vertex_shader_code =
+R"(
 	#version 450 core
 	layout (location = 0) in vec3 pos;
 	layout (location = 1) in vec3 norm;
@@ -75,12 +74,16 @@ std::string flat_t<AllocPolicy>::vertex_shader_code(const material_t&) const  {
 		v_uv = vec2(uv.x, 1-uv.y);
 	};
 	)";
-	return code;
+}
+
+template <class AllocPolicy>
+std::string flat_t<AllocPolicy>::vertex_shader_code(const material_t&) const  {
+	return std::string(detail::flat_vertex_shader_code);
 }
 
 namespace detail {
 template <class AllocPolicy>
-void unroll_tex_stack(core::object::shader_factory_t& factory, const texture_stack_t& stack, const core::object::texture_atlas_t<AllocPolicy>& textures) {
+void unroll_tex_stack(core::object::shader_bindings_t& bindings, const texture_stack_t& stack, const core::object::texture_atlas_t<AllocPolicy>& textures) {
 	const auto to_string = [](op_t op) -> std::string {
 		switch(op) {
 			case op_t::addition:
@@ -94,21 +97,18 @@ void unroll_tex_stack(core::object::shader_factory_t& factory, const texture_sta
 		}
 	};
 
-	factory.set("<tex_stack_declaration>", textures.declaration("textures"));
+	bindings.set("<tex_stack_declaration>", textures.declaration("textures"));
 
 	std::string tex_stack_handling = "";
 	for(const auto& t : stack) {
 		tex_stack_handling += "FragColor "+to_string(t.op)+" "+std::to_string(t.strength)+"*"+textures.get(t.texture_key).fetch("textures", "v_uv")+";\n";
 	}
 
-	factory.set("<tex_stack_handling>", tex_stack_handling);
-}
+	bindings.set("<tex_stack_handling>", std::move(tex_stack_handling));
 }
 
-template <class AllocPolicy>
-std::string flat_t<AllocPolicy>::fragment_shader_code(const material_t& material) const {
-	std::string code_template =
-	R"(
+constexpr std::string_view flat_fragment_shader_template =
+R"(
 	#version 450 core
 	in vec3 v_world_pos;
 	in vec3 v_norm;
@@ -124,29 +124,36 @@ std::string flat_t<AllocPolicy>::fragment_shader_code(const material_t& material
 		<tex_stack_handling>
 	};
 	)";
+}
+
+template <class AllocPolicy>
+std::string flat_t<AllocPolicy>::fragment_shader_code(const material_t& material) const {
+	static constexpr core::object::shader_template_t<
+		core::object::count_shader_template_segments(detail::flat_fragment_shader_template)
+	> code_template { detail::flat_fragment_shader_template };
 
-	core::object::shader_factory_t factory(code_template);
+	core::object::shader_bindings_t bindings;
 
 	switch(m_source) {
 		case flat_shading_channel_t::ambient:
-			factory.set("<channel>", material.ambient);
-			detail::unroll_tex_stack(factory, material.ambient_textures, m_textures);
+			bindings.set("<channel>", material.ambient);
+			detail::unroll_tex_stack(bindings, material.ambient_textures, m_textures);
 			break;
 		case flat_shading_channel_t::diffuse:
-			factory.set("<channel>", material.diffuse);
-			detail::unroll_tex_stack(factory, material.diffuse_textures, m_textures);
+			bindings.set("<channel>", material.diffuse);
+			detail::unroll_tex_stack(bindings, material.diffuse_textures, m_textures);
 			break;
 		case flat_shading_channel_t::specular:
-			factory.set("<channel>", material.specular);
-			detail::unroll_tex_stack(factory, material.specular_textures, m_textures);
+			bindings.set("<channel>", material.specular);
+			detail::unroll_tex_stack(bindings, material.specular_textures, m_textures);
 			break;
 		case flat_shading_channel_t::emission:
-			factory.set("<channel>", material.emissive);
-			detail::unroll_tex_stack(factory, material.emissive_textures, m_textures);
+			bindings.set("<channel>", material.emissive);
+			detail::unroll_tex_stack(bindings, material.emissive_textures, m_textures);
 			break;
 	}
 
-	return factory.code();
+	return code_template.render(bindings);
 }
 
 template <class AllocPolicy>
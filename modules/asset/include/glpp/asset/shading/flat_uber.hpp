@@ -0,0 +1,152 @@
+#pragma once
+
+#include "glpp/asset/shading/flat.hpp"
+#include "glpp/asset/shading/material_buffer.hpp"
+
+namespace glpp::asset::shading {
+
+/*
+ * Material independent variant of flat_t. All materials share one shader program and read their
+ * parameters and texture stacks from a material_buffer_t, selected by the material_id uniform.
+ */
+template <class AllocPolicy = core::object::texture_atlas::multi_policy_t>
+class flat_uber_t {
+public:
+
+	flat_uber_t(const core::object::texture_atlas_t<AllocPolicy>& textures, flat_shading_channel_t source = flat_shading_channel_t::diffuse);
+
+	struct uniform_description_t {
+		glm::mat4 model_matrix;
+		glm::mat4 view_projection;
+		GLint material_id;
+	};
+
+	using vertex_description_t = asset::mesh_t::vertex_description_t;
+	using model_t = asset::mesh_t::model_t;
+	using view_t = core::render::view_t<model_t>;
+	using renderer_t = core::render::renderer_t<uniform_description_t>;
+
+	std::string vertex_shader_code() const;
+	std::string fragment_shader_code() const;
+
+	void set_up(renderer_t& renderer, const core::object::texture_atlas_slot_t<AllocPolicy>& texture_slots) const;
+	renderer_t renderer() const;
+
+private:
+	const core::object::texture_atlas_t<AllocPolicy>&  m_textures;
+	flat_shading_channel_t m_source;
+};
+
+template <class AllocPolicy>
+flat_uber_t(const core::object::texture_atlas_t<AllocPolicy>&, flat_shading_channel_t) -> flat_uber_t<AllocPolicy>;
+
+namespace detail {
+constexpr std::string_view flat_uber_fragment_shader_template =
+R"(
+	#version 450 core
+	in vec3 v_world_pos;
+	in vec3 v_norm;
+	in vec2 v_uv;
+	out vec4 FragColor;
+
+	uniform int material_id;
+
+	<material_declaration>
+
+	<tex_stack_declaration>;
+
+	vec4 glpp_fetch(uint key, vec2 uv) {
+		<tex_stack_fetch>
+	}
+
+	vec4 glpp_apply(uint op, vec4 lhs, vec4 rhs, float strength) {
+		switch(op) {
+			case 0u: return lhs + strength*rhs;
+			case 1u: return lhs * (strength*rhs);
+			case 2u: return lhs / (strength*rhs);
+			case 3u: return (lhs + strength*rhs) - (lhs * strength*rhs);
+			case 4u: return lhs + strength*(rhs-0.5);
+		}
+		return lhs;
+	}
+
+	void main()
+	{
+		const glpp_material_t material = glpp_materials[material_id];
+		FragColor = vec4(<channel>.xyz, 1.0);
+
+		const uint offset = material.stack_offset[<channel_index>];
+		const uint size = material.stack_size[<channel_index>];
+		for(uint i = offset; i < offset+size; ++i) {
+			const glpp_texture_stack_entry_t entry = glpp_texture_stack[i];
+			FragColor = glpp_apply(entry.op, FragColor, glpp_fetch(entry.texture_key, v_uv), entry.strength);
+		}
+	};
+	)";
+}
+
+template <class AllocPolicy>
+flat_uber_t<AllocPolicy>::flat_uber_t(const core::object::texture_atlas_t<AllocPolicy>& textures, flat_shading_channel_t source) :
+	m_textures(textures),
+	m_source(source)
+{}
+
+template <class AllocPolicy>
+std::string flat_uber_t<AllocPolicy>::vertex_shader_code() const  {
+	return std::string(detail::flat_vertex_shader_code);
+}
+
+template <class AllocPolicy>
+std::string flat_uber_t<AllocPolicy>::fragment_shader_code() const {
+	static constexpr core::object::shader_template_t<
+		core::object::count_shader_template_segments(detail::flat_uber_fragment_shader_template)
+	> code_template { detail::flat_uber_fragment_shader_template };
+
+	core::object::shader_bindings_t bindings;
+	bindings.set("<material_declaration>", material_buffer_t::declaration());
+	bindings.set("<tex_stack_declaration>", m_textures.declaration("textures"));
+	if(m_textures.empty()) {
+		bindings.set("<tex_stack_fetch>", "return vec4(0.0);");
+	} else {
+		bindings.set("<tex_stack_fetch>", "return "+m_textures.dynamic_fetch("textures", "int(key)", "uv")+";");
+	}
+
+	switch(m_source) {
+		case flat_shading_channel_t::ambient:
+			bindings.set("<channel>", "material.ambient");
+			break;
+		case flat_shading_channel_t::diffuse:
+			bindings.set("<channel>", "material.diffuse");
+			break;
+		case flat_shading_channel_t::specular:
+			bindings.set("<channel>", "material.specular");
+			break;
+		case flat_shading_channel_t::emission:
+			bindings.set("<channel>", "material.emissive");
+			break;
+	}
+	bindings.set("<channel_index>", std::to_string(static_cast<int>(m_source)));
+
+	return code_template.render(bindings);
+}
+
+template <class AllocPolicy>
+typename flat_uber_t<AllocPolicy>::renderer_t flat_uber_t<AllocPolicy>::renderer() const {
+	renderer_t result(
+		core::object::shader_t(core::object::shader_type_t::vertex, vertex_shader_code()),
+		core::object::shader_t(core::object::shader_type_t::fragment, fragment_shader_code())
+	);
+	result.set_uniform_name(&uniform_description_t::model_matrix, "model_matrix");
+	result.set_uniform_name(&uniform_description_t::view_projection, "view_projection");
+	result.set_uniform_name(&uniform_description_t::material_id, "material_id");
+
+	return result;
+}
+
+template <class AllocPolicy>
+void flat_uber_t<AllocPolicy>::set_up(renderer_t& renderer, const core::object::texture_atlas_slot_t<AllocPolicy>& texture_slots) const {
+	renderer.set_texture_atlas("textures", texture_slots);
+}
+
+extern template class flat_uber_t<core::object::texture_atlas::multi_policy_t>;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "glpp/asset/material.hpp"
+#include "glpp/core/object/buffer.hpp"
+#include <cstdint>
+
+namespace glpp::asset::shading {
+
+// Material record as laid out in the shader storage buffer (std430). The channel arrays are
+// indexed in the order of flat_shading_channel_t: ambient, diffuse, specular, emission.
+struct gpu_material_t {
+	glm::vec4 ambient;
+	glm::vec4 diffuse;
+	glm::vec4 specular;
+	glm::vec4 emissive;
+	glm::uvec4 stack_offset;
+	glm::uvec4 stack_size;
+	float shininess;
+	float padding[3];
+};
+
+struct gpu_texture_stack_entry_t {
+	std::uint32_t texture_key;
+	float strength;
+	std::uint32_t op;
+	std::uint32_t padding;
+};
+
+static_assert(sizeof(gpu_material_t) == 112, "gpu_material_t must match the std430 layout.");
+static_assert(sizeof(gpu_texture_stack_entry_t) == 16, "gpu_texture_stack_entry_t must match the std430 layout.");
+
+class material_buffer_t {
+public:
+	static constexpr GLuint default_material_binding = 0;
+	static constexpr GLuint default_texture_stack_binding = 1;
+
+	explicit material_buffer_t(const std::vector<material_t>& materials);
+
+	void update(const std::vector<material_t>& materials);
+	void bind(GLuint material_binding = default_material_binding, GLuint texture_stack_binding = default_texture_stack_binding) const;
+
+	size_t size() const;
+
+	static std::string declaration(GLuint material_binding = default_material_binding, GLuint texture_stack_binding = default_texture_stack_binding);
+
+private:
+	size_t m_size;
+	core::object::buffer_t<gpu_material_t> m_materials;
+	core::object::buffer_t<gpu_texture_stack_entry_t> m_texture_stack;
+};
+
+}
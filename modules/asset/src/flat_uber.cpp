@@ -0,0 +1,7 @@
+#include "glpp/asset/shading/flat_uber.hpp"
+
+namespace glpp::asset::shading {
+
+template class flat_uber_t<core::object::texture_atlas::multi_policy_t>;
+
+}
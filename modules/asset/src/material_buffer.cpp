@@ -0,0 +1,119 @@
+#include "glpp/asset/shading/material_buffer.hpp"
+#include <fmt/format.h>
+
+namespace glpp::asset::shading {
+
+namespace {
+
+struct material_records_t {
+	std::vector<gpu_material_t> materials;
+	std::vector<gpu_texture_stack_entry_t> texture_stack;
+};
+
+material_records_t pack(const std::vector<material_t>& materials) {
+	material_records_t result;
+	result.materials.reserve(materials.size());
+
+	const auto push_stack = [&](const texture_stack_t& stack, glm::uvec4& offset, glm::uvec4& size, int channel) {
+		offset[channel] = result.texture_stack.size();
+		size[channel] = stack.size();
+		for(const auto& entry : stack) {
+			result.texture_stack.push_back({
+				static_cast<std::uint32_t>(entry.texture_key),
+				entry.strength,
+				static_cast<std::uint32_t>(entry.op),
+				0
+			});
+		}
+	};
+
+	for(const auto& material : materials) {
+		gpu_material_t record {
+			glm::vec4(material.ambient, 1.0f),
+			glm::vec4(material.diffuse, 1.0f),
+			glm::vec4(material.specular, 1.0f),
+			glm::vec4(material.emissive, 1.0f),
+			glm::uvec4(0),
+			glm::uvec4(0),
+			material.shininess,
+			{ 0.0f, 0.0f, 0.0f }
+		};
+		push_stack(material.ambient_textures, record.stack_offset, record.stack_size, 0);
+		push_stack(material.diffuse_textures, record.stack_offset, record.stack_size, 1);
+		push_stack(material.specular_textures, record.stack_offset, record.stack_size, 2);
+		push_stack(material.emissive_textures, record.stack_offset, record.stack_size, 3);
+		result.materials.push_back(record);
+	}
+
+	// Zero sized storage buffers can not be bound, so both arrays hold at least one record.
+	if(result.materials.empty()) {
+		result.materials.emplace_back();
+	}
+	if(result.texture_stack.empty()) {
+		result.texture_stack.emplace_back();
+	}
+	return result;
+}
+
+}
+
+material_buffer_t::material_buffer_t(const std::vector<material_t>& materials) {
+	update(materials);
+}
+
+void material_buffer_t::update(const std::vector<material_t>& materials) {
+	const auto records = pack(materials);
+	m_size = materials.size();
+	m_materials = core::object::buffer_t<gpu_material_t>(
+		core::object::buffer_target_t::shader_storage_buffer,
+		records.materials.data(),
+		records.materials.size()*sizeof(gpu_material_t),
+		core::object::buffer_usage_t::static_draw
+	);
+	m_texture_stack = core::object::buffer_t<gpu_texture_stack_entry_t>(
+		core::object::buffer_target_t::shader_storage_buffer,
+		records.texture_stack.data(),
+		records.texture_stack.size()*sizeof(gpu_texture_stack_entry_t),
+		core::object::buffer_usage_t::static_draw
+	);
+}
+
+void material_buffer_t::bind(GLuint material_binding, GLuint texture_stack_binding) const {
+	m_materials.bind_base(material_binding);
+	m_texture_stack.bind_base(texture_stack_binding);
+}
+
+size_t material_buffer_t::size() const {
+	return m_size;
+}
+
+std::string material_buffer_t::declaration(GLuint material_binding, GLuint texture_stack_binding) {
+	return fmt::format(R"(
+	struct glpp_material_t {{
+		vec4 ambient;
+		vec4 diffuse;
+		vec4 specular;
+		vec4 emissive;
+		uvec4 stack_offset;
+		uvec4 stack_size;
+		float shininess;
+	}};
+
+	struct glpp_texture_stack_entry_t {{
+		uint texture_key;
+		float strength;
+		uint op;
+		uint padding;
+	}};
+
+	layout(std430, binding = {}) readonly buffer glpp_materials_block {{
+		glpp_material_t glpp_materials[];
+	}};
+
+	layout(std430, binding = {}) readonly buffer glpp_texture_stack_block {{
+		glpp_texture_stack_entry_t glpp_texture_stack[];
+	}};
+	)", material_binding, texture_stack_binding);
+}
+
+}
@@ -3,11 +3,29 @@
 #include "core/object/attribute_properties.hpp"
 #include "core/object/buffer.hpp"
 #include "core/object/shader.hpp"
+#include "core/object/image_view.hpp"
+#include "core/object/image_conversion.hpp"
+#include "core/object/image_analysis.hpp"
+#include "core/object/image_pipeline.hpp"
+#include "core/object/compressed_image.hpp"
+#include "core/object/block_compression.hpp"
 #include "core/object/texture.hpp"
+#include "core/object/texture_array.hpp"
+#include "core/object/texture_upload_queue.hpp"
+#include "core/object/texture_unit_cache.hpp"
+#include "core/object/texture_streamer.hpp"
+#include "core/object/virtual_texture.hpp"
+#include "core/object/fence.hpp"
+#include "core/object/readback.hpp"
 #include "core/object/vertex_array.hpp"
+#include "core/object/renderbuffer.hpp"
+#include "core/object/multisample_texture.hpp"
 #include "core/object/framebuffer.hpp"
+#include "core/object/shared_frame.hpp"
 #include "core/object/texture_atlas.hpp"
+#include "core/object/texture_atlas_table.hpp"
 #include "core/object/shader_factory.hpp"
+#include "core/object/shader_template.hpp"
 #include "core/render/model.hpp"
 #include "core/render/renderer.hpp"
 #include "core/render/view.hpp"
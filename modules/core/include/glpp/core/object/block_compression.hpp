@@ -0,0 +1,104 @@
+#pragma once
+
+#include "glpp/core/object/compressed_image.hpp"
+#include "glpp/core/object/image.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace glpp::core::object {
+
+enum class compression_quality_t {
+	fast,
+	normal,
+	high
+};
+
+// Returns true, if compress() can encode into the given format.
+constexpr bool is_encodable(image_format_t format) {
+	switch(format) {
+		case image_format_t::bc1_rgb:
+		case image_format_t::bc1_rgba:
+		case image_format_t::bc1_srgb:
+		case image_format_t::bc1_srgba:
+		case image_format_t::bc3:
+		case image_format_t::bc3_srgba:
+		case image_format_t::bc4:
+		case image_format_t::bc5:
+			return true;
+		default:
+			return false;
+	}
+}
+
+namespace detail {
+
+	// Encodes a tightly packed RGBA8 image of the given size into a single compressed level.
+	std::vector<std::byte> compress_rgba8(
+		const std::uint8_t* rgba,
+		size_t width,
+		size_t height,
+		image_format_t format,
+		compression_quality_t quality
+	);
+
+	template <class T>
+	std::vector<std::uint8_t> to_rgba8(const image_t<T>& image);
+
+}
+
+template <class T>
+compressed_image_t compress(
+	const image_t<T>& image,
+	image_format_t format,
+	compression_quality_t quality = compression_quality_t::normal
+);
+
+template <class T>
+compressed_image_t compress(
+	const std::vector<image_t<T>>& mip_chain,
+	image_format_t format,
+	compression_quality_t quality = compression_quality_t::normal
+);
+
+/* Implementation */
+
+template <class T>
+std::vector<std::uint8_t> detail::to_rgba8(const image_t<T>& image) {
+	using internal_type = typename attribute_properties<T>::value_type;
+	const auto channels = static_cast<size_t>(image.channels());
+	const auto* src = reinterpret_cast<const internal_type*>(image.data());
+
+	// Missing channels are filled like OpenGL does for textures, so red images become (r, 0, 0, 1).
+	std::vector<std::uint8_t> result(image.size()*4);
+	for(size_t i = 0; i < image.size(); ++i) {
+		auto* out = result.data()+i*4;
+		out[0] = out[1] = out[2] = 0;
+		out[3] = 255;
+		for(size_t c = 0; c < std::min<size_t>(channels, 4); ++c) {
+			out[c] = channel_from_float<std::uint8_t>(channel_to_float(src[i*channels+c]));
+		}
+	}
+	return result;
+}
+
+template <class T>
+compressed_image_t compress(const image_t<T>& image, image_format_t format, compression_quality_t quality) {
+	return compress(std::vector<image_t<T>>{ image }, format, quality);
+}
+
+template <class T>
+compressed_image_t compress(const std::vector<image_t<T>>& mip_chain, image_format_t format, compression_quality_t quality) {
+	std::vector<compressed_image_t::level_t> levels;
+	levels.reserve(mip_chain.size());
+	for(const auto& image : mip_chain) {
+		const auto rgba = detail::to_rgba8(image);
+		levels.push_back({
+			image.width(),
+			image.height(),
+			detail::compress_rgba8(rgba.data(), image.width(), image.height(), format, quality)
+		});
+	}
+	return { format, std::move(levels) };
+}
+
+}
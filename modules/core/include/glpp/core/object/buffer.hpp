@@ -1,8 +1,10 @@
 #pragma once
 
 #include "glpp/core/object.hpp"
+#include "glpp/core/object/readback.hpp"
 #include "glpp/gl/constants.hpp"
 #include "glpp/gl/functions.hpp"
+#include <stdexcept>
 #include <vector>
 
 namespace glpp::core::object {
@@ -51,9 +53,15 @@ public:
 	buffer_t(buffer_target_t target, const T* data, size_t size, buffer_usage_t usage);
 
 	void bind() const;
+	void bind_base(GLuint index) const;
+
+	// Overwrites size bytes at offset in place, the buffer keeps its storage and name.
+	void update(const T* data, size_t size, size_t offset = 0);
 
 	std::vector<T> read() const;
 	void read(T* data) const;
+	// Copies the contents into a staging buffer on the GPU and returns without waiting for it.
+	buffer_readback_t<T> async_read() const;
 
 	size_t size() const ;
 
@@ -65,6 +73,7 @@ private:
 
 	buffer_target_t m_target;
 	size_t m_size = 0;
+	mutable detail::readback_pool_t m_readbacks;
 };
 
 /*
@@ -104,6 +113,19 @@ void buffer_t<T>::bind() const {
 	glBindBuffer(static_cast<GLenum>(m_target), id());
 }
 
+template <class T>
+void buffer_t<T>::bind_base(GLuint index) const {
+	glBindBufferBase(static_cast<GLenum>(m_target), index, id());
+}
+
+template <class T>
+void buffer_t<T>::update(const T* data, size_t size, size_t offset) {
+	if(offset+size > m_size) {
+		throw std::runtime_error("Buffer update exceeds the size of the buffer.");
+	}
+	glNamedBufferSubData(id(), offset, size, data);
+}
+
 template <class T>
 GLuint buffer_t<T>::create() {
 	GLuint id;
@@ -129,6 +151,16 @@ void buffer_t<T>::read(T* data) const {
 	glGetNamedBufferSubData(id(), 0, m_size, data);
 }
 
+template <class T>
+buffer_readback_t<T> buffer_t<T>::async_read() const {
+	auto staging = m_readbacks.acquire(m_size);
+	if(m_size > 0) {
+		glCopyNamedBufferSubData(id(), staging->id(), 0, 0, m_size);
+	}
+	staging->finish();
+	return buffer_readback_t<T>(std::move(staging), m_size);
+}
+
 template <class T>
 size_t buffer_t<T>::size() const {
 	return m_size;
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "glpp/core/object/image.hpp"
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace glpp::core::object {
+
+// Returns the size of a 4x4 block in bytes or 0, if the format is not block compressed.
+constexpr size_t compressed_block_size(image_format_t format) {
+	switch(format) {
+		case image_format_t::bc1_rgb:
+		case image_format_t::bc1_rgba:
+		case image_format_t::bc1_srgb:
+		case image_format_t::bc1_srgba:
+		case image_format_t::bc4:
+		case image_format_t::bc4_s:
+		case image_format_t::etc2_rgb:
+		case image_format_t::etc2_srgb:
+		case image_format_t::etc2_rgb_a1:
+		case image_format_t::etc2_srgb_a1:
+		case image_format_t::eac_r11:
+		case image_format_t::eac_r11_s:
+			return 8;
+		case image_format_t::bc2:
+		case image_format_t::bc2_srgba:
+		case image_format_t::bc3:
+		case image_format_t::bc3_srgba:
+		case image_format_t::bc5:
+		case image_format_t::bc5_s:
+		case image_format_t::bc6h_sf:
+		case image_format_t::bc6h_uf:
+		case image_format_t::bc7:
+		case image_format_t::bc7_srgba:
+		case image_format_t::etc2_rgba:
+		case image_format_t::etc2_srgba:
+		case image_format_t::eac_rg11:
+		case image_format_t::eac_rg11_s:
+			return 16;
+		default:
+			return 0;
+	}
+}
+
+constexpr bool is_block_compressed(image_format_t format) {
+	return compressed_block_size(format) != 0;
+}
+
+constexpr size_t compressed_image_size(image_format_t format, size_t width, size_t height) {
+	return ((width+3)/4)*((height+3)/4)*compressed_block_size(format);
+}
+
+class compressed_image_t {
+public:
+	struct level_t {
+		size_t width;
+		size_t height;
+		std::vector<std::byte> data;
+	};
+
+	compressed_image_t() = default;
+	compressed_image_t(image_format_t format, std::vector<level_t> levels);
+
+	// The implementation of these functions is in the image module. If you want to use them, you need
+	// to link against glpp::image. KTX2 and DDS containers are detected by their file signature.
+	explicit compressed_image_t(const char* filename);
+	static compressed_image_t from_memory(std::span<const std::byte> data);
+	static compressed_image_t from_ktx2(std::span<const std::byte> data);
+	static compressed_image_t from_dds(std::span<const std::byte> data);
+
+	image_format_t format() const noexcept;
+	size_t width() const noexcept;
+	size_t height() const noexcept;
+	const std::vector<level_t>& levels() const noexcept;
+	const level_t& level(size_t index) const;
+
+private:
+	image_format_t m_format = image_format_t::preferred;
+	std::vector<level_t> m_levels;
+};
+
+}
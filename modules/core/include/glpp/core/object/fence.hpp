@@ -0,0 +1,29 @@
+#pragma once
+
+#include "glpp/gl.hpp"
+#include <chrono>
+
+namespace glpp::core::object {
+
+class fence_t {
+public:
+
+	fence_t();
+	~fence_t();
+
+	fence_t(fence_t&& mov) noexcept;
+	fence_t& operator=(fence_t&& mov) noexcept;
+
+	fence_t(const fence_t& cpy) = delete;
+	fence_t& operator=(const fence_t& cpy) = delete;
+
+	bool signaled() const;
+	bool wait(std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max()) const;
+
+	GLsync id() const noexcept;
+
+private:
+	GLsync m_sync;
+};
+
+}
@@ -2,7 +2,14 @@
 
 #include "glpp/gl.hpp"
 #include "glpp/core/object.hpp"
+#include "multisample_texture.hpp"
+#include "readback.hpp"
+#include "renderbuffer.hpp"
 #include "texture.hpp"
+#include <deque>
+#include <map>
+#include <span>
+#include <vector>
 
 namespace glpp::core::object {
 
@@ -19,6 +26,16 @@ enum class framebuffer_target_t : GLenum {
 	read_and_write = GL_FRAMEBUFFER
 };
 
+enum class blit_mask_t : GLbitfield {
+	color = GL_COLOR_BUFFER_BIT,
+	depth = GL_DEPTH_BUFFER_BIT,
+	stencil = GL_STENCIL_BUFFER_BIT
+};
+
+constexpr blit_mask_t operator|(blit_mask_t lhs, blit_mask_t rhs) {
+	return static_cast<blit_mask_t>(static_cast<GLbitfield>(lhs) | static_cast<GLbitfield>(rhs));
+}
+
 class framebuffer_t : public object_t<> {
 public:
 
@@ -32,10 +49,14 @@ public:
 	framebuffer_t& operator=(framebuffer_t&& mov) = default;
 
 	void attach(const texture_t& texture, attachment_t attatchment);
+	void attach(const multisample_texture_t& texture, attachment_t attatchment);
+	void attach(const renderbuffer_t& renderbuffer, attachment_t attatchment);
 	void bind(framebuffer_target_t target = framebuffer_target_t::read_and_write);
 
 	size_t width() const;
 	size_t height() const;
+	// Samples of the attachments, zero if they are single sampled.
+	size_t samples() const;
 
 	static void bind_default_framebuffer(framebuffer_target_t target = framebuffer_target_t::read_and_write);
 	static framebuffer_t get_default_framebuffer();
@@ -46,16 +67,98 @@ public:
 	template <class T = glm::vec3>
 	image_t<T> pixel_read(size_t x, size_t y, size_t width, size_t height) const;
 
+	// Like pixel_read, but only queues the copy into a buffer and returns without waiting for the GPU.
+	template <class T = glm::vec3>
+	pixel_readback_t<T> async_pixel_read(size_t x = 0, size_t y = 0) const;
+
+	template <class T = glm::vec3>
+	pixel_readback_t<T> async_pixel_read(size_t x, size_t y, size_t width, size_t height) const;
+
+	pixel_readback_t<float> async_depth_read(size_t x, size_t y, size_t width = 1, size_t height = 1) const;
+
+	// Copies a region into a region of target and scales it with filter. Depth and stencil can only be
+	// copied with nearest filtering. Multisampled buffers are resolved, which needs regions of the same size.
+	void blit_to(
+		const framebuffer_t& target,
+		size_t x,
+		size_t y,
+		size_t width,
+		size_t height,
+		size_t target_x,
+		size_t target_y,
+		size_t target_width,
+		size_t target_height,
+		blit_mask_t mask = blit_mask_t::color,
+		filter_mode_t filter = filter_mode_t::nearest
+	) const;
+
+	// Scales the whole framebuffer to the whole target.
+	void blit_to(const framebuffer_t& target, blit_mask_t mask = blit_mask_t::color, filter_mode_t filter = filter_mode_t::linear) const;
+
+	// Averages the samples into target of the same size, e.g. a single sampled texture or the default framebuffer.
+	void resolve(const framebuffer_t& target, blit_mask_t mask = blit_mask_t::color) const;
+
 private:
 	framebuffer_t();
+
+	std::shared_ptr<const detail::readback_buffer_t> read_to_buffer(
+		size_t x,
+		size_t y,
+		size_t width,
+		size_t height,
+		GLenum format,
+		GLenum type,
+		size_t pixel_size
+	) const;
 	
 	GLuint create();
 	static void destroy(GLuint id);
+	// Throws if the other attachments have a different number of samples, which would leave the
+	// framebuffer incomplete.
+	void attach_samples(attachment_t attachment, size_t samples);
 
 	size_t m_width;
 	size_t m_height;
+	size_t m_samples = 0;
+	std::map<GLenum, size_t> m_attachment_samples;
+	// Whether the color attachment has an integer format, which is read with the *_INTEGER formats.
+	bool m_integer_color = false;
+	mutable detail::readback_pool_t m_readbacks;
 };
 
+namespace detail {
+
+	// Ring of readback buffers for whole frames, finished copies are collected in capture order.
+	class frame_readback_ring_t {
+	public:
+		frame_readback_ring_t(size_t width, size_t height, GLenum format, size_t pixel_size, size_t depth);
+
+		// Queues a copy of the color attachment, or of the back buffer of the default framebuffer.
+		// Needs a free buffer, wait for the oldest copy if the ring is full.
+		void capture(const framebuffer_t& framebuffer);
+		void wait() const;
+
+		// Passes the finished copies in capture order to functor(std::span<const std::byte>), waits for
+		// all of them if wait is set. Returns the number of collected frames.
+		template <class Functor>
+		size_t collect(bool wait, Functor&& functor);
+
+		bool full() const;
+		size_t pending() const;
+		size_t width() const;
+		size_t height() const;
+
+	private:
+		size_t m_width;
+		size_t m_height;
+		GLenum m_format;
+		std::vector<readback_buffer_t> m_ring;
+		std::deque<size_t> m_pending;
+		size_t m_next_slot = 0;
+	};
+
+}
+
 template <class T>
 image_t<T> framebuffer_t::pixel_read(size_t x, size_t y) const {
 	return pixel_read<T>(x, y, m_width - x, m_height - y);
@@ -63,10 +166,42 @@ image_t<T> framebuffer_t::pixel_read(size_t x, size_t y) const {
 
 template <class T>
 image_t<T> framebuffer_t::pixel_read(size_t x, size_t y, size_t width, size_t height) const {
+	if(m_samples > 0) {
+		throw std::runtime_error("Multisampled framebuffers need to be resolved before reading pixels.");
+	}
 	image_t<T> result(width, height);
 	glNamedFramebufferReadBuffer(id(), GL_COLOR_ATTACHMENT0);
 	glReadPixels(x, y, width, height, static_cast<GLenum>(result.format()), result.type(), result.data());
 	return result;
 }
 
+template <class T>
+pixel_readback_t<T> framebuffer_t::async_pixel_read(size_t x, size_t y) const {
+	return async_pixel_read<T>(x, y, m_width - x, m_height - y);
+}
+
+template <class T>
+pixel_readback_t<T> framebuffer_t::async_pixel_read(size_t x, size_t y, size_t width, size_t height) const {
+	glNamedFramebufferReadBuffer(id(), GL_COLOR_ATTACHMENT0);
+	return pixel_readback_t<T>(
+		read_to_buffer(x, y, width, height, detail::pixel_format(attribute_properties<T>::elements_per_vertex, m_integer_color), attribute_properties<T>::type, sizeof(T)),
+		width,
+		height
+	);
+}
+
+template <class Functor>
+size_t detail::frame_readback_ring_t::collect(bool wait, Functor&& functor) {
+	size_t collected = 0;
+	for(; !m_pending.empty(); ++collected) {
+		const auto& buffer = m_ring[m_pending.front()];
+		if(!wait && !buffer.ready()) break;
+		buffer.read([&](const std::byte* data) {
+			functor(std::span<const std::byte>(data, buffer.size()));
+		});
+		m_pending.pop_front();
+	}
+	return collected;
+}
+
 } // End of namespace glpp::object
@@ -8,7 +8,12 @@
 #include <glm/gtx/string_cast.hpp>
 #include <glpp/gl/constants.hpp>
 #include <glpp/core/object/attribute_properties.hpp>
+#include <glpp/core/object/image_conversion.hpp>
+#include <glpp/core/object/image_view.hpp>
 #include <functional>
+#include <cmath>
+#include <cstdint>
+#include <span>
 
 namespace glpp::core::object {
 
@@ -89,14 +94,32 @@ enum class image_format_t : GLenum {
 	rgba_c          = GL_COMPRESSED_RGBA,
 	rgb_s_c         = GL_COMPRESSED_SRGB,
 	rgba_s_c        = GL_COMPRESSED_SRGB_ALPHA,
-// 	                = GL_COMPRESSED_RED_RGTC1,
-// 	                = GL_COMPRESSED_SIGNED_RED_RGTC1,
-// 	                = GL_COMPRESSED_RG_RGTC2,
-// 	                = GL_COMPRESSED_SIGNED_RG_RGTC2,
-// 	                = GL_COMPRESSED_RGBA_BPTC_UNORM,
-// 	                = GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM,
-// 	                = GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT,
-// 	                = GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT,
+	bc1_rgb         = GL_COMPRESSED_RGB_S3TC_DXT1_EXT,
+	bc1_rgba        = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,
+	bc2             = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT,
+	bc3             = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,
+	bc1_srgb        = GL_COMPRESSED_SRGB_S3TC_DXT1_EXT,
+	bc1_srgba       = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT,
+	bc2_srgba       = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT,
+	bc3_srgba       = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT,
+	bc4             = GL_COMPRESSED_RED_RGTC1,
+	bc4_s           = GL_COMPRESSED_SIGNED_RED_RGTC1,
+	bc5             = GL_COMPRESSED_RG_RGTC2,
+	bc5_s           = GL_COMPRESSED_SIGNED_RG_RGTC2,
+	bc6h_sf         = GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT,
+	bc6h_uf         = GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT,
+	bc7             = GL_COMPRESSED_RGBA_BPTC_UNORM,
+	bc7_srgba       = GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM,
+	etc2_rgb        = GL_COMPRESSED_RGB8_ETC2,
+	etc2_srgb       = GL_COMPRESSED_SRGB8_ETC2,
+	etc2_rgb_a1     = GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2,
+	etc2_srgb_a1    = GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2,
+	etc2_rgba       = GL_COMPRESSED_RGBA8_ETC2_EAC,
+	etc2_srgba      = GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC,
+	eac_r11         = GL_COMPRESSED_R11_EAC,
+	eac_r11_s       = GL_COMPRESSED_SIGNED_R11_EAC,
+	eac_rg11        = GL_COMPRESSED_RG11_EAC,
+	eac_rg11_s      = GL_COMPRESSED_SIGNED_RG11_EAC,
 	d_32f           = GL_DEPTH_COMPONENT32F,
 	d_24i           = GL_DEPTH_COMPONENT24,
 	d_16i           = GL_DEPTH_COMPONENT16,
@@ -105,13 +128,199 @@ enum class image_format_t : GLenum {
 	s_8i            = GL_STENCIL_INDEX8,
 };
 
+// Returns the size of a texel in video memory in bytes or 0, if the format is unsized or compressed.
+// Three channel formats are counted with four channels, as drivers pad them.
+constexpr size_t format_texel_size(image_format_t format) {
+	switch(format) {
+		case image_format_t::red_8:
+		case image_format_t::red_s8:
+		case image_format_t::rgb_332:
+		case image_format_t::rgba_2:
+		case image_format_t::r_8i:
+		case image_format_t::r_8ui:
+		case image_format_t::s_8i:
+			return 1;
+		case image_format_t::red_16:
+		case image_format_t::red_16s:
+		case image_format_t::rg_8:
+		case image_format_t::rg_8s:
+		case image_format_t::rgb_4:
+		case image_format_t::rgb_5:
+		case image_format_t::rgba_4:
+		case image_format_t::rgb_5_a1:
+		case image_format_t::r_16f:
+		case image_format_t::r_16i:
+		case image_format_t::r_16ui:
+		case image_format_t::rg_8i:
+		case image_format_t::rg8_ui:
+		case image_format_t::d_16i:
+			return 2;
+		case image_format_t::rg_16:
+		case image_format_t::rg_16s:
+		case image_format_t::rgb_8:
+		case image_format_t::rgb_8s:
+		case image_format_t::rgb_10:
+		case image_format_t::rgba_8:
+		case image_format_t::rgba_8s:
+		case image_format_t::rgb10_a2:
+		case image_format_t::rgba_10ui_a2ui:
+		case image_format_t::srgb8:
+		case image_format_t::srgba_8:
+		case image_format_t::rg_16f:
+		case image_format_t::red_32f:
+		case image_format_t::rgb_11f_11f_10f:
+		case image_format_t::rgb_9_e5:
+		case image_format_t::r_32i:
+		case image_format_t::r_32ui:
+		case image_format_t::rg_16i:
+		case image_format_t::rg_16ui:
+		case image_format_t::rgb_8i:
+		case image_format_t::rgb_8ui:
+		case image_format_t::rgba_8i:
+		case image_format_t::rgba_8ui:
+		case image_format_t::d_32f:
+		case image_format_t::d_24i:
+		case image_format_t::d_24i_s_8i:
+			return 4;
+		case image_format_t::rgb_12:
+		case image_format_t::rgb_16:
+		case image_format_t::rgba_12:
+		case image_format_t::rgba_16:
+		case image_format_t::rgb_16f:
+		case image_format_t::rgba_16f:
+		case image_format_t::rg_32f:
+		case image_format_t::rg_32i:
+		case image_format_t::rg_32ui:
+		case image_format_t::rgb_16i:
+		case image_format_t::rgb_16ui:
+		case image_format_t::rgba_16i:
+		case image_format_t::rgba_16ui:
+		case image_format_t::d_32f_s_8i:
+			return 8;
+		case image_format_t::rgb_32f:
+		case image_format_t::rgba_32f:
+		case image_format_t::rgb_32i:
+		case image_format_t::rgb_32ui:
+		case image_format_t::rgba_32i:
+		case image_format_t::rgba_32ui:
+			return 16;
+		default:
+			return 0;
+	}
+}
+
+enum class mip_filter_t {
+	box,
+	kaiser,
+	bilinear,
+	bicubic,
+	lanczos
+};
+
+enum class color_space_t {
+	linear,
+	srgb
+};
+
+constexpr size_t mip_level_count(size_t width, size_t height) {
+	size_t levels = 1;
+	for(auto size = std::max(width, height); size > 1; size /= 2) {
+		++levels;
+	}
+	return levels;
+}
+
 namespace detail {
 
+	void resample(
+		const float* src,
+		size_t src_width,
+		size_t src_height,
+		float* dst,
+		size_t dst_width,
+		size_t dst_height,
+		size_t channels,
+		mip_filter_t filter
+	);
+	void srgb_to_linear(float* data, size_t pixels, size_t channels);
+	void linear_to_srgb(float* data, size_t pixels, size_t channels);
+
+	// Channel conversions with a vectorized kernel in conversion::convert.
+	template <class From, class To>
+	constexpr bool vectorized_conversion_v =
+		(std::is_same_v<From, std::uint8_t> && (std::is_same_v<To, float> || std::is_same_v<To, std::uint16_t>)) ||
+		((std::is_same_v<From, float> || std::is_same_v<From, std::uint16_t>) && std::is_same_v<To, std::uint8_t>);
+
+	template <class V>
+	constexpr float channel_to_float(V v) {
+		if constexpr(std::is_integral_v<V>) {
+			constexpr auto max = static_cast<float>(std::numeric_limits<V>::max());
+			return std::max(static_cast<float>(v)/max, -1.0f);
+		} else {
+			return static_cast<float>(v);
+		}
+	}
+
+	template <class V>
+	constexpr V channel_from_float(float f) {
+		if constexpr(std::is_integral_v<V>) {
+			constexpr auto max = static_cast<float>(std::numeric_limits<V>::max());
+			constexpr auto min = std::is_signed_v<V> ? -1.0f : 0.0f;
+			return static_cast<V>(std::lround(std::clamp(f, min, 1.0f)*max));
+		} else {
+			return static_cast<V>(f);
+		}
+	}
+
+	// Channel types decoded without a conversion of the source data.
+	enum class decoded_type_t {
+		u8,
+		u16,
+		f32
+	};
+
+	// Widest decoded type useful for the channel type V of an image.
+	template <class V>
+	constexpr decoded_type_t decoded_type_for_v =
+		std::is_floating_point_v<V> ? decoded_type_t::f32 :
+		sizeof(V) > 1 ? decoded_type_t::u16 : decoded_type_t::u8;
+
+	/*
+	 * Pixels decoded by the image module. Files are memory mapped and decoded in place. 16 bit and HDR
+	 * sources keep their precision, if max_type allows it, otherwise they are reduced to 8 bit.
+	 */
+	class decoded_image_t {
+	public:
+		decoded_image_t(const char* filename, int channels, decoded_type_t max_type);
+		decoded_image_t(std::span<const std::byte> data, int channels, decoded_type_t max_type);
+		~decoded_image_t();
+
+		decoded_image_t(const decoded_image_t& cpy) = delete;
+		decoded_image_t& operator=(const decoded_image_t& cpy) = delete;
+
+		size_t width() const;
+		size_t height() const;
+		decoded_type_t type() const;
+
+		template <class V>
+		std::span<const V> pixels() const {
+			return { static_cast<const V*>(m_storage), m_width*m_height*m_channels };
+		}
+
+	private:
+		void decode(std::span<const std::byte> data, decoded_type_t max_type, const char* name);
+
+		size_t         m_width = 0;
+		size_t         m_height = 0;
+		size_t         m_channels;
+		decoded_type_t m_type = decoded_type_t::u8;
+		void*          m_storage = nullptr;
+	};
+
 	class stbi_image_t {
 	public:
 		using value_type = unsigned char;
 
-		stbi_image_t(const char* filename, int channels);
 		stbi_image_t(size_t width, size_t height, int channels);
 		~stbi_image_t();
 
@@ -157,6 +366,7 @@ public:
 
 	constexpr image_t(size_t width, size_t height, const value_type* begin);
 	constexpr image_t(size_t width, size_t height, std::initializer_list<T> init_list);
+	explicit image_t(image_view_t<const T> view);
 
 	template <
 		class Range,
@@ -194,7 +404,14 @@ public:
 
 
 	void load(const char* filename);
+	static image_t from_memory(std::span<const std::byte> data);
 	constexpr image_t& update(size_t x, size_t y, const image_t<T>& update) noexcept;
+	image_t& update(size_t x, size_t y, image_view_t<const T> update) noexcept;
+
+	image_view_t<T> view() noexcept;
+	image_view_t<const T> view() const noexcept;
+	image_view_t<T> view(size_t x, size_t y, size_t width, size_t height);
+	image_view_t<const T> view(size_t x, size_t y, size_t width, size_t height) const;
 
 	void write(const char* filename) const;
 
@@ -218,10 +435,38 @@ public:
 	constexpr GLenum type() const noexcept;
 
 	image_t resize(size_t width, size_t height) const;
+	image_t resize(
+		size_t width,
+		size_t height,
+		mip_filter_t filter,
+		color_space_t color_space = color_space_t::linear
+	) const;
+	image_t thumbnail(
+		size_t max_size,
+		mip_filter_t filter = mip_filter_t::lanczos,
+		color_space_t color_space = color_space_t::linear
+	) const;
+
+	image_t downsample(
+		mip_filter_t filter = mip_filter_t::box,
+		color_space_t color_space = color_space_t::linear
+	) const;
+	std::vector<image_t> mip_chain(
+		mip_filter_t filter = mip_filter_t::box,
+		color_space_t color_space = color_space_t::linear,
+		size_t levels = 0
+	) const;
 
 private:
 
+	std::vector<float> to_float(color_space_t color_space) const;
+	static image_t from_float(size_t width, size_t height, std::vector<float> channels, color_space_t color_space);
+
 	static constexpr int channels_impl() noexcept;
+
+	void assign(const detail::decoded_image_t& decoded);
+	template <class V>
+	void assign_pixels(std::span<const V> pixels);
 	
 	template <class From, class To>
 	static constexpr To convert_pixel_format(From v);
@@ -264,7 +509,7 @@ struct image_comperator_t {
 	constexpr operator bool() const {
 		return 
 			lhs.width() == rhs.width() &&
-			lhs.width() == rhs.width() &&
+			lhs.height() == rhs.height() &&
 			std::equal(lhs.begin(), lhs.end(), rhs.begin(), comperator);
 	}
 
@@ -327,22 +572,32 @@ constexpr image_t<T>::image_t(const image_t<U>& conv) :
 		attribute_properties<T>::elements_per_vertex == attribute_properties<U>::elements_per_vertex,
 		"Conversion between image formats is only possible, if the number of channels match exactly."
 	);
-	std::transform(
-		conv.begin(),
-		conv.end(),
-		begin(),
-		[](U u) {
-			if constexpr (std::is_arithmetic_v<U>) {
-				return convert_pixel_format<U, T>(u);
-			} else {
-				T result;
-				for(auto i = 0; i < attribute_properties<T>::elements_per_vertex; ++i) {
-					result[i] = convert_pixel_format<attribute_properties<U>::value_type, attribute_properties<T>::value_type>(u[i]);
+	using from_t = typename attribute_properties<U>::value_type;
+	using to_t = typename attribute_properties<T>::value_type;
+	if constexpr(detail::vectorized_conversion_v<from_t, to_t>) {
+		const auto channels = conv.size()*channels_impl();
+		conversion::convert(
+			std::span(reinterpret_cast<const from_t*>(conv.data()), channels),
+			std::span(reinterpret_cast<to_t*>(data()), channels)
+		);
+	} else {
+		std::transform(
+			conv.begin(),
+			conv.end(),
+			begin(),
+			[](U u) {
+				if constexpr (std::is_arithmetic_v<U>) {
+					return convert_pixel_format<U, T>(u);
+				} else {
+					T result;
+					for(auto i = 0; i < attribute_properties<T>::elements_per_vertex; ++i) {
+						result[i] = convert_pixel_format<from_t, to_t>(u[i]);
+					}
+					return result;
 				}
-				return result;
 			}
-		}
-	);
+		);
+	}
 }
 
 template <class T>
@@ -354,6 +609,17 @@ constexpr image_t<T>::image_t(size_t width, size_t height, std::initializer_list
 	assert(width*height == m_storage.size());
 }
 
+template <class T>
+image_t<T>::image_t(image_view_t<const T> view) :
+	m_width(view.width()),
+	m_height(view.height())
+{
+	m_storage.reserve(view.size());
+	for(size_t y = 0; y < view.height(); ++y) {
+		m_storage.insert(m_storage.end(), view.row(y), view.row(y)+view.width());
+	}
+}
+
 template <class T>
 constexpr image_t<T>::image_t(size_t width, size_t height, const value_type* begin) :
 	m_width(width),
@@ -387,17 +653,52 @@ image_t<T>::image_t(const char* filename)
 template <class T>
 void image_t<T>::load(const char* filename)
 {
-	const auto storage = detail::stbi_image_t(filename, channels_impl());
-	m_width = storage.width();
-	m_height = storage.height();
-	m_storage.resize(m_width*m_height);
 	using internal_type = typename attribute_properties<T>::value_type;
-	std::transform(
-		storage.begin(),
-		storage.end(),
-		reinterpret_cast<internal_type*>(m_storage.data()),
-		convert_pixel_format<detail::stbi_image_t::value_type, internal_type>
-	);
+	assign(detail::decoded_image_t(filename, channels_impl(), detail::decoded_type_for_v<internal_type>));
+}
+
+template <class T>
+image_t<T> image_t<T>::from_memory(std::span<const std::byte> data) {
+	using internal_type = typename attribute_properties<T>::value_type;
+	image_t result;
+	result.assign(detail::decoded_image_t(data, channels_impl(), detail::decoded_type_for_v<internal_type>));
+	return result;
+}
+
+template <class T>
+void image_t<T>::assign(const detail::decoded_image_t& decoded) {
+	m_width = decoded.width();
+	m_height = decoded.height();
+	switch(decoded.type()) {
+		case detail::decoded_type_t::u8:
+			assign_pixels(decoded.pixels<std::uint8_t>());
+			break;
+		case detail::decoded_type_t::u16:
+			assign_pixels(decoded.pixels<std::uint16_t>());
+			break;
+		case detail::decoded_type_t::f32:
+			assign_pixels(decoded.pixels<float>());
+			break;
+	}
+}
+
+template <class T>
+template <class V>
+void image_t<T>::assign_pixels(std::span<const V> pixels) {
+	using internal_type = typename attribute_properties<T>::value_type;
+	if constexpr(std::is_same_v<V, internal_type>) {
+		// Matching formats are copied once from the decoder output, without zeroing the storage first.
+		const auto* begin = reinterpret_cast<const value_type*>(pixels.data());
+		m_storage.assign(begin, begin+m_width*m_height);
+	} else {
+		m_storage.resize(m_width*m_height);
+		auto* target = reinterpret_cast<internal_type*>(m_storage.data());
+		if constexpr(detail::vectorized_conversion_v<V, internal_type>) {
+			conversion::convert(pixels, std::span(target, pixels.size()));
+		} else {
+			std::transform(pixels.begin(), pixels.end(), target, convert_pixel_format<V, internal_type>);
+		}
+	}
 }
 
 template <class T>
@@ -414,16 +715,53 @@ constexpr image_t<T>& image_t<T>::update(const size_t x, const size_t y, const i
 	return *this;
 }
 
+template <class T>
+image_t<T>& image_t<T>::update(const size_t x, const size_t y, image_view_t<const T> update) noexcept {
+	const auto cols = std::min(x<=m_width  ? m_width-x : 0, update.width());
+	const auto rows = std::min(y<=m_height ? m_height-y : 0, update.height());
+	for(auto i = y; i < y+rows; ++i) {
+		std::copy_n(update.row(i-y), cols, m_storage.begin()+i*m_width+x);
+	}
+	return *this;
+}
+
+template <class T>
+image_view_t<T> image_t<T>::view() noexcept {
+	return image_view_t<T>(*this);
+}
+
+template <class T>
+image_view_t<const T> image_t<T>::view() const noexcept {
+	return image_view_t<const T>(*this);
+}
+
+template <class T>
+image_view_t<T> image_t<T>::view(size_t x, size_t y, size_t width, size_t height) {
+	return view().subview(x, y, width, height);
+}
+
+template <class T>
+image_view_t<const T> image_t<T>::view(size_t x, size_t y, size_t width, size_t height) const {
+	return view().subview(x, y, width, height);
+}
+
 template <class T>
 void image_t<T>::write(const char* filename) const {
 	auto storage = detail::stbi_image_t(m_width, m_height, channels_impl());
 	using internal_type = typename attribute_properties<T>::value_type;
-	std::transform(
-		reinterpret_cast<const internal_type*>(data()),
-		reinterpret_cast<const internal_type*>(data())+size()*channels_impl(),
-		storage.begin(),
-		convert_pixel_format<internal_type, detail::stbi_image_t::value_type>
-	);
+	const auto* source = reinterpret_cast<const internal_type*>(data());
+	if constexpr(std::is_same_v<detail::stbi_image_t::value_type, internal_type>) {
+		std::copy(source, source+size()*channels_impl(), storage.begin());
+	} else if constexpr(detail::vectorized_conversion_v<internal_type, detail::stbi_image_t::value_type>) {
+		conversion::convert(std::span(source, size()*channels_impl()), std::span(storage.begin(), storage.end()));
+	} else {
+		std::transform(
+			source,
+			source+size()*channels_impl(),
+			storage.begin(),
+			convert_pixel_format<internal_type, detail::stbi_image_t::value_type>
+		);
+	}
 	storage.write(filename);
 }
 
@@ -530,28 +868,109 @@ constexpr GLenum image_t<T>::type() const noexcept {
 template <class T>
 image_t<T> image_t<T>::resize(size_t width, size_t height) const {
 	image_t<T> result { width, height };
-	for(auto x = 0u; x < width; ++x) {
-		for(auto y = 0u; y < height; ++y) {
-			const auto j = static_cast<size_t>(
-				std::lerp(
-					0.0,
-					static_cast<double>(m_width),
-					static_cast<double>(x)/static_cast<double>(width)
-				)
-			);
-			const auto i = static_cast<size_t>(
-				std::lerp(
-					0.0,
-					static_cast<double>(m_height),
-					static_cast<double>(y)/static_cast<double>(height)
-				)
-			);
-			result.get(x,y) = get(j,i);
+	std::vector<size_t> columns(width);
+	for(size_t x = 0; x < width; ++x) {
+		columns[x] = x*m_width/width;
+	}
+	for(size_t y = 0; y < height; ++y) {
+		const auto* src = m_storage.data()+y*m_height/height*m_width;
+		auto* dst = result.m_storage.data()+y*width;
+		for(size_t x = 0; x < width; ++x) {
+			dst[x] = src[columns[x]];
 		}
 	}
 	return result;
 }
 
+template <class T>
+image_t<T> image_t<T>::resize(size_t width, size_t height, mip_filter_t filter, color_space_t color_space) const {
+	if(width == 0 || height == 0) {
+		throw std::runtime_error("Can not resize an image to zero pixels.");
+	}
+	const auto source = to_float(color_space);
+	std::vector<float> target(width*height*channels_impl());
+	detail::resample(source.data(), m_width, m_height, target.data(), width, height, channels_impl(), filter);
+	return from_float(width, height, std::move(target), color_space);
+}
+
+template <class T>
+image_t<T> image_t<T>::thumbnail(size_t max_size, mip_filter_t filter, color_space_t color_space) const {
+	if(max_size == 0) {
+		throw std::runtime_error("Can not create a thumbnail with zero pixels.");
+	}
+	if(m_width <= max_size && m_height <= max_size) {
+		return *this;
+	}
+	const auto scale = static_cast<double>(max_size)/static_cast<double>(std::max(m_width, m_height));
+	const auto width = std::max<size_t>(static_cast<size_t>(std::lround(m_width*scale)), 1);
+	const auto height = std::max<size_t>(static_cast<size_t>(std::lround(m_height*scale)), 1);
+	return resize(width, height, filter, color_space);
+}
+
+template <class T>
+image_t<T> image_t<T>::downsample(mip_filter_t filter, color_space_t color_space) const {
+	const auto width = std::max<size_t>(m_width/2, 1);
+	const auto height = std::max<size_t>(m_height/2, 1);
+	const auto source = to_float(color_space);
+	std::vector<float> target(width*height*channels_impl());
+	detail::resample(source.data(), m_width, m_height, target.data(), width, height, channels_impl(), filter);
+	return from_float(width, height, std::move(target), color_space);
+}
+
+template <class T>
+std::vector<image_t<T>> image_t<T>::mip_chain(mip_filter_t filter, color_space_t color_space, size_t levels) const {
+	const auto max_levels = mip_level_count(m_width, m_height);
+	levels = levels == 0 ? max_levels : std::min(levels, max_levels);
+
+	std::vector<image_t> result;
+	result.reserve(levels);
+	result.push_back(*this);
+
+	// The whole chain is filtered in linear float space, so every level is derived from unquantized data.
+	auto level = to_float(color_space);
+	std::vector<float> next;
+	auto width = m_width;
+	auto height = m_height;
+	while(result.size() < levels) {
+		const auto next_width = std::max<size_t>(width/2, 1);
+		const auto next_height = std::max<size_t>(height/2, 1);
+		next.resize(next_width*next_height*channels_impl());
+		detail::resample(level.data(), width, height, next.data(), next_width, next_height, channels_impl(), filter);
+		std::swap(level, next);
+		width = next_width;
+		height = next_height;
+		result.push_back(from_float(width, height, level, color_space));
+	}
+	return result;
+}
+
+template <class T>
+std::vector<float> image_t<T>::to_float(color_space_t color_space) const {
+	using internal_type = typename attribute_properties<T>::value_type;
+	const auto* begin = reinterpret_cast<const internal_type*>(data());
+	std::vector<float> result(size()*channels_impl());
+	if constexpr(detail::vectorized_conversion_v<internal_type, float>) {
+		conversion::convert(std::span(begin, result.size()), std::span(result));
+	} else {
+		std::transform(begin, begin+result.size(), result.begin(), detail::channel_to_float<internal_type>);
+	}
+	if(color_space == color_space_t::srgb) {
+		detail::srgb_to_linear(result.data(), size(), channels_impl());
+	}
+	return result;
+}
+
+template <class T>
+image_t<T> image_t<T>::from_float(size_t width, size_t height, std::vector<float> channels, color_space_t color_space) {
+	using internal_type = typename attribute_properties<T>::value_type;
+	if(color_space == color_space_t::srgb) {
+		detail::linear_to_srgb(channels.data(), width*height, channels_impl());
+	}
+	image_t result(width, height);
+	std::transform(channels.begin(), channels.end(), reinterpret_cast<internal_type*>(result.data()), detail::channel_from_float<internal_type>);
+	return result;
+}
+
 template <class T>
 constexpr int image_t<T>::channels_impl() noexcept {
 	return attribute_properties<value_type>::elements_per_vertex;
@@ -582,7 +1001,7 @@ constexpr To image_t<T>::convert_pixel_format(From v) {
 		constexpr auto max = static_cast<From>(std::numeric_limits<To>::max());
 		constexpr auto min = static_cast<From>(std::numeric_limits<To>::min());
 		constexpr auto increments = max-min;
-		return static_cast<To>(std::ceil(v*increments+min));
+		return static_cast<To>(std::round(std::clamp(v, From(0), From(1))*increments+min));
 	} else 
 	if constexpr(std::is_same_v<From, To>) {
 		return v;
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "glpp/core/object/image.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace glpp::core::object {
+
+// How much two images differ. Errors are measured on channels normalized to [0, 1].
+struct image_difference_t {
+	double max_error = 0.0;
+	double mean_error = 0.0;
+	double mean_squared_error = 0.0;
+	// Peak signal to noise ratio in dB, infinite for identical images.
+	double psnr = std::numeric_limits<double>::infinity();
+	// Pixels with at least one different channel.
+	size_t different_pixels = 0;
+
+	constexpr bool identical() const noexcept {
+		return different_pixels == 0;
+	}
+};
+
+/*
+ * Analysis kernels for interleaved pixels. Like the conversion kernels they use the instruction set
+ * selected by conversion::simd_level() and large inputs are split across threads.
+ */
+namespace analysis {
+
+	// lhs and rhs need to have the same size, which is a multiple of channels.
+	image_difference_t compare(std::span<const std::uint8_t> lhs, std::span<const std::uint8_t> rhs, size_t channels);
+	image_difference_t compare(std::span<const float> lhs, std::span<const float> rhs, size_t channels);
+
+	void absolute_difference(std::span<const std::uint8_t> lhs, std::span<const std::uint8_t> rhs, std::span<std::uint8_t> dst);
+	void absolute_difference(std::span<const float> lhs, std::span<const float> rhs, std::span<float> dst);
+
+	// Mean structural similarity of all channels over 8x8 windows, which are 4 pixels apart.
+	// Images smaller than a window are compared as a whole.
+	double ssim(std::span<const std::uint8_t> lhs, std::span<const std::uint8_t> rhs, size_t width, size_t height, size_t channels);
+	double ssim(std::span<const float> lhs, std::span<const float> rhs, size_t width, size_t height, size_t channels);
+
+	// 256 bins per channel, the count of value v in channel c is stored in bins[c*256+v].
+	void histogram(std::span<const std::uint8_t> pixels, size_t channels, std::span<std::uint64_t> bins);
+
+	// Reverses the order of the rows, e.g. of bottom up pixels read from a framebuffer.
+	void flip_vertical(std::span<std::byte> pixels, size_t row_size);
+
+}
+
+template <class T>
+image_difference_t compare(const image_t<T>& lhs, const image_t<T>& rhs);
+
+template <class T>
+image_t<T> absolute_difference(const image_t<T>& lhs, const image_t<T>& rhs);
+
+template <class T>
+double ssim(const image_t<T>& lhs, const image_t<T>& rhs);
+
+// Available for 8 bit channels only.
+template <class T>
+std::vector<std::array<std::uint64_t, 256>> histogram(const image_t<T>& image);
+
+template <class T>
+void flip_vertical(image_t<T>& image);
+
+/*
+ * Implementation
+ */
+
+namespace detail {
+
+	template <class T>
+	void check_same_size(const image_t<T>& lhs, const image_t<T>& rhs) {
+		if(lhs.width() != rhs.width() || lhs.height() != rhs.height()) {
+			throw std::runtime_error(
+				"Images of size "+std::to_string(lhs.width())+"x"+std::to_string(lhs.height())+" and "+
+				std::to_string(rhs.width())+"x"+std::to_string(rhs.height())+" can not be compared."
+			);
+		}
+	}
+
+	template <class T>
+	constexpr bool analysis_native_v =
+		std::is_same_v<typename attribute_properties<T>::value_type, std::uint8_t> ||
+		std::is_same_v<typename attribute_properties<T>::value_type, float>;
+
+	template <class T>
+	auto channels_of(const image_t<T>& image) {
+		using internal_type = typename attribute_properties<T>::value_type;
+		const auto* data = reinterpret_cast<const internal_type*>(image.data());
+		return std::span<const internal_type>(data, image.size()*image.channels());
+	}
+
+	template <class T>
+	std::vector<float> normalized_channels(const image_t<T>& image) {
+		const auto channels = channels_of(image);
+		std::vector<float> result(channels.size());
+		std::transform(channels.begin(), channels.end(), result.begin(), channel_to_float<typename decltype(channels)::value_type>);
+		return result;
+	}
+
+}
+
+template <class T>
+image_difference_t compare(const image_t<T>& lhs, const image_t<T>& rhs) {
+	detail::check_same_size(lhs, rhs);
+	if constexpr(detail::analysis_native_v<T>) {
+		return analysis::compare(detail::channels_of(lhs), detail::channels_of(rhs), lhs.channels());
+	} else {
+		const auto lhs_float = detail::normalized_channels(lhs);
+		const auto rhs_float = detail::normalized_channels(rhs);
+		return analysis::compare(std::span<const float>(lhs_float), std::span<const float>(rhs_float), lhs.channels());
+	}
+}
+
+template <class T>
+image_t<T> absolute_difference(const image_t<T>& lhs, const image_t<T>& rhs) {
+	detail::check_same_size(lhs, rhs);
+	if constexpr(detail::analysis_native_v<T>) {
+		using internal_type = typename attribute_properties<T>::value_type;
+		image_t<T> result(lhs.width(), lhs.height());
+		auto* data = reinterpret_cast<internal_type*>(result.data());
+		analysis::absolute_difference(detail::channels_of(lhs), detail::channels_of(rhs), std::span(data, result.size()*result.channels()));
+		return result;
+	} else {
+		using internal_type = typename attribute_properties<T>::value_type;
+		auto lhs_float = detail::normalized_channels(lhs);
+		const auto rhs_float = detail::normalized_channels(rhs);
+		analysis::absolute_difference(std::span<const float>(lhs_float), std::span<const float>(rhs_float), std::span<float>(lhs_float));
+		image_t<T> result(lhs.width(), lhs.height());
+		std::transform(lhs_float.begin(), lhs_float.end(), reinterpret_cast<internal_type*>(result.data()), detail::channel_from_float<internal_type>);
+		return result;
+	}
+}
+
+template <class T>
+double ssim(const image_t<T>& lhs, const image_t<T>& rhs) {
+	detail::check_same_size(lhs, rhs);
+	if constexpr(detail::analysis_native_v<T>) {
+		return analysis::ssim(detail::channels_of(lhs), detail::channels_of(rhs), lhs.width(), lhs.height(), lhs.channels());
+	} else {
+		const auto lhs_float = detail::normalized_channels(lhs);
+		const auto rhs_float = detail::normalized_channels(rhs);
+		return analysis::ssim(std::span<const float>(lhs_float), std::span<const float>(rhs_float), lhs.width(), lhs.height(), lhs.channels());
+	}
+}
+
+template <class T>
+std::vector<std::array<std::uint64_t, 256>> histogram(const image_t<T>& image) {
+	static_assert(std::is_same_v<typename attribute_properties<T>::value_type, std::uint8_t>, "Histograms need 8 bit channels.");
+	std::vector<std::uint64_t> bins(image.channels()*256);
+	analysis::histogram(detail::channels_of(image), image.channels(), bins);
+	std::vector<std::array<std::uint64_t, 256>> result(image.channels());
+	for(size_t c = 0; c < result.size(); ++c) {
+		std::copy_n(bins.begin()+c*256, 256, result[c].begin());
+	}
+	return result;
+}
+
+template <class T>
+void flip_vertical(image_t<T>& image) {
+	analysis::flip_vertical(std::as_writable_bytes(std::span(image.data(), image.size())), image.width()*sizeof(T));
+}
+
+}
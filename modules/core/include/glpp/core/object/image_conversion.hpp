@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace glpp::core::object {
+
+enum class simd_level_t {
+	scalar,
+	sse2,
+	avx2,
+	neon
+};
+
+/*
+ * Conversion kernels between pixel formats. Every kernel is selected at runtime by the instruction
+ * set of the CPU and large inputs are split across threads. Integer results are rounded to nearest.
+ */
+namespace conversion {
+
+	// Instruction set used by the kernels, the best supported one by default.
+	simd_level_t simd_level();
+	bool simd_supported(simd_level_t level);
+	void set_simd_level(simd_level_t level);
+
+	// Normalized channel conversions, all spans need to have the same size.
+	void convert(std::span<const std::uint8_t> src, std::span<float> dst);
+	void convert(std::span<const float> src, std::span<std::uint8_t> dst);
+	void convert(std::span<const std::uint8_t> src, std::span<std::uint16_t> dst);
+	void convert(std::span<const std::uint16_t> src, std::span<std::uint8_t> dst);
+
+	// IEEE 754 half precision floats stored as their bit pattern.
+	void float_to_half(std::span<const float> src, std::span<std::uint16_t> dst);
+	void half_to_float(std::span<const std::uint16_t> src, std::span<float> dst);
+
+	void rgb_to_rgba(std::span<const std::uint8_t> rgb, std::span<std::uint8_t> rgba, std::uint8_t alpha = 255);
+	void rgba_to_rgb(std::span<const std::uint8_t> rgba, std::span<std::uint8_t> rgb);
+
+	// dst[i] = src[order[i]] for every channel i of each rgba pixel, e.g. { 2, 1, 0, 3 } for bgra.
+	void swizzle(std::span<const std::uint8_t> rgba, std::span<std::uint8_t> dst, std::array<std::uint8_t, 4> order);
+
+	// The alpha channel of images with 2 or 4 channels is converted linearly.
+	void srgb_to_linear(std::span<const std::uint8_t> src, std::span<float> dst, size_t channels);
+	void linear_to_srgb(std::span<const float> src, std::span<std::uint8_t> dst, size_t channels);
+
+	void premultiply_alpha(std::span<std::uint8_t> rgba);
+	void unpremultiply_alpha(std::span<std::uint8_t> rgba);
+
+	// Resampling kernels for single rows, which are not split across threads. accumulate adds
+	// weight*src[i] to dst[i]. filter_rgba sets each rgba pixel x of dst to the sum of weight[k] times
+	// pixel index[k] of src for k in [offset[x], offset[x+1]), all indices need to be inside src.
+	void accumulate(std::span<const float> src, std::span<float> dst, float weight);
+	void filter_rgba(
+		std::span<const float> src,
+		std::span<float> dst,
+		std::span<const size_t> offset,
+		std::span<const size_t> index,
+		std::span<const float> weight
+	);
+
+}
+
+}
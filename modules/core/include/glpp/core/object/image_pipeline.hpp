@@ -0,0 +1,222 @@
+#pragma once
+
+#include "glpp/gl.hpp"
+#include "glpp/core/object.hpp"
+#include "glpp/core/object/image.hpp"
+#include "glpp/core/object/readback.hpp"
+#include "glpp/core/object/shader.hpp"
+#include "glpp/core/object/texture.hpp"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace glpp::core::object {
+
+enum class color_conversion_t {
+	srgb_to_linear,
+	linear_to_srgb,
+	// Rec. 709 luma in the color channels, alpha is kept.
+	grayscale
+};
+
+/*
+ * Chain of image operations, which is executed on the GPU by a gpu_image_processor_t. A pipeline only
+ * describes the work and can be submitted any number of times.
+ */
+class image_pipeline_t {
+public:
+	image_pipeline_t& resample(size_t width, size_t height, mip_filter_t filter = mip_filter_t::bilinear);
+	image_pipeline_t& convert(color_conversion_t conversion);
+	image_pipeline_t& blur(float sigma);
+	// Unsharp mask, adds amount times the difference to a blurred copy.
+	image_pipeline_t& sharpen(float amount, float sigma = 1.0f);
+	// Needs to be the last operation, jobs of the pipeline read back the whole mip chain.
+	image_pipeline_t& generate_mipmaps();
+
+	size_t size() const;
+	bool empty() const;
+
+private:
+	friend class gpu_image_processor_t;
+
+	enum class kind_t {
+		resample,
+		convert,
+		blur,
+		sharpen,
+		mipmaps
+	};
+
+	struct operation_t {
+		kind_t kind;
+		size_t width = 0;
+		size_t height = 0;
+		mip_filter_t filter = mip_filter_t::bilinear;
+		color_conversion_t conversion = color_conversion_t::srgb_to_linear;
+		float sigma = 0.0f;
+		float amount = 0.0f;
+	};
+
+	image_pipeline_t& add(operation_t operation);
+
+	std::vector<operation_t> m_operations;
+};
+
+namespace detail {
+
+	// Mip levels of a finished job, which are stored one after another in a readback buffer.
+	class image_readback_t : public readback_buffer_t {
+	public:
+		struct level_t {
+			size_t width;
+			size_t height;
+			size_t offset;
+		};
+
+		image_readback_t(std::vector<level_t> levels, size_t size);
+
+		// Waits for the GPU and copies the first count levels to the memory returned by functor(level).
+		template <class Functor>
+		void read(size_t count, Functor&& functor) const;
+
+		const std::vector<level_t>& levels() const;
+
+	private:
+		std::vector<level_t> m_levels;
+	};
+
+}
+
+template <class T>
+class image_job_t {
+public:
+	// True once the GPU has finished the job, the pixels can be read without waiting.
+	bool ready() const;
+	void wait() const;
+
+	image_t<T> get() const;
+	// All levels of a pipeline ending with generate_mipmaps(), otherwise just the image.
+	std::vector<image_t<T>> mip_chain() const;
+
+private:
+	friend class gpu_image_processor_t;
+	explicit image_job_t(std::shared_ptr<const detail::image_readback_t> readback);
+
+	std::shared_ptr<const detail::image_readback_t> m_readback;
+};
+
+/*
+ * Executes image pipelines with compute shaders. Images are processed in RGBA 32 bit float textures,
+ * which are pooled by size and reused by later jobs. Submitting only records GL commands, the result is
+ * read back through a pixel pack buffer once a job is ready. Requires OpenGL 4.3 and works headless,
+ * e.g. in a windowless_context_t on llvmpipe.
+ */
+class gpu_image_processor_t {
+public:
+	gpu_image_processor_t();
+
+	gpu_image_processor_t(const gpu_image_processor_t& cpy) = delete;
+	gpu_image_processor_t& operator=(const gpu_image_processor_t& cpy) = delete;
+
+	template <class T>
+	image_job_t<T> submit(const image_t<T>& image, const image_pipeline_t& pipeline);
+
+	size_t pooled_textures() const;
+	void clear_pool();
+
+private:
+	struct pooled_texture_t {
+		size_t width;
+		size_t height;
+		bool mipmaps;
+		texture_t texture;
+	};
+
+	std::shared_ptr<const detail::image_readback_t> run(
+		pooled_texture_t source,
+		const image_pipeline_t& pipeline,
+		GLenum format,
+		GLenum type,
+		size_t pixel_size
+	);
+
+	pooled_texture_t acquire(size_t width, size_t height, bool mipmaps = false);
+	void release(pooled_texture_t texture);
+
+	pooled_texture_t filter(const pooled_texture_t& source, size_t width, size_t height, mip_filter_t filter);
+	pooled_texture_t blur(const pooled_texture_t& source, float sigma);
+	void filter_pass(const pooled_texture_t& source, const pooled_texture_t& destination, bool horizontal, int kernel, float support, float sigma);
+	void dispatch(const pooled_texture_t& destination);
+
+	std::vector<pooled_texture_t> m_pool;
+	shader_program_t m_filter;
+	shader_program_t m_convert;
+	shader_program_t m_sharpen;
+};
+
+/*
+ * Implementation
+ */
+
+template <class Functor>
+void detail::image_readback_t::read(size_t count, Functor&& functor) const {
+	readback_buffer_t::read([&](const std::byte* data) {
+		for(size_t level = 0; level < std::min(count, m_levels.size()); ++level) {
+			const auto& region = m_levels[level];
+			const auto size = (level+1 < m_levels.size() ? m_levels[level+1].offset : this->size())-region.offset;
+			std::memcpy(functor(level), data+region.offset, size);
+		}
+	});
+}
+
+template <class T>
+image_job_t<T>::image_job_t(std::shared_ptr<const detail::image_readback_t> readback) :
+	m_readback(std::move(readback))
+{}
+
+template <class T>
+bool image_job_t<T>::ready() const {
+	return m_readback->ready();
+}
+
+template <class T>
+void image_job_t<T>::wait() const {
+	m_readback->wait();
+}
+
+template <class T>
+image_t<T> image_job_t<T>::get() const {
+	const auto& level = m_readback->levels().front();
+	image_t<T> result(level.width, level.height);
+	m_readback->read(1, [&](size_t) {
+		return result.data();
+	});
+	return result;
+}
+
+template <class T>
+std::vector<image_t<T>> image_job_t<T>::mip_chain() const {
+	std::vector<image_t<T>> result;
+	result.reserve(m_readback->levels().size());
+	for(const auto& level : m_readback->levels()) {
+		result.emplace_back(level.width, level.height);
+	}
+	m_readback->read(result.size(), [&](size_t index) {
+		return result[index].data();
+	});
+	return result;
+}
+
+template <class T>
+image_job_t<T> gpu_image_processor_t::submit(const image_t<T>& image, const image_pipeline_t& pipeline) {
+	if(image.width() == 0 || image.height() == 0) {
+		throw std::runtime_error("Empty images can not be processed.");
+	}
+	auto source = acquire(image.width(), image.height());
+	const auto format = detail::pixel_format(image.channels());
+	source.texture.update(image.view(), 0, 0, static_cast<image_format_t>(format));
+	return image_job_t<T>(run(std::move(source), pipeline, format, image.type(), sizeof(T)));
+}
+
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace glpp::core::object {
+
+template <class T>
+class image_t;
+
+/*
+ * Non-owning view of pixels in memory, e.g. an image_t, a mapped file or a buffer of another library.
+ * Rows are row_stride bytes apart, so a view can describe a region of a larger image without copying.
+ */
+template <class T>
+class image_view_t {
+public:
+	using value_type = T;
+
+	constexpr image_view_t() noexcept = default;
+	constexpr image_view_t(T* data, size_t width, size_t height) noexcept;
+	constexpr image_view_t(T* data, size_t width, size_t height, size_t row_stride) noexcept;
+
+	template <class U, std::enable_if_t<std::is_same_v<const U, T>, int> = 0>
+	constexpr image_view_t(const image_view_t<U>& view) noexcept;
+
+	template <class U, std::enable_if_t<std::is_same_v<const U, T>, int> = 0>
+	constexpr image_view_t(const image_t<U>& image) noexcept;
+
+	template <class U, std::enable_if_t<std::is_same_v<std::remove_const_t<T>, U>, int> = 0>
+	constexpr image_view_t(image_t<U>& image) noexcept;
+
+	constexpr T* data() const noexcept;
+	constexpr size_t width() const noexcept;
+	constexpr size_t height() const noexcept;
+	constexpr size_t row_stride() const noexcept;
+	constexpr size_t size() const noexcept;
+	constexpr bool empty() const noexcept;
+	constexpr bool contiguous() const noexcept;
+
+	T* row(size_t y) const noexcept;
+	T& get(size_t x, size_t y) const noexcept;
+	T& at(size_t x, size_t y) const;
+
+	image_view_t subview(size_t x, size_t y, size_t width, size_t height) const;
+
+private:
+	T* m_data = nullptr;
+	size_t m_width = 0;
+	size_t m_height = 0;
+	size_t m_row_stride = 0;
+};
+
+/*
+ * Implementation
+ */
+
+template <class T>
+constexpr image_view_t<T>::image_view_t(T* data, size_t width, size_t height) noexcept :
+	image_view_t(data, width, height, width*sizeof(T))
+{}
+
+template <class T>
+constexpr image_view_t<T>::image_view_t(T* data, size_t width, size_t height, size_t row_stride) noexcept :
+	m_data(data),
+	m_width(width),
+	m_height(height),
+	m_row_stride(row_stride)
+{}
+
+template <class T>
+template <class U, std::enable_if_t<std::is_same_v<const U, T>, int>>
+constexpr image_view_t<T>::image_view_t(const image_view_t<U>& view) noexcept :
+	image_view_t(view.data(), view.width(), view.height(), view.row_stride())
+{}
+
+template <class T>
+template <class U, std::enable_if_t<std::is_same_v<const U, T>, int>>
+constexpr image_view_t<T>::image_view_t(const image_t<U>& image) noexcept :
+	image_view_t(image.data(), image.width(), image.height())
+{}
+
+template <class T>
+template <class U, std::enable_if_t<std::is_same_v<std::remove_const_t<T>, U>, int>>
+constexpr image_view_t<T>::image_view_t(image_t<U>& image) noexcept :
+	image_view_t(image.data(), image.width(), image.height())
+{}
+
+template <class T>
+constexpr T* image_view_t<T>::data() const noexcept {
+	return m_data;
+}
+
+template <class T>
+constexpr size_t image_view_t<T>::width() const noexcept {
+	return m_width;
+}
+
+template <class T>
+constexpr size_t image_view_t<T>::height() const noexcept {
+	return m_height;
+}
+
+template <class T>
+constexpr size_t image_view_t<T>::row_stride() const noexcept {
+	return m_row_stride;
+}
+
+template <class T>
+constexpr size_t image_view_t<T>::size() const noexcept {
+	return m_width*m_height;
+}
+
+template <class T>
+constexpr bool image_view_t<T>::empty() const noexcept {
+	return m_width == 0 || m_height == 0;
+}
+
+template <class T>
+constexpr bool image_view_t<T>::contiguous() const noexcept {
+	return m_row_stride == m_width*sizeof(T) || m_height <= 1;
+}
+
+template <class T>
+T* image_view_t<T>::row(size_t y) const noexcept {
+	using byte_t = std::conditional_t<std::is_const_v<T>, const std::byte, std::byte>;
+	return reinterpret_cast<T*>(reinterpret_cast<byte_t*>(m_data)+y*m_row_stride);
+}
+
+template <class T>
+T& image_view_t<T>::get(size_t x, size_t y) const noexcept {
+	return row(y)[x];
+}
+
+template <class T>
+T& image_view_t<T>::at(size_t x, size_t y) const {
+	if(x >= m_width || y >= m_height) {
+		throw std::out_of_range("Pixel "+std::to_string(x)+", "+std::to_string(y)+" is outside of the image view.");
+	}
+	return get(x, y);
+}
+
+template <class T>
+image_view_t<T> image_view_t<T>::subview(size_t x, size_t y, size_t width, size_t height) const {
+	if(x+width > m_width || y+height > m_height) {
+		throw std::runtime_error(
+			"Region "+std::to_string(width)+"x"+std::to_string(height)+" at "+std::to_string(x)+", "+std::to_string(y)+
+			" is outside of the "+std::to_string(m_width)+"x"+std::to_string(m_height)+" image view."
+		);
+	}
+	return image_view_t(row(y)+x, width, height, m_row_stride);
+}
+
+}
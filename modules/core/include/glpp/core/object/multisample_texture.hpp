@@ -0,0 +1,45 @@
+#pragma once
+
+#include "glpp/core/object/texture.hpp"
+
+namespace glpp::core::object {
+
+// Texture with several samples per pixel, e.g. as antialiased render target. Shaders read single
+// samples with texelFetch from a sampler2DMS, blit it into a texture_t to filter it.
+class multisample_texture_t : public object_t<> {
+public:
+
+	multisample_texture_t(multisample_texture_t&& mov) = default;
+	multisample_texture_t& operator=(multisample_texture_t&& mov) = default;
+
+	multisample_texture_t(const multisample_texture_t& cpy) = delete;
+	multisample_texture_t& operator=(const multisample_texture_t& cpy) = delete;
+
+	multisample_texture_t(
+		const size_t width,
+		const size_t height,
+		const size_t samples,
+		image_format_t format = image_format_t::rgba_8,
+		bool fixed_sample_locations = true
+	);
+
+	texture_slot_t bind_to_texture_slot() const;
+
+	size_t width() const;
+	size_t height() const;
+	size_t samples() const;
+	image_format_t format() const;
+
+	// Largest sample count of color formats, depth formats may support fewer.
+	static size_t max_samples();
+
+private:
+	static GLuint init();
+	static void destroy(GLuint id);
+	size_t m_width;
+	size_t m_height;
+	size_t m_samples;
+	GLenum m_format;
+};
+
+}
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "glpp/gl.hpp"
+#include "glpp/core/object.hpp"
+#include "glpp/core/object/fence.hpp"
+#include "glpp/core/object/image.hpp"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace glpp::core::object {
+
+namespace detail {
+
+	// Buffer written by GPU copies, which is mapped once the fence behind the copies has been signaled.
+	class readback_buffer_t : public object_t<> {
+	public:
+		explicit readback_buffer_t(size_t size);
+
+		bool ready() const;
+		bool wait(std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max()) const;
+
+		// Waits for the GPU and calls functor with the contents of the buffer.
+		template <class Functor>
+		void read(Functor&& functor) const;
+
+		size_t size() const;
+		size_t capacity() const;
+		// Prepares the buffer for the next copy of at most capacity() bytes.
+		void reuse(size_t size);
+		// Marks the end of the commands writing the buffer.
+		void finish();
+
+	private:
+		const std::byte* map() const;
+		void unmap() const;
+		static GLuint init();
+		static void destroy(GLuint id);
+
+		size_t m_size;
+		size_t m_capacity;
+		std::unique_ptr<fence_t> m_fence;
+	};
+
+	// Staging buffers of the async reads of one object. A buffer is reused for the next read once all
+	// handles of its readback are gone, so reading every frame does not create a buffer every frame.
+	class readback_pool_t {
+	public:
+		static constexpr size_t max_buffers = 3;
+
+		readback_pool_t() = default;
+		readback_pool_t(readback_pool_t&& mov) noexcept = default;
+		readback_pool_t& operator=(readback_pool_t&& mov) noexcept = default;
+
+		readback_pool_t(const readback_pool_t& cpy) = delete;
+		readback_pool_t& operator=(const readback_pool_t& cpy) = delete;
+
+		// A free buffer of at least size bytes, or a new one if all max_buffers are in use.
+		std::shared_ptr<readback_buffer_t> acquire(size_t size);
+
+		size_t size() const;
+
+	private:
+		std::vector<std::shared_ptr<readback_buffer_t>> m_buffers;
+	};
+
+	constexpr GLenum pixel_format(size_t channels, bool integer = false) {
+		switch(channels) {
+			case 1: return integer ? GL_RED_INTEGER : GL_RED;
+			case 2: return integer ? GL_RG_INTEGER : GL_RG;
+			case 3: return integer ? GL_RGB_INTEGER : GL_RGB;
+			default: return integer ? GL_RGBA_INTEGER : GL_RGBA;
+		}
+	}
+
+	// Records the glReadPixels or glGetTextureImage calls of functor into buffer with tightly packed rows.
+	template <class Functor>
+	void pack_pixels(readback_buffer_t& buffer, Functor&& functor);
+
+}
+
+/*
+ * Handle of pixels, which are copied by the GPU into a buffer. The copy is queued without waiting,
+ * get() only blocks if the GPU has not reached it yet. Poll ready() a frame or two later to never stall.
+ */
+template <class T>
+class pixel_readback_t {
+public:
+	pixel_readback_t(std::shared_ptr<const detail::readback_buffer_t> buffer, size_t width, size_t height);
+
+	bool ready() const;
+	bool wait(std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max()) const;
+
+	image_t<T> get() const;
+
+	size_t width() const;
+	size_t height() const;
+
+private:
+	std::shared_ptr<const detail::readback_buffer_t> m_buffer;
+	size_t m_width;
+	size_t m_height;
+};
+
+// Like pixel_readback_t for the contents of a buffer_t.
+template <class T>
+class buffer_readback_t {
+public:
+	buffer_readback_t(std::shared_ptr<const detail::readback_buffer_t> buffer, size_t size);
+
+	bool ready() const;
+	bool wait(std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max()) const;
+
+	std::vector<T> get() const;
+
+	size_t size() const;
+
+private:
+	std::shared_ptr<const detail::readback_buffer_t> m_buffer;
+	size_t m_size;
+};
+
+/*
+ * Implementation
+ */
+
+template <class Functor>
+void detail::readback_buffer_t::read(Functor&& functor) const {
+	wait();
+	const auto* data = map();
+	try {
+		functor(data);
+	} catch(...) {
+		unmap();
+		throw;
+	}
+	unmap();
+}
+
+template <class Functor>
+void detail::pack_pixels(readback_buffer_t& buffer, Functor&& functor) {
+	// The pack state of the caller is restored, also if the debug callback throws.
+	GLint alignment;
+	glGetIntegerv(GL_PACK_ALIGNMENT, &alignment);
+	const auto restore = [alignment]() {
+		glPixelStorei(GL_PACK_ALIGNMENT, alignment);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	};
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.id());
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	try {
+		functor();
+	} catch(...) {
+		restore();
+		throw;
+	}
+	restore();
+	buffer.finish();
+}
+
+template <class T>
+pixel_readback_t<T>::pixel_readback_t(std::shared_ptr<const detail::readback_buffer_t> buffer, size_t width, size_t height) :
+	m_buffer(std::move(buffer)),
+	m_width(width),
+	m_height(height)
+{}
+
+template <class T>
+bool pixel_readback_t<T>::ready() const {
+	return m_buffer->ready();
+}
+
+template <class T>
+bool pixel_readback_t<T>::wait(std::chrono::nanoseconds timeout) const {
+	return m_buffer->wait(timeout);
+}
+
+template <class T>
+image_t<T> pixel_readback_t<T>::get() const {
+	image_t<T> result(m_width, m_height);
+	m_buffer->read([&](const std::byte* data) {
+		std::copy_n(data, result.size()*sizeof(T), reinterpret_cast<std::byte*>(result.data()));
+	});
+	return result;
+}
+
+template <class T>
+size_t pixel_readback_t<T>::width() const {
+	return m_width;
+}
+
+template <class T>
+size_t pixel_readback_t<T>::height() const {
+	return m_height;
+}
+
+template <class T>
+buffer_readback_t<T>::buffer_readback_t(std::shared_ptr<const detail::readback_buffer_t> buffer, size_t size) :
+	m_buffer(std::move(buffer)),
+	m_size(size)
+{}
+
+template <class T>
+bool buffer_readback_t<T>::ready() const {
+	return m_buffer->ready();
+}
+
+template <class T>
+bool buffer_readback_t<T>::wait(std::chrono::nanoseconds timeout) const {
+	return m_buffer->wait(timeout);
+}
+
+template <class T>
+std::vector<T> buffer_readback_t<T>::get() const {
+	std::vector<T> result(m_size/sizeof(T));
+	m_buffer->read([&](const std::byte* data) {
+		std::copy_n(data, result.size()*sizeof(T), reinterpret_cast<std::byte*>(result.data()));
+	});
+	return result;
+}
+
+template <class T>
+size_t buffer_readback_t<T>::size() const {
+	return m_size;
+}
+
+}
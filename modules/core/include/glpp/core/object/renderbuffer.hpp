@@ -0,0 +1,44 @@
+#pragma once
+
+#include "glpp/gl.hpp"
+#include "glpp/core/object.hpp"
+#include "glpp/core/object/image.hpp"
+
+namespace glpp::core::object {
+
+// Storage for framebuffer attachments, which are rendered to but never sampled, e.g. depth and
+// stencil buffers. Drivers may store them in formats that are not usable as textures.
+class renderbuffer_t : public object_t<> {
+public:
+
+	renderbuffer_t(renderbuffer_t&& mov) = default;
+	renderbuffer_t& operator=(renderbuffer_t&& mov) = default;
+
+	renderbuffer_t(const renderbuffer_t& cpy) = delete;
+	renderbuffer_t& operator=(const renderbuffer_t& cpy) = delete;
+
+	// Zero samples creates a single sampled buffer.
+	renderbuffer_t(
+		const size_t width,
+		const size_t height,
+		image_format_t format = image_format_t::d_24i_s_8i,
+		const size_t samples = 0
+	);
+
+	size_t width() const;
+	size_t height() const;
+	size_t samples() const;
+	image_format_t format() const;
+
+	static size_t max_samples();
+
+private:
+	static GLuint init();
+	static void destroy(GLuint id);
+	size_t m_width;
+	size_t m_height;
+	size_t m_samples;
+	GLenum m_format;
+};
+
+}
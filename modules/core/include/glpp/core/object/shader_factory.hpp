@@ -27,9 +27,9 @@ public:
 	
 	shader_factory_t& set(std::string_view key, const char* value);
 
-	std::string code() const ;
-	
-	
+	const std::string& code() const &;
+	std::string code() &&;
+
 private:
 	std::string m_code;
 };
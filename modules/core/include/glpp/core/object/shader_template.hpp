@@ -0,0 +1,227 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace glpp::core::object {
+
+namespace detail {
+
+template <class T>
+std::string to_glsl(const T& value);
+
+constexpr bool is_placeholder_char(char c) {
+	return
+		(c >= 'a' && c <= 'z') ||
+		(c >= 'A' && c <= 'Z') ||
+		(c >= '0' && c <= '9') ||
+		c == '_';
+}
+
+// Returns the length of the placeholder starting at pos, including the angle brackets or 0 if
+// there is none. Placeholders have the form <identifier>, which can not collide with the GLSL
+// comparison operators, since those are never directly followed by an identifier and a '>'.
+constexpr std::size_t placeholder_length(std::string_view code, std::size_t pos) {
+	if(code[pos] != '<') return 0;
+	auto end = pos+1;
+	while(end < code.size() && is_placeholder_char(code[end])) {
+		++end;
+	}
+	if(end == pos+1 || end == code.size() || code[end] != '>') return 0;
+	return end-pos+1;
+}
+
+template <class Callback>
+constexpr void parse_shader_template(std::string_view code, Callback&& emit) {
+	std::size_t text_begin = 0;
+	for(std::size_t pos = 0; pos < code.size();) {
+		const auto length = placeholder_length(code, pos);
+		if(length == 0) {
+			++pos;
+			continue;
+		}
+		if(pos != text_begin) emit(text_begin, pos-text_begin, false);
+		emit(pos, length, true);
+		pos += length;
+		text_begin = pos;
+	}
+	if(text_begin != code.size()) emit(text_begin, code.size()-text_begin, false);
+}
+
+}
+
+constexpr std::size_t count_shader_template_segments(std::string_view code) {
+	std::size_t count = 0;
+	detail::parse_shader_template(code, [&count](std::size_t, std::size_t, bool){ ++count; });
+	return count;
+}
+
+struct shader_template_segment_t {
+	std::size_t offset;
+	std::size_t length;
+	bool placeholder;
+};
+
+class shader_bindings_t {
+public:
+
+	shader_bindings_t() = default;
+
+	template <class T>
+	shader_bindings_t& set(std::string_view key, const T& value);
+	shader_bindings_t& set(std::string_view key, std::string value);
+	shader_bindings_t& set(std::string_view key, const char* value);
+
+	const std::string* find(std::string_view key) const;
+	bool contains(std::string_view key) const;
+	std::size_t size() const;
+	std::vector<std::string_view> keys() const;
+
+private:
+	std::vector<std::pair<std::string, std::string>> m_values;
+};
+
+template <std::size_t Segments = std::dynamic_extent>
+class shader_template_t {
+public:
+	static constexpr bool is_dynamic = Segments == std::dynamic_extent;
+	using code_storage_t = std::conditional_t<is_dynamic, std::string, std::string_view>;
+	using segment_storage_t = std::conditional_t<
+		is_dynamic,
+		std::vector<shader_template_segment_t>,
+		std::array<shader_template_segment_t, Segments>
+	>;
+
+	constexpr explicit shader_template_t(code_storage_t code);
+
+	constexpr shader_template_t(const shader_template_t& cpy) = default;
+	constexpr shader_template_t(shader_template_t&& mov) noexcept = default;
+
+	constexpr shader_template_t& operator=(const shader_template_t& cpy) = default;
+	constexpr shader_template_t& operator=(shader_template_t&& mov) noexcept = default;
+
+	std::string render(const shader_bindings_t& bindings) const;
+	void render(const shader_bindings_t& bindings, std::string& output) const;
+
+	std::vector<std::string_view> placeholders() const;
+	std::vector<std::string_view> unbound(const shader_bindings_t& bindings) const;
+	std::vector<std::string_view> unused(const shader_bindings_t& bindings) const;
+
+	constexpr std::span<const shader_template_segment_t> segments() const;
+	constexpr std::string_view text(const shader_template_segment_t& segment) const;
+	constexpr std::string_view code() const;
+
+private:
+	code_storage_t m_code;
+	segment_storage_t m_segments {};
+};
+
+shader_template_t(std::string) -> shader_template_t<>;
+shader_template_t(const char*) -> shader_template_t<>;
+
+namespace detail {
+	void render_shader_template(
+		std::string_view code,
+		std::span<const shader_template_segment_t> segments,
+		const shader_bindings_t& bindings,
+		std::string& output
+	);
+	std::vector<std::string_view> shader_template_placeholders(
+		std::string_view code,
+		std::span<const shader_template_segment_t> segments
+	);
+}
+
+/*
+ * Implementation
+ */
+
+template <class T>
+shader_bindings_t& shader_bindings_t::set(std::string_view key, const T& value) {
+	return set(key, detail::to_glsl(value));
+}
+
+template <std::size_t Segments>
+constexpr shader_template_t<Segments>::shader_template_t(code_storage_t code) :
+	m_code(std::move(code))
+{
+	const std::string_view view = m_code;
+	if constexpr(is_dynamic) {
+		m_segments.reserve(count_shader_template_segments(view));
+	}
+	std::size_t index = 0;
+	detail::parse_shader_template(view, [&](std::size_t offset, std::size_t length, bool placeholder) {
+		if constexpr(is_dynamic) {
+			m_segments.push_back({ offset, length, placeholder });
+		} else {
+			if(index >= Segments) {
+				throw std::runtime_error("shader_template_t has fewer segments than the code template.");
+			}
+			m_segments[index] = { offset, length, placeholder };
+		}
+		++index;
+	});
+	if(index != m_segments.size()) {
+		throw std::runtime_error("shader_template_t has more segments than the code template.");
+	}
+}
+
+template <std::size_t Segments>
+std::string shader_template_t<Segments>::render(const shader_bindings_t& bindings) const {
+	std::string result;
+	render(bindings, result);
+	return result;
+}
+
+template <std::size_t Segments>
+void shader_template_t<Segments>::render(const shader_bindings_t& bindings, std::string& output) const {
+	detail::render_shader_template(code(), segments(), bindings, output);
+}
+
+template <std::size_t Segments>
+std::vector<std::string_view> shader_template_t<Segments>::placeholders() const {
+	return detail::shader_template_placeholders(code(), segments());
+}
+
+template <std::size_t Segments>
+std::vector<std::string_view> shader_template_t<Segments>::unbound(const shader_bindings_t& bindings) const {
+	auto result = placeholders();
+	std::erase_if(result, [&](std::string_view key){ return bindings.contains(key); });
+	return result;
+}
+
+template <std::size_t Segments>
+std::vector<std::string_view> shader_template_t<Segments>::unused(const shader_bindings_t& bindings) const {
+	const auto used = placeholders();
+	auto result = bindings.keys();
+	std::erase_if(result, [&](std::string_view key){
+		return std::find(used.begin(), used.end(), key) != used.end();
+	});
+	return result;
+}
+
+template <std::size_t Segments>
+constexpr std::span<const shader_template_segment_t> shader_template_t<Segments>::segments() const {
+	return { m_segments.data(), m_segments.size() };
+}
+
+template <std::size_t Segments>
+constexpr std::string_view shader_template_t<Segments>::text(const shader_template_segment_t& segment) const {
+	return code().substr(segment.offset, segment.length);
+}
+
+template <std::size_t Segments>
+constexpr std::string_view shader_template_t<Segments>::code() const {
+	return m_code;
+}
+
+extern template class shader_template_t<>;
+
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "glpp/core/object/framebuffer.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace glpp::core::object {
+
+/*
+ * Layout of the shared memory written by a shared_frame_sink_t, the header is followed by the
+ * slots at data_offset. Frames are tightly packed RGBA rows, bottom row first like pixel_read.
+ */
+struct shared_frame_slot_t {
+	// Zero while the slot is written.
+	std::atomic<std::uint64_t> sequence;
+	// CLOCK_MONOTONIC nanoseconds of the publication, comparable across processes.
+	std::atomic<std::uint64_t> timestamp;
+};
+
+struct shared_frame_header_t {
+	static constexpr std::uint32_t magic_value = 0x46505047; // "GPPF"
+	static constexpr std::uint32_t version_value = 2;
+	static constexpr size_t max_slots = 16;
+	static constexpr size_t max_consumers = 32;
+	static constexpr size_t slot_bits = 8;
+
+	std::uint32_t magic;
+	std::uint32_t version;
+	std::uint32_t width;
+	std::uint32_t height;
+	std::uint32_t pixel_size;
+	std::uint32_t slots;
+	std::uint64_t slot_stride;
+	std::uint64_t data_offset;
+	// Sequence of the newest frame shifted by slot_bits, or-ed with its slot. Zero before the first frame.
+	std::atomic<std::uint64_t> latest;
+	shared_frame_slot_t slot[max_slots];
+	// Slots read by each consumer, one bit per slot. The producer never writes a slot with readers and
+	// clears the bits of disconnected consumers, so a crashed consumer does not block its slots.
+	std::atomic<std::uint32_t> reading[max_consumers];
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free && std::atomic<std::uint32_t>::is_always_lock_free);
+static_assert(shared_frame_header_t::max_slots <= 32, "Slots are tracked in 32 bit masks.");
+
+/*
+ * Publishes frames to other local processes through a memfd ring of frame slots. Consumers connect
+ * to a unix socket and receive the memfd and an eventfd, which is signaled for every frame. They read
+ * the newest frame in place, the producer skips slots which are being read and drops the frame if no
+ * slot is free. Consumers are accepted by accept() and publish(). Only available on Linux.
+ */
+class shared_frame_sink_t {
+public:
+	static constexpr size_t default_slots = 4;
+	static constexpr size_t readback_depth = 3;
+
+	shared_frame_sink_t(std::string socket_path, size_t width, size_t height, size_t slots = default_slots);
+	~shared_frame_sink_t();
+
+	shared_frame_sink_t(const shared_frame_sink_t& cpy) = delete;
+	shared_frame_sink_t& operator=(const shared_frame_sink_t& cpy) = delete;
+
+	// Queues a copy of the framebuffer and publishes the copies the GPU has finished since the last call.
+	// For the default framebuffer call it before the buffers are swapped.
+	void capture(const framebuffer_t& framebuffer);
+	// Waits for all queued copies and publishes them.
+	void flush();
+	// Publishes pixels from client memory, e.g. of a software renderer. Returns false if the frame was dropped.
+	bool publish(std::span<const std::byte> pixels);
+	// Accepts connecting consumers and forgets disconnected ones, without publishing a frame. Waits up to
+	// timeout for a connection, if none is pending. Returns the number of connected consumers.
+	size_t accept(std::chrono::nanoseconds timeout = std::chrono::nanoseconds(0));
+
+	size_t consumers() const;
+	size_t published() const;
+	size_t dropped() const;
+	size_t frame_size() const;
+
+private:
+	struct consumer_t {
+		int socket;
+		int event;
+		// Index of the reading mask of the consumer in the header.
+		size_t index;
+	};
+
+	void update_consumers();
+	void notify_consumers();
+	void close();
+
+	std::string m_socket_path;
+	size_t m_frame_size;
+	size_t m_mapping_size = 0;
+	int m_memory = -1;
+	int m_listener = -1;
+	shared_frame_header_t* m_header = nullptr;
+	std::vector<consumer_t> m_consumers;
+	size_t m_last_slot = 0;
+	std::uint64_t m_sequence = 0;
+	size_t m_dropped = 0;
+	// Created by the first capture, so frames of software renderers can be published without a context.
+	std::optional<detail::frame_readback_ring_t> m_readbacks;
+};
+
+/*
+ * Reference consumer of a shared_frame_sink_t. Frames are read in place from the shared memory and
+ * stay valid until the frame_t is destroyed.
+ */
+class shared_frame_source_t {
+public:
+	class frame_t {
+	public:
+		frame_t(frame_t&& mov) noexcept;
+		frame_t& operator=(frame_t&& mov) noexcept;
+		~frame_t();
+
+		frame_t(const frame_t& cpy) = delete;
+		frame_t& operator=(const frame_t& cpy) = delete;
+
+		std::uint64_t sequence() const;
+		// Time between the publication and now.
+		std::chrono::nanoseconds age() const;
+		size_t width() const;
+		size_t height() const;
+		std::span<const std::byte> pixels() const;
+
+	private:
+		friend class shared_frame_source_t;
+		frame_t(shared_frame_header_t* header, size_t consumer, size_t slot);
+
+		const shared_frame_header_t* m_header;
+		const shared_frame_slot_t* m_slot;
+		// Reading mask of the consumer and the bit of the slot, null once moved from.
+		std::atomic<std::uint32_t>* m_reading;
+		std::uint32_t m_bit;
+		std::span<const std::byte> m_pixels;
+	};
+
+	static constexpr std::chrono::seconds default_timeout { 5 };
+
+	// Retries to connect until the producer listens and waits until it accepted the consumer, but
+	// at most timeout in total.
+	explicit shared_frame_source_t(const std::string& socket_path, std::chrono::nanoseconds timeout = default_timeout);
+	~shared_frame_source_t();
+
+	shared_frame_source_t(const shared_frame_source_t& cpy) = delete;
+	shared_frame_source_t& operator=(const shared_frame_source_t& cpy) = delete;
+
+	// Blocks until a frame has been published since the last call. Returns false on timeout.
+	bool wait(std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max());
+	// The newest frame, if it is newer than the last acquired one.
+	std::optional<frame_t> acquire();
+
+	size_t width() const;
+	size_t height() const;
+
+private:
+	void close();
+
+	int m_socket = -1;
+	int m_memory = -1;
+	int m_event = -1;
+	size_t m_mapping_size = 0;
+	shared_frame_header_t* m_header = nullptr;
+	size_t m_consumer = 0;
+	std::uint64_t m_last_sequence = 0;
+};
+
+}
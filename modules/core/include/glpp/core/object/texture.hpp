@@ -4,6 +4,8 @@
 #include "glpp/core/object.hpp"
 #include "glpp/core/object/attribute_properties.hpp"
 #include "glpp/core/object/image.hpp"
+#include "glpp/core/object/compressed_image.hpp"
+#include "glpp/core/object/readback.hpp"
 #include <vector>
 #include <type_traits>
 #include <iterator>
@@ -32,6 +34,7 @@ enum class mipmap_mode_t {
 };
 
 class texture_slot_t;
+class texture_unit_cache_t;
 
 enum class texture_channel_t : GLenum {
 	red = GL_RED,
@@ -73,6 +76,14 @@ public:
 		swizzle_mask_t swizzle_mask = {texture_channel_t::red, texture_channel_t::green, texture_channel_t::blue, texture_channel_t::alpha}
 	);
 
+	explicit texture_t(
+		const compressed_image_t& image,
+		const clamp_mode_t clamp_mode = clamp_mode_t::repeat,
+		const filter_mode_t filter = filter_mode_t::linear,
+		const mipmap_mode_t mipmap_mode = mipmap_mode_t::linear,
+		swizzle_mask_t swizzle_mask = {texture_channel_t::red, texture_channel_t::green, texture_channel_t::blue, texture_channel_t::alpha}
+	);
+
 	texture_slot_t bind_to_texture_slot() const;
 
 	template <class T>
@@ -94,6 +105,15 @@ public:
 	template <class T>
 	void update(const image_t<T>& image);
 
+	// Uploads the view directly from its memory, rows of a larger image are not copied.
+	template <class T>
+	void update(
+		image_view_t<T> view,
+		size_t xoffset = 0,
+		size_t yoffset = 0,
+		image_format_t format = image_format_t::preferred
+	);
+
 	template <class T>
 	void update(
 		const image_t<T>& image,
@@ -103,21 +123,93 @@ public:
 		size_t height
 	);
 
+	template <class T>
+	void update_level(
+		size_t level,
+		size_t xoffset,
+		size_t yoffset,
+		size_t width,
+		size_t height,
+		const T* pixels,
+		image_format_t format = image_format_t::preferred
+	);
+
+	template <class T>
+	void update_level(size_t level, const image_t<T>& image);
+
+	template <class T>
+	void update_level(
+		size_t level,
+		image_view_t<T> view,
+		size_t xoffset = 0,
+		size_t yoffset = 0,
+		image_format_t format = image_format_t::preferred
+	);
+
+	template <class T>
+	void update_mip_chain(const std::vector<image_t<T>>& mip_chain);
+
+	void update(const compressed_image_t& image);
+	void update_compressed_level(
+		size_t level,
+		size_t xoffset,
+		size_t yoffset,
+		size_t width,
+		size_t height,
+		std::span<const std::byte> data
+	);
+
+	void generate_mipmaps();
+
+	// Copies a region of level 0 of source into this texture. Both textures need compatible formats.
+	void copy(
+		const texture_t& source,
+		size_t source_x,
+		size_t source_y,
+		size_t xoffset,
+		size_t yoffset,
+		size_t width,
+		size_t height
+	);
+
+	// Copies a whole mip level of source into a level of the same size of this texture.
+	void copy_level(const texture_t& source, size_t source_level, size_t level);
+
+	// Queues a copy of a mip level into a buffer without waiting for the GPU. Depth textures are read as depth.
+	template <class T>
+	pixel_readback_t<T> async_read(size_t level = 0) const;
+
 	size_t width() const;
 	size_t height() const;
+	size_t levels() const;
+	image_format_t format() const;
 
 private:
+	texture_t(
+		const size_t width,
+		const size_t height,
+		image_format_t format,
+		const clamp_mode_t clamp_mode,
+		const filter_mode_t filter,
+		const mipmap_mode_t mipmap_mode,
+		swizzle_mask_t swizzle_mask,
+		size_t levels
+	);
+
 	static GLuint init();
 	static void destroy(GLuint id);
 	size_t m_width;
 	size_t m_height;
 	GLenum m_format;
+	size_t m_levels;
+	mutable detail::readback_pool_t m_readbacks;
 };
 
 class texture_slot_t {
 public:
 
 	texture_slot_t(const texture_t& texture);
+	texture_slot_t(const texture_t& texture, GLuint sampler);
 
 	texture_slot_t(texture_slot_t&& mov);
 	texture_slot_t& operator=(texture_slot_t&& mov);
@@ -132,9 +224,12 @@ public:
 	static int max_texture_units();
 
 private:
-	int next_free_id();
+	friend class texture_unit_cache_t;
 
-	static std::vector<int> units;
+	// Locks the unit in the cache for the lifetime of the slot.
+	texture_slot_t(texture_unit_cache_t& cache, GLuint unit);
+
+	texture_unit_cache_t* m_cache;
 	GLint m_id;
 };
 
@@ -155,6 +250,104 @@ constexpr auto resolve_format(image_format_t format, const image_t<T>& image) {
 	}
 	return format;
 }
+
+constexpr GLenum base_internal_format(GLenum format) {
+	switch(format) {
+		case GL_R8                 : return GL_RED;
+		case GL_R8_SNORM           : return GL_RED;
+		case GL_R16                : return GL_RED;
+		case GL_R16_SNORM          : return GL_RED;
+		case GL_RG8                : return GL_RG;
+		case GL_RG8_SNORM          : return GL_RG;
+		case GL_RG16               : return GL_RG;
+		case GL_RG16_SNORM         : return GL_RG;
+		case GL_R3_G3_B2           : return GL_RGB;
+		case GL_RGB4               : return GL_RGB;
+		case GL_RGB5               : return GL_RGB;
+		case GL_RGB8               : return GL_RGB;
+		case GL_RGB8_SNORM         : return GL_RGB;
+		case GL_RGB10              : return GL_RGB;
+		case GL_RGB12              : return GL_RGB;
+		case GL_RGB16_SNORM        : return GL_RGB;
+		case GL_RGBA2              : return GL_RGB;
+		case GL_RGBA4              : return GL_RGB;
+		case GL_RGB5_A1            : return GL_RGBA;
+		case GL_RGBA8              : return GL_RGBA;
+		case GL_RGBA8_SNORM        : return GL_RGBA;
+		case GL_RGB10_A2           : return GL_RGBA;
+		case GL_RGB10_A2UI         : return GL_RGBA;
+		case GL_RGBA12             : return GL_RGBA;
+		case GL_RGBA16             : return GL_RGBA;
+		case GL_SRGB8              : return GL_RGB;
+		case GL_SRGB8_ALPHA8       : return GL_RGBA;
+		case GL_R16F               : return GL_RED;
+		case GL_RG16F              : return GL_RG;
+		case GL_RGB16F             : return GL_RGB;
+		case GL_RGBA16F            : return GL_RGBA;
+		case GL_R32F               : return GL_RED;
+		case GL_RG32F              : return GL_RG;
+		case GL_RGB32F             : return GL_RGB;
+		case GL_RGBA32F            : return GL_RGBA;
+		case GL_R11F_G11F_B10F     : return GL_RGB;
+		case GL_RGB9_E5            : return GL_RGB;
+		case GL_R8I                : return GL_RED;
+		case GL_R8UI               : return GL_RED;
+		case GL_R16I               : return GL_RED;
+		case GL_R16UI              : return GL_RED;
+		case GL_R32I               : return GL_RED;
+		case GL_R32UI              : return GL_RED;
+		case GL_RG8I               : return GL_RG;
+		case GL_RG8UI              : return GL_RG;
+		case GL_RG16I              : return GL_RG;
+		case GL_RG16UI             : return GL_RG;
+		case GL_RG32I              : return GL_RG;
+		case GL_RG32UI             : return GL_RG;
+		case GL_RGB8I              : return GL_RGB;
+		case GL_RGB8UI             : return GL_RGB;
+		case GL_RGB16I             : return GL_RGB;
+		case GL_RGB16UI            : return GL_RGB;
+		case GL_RGB32I             : return GL_RGB;
+		case GL_RGB32UI            : return GL_RGB;
+		case GL_RGBA8I             : return GL_RGBA;
+		case GL_RGBA8UI            : return GL_RGBA;
+		case GL_RGBA16I            : return GL_RGBA;
+		case GL_RGBA16UI           : return GL_RGBA;
+		case GL_RGBA32I            : return GL_RGBA;
+		case GL_RGBA32UI           : return GL_RGBA;
+		case GL_DEPTH_COMPONENT24  : return GL_DEPTH_COMPONENT;
+		case GL_DEPTH_COMPONENT16  : return GL_DEPTH_COMPONENT;
+		case GL_DEPTH_COMPONENT32F : return GL_DEPTH_COMPONENT;
+		case GL_DEPTH32F_STENCIL8  : return GL_DEPTH_STENCIL;
+		case GL_DEPTH24_STENCIL8   : return GL_DEPTH_STENCIL;
+		case GL_STENCIL_INDEX8	   : return GL_STENCIL_INDEX;
+	}
+	throw std::runtime_error("Unable to convert sized internal format to base internal format.");
+}
+
+// Integer formats are transferred with the *_INTEGER pixel formats and are not normalized.
+constexpr bool is_integer_format(GLenum format) {
+	switch(format) {
+		case GL_R8I: case GL_R8UI: case GL_R16I: case GL_R16UI: case GL_R32I: case GL_R32UI:
+		case GL_RG8I: case GL_RG8UI: case GL_RG16I: case GL_RG16UI: case GL_RG32I: case GL_RG32UI:
+		case GL_RGB8I: case GL_RGB8UI: case GL_RGB16I: case GL_RGB16UI: case GL_RGB32I: case GL_RGB32UI:
+		case GL_RGBA8I: case GL_RGBA8UI: case GL_RGBA16I: case GL_RGBA16UI: case GL_RGBA32I: case GL_RGBA32UI:
+		case GL_RGB10_A2UI:
+			return true;
+	}
+	return false;
+}
+
+void set_texture_parameters(
+	GLuint texture,
+	clamp_mode_t clamp_mode,
+	filter_mode_t filter,
+	mipmap_mode_t mipmap_mode,
+	const swizzle_mask_t& swizzle_mask
+);
+
+// Sets the unpack row length and the largest fitting alignment for pixels with rows row_stride bytes apart.
+// Returns false, if the layout can not be described to OpenGL and the rows need to be uploaded one by one.
+bool set_unpack_layout(const void* pixels, size_t width, size_t height, size_t row_stride, size_t pixel_size);
 }
 
 template <class T>
@@ -169,10 +362,7 @@ texture_t::texture_t(
 	texture_t(image.width(), image.height(), detail::resolve_format(format, image), clamp_mode, filter, mipmap_mode, swizzle_mask)
 {
 	update(image);
-
-	if(mipmap_mode != mipmap_mode_t::none) {
-		glGenerateTextureMipmap(id());
-	}
+	generate_mipmaps();
 }
 
 template <class T>
@@ -192,92 +382,73 @@ void texture_t::update(
 	const T* pixels,
 	image_format_t format
 ) {
-	auto base_internal_format = [](GLenum format) {
-		switch(format) {
-			case GL_R8                 : return GL_RED;
-			case GL_R8_SNORM           : return GL_RED;
-			case GL_R16                : return GL_RED;
-			case GL_R16_SNORM          : return GL_RED;
-			case GL_RG8                : return GL_RG;
-			case GL_RG8_SNORM          : return GL_RG;
-			case GL_RG16               : return GL_RG;
-			case GL_RG16_SNORM         : return GL_RG;
-			case GL_R3_G3_B2           : return GL_RGB;
-			case GL_RGB4               : return GL_RGB;
-			case GL_RGB5               : return GL_RGB;
-			case GL_RGB8               : return GL_RGB;
-			case GL_RGB8_SNORM         : return GL_RGB;
-			case GL_RGB10              : return GL_RGB;
-			case GL_RGB12              : return GL_RGB;
-			case GL_RGB16_SNORM        : return GL_RGB;
-			case GL_RGBA2              : return GL_RGB;
-			case GL_RGBA4              : return GL_RGB;
-			case GL_RGB5_A1            : return GL_RGBA;
-			case GL_RGBA8              : return GL_RGBA;
-			case GL_RGBA8_SNORM        : return GL_RGBA;
-			case GL_RGB10_A2           : return GL_RGBA;
-			case GL_RGB10_A2UI         : return GL_RGBA;
-			case GL_RGBA12             : return GL_RGBA;
-			case GL_RGBA16             : return GL_RGBA;
-			case GL_SRGB8              : return GL_RGB;
-			case GL_SRGB8_ALPHA8       : return GL_RGBA;
-			case GL_R16F               : return GL_RED;
-			case GL_RG16F              : return GL_RG;
-			case GL_RGB16F             : return GL_RGB;
-			case GL_RGBA16F            : return GL_RGBA;
-			case GL_R32F               : return GL_RED;
-			case GL_RG32F              : return GL_RG;
-			case GL_RGB32F             : return GL_RGB;
-			case GL_RGBA32F            : return GL_RGBA;
-			case GL_R11F_G11F_B10F     : return GL_RGB;
-			case GL_RGB9_E5            : return GL_RGB;
-			case GL_R8I                : return GL_RED;
-			case GL_R8UI               : return GL_RED;
-			case GL_R16I               : return GL_RED;
-			case GL_R16UI              : return GL_RED;
-			case GL_R32I               : return GL_RED;
-			case GL_R32UI              : return GL_RED;
-			case GL_RG8I               : return GL_RG;
-			case GL_RG8UI              : return GL_RG;
-			case GL_RG16I              : return GL_RG;
-			case GL_RG16UI             : return GL_RG;
-			case GL_RG32I              : return GL_RG;
-			case GL_RG32UI             : return GL_RG;
-			case GL_RGB8I              : return GL_RGB;
-			case GL_RGB8UI             : return GL_RGB;
-			case GL_RGB16I             : return GL_RGB;
-			case GL_RGB16UI            : return GL_RGB;
-			case GL_RGB32I             : return GL_RGB;
-			case GL_RGB32UI            : return GL_RGB;
-			case GL_RGBA8I             : return GL_RGBA;
-			case GL_RGBA8UI            : return GL_RGBA;
-			case GL_RGBA16I            : return GL_RGBA;
-			case GL_RGBA16UI           : return GL_RGBA;
-			case GL_RGBA32I            : return GL_RGBA;
-			case GL_RGBA32UI           : return GL_RGBA;
-			case GL_DEPTH_COMPONENT24  : return GL_DEPTH_COMPONENT;
-			case GL_DEPTH_COMPONENT16  : return GL_DEPTH_COMPONENT;
-			case GL_DEPTH_COMPONENT32F : return GL_DEPTH_COMPONENT;
-			case GL_DEPTH32F_STENCIL8  : return GL_DEPTH_STENCIL;
-			case GL_DEPTH24_STENCIL8   : return GL_DEPTH_STENCIL;
-			case GL_STENCIL_INDEX8	   : return GL_STENCIL_INDEX;
-		}
-		throw std::runtime_error("Unable to convert sized internal format to base internal format.");
-	};
-
-	if(format == image_format_t::preferred) format = static_cast<image_format_t>(base_internal_format(m_format));
-	constexpr int level_of_detail = 0;
-	glTextureSubImage2D(
-		id(),
-		level_of_detail,
-		xoffset,
-		yoffset,
-		width,
-		height,
-		static_cast<GLenum>(format),
-		attribute_properties<T>::type,
-		pixels
-	);
+	update_level(0, xoffset, yoffset, width, height, pixels, format);
+}
+
+template<class T>
+void texture_t::update_level(
+	size_t level,
+	size_t xoffset,
+	size_t yoffset,
+	size_t width,
+	size_t height,
+	const T* pixels,
+	image_format_t format
+) {
+	update_level(level, image_view_t<const T>(pixels, width, height), xoffset, yoffset, format);
+}
+
+template <class T>
+void texture_t::update(
+	image_view_t<T> view,
+	size_t xoffset,
+	size_t yoffset,
+	image_format_t format
+) {
+	update_level(0, view, xoffset, yoffset, format);
+}
+
+template <class T>
+void texture_t::update_level(
+	size_t level,
+	image_view_t<T> view,
+	size_t xoffset,
+	size_t yoffset,
+	image_format_t format
+) {
+	using pixel_t = std::remove_const_t<T>;
+	if(level >= m_levels) {
+		throw std::runtime_error("Trying to update mip level "+std::to_string(level)+" of a texture with "+std::to_string(m_levels)+" levels.");
+	}
+	if(format == image_format_t::preferred) format = static_cast<image_format_t>(detail::base_internal_format(m_format));
+	if(detail::set_unpack_layout(view.data(), view.width(), view.height(), view.row_stride(), sizeof(pixel_t))) {
+		glTextureSubImage2D(
+			id(),
+			level,
+			xoffset,
+			yoffset,
+			view.width(),
+			view.height(),
+			static_cast<GLenum>(format),
+			attribute_properties<pixel_t>::type,
+			view.data()
+		);
+		return;
+	}
+	for(size_t y = 0; y < view.height(); ++y) {
+		detail::set_unpack_layout(view.row(y), view.width(), 1, view.row_stride(), sizeof(pixel_t));
+		glTextureSubImage2D(
+			id(),
+			level,
+			xoffset,
+			yoffset+y,
+			view.width(),
+			1,
+			static_cast<GLenum>(format),
+			attribute_properties<pixel_t>::type,
+			view.row(y)
+		);
+	}
 }
 
 template <class T>
@@ -288,20 +459,48 @@ void texture_t::update(
 	size_t width,
 	size_t height
 ) {
-	update(
-		xoffset,
-		yoffset,
-		width,
-		height,
-		image.data()
-	);
+	update(image.view(0, 0, width, height), xoffset, yoffset);
 }
 
 template <class T>
 void texture_t::update(
 	const image_t<T>& image
 ) {
-	update(0, 0, image.width(), image.height(), image.data());
+	update(image.view());
+}
+
+template <class T>
+void texture_t::update_level(size_t level, const image_t<T>& image) {
+	update_level(level, image.view());
+}
+
+template <class T>
+pixel_readback_t<T> texture_t::async_read(size_t level) const {
+	if(level >= m_levels) {
+		throw std::runtime_error("Trying to read mip level "+std::to_string(level)+" of a texture with "+std::to_string(m_levels)+" levels.");
+	}
+	const auto width = std::max<size_t>(m_width >> level, 1);
+	const auto height = std::max<size_t>(m_height >> level, 1);
+	const auto base_format = detail::base_internal_format(m_format);
+	const auto format = base_format == GL_DEPTH_COMPONENT || base_format == GL_DEPTH_STENCIL || base_format == GL_STENCIL_INDEX ?
+		base_format :
+		detail::pixel_format(attribute_properties<T>::elements_per_vertex, detail::is_integer_format(m_format));
+	const auto size = width*height*sizeof(T);
+	auto buffer = m_readbacks.acquire(size);
+	detail::pack_pixels(*buffer, [&]() {
+		glGetTextureImage(id(), level, format, attribute_properties<T>::type, size, nullptr);
+	});
+	return pixel_readback_t<T>(std::move(buffer), width, height);
+}
+
+template <class T>
+void texture_t::update_mip_chain(const std::vector<image_t<T>>& mip_chain) {
+	if(mip_chain.size() > m_levels) {
+		throw std::runtime_error("Mip chain has more levels than the texture storage.");
+	}
+	for(auto level = 0u; level < mip_chain.size(); ++level) {
+		update_level(level, mip_chain[level]);
+	}
 }
 
 } // End of namespace glpp::object
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "glpp/core/object/texture.hpp"
+
+namespace glpp::core::object {
+
+class texture_array_t : public object_t<> {
+public:
+
+	texture_array_t(texture_array_t&& mov) = default;
+	texture_array_t& operator=(texture_array_t&& mov) = default;
+
+	texture_array_t(const texture_array_t& cpy) = delete;
+	texture_array_t& operator=(const texture_array_t& cpy) = delete;
+
+	texture_array_t(
+		const size_t width,
+		const size_t height,
+		const size_t layers,
+		image_format_t format = image_format_t::rgb_8,
+		const clamp_mode_t clamp_mode = clamp_mode_t::repeat,
+		const filter_mode_t filter = filter_mode_t::linear,
+		const mipmap_mode_t mipmap_mode = mipmap_mode_t::none,
+		swizzle_mask_t swizzle_mask = {texture_channel_t::red, texture_channel_t::green, texture_channel_t::blue, texture_channel_t::alpha}
+	);
+
+	texture_slot_t bind_to_texture_slot() const;
+
+	template <class T>
+	void update(size_t layer, const image_t<T>& image);
+
+	template <class T>
+	void update_level(
+		size_t level,
+		size_t layer,
+		size_t xoffset,
+		size_t yoffset,
+		size_t width,
+		size_t height,
+		const T* pixels,
+		image_format_t format = image_format_t::preferred
+	);
+
+	// Copies all levels of count layers from source, which must have the same size and format.
+	void copy_layers(const texture_array_t& source, size_t source_layer, size_t layer, size_t count);
+
+	void generate_mipmaps();
+
+	size_t width() const;
+	size_t height() const;
+	size_t layers() const;
+	size_t levels() const;
+	image_format_t format() const;
+
+	static size_t max_layers();
+
+private:
+	static GLuint init();
+	static void destroy(GLuint id);
+	size_t m_width;
+	size_t m_height;
+	size_t m_layers;
+	GLenum m_format;
+	size_t m_levels;
+};
+
+/* Implementation */
+
+template <class T>
+void texture_array_t::update(size_t layer, const image_t<T>& image) {
+	update_level(0, layer, 0, 0, image.width(), image.height(), image.data());
+}
+
+template <class T>
+void texture_array_t::update_level(
+	size_t level,
+	size_t layer,
+	size_t xoffset,
+	size_t yoffset,
+	size_t width,
+	size_t height,
+	const T* pixels,
+	image_format_t format
+) {
+	if(level >= m_levels) {
+		throw std::runtime_error("Trying to update mip level "+std::to_string(level)+" of a texture array with "+std::to_string(m_levels)+" levels.");
+	}
+	if(layer >= m_layers) {
+		throw std::runtime_error("Trying to update layer "+std::to_string(layer)+" of a texture array with "+std::to_string(m_layers)+" layers.");
+	}
+	if(format == image_format_t::preferred) format = static_cast<image_format_t>(detail::base_internal_format(m_format));
+	detail::set_unpack_layout(pixels, width, height, width*sizeof(T), sizeof(T));
+	glTextureSubImage3D(
+		id(),
+		level,
+		xoffset,
+		yoffset,
+		layer,
+		width,
+		height,
+		1,
+		static_cast<GLenum>(format),
+		attribute_properties<T>::type,
+		pixels
+	);
+}
+
+}
@@ -1,7 +1,10 @@
 #pragma once
 
+#include "texture_atlas/array.hpp"
 #include "texture_atlas/grid.hpp"
 #include "texture_atlas/multi.hpp"
+#include "texture_atlas/packed.hpp"
+#include <numeric>
 
 namespace glpp::core::object {
 
@@ -94,6 +97,10 @@ public:
 	template <class PixelFormat>
 	entry_t insert(const allocation_hint_t allocation_hint, const image_t<PixelFormat>& image);
 
+	// Inserts the images with free keys, largest first, and returns the entries in input order.
+	template <class PixelFormat>
+	std::vector<entry_t> insert(const std::vector<image_t<PixelFormat>>& images);
+
 	void erase(const key_t key);
 	void erase(const entry_t entry);
 
@@ -106,6 +113,10 @@ public:
 
 	texture_atlas_slot_t<AllocationPolicy> bind_to_texture_slot() const;
 
+	// Access to policy specific functionality like growing or defragmenting the atlas.
+	AllocationPolicy& policy();
+	const AllocationPolicy& policy() const;
+
 private:
 
 	AllocationPolicy m_alloc;		
@@ -156,6 +167,31 @@ texture_atlas_entry_t<AllocationPolicy> texture_atlas_t<AllocationPolicy>::inser
 	return {m_alloc, allocated_key};
 }
 
+template <class AllocationPolicy>
+template <class PixelFormat>
+std::vector<texture_atlas_entry_t<AllocationPolicy>> texture_atlas_t<AllocationPolicy>::insert(const std::vector<image_t<PixelFormat>>& images) {
+	// Packing policies waste less space, if tall images are placed first.
+	std::vector<size_t> order(images.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+		const auto& a = images[lhs];
+		const auto& b = images[rhs];
+		return std::pair(a.height(), a.width()) > std::pair(b.height(), b.width());
+	});
+
+	std::vector<key_t> keys(images.size());
+	for(const auto i : order) {
+		keys[i] = m_alloc.alloc(m_alloc.first_free_key(), images[i]);
+	}
+
+	std::vector<entry_t> result;
+	result.reserve(keys.size());
+	for(const auto key : keys) {
+		result.push_back(entry_t{m_alloc, key});
+	}
+	return result;
+}
+
 using grid_atlas_t = texture_atlas_t<texture_atlas::grid_policy_t>;
 extern template class texture_atlas_entry_t<texture_atlas::grid_policy_t>;
 extern template class texture_atlas_slot_t<texture_atlas::grid_policy_t>;
@@ -166,4 +202,14 @@ extern template class texture_atlas_entry_t<texture_atlas::multi_policy_t>;
 extern template class texture_atlas_slot_t<texture_atlas::multi_policy_t>;
 extern template class texture_atlas_t<texture_atlas::multi_policy_t>;
 
+using array_atlas_t = texture_atlas_t<texture_atlas::array_policy_t>;
+extern template class texture_atlas_entry_t<texture_atlas::array_policy_t>;
+extern template class texture_atlas_slot_t<texture_atlas::array_policy_t>;
+extern template class texture_atlas_t<texture_atlas::array_policy_t>;
+
+using packed_atlas_t = texture_atlas_t<texture_atlas::packed_policy_t>;
+extern template class texture_atlas_entry_t<texture_atlas::packed_policy_t>;
+extern template class texture_atlas_slot_t<texture_atlas::packed_policy_t>;
+extern template class texture_atlas_t<texture_atlas::packed_policy_t>;
+
 }
\ No newline at end of file
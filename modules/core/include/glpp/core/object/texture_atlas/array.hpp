@@ -0,0 +1,109 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <fmt/core.h>
+#include "glpp/core/object/texture_array.hpp"
+#include "glpp/core/object/texture_atlas/multi.hpp"
+#include "glpp/core/object/texture_atlas/table.hpp"
+
+namespace glpp::core::object::texture_atlas {
+
+class array_policy_t {
+public:
+	using key_t = std::uint32_t;
+	using allocation_hint_t = non_existant_t;
+	using storage_t = texture_array_t;
+	using slot_storage_t = std::array<texture_slot_t, 1>;
+	using swizzle_mask_t = std::array<texture_channel_t, 4>;
+	using key_storage_t = std::vector<key_t>;
+
+	array_policy_t(
+		const std::size_t width,
+		const std::size_t height,
+		const std::size_t initial_layers = 1,
+		const image_format_t format = image_format_t::rgb_8,
+		const clamp_mode_t clamp_mode = clamp_mode_t::repeat,
+		const filter_mode_t filter = filter_mode_t::linear,
+		const mipmap_mode_t mipmap_mode = mipmap_mode_t::none,
+		const swizzle_mask_t swizzle_mask = {texture_channel_t::red, texture_channel_t::green, texture_channel_t::blue, texture_channel_t::alpha}
+	);
+
+	array_policy_t(const array_policy_t& cpy) = delete;
+	array_policy_t(array_policy_t&& mov) noexcept = default;
+
+	array_policy_t& operator=(const array_policy_t& cpy) = delete;
+	array_policy_t& operator=(array_policy_t&& mov) noexcept = default;
+
+	bool contains(const key_t key) const;
+	size_t size() const;
+	size_t max_size() const;
+	size_t capacity() const;
+
+	template <class PixelFormat>
+	key_t alloc(const key_t key, const image_t<PixelFormat>& image);
+
+	template <class Image>
+	void update(const key_t key, const Image& image);
+
+	void free(const key_t key);
+
+	slot_storage_t slots() const;
+
+	std::string texture_id(const std::string_view name, const std::string_view key) const;
+
+	std::string declaration(const std::string_view name) const;
+
+	std::string fetch(const std::string_view name, const std::string_view key, const std::string_view uv) const;
+
+	key_t first_free_key() const;
+
+	key_storage_t keys() const;
+
+	// Lookup table support, see texture_atlas_table_t.
+	table_record_t record(const key_t key) const;
+	std::string table_sampler(const std::string_view name) const;
+
+private:
+	// Reallocates the array with at least the given number of layers and copies the allocated layers.
+	void reserve(size_t layers);
+	void take(const key_t key);
+
+	size_t m_width;
+	size_t m_height;
+	image_format_t m_format;
+	clamp_mode_t m_clamp_mode;
+	filter_mode_t m_filter;
+	mipmap_mode_t m_mipmap_mode;
+	swizzle_mask_t m_swizzle_mask;
+
+	std::vector<bool> m_used;
+	// Freed layers below the highest allocated layer, reused before the array grows.
+	std::vector<key_t> m_free;
+	storage_t m_storage;
+};
+
+template <class PixelFormat>
+array_policy_t::key_t array_policy_t::alloc(const key_t key, const image_t<PixelFormat>& image) {
+	if(contains(key)) {
+		throw std::runtime_error("Trying to allocate subtexture with key that is already taken.");
+	}
+	take(key);
+	update(key, image);
+	return key;
+}
+
+template <class Image>
+void array_policy_t::update(const key_t key, const Image& image) {
+	if(!contains(key)) {
+		throw std::runtime_error("Trying to update subtexture with key that is not allocated.");
+	}
+	if(image.width() == m_width && image.height() == m_height) {
+		m_storage.update(key, image);
+	} else {
+		m_storage.update(key, image.resize(m_width, m_height));
+	}
+	m_storage.generate_mipmaps();
+}
+
+} // namespace
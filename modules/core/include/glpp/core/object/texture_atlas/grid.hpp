@@ -7,9 +7,16 @@
 #include <algorithm>
 #include <fmt/core.h>
 #include "glpp/core/object/texture.hpp"
+#include "glpp/core/object/texture_atlas/relocation.hpp"
+#include "glpp/core/object/texture_atlas/table.hpp"
 
 namespace glpp::core::object::texture_atlas {
 
+namespace detail {
+	// Returns a GLSL expression, which applies the clamp mode to the vec2 variable uv.
+	std::string clamp_uv(clamp_mode_t clamp_mode, glm::vec2 texel_width);
+}
+
 class grid_policy_t {
 public:
 	using key_t = std::uint32_t;
@@ -63,6 +70,21 @@ public:
 
 	key_storage_t keys() const;
 
+	// Lookup table support, see texture_atlas_table_t.
+	table_record_t record(const key_t key) const;
+	std::string table_sampler(const std::string_view name) const;
+
+	std::uint32_t rows() const;
+	std::uint32_t max_rows() const;
+
+	// Allows the grid to grow up to max_rows, once all cells are taken.
+	void set_max_rows(const std::uint32_t max_rows);
+
+	// Appends rows to the grid. Existing entries keep their keys and pixels, but the declaration changes.
+	void grow(const std::uint32_t rows);
+
+	relocation_notifier_t<key_t>& relocations();
+
 private:
 	
 	size_t padding() const {
@@ -128,14 +150,23 @@ private:
 	size_t m_width;
 	size_t m_height;
 
+	std::uint32_t m_max_rows;
+
 	std::vector<bool> m_keys;
+	image_format_t m_format;
 	clamp_mode_t m_clamp_mode;
 	filter_mode_t m_filter_mode;
+	mipmap_mode_t m_mipmap_mode;
+	swizzle_mask_t m_swizzle_mask;
 	storage_t m_storage;
+	relocation_notifier_t<key_t> m_relocations;
 };
 
 template <class PixelFormat>
 grid_policy_t::key_t grid_policy_t::alloc(const key_t key, const image_t<PixelFormat>& image) {
+    if(key >= m_keys.size() && key/m_cols < m_max_rows) {
+        grow(std::min(m_max_rows, std::max(m_rows*2, key/m_cols+1)));
+    }
     if(contains(key)) {
         throw std::runtime_error("Trying to allocate subtexture with key that is already taken.");
     }
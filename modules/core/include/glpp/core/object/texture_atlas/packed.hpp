@@ -0,0 +1,250 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <chrono>
+#include <map>
+#include <optional>
+#include <vector>
+#include <algorithm>
+#include <fmt/core.h>
+#include "glpp/core/object/buffer.hpp"
+#include "glpp/core/object/texture.hpp"
+#include "glpp/core/object/texture_atlas/grid.hpp"
+#include "glpp/core/object/texture_atlas/multi.hpp"
+#include "glpp/core/object/texture_atlas/relocation.hpp"
+#include "glpp/core/object/texture_atlas/table.hpp"
+
+namespace glpp::core::object::texture_atlas {
+
+struct rect_t {
+	std::uint32_t x;
+	std::uint32_t y;
+	std::uint32_t width;
+	std::uint32_t height;
+
+	bool operator==(const rect_t&) const = default;
+};
+
+// Packs rectangles with the skyline bottom left heuristic. Released rectangles are kept in a map
+// ordered by area and reused before the skyline grows.
+class rect_packer_t {
+public:
+	rect_packer_t(std::uint32_t width, std::uint32_t height);
+
+	std::optional<rect_t> alloc(std::uint32_t width, std::uint32_t height);
+	void free(const rect_t& rect);
+
+	// Enlarges the packing area, allocated rectangles keep their position.
+	void grow(std::uint32_t width, std::uint32_t height);
+
+	std::uint32_t width() const;
+	std::uint32_t height() const;
+
+	// Share of the area below the skyline, that is not covered by allocated rectangles.
+	float fragmentation() const;
+
+private:
+	struct segment_t {
+		std::uint32_t x;
+		std::uint32_t y;
+		std::uint32_t width;
+	};
+
+	std::optional<rect_t> alloc_free(std::uint32_t width, std::uint32_t height);
+	std::optional<rect_t> alloc_skyline(std::uint32_t width, std::uint32_t height);
+
+	std::uint32_t m_width;
+	std::uint32_t m_height;
+	std::vector<segment_t> m_skyline;
+	std::multimap<std::uint64_t, rect_t> m_free;
+	std::uint64_t m_used_area = 0;
+};
+
+class packed_policy_t {
+public:
+	using key_t = std::uint32_t;
+	using allocation_hint_t = non_existant_t;
+	using storage_t = std::array<texture_t, 1>;
+	using slot_storage_t = std::array<texture_slot_t, 1>;
+	using swizzle_mask_t = std::array<texture_channel_t, 4>;
+	using key_storage_t = std::vector<key_t>;
+
+	// Shader storage binding of the rectangle buffer read by glpp_fetch_<name>.
+	static constexpr GLuint default_rect_binding = 3;
+
+	packed_policy_t(
+		const std::size_t width,
+		const std::size_t height,
+		const std::size_t padding = 1,
+		const image_format_t format = image_format_t::rgb_8,
+		const clamp_mode_t clamp_mode = clamp_mode_t::repeat,
+		const filter_mode_t filter = filter_mode_t::linear,
+		const mipmap_mode_t mipmap_mode = mipmap_mode_t::none,
+		const swizzle_mask_t swizzle_mask = {texture_channel_t::red, texture_channel_t::green, texture_channel_t::blue, texture_channel_t::alpha}
+	);
+
+	packed_policy_t(const packed_policy_t& cpy) = delete;
+	packed_policy_t(packed_policy_t&& mov) noexcept = default;
+
+	packed_policy_t& operator=(const packed_policy_t& cpy) = delete;
+	packed_policy_t& operator=(packed_policy_t&& mov) noexcept = default;
+
+	bool contains(const key_t key) const;
+	size_t size() const;
+	size_t max_size() const;
+
+	template <class PixelFormat>
+	key_t alloc(const key_t key, const image_t<PixelFormat>& image);
+
+	template <class Image>
+	void update(const key_t key, const Image& image);
+
+	void free(const key_t key);
+
+	// Pixel rectangle of the entry without padding.
+	rect_t rect(const key_t key) const;
+	// Offset and size of the entry in normalized texture coordinates.
+	glm::vec4 uv_rect(const key_t key) const;
+
+	// Binds the texture and the rectangle buffer, uploading the rectangles if entries changed.
+	slot_storage_t slots() const;
+
+	std::string texture_id(const std::string_view name, const std::string_view key) const;
+
+	std::string declaration(const std::string_view name) const;
+
+	std::string fetch(const std::string_view name, const std::string_view key, const std::string_view uv) const;
+
+	key_t first_free_key() const;
+
+	key_storage_t keys() const;
+
+	// Lookup table support, see texture_atlas_table_t.
+	table_record_t record(const key_t key) const;
+	std::string table_sampler(const std::string_view name) const;
+
+	std::size_t width() const;
+	std::size_t height() const;
+
+	// Allows the texture to grow up to the given size, once an entry does not fit anymore.
+	void set_max_size(const std::size_t width, const std::size_t height);
+
+	// Reallocates the texture with a larger size. Entries keep their pixel position, but their uv_rect changes.
+	void grow(const std::size_t width, const std::size_t height);
+
+	float fragmentation() const;
+
+	// Repacks the entries into a new texture, copying entries until the budget is spent. Returns true,
+	// once the defragmentation finished. Any modification of the atlas cancels a pending defragmentation.
+	bool defragment(const std::chrono::nanoseconds budget);
+	bool defragmenting() const;
+
+	relocation_notifier_t<key_t>& relocations();
+
+	// Moves the rectangle buffer to another binding, e.g. to declare several packed atlases in one shader.
+	void set_rect_binding(const GLuint binding);
+	GLuint rect_binding() const;
+
+private:
+	struct defragmentation_t {
+		texture_t storage;
+		rect_packer_t packer;
+		std::map<key_t, rect_t> entries;
+		// Keys still to be copied, the largest entry is at the back.
+		std::vector<key_t> pending;
+	};
+
+	template <class Image>
+	Image pad(const Image& image) const;
+
+	rect_t reserve(std::uint32_t width, std::uint32_t height);
+	texture_t make_storage(const std::size_t width, const std::size_t height) const;
+	void upload_rects() const;
+
+	size_t m_padding;
+	image_format_t m_format;
+	clamp_mode_t m_clamp_mode;
+	filter_mode_t m_filter;
+	mipmap_mode_t m_mipmap_mode;
+	swizzle_mask_t m_swizzle_mask;
+	std::size_t m_max_width;
+	std::size_t m_max_height;
+	rect_packer_t m_packer;
+	// Allocated rectangles including the padding.
+	std::map<key_t, rect_t> m_entries;
+	storage_t m_storage;
+	std::optional<defragmentation_t> m_defragmentation;
+	relocation_notifier_t<key_t> m_relocations;
+	GLuint m_rect_binding = default_rect_binding;
+	// Normalized rectangles indexed by key, uploaded on the next slots() after a change.
+	mutable buffer_t<glm::vec4> m_rects;
+	mutable bool m_rects_dirty = true;
+};
+
+template <class PixelFormat>
+packed_policy_t::key_t packed_policy_t::alloc(const key_t key, const image_t<PixelFormat>& image) {
+	if(contains(key)) {
+		throw std::runtime_error("Trying to allocate subtexture with key that is already taken.");
+	}
+	m_defragmentation.reset();
+	m_entries.emplace(key, reserve(image.width()+2*m_padding, image.height()+2*m_padding));
+	update(key, image);
+	return key;
+}
+
+template <class Image>
+void packed_policy_t::update(const key_t key, const Image& image) {
+	if(!contains(key)) {
+		throw std::runtime_error("Trying to update subtexture with key that is not allocated.");
+	}
+	m_defragmentation.reset();
+	m_rects_dirty = true;
+	auto& entry = m_entries.at(key);
+	const auto width = image.width()+2*m_padding;
+	const auto height = image.height()+2*m_padding;
+	if(entry.width != width || entry.height != height) {
+		// Allocate the new rectangle first, so the entry stays valid if the atlas is full.
+		const auto previous = entry;
+		entry = reserve(width, height);
+		m_packer.free(previous);
+	}
+	m_storage[0].update(pad(image), entry.x, entry.y, entry.width, entry.height);
+	if(m_mipmap_mode != mipmap_mode_t::none) {
+		m_storage[0].generate_mipmaps();
+	}
+}
+
+template <class Image>
+Image packed_policy_t::pad(const Image& image) const {
+	if(m_padding == 0) {
+		return image;
+	}
+	// The padding repeats the pixels the sampler would read outside of the entry, so linear
+	// filtering at the border does not bleed into neighbouring entries.
+	const auto width = static_cast<std::ptrdiff_t>(image.width());
+	const auto height = static_cast<std::ptrdiff_t>(image.height());
+	const auto padding = static_cast<std::ptrdiff_t>(m_padding);
+	const auto wrap = [this](std::ptrdiff_t i, std::ptrdiff_t size) -> std::ptrdiff_t {
+		switch(m_clamp_mode) {
+			case clamp_mode_t::repeat:
+				return ((i%size)+size)%size;
+			case clamp_mode_t::clamp_to_border:
+				return i < 0 || i >= size ? -1 : i;
+			default:
+				return std::clamp<std::ptrdiff_t>(i, 0, size-1);
+		}
+	};
+	Image padded { image.width()+2*m_padding, image.height()+2*m_padding };
+	for(std::ptrdiff_t y = 0; y < height+2*padding; ++y) {
+		for(std::ptrdiff_t x = 0; x < width+2*padding; ++x) {
+			const auto sx = wrap(x-padding, width);
+			const auto sy = wrap(y-padding, height);
+			padded.get(x, y) = sx < 0 || sy < 0 ?
+				typename Image::value_type{} :
+				image.get(sx, sy);
+		}
+	}
+	return padded;
+}
+
+} // namespace
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace glpp::core::object::texture_atlas {
+
+// Informs holders of atlas entries, that the texture coordinates of some keys changed. Callbacks
+// receive all keys changed by a single grow or defragmentation step at once.
+template <class Key>
+class relocation_notifier_t {
+public:
+	using callback_t = std::function<void(const std::vector<Key>&)>;
+	using id_t = std::size_t;
+
+	id_t subscribe(callback_t callback) {
+		const auto id = m_next_id++;
+		m_callbacks.emplace(id, std::move(callback));
+		return id;
+	}
+
+	void unsubscribe(const id_t id) {
+		m_callbacks.erase(id);
+	}
+
+	void notify(const std::vector<Key>& keys) const {
+		if(keys.empty()) {
+			return;
+		}
+		for(const auto& [id, callback] : m_callbacks) {
+			callback(keys);
+		}
+	}
+
+private:
+	std::map<id_t, callback_t> m_callbacks;
+	id_t m_next_id = 0;
+};
+
+} // namespace
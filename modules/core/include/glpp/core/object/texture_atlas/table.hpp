@@ -0,0 +1,46 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "glpp/core/object/texture.hpp"
+
+namespace glpp::core::object::texture_atlas {
+
+// Entry of the atlas lookup table as laid out in the shader storage buffer (std430).
+struct table_record_t {
+	// Offset in xy and size in zw of the entry in texture coordinates.
+	glm::vec4 uv_rect;
+	std::uint32_t layer;
+	std::uint32_t clamp_mode;
+	std::uint32_t valid;
+	std::uint32_t padding;
+};
+
+static_assert(sizeof(table_record_t) == 32, "table_record_t must match the std430 layout.");
+
+namespace detail {
+	// Index of the clamp mode in the switch of the lookup function.
+	constexpr std::uint32_t table_clamp_mode(clamp_mode_t clamp_mode) {
+		switch(clamp_mode) {
+			case clamp_mode_t::repeat:
+				return 0;
+			case clamp_mode_t::mirrored_repeat:
+				return 1;
+			case clamp_mode_t::clamp_to_edge:
+				return 2;
+			default:
+				return 3;
+		}
+	}
+
+	// Declares the sampler and the function sampling the already mapped uv coordinates.
+	std::string table_sampler_2d(const std::string_view name);
+	std::string table_sampler_2d_array(const std::string_view name);
+
+	// Declares the record buffer and the lookup function, which only depend on name and binding.
+	std::string table_lookup(const std::string_view name, const std::uint32_t binding);
+}
+
+} // namespace
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "glpp/core/object/buffer.hpp"
+#include "glpp/core/object/texture_atlas.hpp"
+#include <fmt/core.h>
+#include <algorithm>
+#include <optional>
+
+namespace glpp::core::object {
+
+/*
+ * Publishes the entries of a texture atlas in a shader storage buffer. The generated GLSL only depends
+ * on the name and binding, so adding, updating or moving entries requires an update() of the table,
+ * but never a new shader. Supported by all allocation policies providing record() and table_sampler().
+ * Entries relocated by the policy, e.g. by growing or defragmenting, are updated automatically.
+ */
+template <class AllocationPolicy>
+class texture_atlas_table_t {
+public:
+	static constexpr GLuint default_binding = 2;
+
+	using key_t = typename AllocationPolicy::key_t;
+	using record_t = texture_atlas::table_record_t;
+
+	explicit texture_atlas_table_t(texture_atlas_t<AllocationPolicy>& atlas);
+	~texture_atlas_table_t();
+
+	// The table subscribes to the relocations of the atlas with its address.
+	texture_atlas_table_t(const texture_atlas_table_t& cpy) = delete;
+	texture_atlas_table_t& operator=(const texture_atlas_table_t& cpy) = delete;
+
+	// Uploads the records of all entries of the atlas in place, the buffer only grows if a key does not fit.
+	void update();
+	// Uploads the records of the given allocated keys only.
+	void update(const std::vector<key_t>& keys);
+	void bind(GLuint binding = default_binding) const;
+
+	// Number of records in the buffer, keys below this value can be looked up.
+	size_t size() const;
+
+	std::string declaration(const std::string_view name, GLuint binding = default_binding) const;
+	std::string fetch(const std::string_view name, const std::string_view key, const std::string_view uv) const;
+
+private:
+	static constexpr bool relocatable = requires(AllocationPolicy& policy) { policy.relocations(); };
+
+	size_t capacity() const;
+
+	texture_atlas_t<AllocationPolicy>& m_atlas;
+	buffer_t<record_t> m_records;
+	size_t m_size = 0;
+	// Binding of the last bind(), restored when the buffer grows.
+	mutable std::optional<GLuint> m_binding;
+	std::size_t m_subscription = 0;
+};
+
+template <class AllocationPolicy>
+texture_atlas_table_t(texture_atlas_t<AllocationPolicy>&) -> texture_atlas_table_t<AllocationPolicy>;
+
+/*
+ * Implementation
+ */
+
+template <class AllocationPolicy>
+texture_atlas_table_t<AllocationPolicy>::texture_atlas_table_t(texture_atlas_t<AllocationPolicy>& atlas) :
+	m_atlas(atlas)
+{
+	update();
+	if constexpr(relocatable) {
+		m_subscription = m_atlas.policy().relocations().subscribe([this](const std::vector<key_t>& keys) {
+			update(keys);
+		});
+	}
+}
+
+template <class AllocationPolicy>
+texture_atlas_table_t<AllocationPolicy>::~texture_atlas_table_t() {
+	if constexpr(relocatable) {
+		m_atlas.policy().relocations().unsubscribe(m_subscription);
+	}
+}
+
+template <class AllocationPolicy>
+void texture_atlas_table_t<AllocationPolicy>::update() {
+	const auto keys = m_atlas.keys();
+	const auto max_key = std::max_element(keys.begin(), keys.end());
+	const auto size = max_key == keys.end() ? size_t(0) : static_cast<size_t>(*max_key)+1;
+	// The lookup function bounds keys by the length of the buffer, so records past the last key are
+	// written as invalid, too. Zero sized storage buffers can not be bound.
+	const auto grow = capacity() == 0 || size > capacity();
+	std::vector<record_t> records(grow ? std::max({ size, 2*capacity(), size_t(1) }) : capacity(), record_t{});
+	for(const auto key : keys) {
+		records[key] = m_atlas.policy().record(key);
+	}
+	m_size = size;
+	if(grow) {
+		m_records = buffer_t<record_t>(
+			buffer_target_t::shader_storage_buffer,
+			records.data(),
+			records.size()*sizeof(record_t),
+			buffer_usage_t::dynamic_draw
+		);
+		if(m_binding) {
+			m_records.bind_base(*m_binding);
+		}
+	} else {
+		m_records.update(records.data(), records.size()*sizeof(record_t));
+	}
+}
+
+template <class AllocationPolicy>
+void texture_atlas_table_t<AllocationPolicy>::update(const std::vector<key_t>& keys) {
+	if(std::any_of(keys.begin(), keys.end(), [this](key_t key) { return key >= m_size; })) {
+		update();
+		return;
+	}
+	for(const auto key : keys) {
+		const auto record = m_atlas.policy().record(key);
+		m_records.update(&record, sizeof(record_t), key*sizeof(record_t));
+	}
+}
+
+template <class AllocationPolicy>
+void texture_atlas_table_t<AllocationPolicy>::bind(GLuint binding) const {
+	m_records.bind_base(binding);
+	m_binding = binding;
+}
+
+template <class AllocationPolicy>
+size_t texture_atlas_table_t<AllocationPolicy>::size() const {
+	return m_size;
+}
+
+template <class AllocationPolicy>
+size_t texture_atlas_table_t<AllocationPolicy>::capacity() const {
+	return m_records.size()/sizeof(record_t);
+}
+
+template <class AllocationPolicy>
+std::string texture_atlas_table_t<AllocationPolicy>::declaration(const std::string_view name, GLuint binding) const {
+	return m_atlas.policy().table_sampler(name)+texture_atlas::detail::table_lookup(name, binding);
+}
+
+template <class AllocationPolicy>
+std::string texture_atlas_table_t<AllocationPolicy>::fetch(const std::string_view name, const std::string_view key, const std::string_view uv) const {
+	return fmt::format("glpp_lookup_{}({}, uint({}))", name, uv, key);
+}
+
+}
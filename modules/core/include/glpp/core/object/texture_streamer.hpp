@@ -0,0 +1,190 @@
+#pragma once
+
+#include "glpp/gl.hpp"
+#include "glpp/core/object/texture.hpp"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+namespace glpp::core::object {
+
+/*
+ * Keeps the mip chains of many textures inside a memory budget. Textures start with their coarse levels
+ * resident, finer levels are streamed in for textures requested with a large projected size. When the
+ * budget is exceeded, the finest levels of the least recently used textures are evicted. Changing the
+ * resident levels reallocates the texture, so texture() needs to be bound again after update().
+ */
+class texture_streamer_t {
+public:
+	using handle_t = std::uint32_t;
+
+	// Uploads level source_level of the full mip chain into level of texture.
+	using level_loader_t = std::function<void(texture_t& texture, size_t level, size_t source_level)>;
+
+	static constexpr size_t default_budget = 256*1024*1024;
+	static constexpr size_t default_resident_size = 64;
+
+	explicit texture_streamer_t(size_t budget = default_budget, size_t resident_size = default_resident_size);
+
+	texture_streamer_t(texture_streamer_t&& mov) = default;
+	texture_streamer_t& operator=(texture_streamer_t&& mov) = default;
+
+	texture_streamer_t(const texture_streamer_t& cpy) = delete;
+	texture_streamer_t& operator=(const texture_streamer_t& cpy) = delete;
+
+	// Keeps the mip chain of the image in client memory.
+	template <class T>
+	handle_t add(
+		const image_t<T>& image,
+		image_format_t format = image_format_t::preferred,
+		const clamp_mode_t clamp_mode = clamp_mode_t::repeat,
+		const filter_mode_t filter = filter_mode_t::linear,
+		const mipmap_mode_t mipmap_mode = mipmap_mode_t::linear
+	);
+
+	// Keeps the block compressed mip chain in client memory, the image needs all levels down to 1x1.
+	handle_t add(
+		const compressed_image_t& image,
+		const clamp_mode_t clamp_mode = clamp_mode_t::repeat,
+		const filter_mode_t filter = filter_mode_t::linear,
+		const mipmap_mode_t mipmap_mode = mipmap_mode_t::linear
+	);
+
+	// Calls the loader for each level, when it is streamed in.
+	template <class T>
+	handle_t add(
+		size_t width,
+		size_t height,
+		std::function<image_t<T>(size_t level)> loader,
+		image_format_t format = image_format_t::preferred,
+		const clamp_mode_t clamp_mode = clamp_mode_t::repeat,
+		const filter_mode_t filter = filter_mode_t::linear,
+		const mipmap_mode_t mipmap_mode = mipmap_mode_t::linear
+	);
+
+	void remove(handle_t handle);
+
+	// Marks the texture as used in the current frame and requests the levels needed to cover
+	// screen_size pixels. Multiple requests in one frame keep the finest level.
+	void request(handle_t handle, float screen_size);
+	void request(handle_t handle, float distance, float world_size, float fov_y, size_t viewport_height);
+
+	// Evicts levels while the budget is exceeded and streams in up to max_levels missing levels of
+	// textures requested in the current frame, coarse levels first. Returns the number of loaded levels.
+	size_t update(size_t max_levels = 4);
+
+	const texture_t& texture(handle_t handle) const;
+	size_t levels(handle_t handle) const;
+	size_t resident_level(handle_t handle) const;
+	size_t requested_level(handle_t handle) const;
+
+	size_t size() const;
+	size_t usage() const;
+	size_t budget() const;
+	void set_budget(size_t bytes);
+
+	static size_t level_for_screen_size(size_t width, size_t height, float screen_size);
+	static float screen_size(float distance, float world_size, float fov_y, size_t viewport_height);
+
+private:
+	struct entry_t {
+		size_t width;
+		size_t height;
+		size_t levels;
+		// Bytes per texel of uncompressed formats.
+		size_t texel_size;
+		image_format_t format;
+		clamp_mode_t clamp_mode;
+		filter_mode_t filter;
+		mipmap_mode_t mipmap_mode;
+		level_loader_t loader;
+		texture_t texture;
+		size_t resident_level;
+		size_t min_level;
+		size_t requested_level;
+		std::uint64_t last_used = 0;
+	};
+
+	handle_t add(
+		size_t width,
+		size_t height,
+		size_t texel_size,
+		image_format_t format,
+		clamp_mode_t clamp_mode,
+		filter_mode_t filter,
+		mipmap_mode_t mipmap_mode,
+		level_loader_t loader
+	);
+
+	static size_t level_size(const entry_t& entry, size_t level);
+	static size_t resident_size(const entry_t& entry, size_t resident_level);
+	static texture_t allocate(const entry_t& entry, size_t resident_level);
+	void reallocate(entry_t& entry, size_t resident_level);
+	entry_t& entry(handle_t handle);
+	const entry_t& entry(handle_t handle) const;
+
+	size_t m_budget;
+	size_t m_resident_size;
+	size_t m_usage = 0;
+	std::unordered_map<handle_t, entry_t> m_entries;
+	handle_t m_next_handle = 0;
+	std::uint64_t m_frame = 1;
+};
+
+/*
+ * Implementation
+ */
+
+template <class T>
+texture_streamer_t::handle_t texture_streamer_t::add(
+	const image_t<T>& image,
+	image_format_t format,
+	const clamp_mode_t clamp_mode,
+	const filter_mode_t filter,
+	const mipmap_mode_t mipmap_mode
+) {
+	auto mip_chain = std::make_shared<const std::vector<image_t<T>>>(image.mip_chain());
+	return add(
+		image.width(),
+		image.height(),
+		sizeof(T),
+		detail::resolve_format(format, image),
+		clamp_mode,
+		filter,
+		mipmap_mode,
+		[mip_chain = std::move(mip_chain)](texture_t& texture, size_t level, size_t source_level) {
+			texture.update_level(level, (*mip_chain)[source_level]);
+		}
+	);
+}
+
+template <class T>
+texture_streamer_t::handle_t texture_streamer_t::add(
+	size_t width,
+	size_t height,
+	std::function<image_t<T>(size_t level)> loader,
+	image_format_t format,
+	const clamp_mode_t clamp_mode,
+	const filter_mode_t filter,
+	const mipmap_mode_t mipmap_mode
+) {
+	return add(
+		width,
+		height,
+		sizeof(T),
+		detail::resolve_format(format, image_t<T>(1, 1)),
+		clamp_mode,
+		filter,
+		mipmap_mode,
+		[loader = std::move(loader), width, height](texture_t& texture, size_t level, size_t source_level) {
+			const auto image = loader(source_level);
+			if(image.width() != std::max<size_t>(width >> source_level, 1) || image.height() != std::max<size_t>(height >> source_level, 1)) {
+				throw std::runtime_error("Streamed mip level "+std::to_string(source_level)+" has the wrong size.");
+			}
+			texture.update_level(level, image);
+		}
+	);
+}
+
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "glpp/gl.hpp"
+#include "glpp/core/object/texture.hpp"
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace glpp::core::object {
+
+struct texture_binding_t {
+	GLuint texture;
+	GLuint sampler = 0;
+	// Units hold one texture per target, e.g. a 2D and a 2D array texture at the same time.
+	GLenum target = GL_TEXTURE_2D;
+};
+
+// Tracks the textures and samplers bound to the texture units of the current context. Textures
+// stay resident on their unit after use, so binding them again is free. Units, which are not
+// locked by a texture_slot_t, are reused in least recently used order.
+class texture_unit_cache_t {
+public:
+
+	// A unit count of 0 uses the maximum number of combined texture units of the context.
+	explicit texture_unit_cache_t(size_t units = 0);
+
+	texture_unit_cache_t(const texture_unit_cache_t& cpy) = delete;
+	texture_unit_cache_t& operator=(const texture_unit_cache_t& cpy) = delete;
+
+	// Returns the cache of the context selected by make_current() on the calling thread. Threads,
+	// which never selected a context, use a cache of their own.
+	static texture_unit_cache_t& current();
+	// Selects the cache of a context after it was made current. The key identifies the context,
+	// e.g. its native handle. glpp::system calls it for its windows and contexts.
+	static void make_current(const void* context);
+	// Drops the cache of a destroyed context.
+	static void release(const void* context);
+
+	GLuint bind(texture_binding_t binding);
+
+	// Makes all bindings resident at once and returns their units in the same order. Missing
+	// bindings are issued with one glBindTextures and glBindSamplers call per range of units.
+	std::vector<GLuint> bind(std::span<const texture_binding_t> bindings);
+
+	texture_slot_t acquire(texture_binding_t binding);
+	std::vector<texture_slot_t> acquire(std::span<const texture_binding_t> bindings);
+
+	bool resident(texture_binding_t binding) const;
+
+	// Forgets the texture or sampler, e.g. because the object is deleted and its name reused.
+	void evict_texture(GLuint texture);
+	void evict_sampler(GLuint sampler);
+
+	// Forgets all bindings, call this after binding textures without the cache.
+	void invalidate();
+
+	size_t size() const;
+
+private:
+	friend class texture_slot_t;
+
+	struct unit_t {
+		// Texture of each bound target, targets without an entry are unbound.
+		std::vector<std::pair<GLenum, GLuint>> textures;
+		// Set by invalidate(), targets without an entry are unknown instead of unbound.
+		bool invalidated = false;
+		GLuint sampler = 0;
+		std::uint64_t last_use = 0;
+		size_t locks = 0;
+
+		GLuint texture(GLenum target) const;
+		void set_texture(GLenum target, GLuint texture);
+	};
+
+	void lock(GLuint unit);
+	void unlock(GLuint unit);
+
+	std::vector<unit_t>& units();
+	std::ptrdiff_t find(texture_binding_t binding) const;
+	GLuint evict_candidate(std::uint64_t batch) const;
+
+	size_t m_size;
+	std::vector<unit_t> m_units;
+	std::uint64_t m_clock = 0;
+};
+
+}
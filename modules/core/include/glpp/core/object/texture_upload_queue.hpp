@@ -0,0 +1,159 @@
+#pragma once
+
+#include "glpp/gl.hpp"
+#include "glpp/core/object.hpp"
+#include "glpp/core/object/fence.hpp"
+#include "glpp/core/object/texture.hpp"
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace glpp::core::object {
+
+namespace detail {
+	struct texture_upload_state_t {
+		bool issued = false;
+		std::shared_ptr<const fence_t> fence;
+	};
+}
+
+class texture_upload_t {
+public:
+	explicit texture_upload_t(std::shared_ptr<const detail::texture_upload_state_t> state);
+
+	bool issued() const;
+	bool done() const;
+	void wait() const;
+
+private:
+	std::shared_ptr<const detail::texture_upload_state_t> m_state;
+};
+
+/*
+ * Uploads are staged straight into a persistently mapped ring, if it has room at the time of the
+ * enqueue and no earlier upload waits for room, and are copied once more into client memory
+ * otherwise. Pending uploads refer to the
+ * texture by name and are dropped, if the texture is destroyed before they are issued.
+ */
+class texture_upload_queue_t : public object_t<> {
+public:
+	static constexpr size_t default_capacity = 32*1024*1024;
+	static constexpr size_t default_frame_budget = 4*1024*1024;
+
+	explicit texture_upload_queue_t(size_t capacity = default_capacity, size_t frame_budget = default_frame_budget);
+	~texture_upload_queue_t();
+
+	texture_upload_queue_t(texture_upload_queue_t&& mov) noexcept;
+	texture_upload_queue_t& operator=(texture_upload_queue_t&& mov) noexcept;
+
+	texture_upload_queue_t(const texture_upload_queue_t& cpy) = delete;
+	texture_upload_queue_t& operator=(const texture_upload_queue_t& cpy) = delete;
+
+	template <class T>
+	texture_upload_t enqueue(const texture_t& texture, const image_t<T>& image, size_t level = 0, size_t xoffset = 0, size_t yoffset = 0);
+
+	// Only the pixels inside the view are staged, rows of a larger image are packed tightly.
+	template <class T>
+	texture_upload_t enqueue(const texture_t& texture, image_view_t<T> view, size_t level = 0, size_t xoffset = 0, size_t yoffset = 0);
+
+	size_t process();
+	void flush();
+
+	// Drops the pending uploads into the texture of all queues of the calling thread, called when a texture is destroyed.
+	static void evict_texture(GLuint texture);
+
+	size_t pending() const;
+	size_t in_flight() const;
+	size_t capacity() const;
+
+	size_t frame_budget() const;
+	void set_frame_budget(size_t bytes);
+
+private:
+	struct request_t {
+		GLuint texture;
+		GLint level;
+		GLint xoffset;
+		GLint yoffset;
+		GLsizei width;
+		GLsizei height;
+		GLenum format;
+		GLenum type;
+		size_t pixel_size;
+		size_t size;
+		// Offset of the pixels in the ring, or no_offset if they are kept in pixels.
+		size_t offset;
+		std::vector<std::byte> pixels;
+		std::shared_ptr<detail::texture_upload_state_t> state;
+	};
+
+	struct region_t {
+		size_t offset;
+		size_t size;
+		// Not set while the upload of the region is pending.
+		std::shared_ptr<const fence_t> fence;
+	};
+
+	static constexpr size_t no_offset = static_cast<size_t>(-1);
+
+	// Copies height rows of row_size bytes, which are row_stride bytes apart, into the ring or the request.
+	texture_upload_t enqueue(request_t request, const std::byte* data, size_t row_stride, size_t row_size);
+
+	void reclaim();
+	bool allocate(size_t size, size_t& offset) const;
+	void reserve(size_t offset, size_t size);
+	size_t issue(size_t budget, bool block);
+
+	static GLuint create(size_t capacity);
+	static void destroy(GLuint id);
+
+	std::byte* m_mapping;
+	size_t m_capacity;
+	size_t m_frame_budget;
+	size_t m_head = 0;
+	std::deque<request_t> m_pending;
+	std::deque<region_t> m_in_flight;
+};
+
+/*
+ * Implementation
+ */
+
+template <class T>
+texture_upload_t texture_upload_queue_t::enqueue(const texture_t& texture, const image_t<T>& image, size_t level, size_t xoffset, size_t yoffset) {
+	return enqueue(texture, image.view(), level, xoffset, yoffset);
+}
+
+template <class T>
+texture_upload_t texture_upload_queue_t::enqueue(const texture_t& texture, image_view_t<T> view, size_t level, size_t xoffset, size_t yoffset) {
+	using pixel_t = std::remove_const_t<T>;
+	if(level >= texture.levels()) {
+		throw std::runtime_error("Trying to update mip level "+std::to_string(level)+" of a texture with "+std::to_string(texture.levels())+" levels.");
+	}
+	const auto row_size = view.width()*sizeof(pixel_t);
+	return enqueue(
+		request_t{
+			texture.id(),
+			static_cast<GLint>(level),
+			static_cast<GLint>(xoffset),
+			static_cast<GLint>(yoffset),
+			static_cast<GLsizei>(view.width()),
+			static_cast<GLsizei>(view.height()),
+			detail::base_internal_format(static_cast<GLenum>(texture.format())),
+			attribute_properties<pixel_t>::type,
+			sizeof(pixel_t),
+			view.height()*row_size,
+			no_offset,
+			{},
+			nullptr
+		},
+		reinterpret_cast<const std::byte*>(view.data()),
+		view.row_stride(),
+		row_size
+	);
+}
+
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "glpp/gl.hpp"
+#include "glpp/core/object/framebuffer.hpp"
+#include "glpp/core/object/texture.hpp"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace glpp::core::object {
+
+struct virtual_page_t {
+	std::uint32_t x;
+	std::uint32_t y;
+	std::uint32_t level;
+
+	bool operator==(const virtual_page_t&) const = default;
+};
+
+/*
+ * Software virtual texture. Only the pages requested by a feedback pass are kept in a physical page
+ * cache of fixed size, a page table texture maps every virtual page to the cache slot of itself or of
+ * its closest resident ancestor. The coarsest page is always resident, so every lookup finds texels.
+ * Pages are loaded on a worker thread, update() only uploads finished pages.
+ */
+class virtual_texture_t {
+public:
+	// Returns the texels of a page including a border of border() texels on each side. Called on the
+	// worker thread, except for the coarsest page, which is loaded by the constructor.
+	using page_loader_t = std::function<image_t<glm::u8vec4>(const virtual_page_t& page)>;
+
+	static constexpr size_t default_page_size = 128;
+	static constexpr size_t default_border = 1;
+	// Feedback copies in flight, the feedback of a frame is evaluated by one of the next updates.
+	static constexpr size_t feedback_depth = 2;
+
+	virtual_texture_t(
+		size_t width,
+		size_t height,
+		size_t cache_pages,
+		page_loader_t loader,
+		size_t page_size = default_page_size,
+		size_t border = default_border
+	);
+
+	virtual_texture_t(virtual_texture_t&& mov) noexcept;
+	virtual_texture_t& operator=(virtual_texture_t&& mov) noexcept;
+	~virtual_texture_t();
+
+	virtual_texture_t(const virtual_texture_t& cpy) = delete;
+	virtual_texture_t& operator=(const virtual_texture_t& cpy) = delete;
+
+	// Cuts pages out of the mip chain of an image.
+	static page_loader_t image_loader(const image_t<glm::u8vec4>& image, size_t page_size = default_page_size, size_t border = default_border);
+
+	// Starts an asynchronous readback of the color attachment written by the feedback pass.
+	void read_feedback(const framebuffer_t& feedback);
+
+	// Requests a page and all of its ancestors for the next update().
+	void request(const virtual_page_t& page);
+
+	// Evaluates finished readbacks, uploads up to max_pages pages finished by the worker and queues up
+	// to max_pages missing pages for loading, coarse pages first. Returns the number of uploaded pages.
+	size_t update(size_t max_pages = 16);
+
+	// Blocks until the worker finished all queued pages, e.g. for a loading screen.
+	void wait_for_pages() const;
+
+	bool resident(const virtual_page_t& page) const;
+	size_t resident_pages() const;
+	// Pages queued, being loaded or waiting for their upload.
+	size_t loading_pages() const;
+	size_t pending_readbacks() const;
+
+	size_t width() const;
+	size_t height() const;
+	size_t page_size() const;
+	size_t border() const;
+	size_t levels() const;
+	size_t pages_x(size_t level = 0) const;
+	size_t pages_y(size_t level = 0) const;
+
+	const texture_t& cache() const;
+	const texture_t& page_table() const;
+
+	// Declares the samplers <name>_cache and <name>_pages, glpp_vt_<name>(uv) to sample the virtual
+	// texture and glpp_vt_feedback_<name>(uv, bias) to write the page request of the feedback pass.
+	std::string declaration(const std::string_view name) const;
+
+private:
+	struct slot_t {
+		virtual_page_t page;
+		std::uint64_t last_used = 0;
+		bool used = false;
+	};
+
+	struct loaded_page_t {
+		virtual_page_t page;
+		image_t<glm::u8vec4> tile;
+		// Set instead of tile, if the loader threw.
+		std::exception_ptr error;
+	};
+
+	// Loader thread and its queues, kept on the heap so the texture stays movable.
+	struct page_worker_t;
+
+	std::uint64_t page_key(const virtual_page_t& page) const;
+	void upload(const image_t<glm::u8vec4>& tile, size_t slot);
+	bool find_slot(size_t& slot) const;
+	void process_feedback(std::span<const std::byte> data);
+	void update_page_table();
+
+	size_t m_width;
+	size_t m_height;
+	size_t m_page_size;
+	size_t m_border;
+	size_t m_levels;
+	size_t m_cache_pages;
+	page_loader_t m_loader;
+
+	texture_t m_cache;
+	texture_t m_page_table;
+
+	std::vector<slot_t> m_slots;
+	std::unordered_map<std::uint64_t, size_t> m_resident;
+	std::unordered_set<std::uint64_t> m_requested;
+	std::vector<virtual_page_t> m_requests;
+	// Keys of the pages handed to the worker and not uploaded yet.
+	std::unordered_set<std::uint64_t> m_loading;
+	// Finished pages, which did not find a free slot yet.
+	std::deque<loaded_page_t> m_loaded;
+	std::optional<detail::frame_readback_ring_t> m_feedback;
+	std::uint64_t m_frame = 1;
+	bool m_page_table_dirty = true;
+	// Declared last, so the worker is stopped before the state above is destroyed.
+	std::unique_ptr<page_worker_t> m_worker;
+};
+
+}
@@ -0,0 +1,130 @@
+#include <glpp/core/object/texture_atlas/array.hpp>
+
+namespace glpp::core::object::texture_atlas {
+
+array_policy_t::array_policy_t(
+    const std::size_t width,
+    const std::size_t height,
+    const std::size_t initial_layers,
+    const image_format_t format,
+    const clamp_mode_t clamp_mode,
+    const filter_mode_t filter,
+    const mipmap_mode_t mipmap_mode,
+    const swizzle_mask_t swizzle_mask
+) :
+    m_width(width),
+    m_height(height),
+    m_format(format),
+    m_clamp_mode(clamp_mode),
+    m_filter(filter),
+    m_mipmap_mode(mipmap_mode),
+    m_swizzle_mask(swizzle_mask),
+    m_storage(width, height, std::max<size_t>(initial_layers, 1), format, clamp_mode, filter, mipmap_mode, swizzle_mask)
+{}
+
+bool array_policy_t::contains(const key_t key) const {
+    return key < m_used.size() && m_used[key];
+}
+
+size_t array_policy_t::size() const {
+    return std::count(m_used.begin(), m_used.end(), true);
+}
+
+size_t array_policy_t::max_size() const {
+    return texture_array_t::max_layers();
+}
+
+size_t array_policy_t::capacity() const {
+    return m_storage.layers();
+}
+
+void array_policy_t::free(const key_t key) {
+    if(!contains(key)) {
+        throw std::runtime_error("Trying to free unallocated subtexture.");
+    }
+    m_used[key] = false;
+    if(key+1 == m_used.size()) {
+        // Shrink the used range, so trailing layers are not kept in the free list.
+        while(!m_used.empty() && !m_used.back()) {
+            m_used.pop_back();
+        }
+        std::erase_if(m_free, [this](key_t free) { return free >= m_used.size(); });
+    } else {
+        m_free.push_back(key);
+    }
+}
+
+array_policy_t::slot_storage_t array_policy_t::slots() const {
+    return { m_storage.bind_to_texture_slot() };
+}
+
+std::string array_policy_t::texture_id(const std::string_view name, const std::string_view) const {
+    // All layers share a single sampler.
+    return std::string(name);
+}
+
+std::string array_policy_t::declaration(const std::string_view name) const {
+    return fmt::format("uniform sampler2DArray {}", name);
+}
+
+std::string array_policy_t::fetch(const std::string_view name, const std::string_view key, const std::string_view uv) const {
+    return fmt::format("texture({}, vec3({}, {}))", texture_id(name, key), uv, key);
+}
+
+array_policy_t::key_t array_policy_t::first_free_key() const {
+    if(!m_free.empty()) {
+        return m_free.back();
+    }
+    return m_used.size();
+}
+
+array_policy_t::key_storage_t array_policy_t::keys() const {
+    key_storage_t result;
+    result.reserve(size());
+    for(auto i = 0u; i < m_used.size(); ++i) {
+        if(m_used[i]) {
+            result.emplace_back(i);
+        }
+    }
+    return result;
+}
+
+table_record_t array_policy_t::record(const key_t key) const {
+    if(!contains(key)) {
+        throw std::runtime_error("Trying to access subtexture with key that is not allocated.");
+    }
+    return { glm::vec4(0.0f, 0.0f, 1.0f, 1.0f), key, detail::table_clamp_mode(m_clamp_mode), 1, 0 };
+}
+
+std::string array_policy_t::table_sampler(const std::string_view name) const {
+    return detail::table_sampler_2d_array(name);
+}
+
+void array_policy_t::take(const key_t key) {
+    if(key >= m_storage.layers()) {
+        if(key >= max_size()) {
+            throw std::runtime_error("bad_alloc: The texture array has no layer "+std::to_string(key)+".");
+        }
+        // Growing geometrically keeps the number of reallocations logarithmic.
+        reserve(std::min(std::max<size_t>(key+1, m_storage.layers()*2), max_size()));
+    }
+    if(key >= m_used.size()) {
+        for(auto layer = static_cast<key_t>(m_used.size()); layer < key; ++layer) {
+            m_free.push_back(layer);
+        }
+        m_used.resize(key+1, false);
+    } else {
+        std::erase(m_free, key);
+    }
+    m_used[key] = true;
+}
+
+void array_policy_t::reserve(size_t layers) {
+    texture_array_t storage { m_width, m_height, layers, m_format, m_clamp_mode, m_filter, m_mipmap_mode, m_swizzle_mask };
+    if(!m_used.empty()) {
+        storage.copy_layers(m_storage, 0, 0, m_used.size());
+    }
+    m_storage = std::move(storage);
+}
+
+} // namespace
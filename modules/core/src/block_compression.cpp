@@ -0,0 +1,728 @@
+#include "glpp/core/object/block_compression.hpp"
+#include "glpp/core/object/image_conversion.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#if (defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))) && defined(__GNUC__)
+	#define GLPP_COMPRESSION_X86
+	#include <immintrin.h>
+#endif
+
+namespace glpp::core::object::detail {
+
+namespace {
+
+// All per block data is stored as structure of arrays with a fixed length of 16 pixels, which are
+// four SSE or two AVX registers.
+constexpr size_t block_pixels = 16;
+using channel_t = std::array<float, block_pixels>;
+using indices_t = std::array<std::uint8_t, block_pixels>;
+
+struct block_t {
+	channel_t r, g, b, a;
+	std::array<bool, block_pixels> transparent {};
+};
+
+struct color_t {
+	float r, g, b;
+};
+
+struct encoded_t {
+	std::uint64_t bits;
+	float error;
+};
+
+struct statistics_t {
+	color_t mean { 0.0f, 0.0f, 0.0f };
+	color_t min { 255.0f, 255.0f, 255.0f };
+	color_t max { 0.0f, 0.0f, 0.0f };
+	// Upper triangle of the covariance matrix: rr, rg, rb, gg, gb, bb.
+	std::array<float, 6> covariance {};
+	size_t count = 0;
+};
+
+// Sums of the opaque pixels are accumulated in four partial sums of every fourth pixel, which are
+// added pairwise, so the SSE lanes produce the same bits as the scalar loop.
+float reduce(const std::array<float, 4>& partial) {
+	return (partial[0]+partial[1])+(partial[2]+partial[3]);
+}
+
+struct kernels_t {
+	// Sets indices[i] to the first closest palette entry of pixel i and best[i] to its squared distance.
+	void (*select_colors)(const block_t& block, const color_t* palette, size_t palette_size, channel_t& best, indices_t& indices);
+	void (*select_values)(const channel_t& values, const float* palette, size_t palette_size, channel_t& best, indices_t& indices);
+	// Mean, bounds and covariance of the opaque pixels.
+	statistics_t (*statistics)(const block_t& block);
+	// Range of the opaque pixels along axis through mean.
+	std::pair<float, float> (*project)(const block_t& block, color_t mean, color_t axis);
+};
+
+/*
+ * Scalar kernels, which define the results of all other instruction sets bit by bit.
+ */
+namespace scalar {
+
+void select_colors(const block_t& block, const color_t* palette, size_t palette_size, channel_t& best, indices_t& indices) {
+	best.fill(std::numeric_limits<float>::max());
+	indices.fill(0);
+	for(size_t p = 0; p < palette_size; ++p) {
+		for(size_t i = 0; i < block_pixels; ++i) {
+			const auto dr = block.r[i]-palette[p].r;
+			const auto dg = block.g[i]-palette[p].g;
+			const auto db = block.b[i]-palette[p].b;
+			const auto d = dr*dr+dg*dg+db*db;
+			if(d < best[i]) {
+				best[i] = d;
+				indices[i] = static_cast<std::uint8_t>(p);
+			}
+		}
+	}
+}
+
+void select_values(const channel_t& values, const float* palette, size_t palette_size, channel_t& best, indices_t& indices) {
+	best.fill(std::numeric_limits<float>::max());
+	indices.fill(0);
+	for(size_t p = 0; p < palette_size; ++p) {
+		for(size_t i = 0; i < block_pixels; ++i) {
+			const auto d = (values[i]-palette[p])*(values[i]-palette[p]);
+			if(d < best[i]) {
+				best[i] = d;
+				indices[i] = static_cast<std::uint8_t>(p);
+			}
+		}
+	}
+}
+
+statistics_t statistics(const block_t& block) {
+	statistics_t stats;
+	std::array<float, 4> r_sum {}, g_sum {}, b_sum {};
+	for(size_t i = 0; i < block_pixels; ++i) {
+		if(block.transparent[i]) continue;
+		r_sum[i%4] += block.r[i];
+		g_sum[i%4] += block.g[i];
+		b_sum[i%4] += block.b[i];
+		stats.min = { std::min(stats.min.r, block.r[i]), std::min(stats.min.g, block.g[i]), std::min(stats.min.b, block.b[i]) };
+		stats.max = { std::max(stats.max.r, block.r[i]), std::max(stats.max.g, block.g[i]), std::max(stats.max.b, block.b[i]) };
+		++stats.count;
+	}
+	if(stats.count == 0) return stats;
+
+	const auto n = static_cast<float>(stats.count);
+	stats.mean = { reduce(r_sum)/n, reduce(g_sum)/n, reduce(b_sum)/n };
+	std::array<std::array<float, 4>, 6> products {};
+	for(size_t i = 0; i < block_pixels; ++i) {
+		if(block.transparent[i]) continue;
+		const auto r = block.r[i]-stats.mean.r;
+		const auto g = block.g[i]-stats.mean.g;
+		const auto b = block.b[i]-stats.mean.b;
+		products[0][i%4] += r*r;
+		products[1][i%4] += r*g;
+		products[2][i%4] += r*b;
+		products[3][i%4] += g*g;
+		products[4][i%4] += g*b;
+		products[5][i%4] += b*b;
+	}
+	for(size_t k = 0; k < products.size(); ++k) {
+		stats.covariance[k] = reduce(products[k]);
+	}
+	return stats;
+}
+
+std::pair<float, float> project(const block_t& block, color_t mean, color_t axis) {
+	auto lo = std::numeric_limits<float>::max();
+	auto hi = std::numeric_limits<float>::lowest();
+	for(size_t i = 0; i < block_pixels; ++i) {
+		if(block.transparent[i]) continue;
+		const auto t =
+			(block.r[i]-mean.r)*axis.r+
+			(block.g[i]-mean.g)*axis.g+
+			(block.b[i]-mean.b)*axis.b;
+		lo = std::min(lo, t);
+		hi = std::max(hi, t);
+	}
+	return { lo, hi };
+}
+
+}
+
+constexpr kernels_t scalar_kernels {
+	scalar::select_colors,
+	scalar::select_values,
+	scalar::statistics,
+	scalar::project
+};
+
+#ifdef GLPP_COMPRESSION_X86
+
+// Compiled for SSE4.1 and AVX2 independent of the target of the build, only called after the runtime check.
+#define GLPP_SSE41 __attribute__((target("sse4.1")))
+#define GLPP_AVX2 __attribute__((target("avx2")))
+
+namespace sse41 {
+
+// All bits set in the lanes of opaque pixels i to i+3.
+GLPP_SSE41 __m128 opaque(const block_t& block, size_t i) {
+	std::int32_t transparent;
+	std::memcpy(&transparent, block.transparent.data()+i, sizeof(transparent));
+	const auto lanes = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(transparent));
+	return _mm_castsi128_ps(_mm_cmpeq_epi32(lanes, _mm_setzero_si128()));
+}
+
+GLPP_SSE41 void store_indices(std::uint8_t* dst, __m128i indices) {
+	const auto bytes = _mm_packus_epi16(_mm_packus_epi32(indices, indices), indices);
+	const auto packed = _mm_cvtsi128_si32(bytes);
+	std::memcpy(dst, &packed, sizeof(packed));
+}
+
+GLPP_SSE41 __m128i select(__m128i indices, size_t p, __m128 closer) {
+	return _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(indices), _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(p))), closer));
+}
+
+GLPP_SSE41 std::array<float, 4> lanes(__m128 v) {
+	std::array<float, 4> result;
+	_mm_storeu_ps(result.data(), v);
+	return result;
+}
+
+GLPP_SSE41 void select_colors(const block_t& block, const color_t* palette, size_t palette_size, channel_t& best, indices_t& indices) {
+	for(size_t i = 0; i < block_pixels; i += 4) {
+		const auto r = _mm_loadu_ps(block.r.data()+i);
+		const auto g = _mm_loadu_ps(block.g.data()+i);
+		const auto b = _mm_loadu_ps(block.b.data()+i);
+		auto best_distance = _mm_set1_ps(std::numeric_limits<float>::max());
+		auto best_index = _mm_setzero_si128();
+		for(size_t p = 0; p < palette_size; ++p) {
+			const auto dr = _mm_sub_ps(r, _mm_set1_ps(palette[p].r));
+			const auto dg = _mm_sub_ps(g, _mm_set1_ps(palette[p].g));
+			const auto db = _mm_sub_ps(b, _mm_set1_ps(palette[p].b));
+			const auto d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(dg, dg)), _mm_mul_ps(db, db));
+			const auto closer = _mm_cmplt_ps(d, best_distance);
+			best_distance = _mm_blendv_ps(best_distance, d, closer);
+			best_index = select(best_index, p, closer);
+		}
+		_mm_storeu_ps(best.data()+i, best_distance);
+		store_indices(indices.data()+i, best_index);
+	}
+}
+
+GLPP_SSE41 void select_values(const channel_t& values, const float* palette, size_t palette_size, channel_t& best, indices_t& indices) {
+	for(size_t i = 0; i < block_pixels; i += 4) {
+		const auto v = _mm_loadu_ps(values.data()+i);
+		auto best_distance = _mm_set1_ps(std::numeric_limits<float>::max());
+		auto best_index = _mm_setzero_si128();
+		for(size_t p = 0; p < palette_size; ++p) {
+			const auto dv = _mm_sub_ps(v, _mm_set1_ps(palette[p]));
+			const auto d = _mm_mul_ps(dv, dv);
+			const auto closer = _mm_cmplt_ps(d, best_distance);
+			best_distance = _mm_blendv_ps(best_distance, d, closer);
+			best_index = select(best_index, p, closer);
+		}
+		_mm_storeu_ps(best.data()+i, best_distance);
+		store_indices(indices.data()+i, best_index);
+	}
+}
+
+GLPP_SSE41 statistics_t statistics(const block_t& block) {
+	const auto zero = _mm_setzero_ps();
+	const auto full = _mm_set1_ps(255.0f);
+	auto r_sum = zero, g_sum = zero, b_sum = zero;
+	auto r_min = full, g_min = full, b_min = full;
+	auto r_max = zero, g_max = zero, b_max = zero;
+	statistics_t stats;
+	for(size_t i = 0; i < block_pixels; i += 4) {
+		const auto mask = opaque(block, i);
+		// Transparent pixels add zeros and do not move the bounds away from their initial values.
+		const auto r = _mm_and_ps(mask, _mm_loadu_ps(block.r.data()+i));
+		const auto g = _mm_and_ps(mask, _mm_loadu_ps(block.g.data()+i));
+		const auto b = _mm_and_ps(mask, _mm_loadu_ps(block.b.data()+i));
+		r_sum = _mm_add_ps(r_sum, r);
+		g_sum = _mm_add_ps(g_sum, g);
+		b_sum = _mm_add_ps(b_sum, b);
+		r_min = _mm_min_ps(r_min, _mm_blendv_ps(full, r, mask));
+		g_min = _mm_min_ps(g_min, _mm_blendv_ps(full, g, mask));
+		b_min = _mm_min_ps(b_min, _mm_blendv_ps(full, b, mask));
+		r_max = _mm_max_ps(r_max, r);
+		g_max = _mm_max_ps(g_max, g);
+		b_max = _mm_max_ps(b_max, b);
+		stats.count += std::popcount(static_cast<unsigned>(_mm_movemask_ps(mask)));
+	}
+	if(stats.count == 0) return stats;
+
+	const auto min = [](__m128 v) { const auto l = lanes(v); return *std::min_element(l.begin(), l.end()); };
+	const auto max = [](__m128 v) { const auto l = lanes(v); return *std::max_element(l.begin(), l.end()); };
+	stats.min = { min(r_min), min(g_min), min(b_min) };
+	stats.max = { max(r_max), max(g_max), max(b_max) };
+	const auto n = static_cast<float>(stats.count);
+	stats.mean = { reduce(lanes(r_sum))/n, reduce(lanes(g_sum))/n, reduce(lanes(b_sum))/n };
+
+	const auto r_mean = _mm_set1_ps(stats.mean.r);
+	const auto g_mean = _mm_set1_ps(stats.mean.g);
+	const auto b_mean = _mm_set1_ps(stats.mean.b);
+	__m128 products[6] { zero, zero, zero, zero, zero, zero };
+	for(size_t i = 0; i < block_pixels; i += 4) {
+		const auto mask = opaque(block, i);
+		const auto r = _mm_and_ps(mask, _mm_sub_ps(_mm_loadu_ps(block.r.data()+i), r_mean));
+		const auto g = _mm_and_ps(mask, _mm_sub_ps(_mm_loadu_ps(block.g.data()+i), g_mean));
+		const auto b = _mm_and_ps(mask, _mm_sub_ps(_mm_loadu_ps(block.b.data()+i), b_mean));
+		products[0] = _mm_add_ps(products[0], _mm_mul_ps(r, r));
+		products[1] = _mm_add_ps(products[1], _mm_mul_ps(r, g));
+		products[2] = _mm_add_ps(products[2], _mm_mul_ps(r, b));
+		products[3] = _mm_add_ps(products[3], _mm_mul_ps(g, g));
+		products[4] = _mm_add_ps(products[4], _mm_mul_ps(g, b));
+		products[5] = _mm_add_ps(products[5], _mm_mul_ps(b, b));
+	}
+	for(size_t k = 0; k < stats.covariance.size(); ++k) {
+		stats.covariance[k] = reduce(lanes(products[k]));
+	}
+	return stats;
+}
+
+GLPP_SSE41 std::pair<float, float> project(const block_t& block, color_t mean, color_t axis) {
+	const auto lowest = _mm_set1_ps(std::numeric_limits<float>::lowest());
+	const auto highest = _mm_set1_ps(std::numeric_limits<float>::max());
+	auto lo = highest;
+	auto hi = lowest;
+	for(size_t i = 0; i < block_pixels; i += 4) {
+		const auto mask = opaque(block, i);
+		const auto t = _mm_add_ps(
+			_mm_add_ps(
+				_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(block.r.data()+i), _mm_set1_ps(mean.r)), _mm_set1_ps(axis.r)),
+				_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(block.g.data()+i), _mm_set1_ps(mean.g)), _mm_set1_ps(axis.g))
+			),
+			_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(block.b.data()+i), _mm_set1_ps(mean.b)), _mm_set1_ps(axis.b))
+		);
+		lo = _mm_min_ps(lo, _mm_blendv_ps(highest, t, mask));
+		hi = _mm_max_ps(hi, _mm_blendv_ps(lowest, t, mask));
+	}
+	const auto lo_lanes = lanes(lo);
+	const auto hi_lanes = lanes(hi);
+	return { *std::min_element(lo_lanes.begin(), lo_lanes.end()), *std::max_element(hi_lanes.begin(), hi_lanes.end()) };
+}
+
+}
+
+constexpr kernels_t sse41_kernels {
+	sse41::select_colors,
+	sse41::select_values,
+	sse41::statistics,
+	sse41::project
+};
+
+namespace avx2 {
+
+// All bits set in the lanes of opaque pixels i to i+7.
+GLPP_AVX2 __m256 opaque(const block_t& block, size_t i) {
+	std::int64_t transparent;
+	std::memcpy(&transparent, block.transparent.data()+i, sizeof(transparent));
+	const auto lanes = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(transparent));
+	return _mm256_castsi256_ps(_mm256_cmpeq_epi32(lanes, _mm256_setzero_si256()));
+}
+
+GLPP_AVX2 void store_indices(std::uint8_t* dst, __m256i indices) {
+	const auto words = _mm_packus_epi32(_mm256_castsi256_si128(indices), _mm256_extracti128_si256(indices, 1));
+	_mm_storel_epi64(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(words, words));
+}
+
+GLPP_AVX2 __m256i select(__m256i indices, size_t p, __m256 closer) {
+	return _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(indices), _mm256_castsi256_ps(_mm256_set1_epi32(static_cast<int>(p))), closer));
+}
+
+GLPP_AVX2 void select_colors(const block_t& block, const color_t* palette, size_t palette_size, channel_t& best, indices_t& indices) {
+	for(size_t i = 0; i < block_pixels; i += 8) {
+		const auto r = _mm256_loadu_ps(block.r.data()+i);
+		const auto g = _mm256_loadu_ps(block.g.data()+i);
+		const auto b = _mm256_loadu_ps(block.b.data()+i);
+		auto best_distance = _mm256_set1_ps(std::numeric_limits<float>::max());
+		auto best_index = _mm256_setzero_si256();
+		for(size_t p = 0; p < palette_size; ++p) {
+			const auto dr = _mm256_sub_ps(r, _mm256_set1_ps(palette[p].r));
+			const auto dg = _mm256_sub_ps(g, _mm256_set1_ps(palette[p].g));
+			const auto db = _mm256_sub_ps(b, _mm256_set1_ps(palette[p].b));
+			const auto d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dr, dr), _mm256_mul_ps(dg, dg)), _mm256_mul_ps(db, db));
+			const auto closer = _mm256_cmp_ps(d, best_distance, _CMP_LT_OQ);
+			best_distance = _mm256_blendv_ps(best_distance, d, closer);
+			best_index = select(best_index, p, closer);
+		}
+		_mm256_storeu_ps(best.data()+i, best_distance);
+		store_indices(indices.data()+i, best_index);
+	}
+}
+
+GLPP_AVX2 void select_values(const channel_t& values, const float* palette, size_t palette_size, channel_t& best, indices_t& indices) {
+	for(size_t i = 0; i < block_pixels; i += 8) {
+		const auto v = _mm256_loadu_ps(values.data()+i);
+		auto best_distance = _mm256_set1_ps(std::numeric_limits<float>::max());
+		auto best_index = _mm256_setzero_si256();
+		for(size_t p = 0; p < palette_size; ++p) {
+			const auto dv = _mm256_sub_ps(v, _mm256_set1_ps(palette[p]));
+			const auto d = _mm256_mul_ps(dv, dv);
+			const auto closer = _mm256_cmp_ps(d, best_distance, _CMP_LT_OQ);
+			best_distance = _mm256_blendv_ps(best_distance, d, closer);
+			best_index = select(best_index, p, closer);
+		}
+		_mm256_storeu_ps(best.data()+i, best_distance);
+		store_indices(indices.data()+i, best_index);
+	}
+}
+
+GLPP_AVX2 std::pair<float, float> project(const block_t& block, color_t mean, color_t axis) {
+	const auto lowest = _mm256_set1_ps(std::numeric_limits<float>::lowest());
+	const auto highest = _mm256_set1_ps(std::numeric_limits<float>::max());
+	auto lo = highest;
+	auto hi = lowest;
+	for(size_t i = 0; i < block_pixels; i += 8) {
+		const auto mask = opaque(block, i);
+		const auto t = _mm256_add_ps(
+			_mm256_add_ps(
+				_mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(block.r.data()+i), _mm256_set1_ps(mean.r)), _mm256_set1_ps(axis.r)),
+				_mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(block.g.data()+i), _mm256_set1_ps(mean.g)), _mm256_set1_ps(axis.g))
+			),
+			_mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(block.b.data()+i), _mm256_set1_ps(mean.b)), _mm256_set1_ps(axis.b))
+		);
+		lo = _mm256_min_ps(lo, _mm256_blendv_ps(highest, t, mask));
+		hi = _mm256_max_ps(hi, _mm256_blendv_ps(lowest, t, mask));
+	}
+	std::array<float, 8> lo_lanes, hi_lanes;
+	_mm256_storeu_ps(lo_lanes.data(), lo);
+	_mm256_storeu_ps(hi_lanes.data(), hi);
+	return { *std::min_element(lo_lanes.begin(), lo_lanes.end()), *std::max_element(hi_lanes.begin(), hi_lanes.end()) };
+}
+
+}
+
+// The sums of the statistics keep the four partial sums of the SSE kernel.
+constexpr kernels_t avx2_kernels {
+	avx2::select_colors,
+	avx2::select_values,
+	sse41::statistics,
+	avx2::project
+};
+
+#endif
+
+const kernels_t& kernels() {
+	switch(conversion::simd_level()) {
+#ifdef GLPP_COMPRESSION_X86
+		case simd_level_t::sse2:
+			// SSE4.1 is not part of the x86-64 baseline, older CPUs use the scalar kernels.
+			return __builtin_cpu_supports("sse4.1") ? sse41_kernels : scalar_kernels;
+		case simd_level_t::avx2:
+			return avx2_kernels;
+#endif
+		default:
+			return scalar_kernels;
+	}
+}
+
+block_t load_block(const std::uint8_t* rgba, size_t width, size_t height, size_t bx, size_t by) {
+	block_t block;
+	for(size_t i = 0; i < block_pixels; ++i) {
+		// Blocks at the right and bottom border are padded by repeating the edge pixels.
+		const auto x = std::min(bx*4+i%4, width-1);
+		const auto y = std::min(by*4+i/4, height-1);
+		const auto* pixel = rgba+(y*width+x)*4;
+		block.r[i] = pixel[0];
+		block.g[i] = pixel[1];
+		block.b[i] = pixel[2];
+		block.a[i] = pixel[3];
+	}
+	return block;
+}
+
+void store(std::byte* dst, std::uint64_t bits) {
+	for(size_t i = 0; i < 8; ++i) {
+		dst[i] = static_cast<std::byte>(bits >> (8*i));
+	}
+}
+
+/* BC1 colors */
+
+std::uint16_t quantize_565(color_t c) {
+	const auto r = static_cast<std::uint16_t>(std::lround(std::clamp(c.r, 0.0f, 255.0f)*31.0f/255.0f));
+	const auto g = static_cast<std::uint16_t>(std::lround(std::clamp(c.g, 0.0f, 255.0f)*63.0f/255.0f));
+	const auto b = static_cast<std::uint16_t>(std::lround(std::clamp(c.b, 0.0f, 255.0f)*31.0f/255.0f));
+	return static_cast<std::uint16_t>(r << 11 | g << 5 | b);
+}
+
+color_t expand_565(std::uint16_t c) {
+	const auto r = (c >> 11) & 31;
+	const auto g = (c >> 5) & 63;
+	const auto b = c & 31;
+	return {
+		static_cast<float>(r << 3 | r >> 2),
+		static_cast<float>(g << 2 | g >> 4),
+		static_cast<float>(b << 3 | b >> 2)
+	};
+}
+
+color_t mix(color_t lhs, color_t rhs, float t) {
+	return { lhs.r+(rhs.r-lhs.r)*t, lhs.g+(rhs.g-lhs.g)*t, lhs.b+(rhs.b-lhs.b)*t };
+}
+
+// Encodes the block with the given endpoints and writes the chosen indices to indices.
+encoded_t encode_colors(const kernels_t& kernels, const block_t& block, color_t e0, color_t e1, bool three_color, indices_t& indices) {
+	auto c0 = quantize_565(e0);
+	auto c1 = quantize_565(e1);
+	// The order of the endpoints selects the mode: c0 > c1 is four color, c0 <= c1 three color.
+	if(three_color ? c0 > c1 : c0 < c1) std::swap(c0, c1);
+
+	const auto p0 = expand_565(c0);
+	const auto p1 = expand_565(c1);
+	const size_t palette_size = three_color || c0 == c1 ? 3 : 4;
+	const std::array<color_t, 4> palette = three_color || c0 == c1 ?
+		std::array<color_t, 4>{ p0, p1, mix(p0, p1, 0.5f), p0 } :
+		std::array<color_t, 4>{ p0, p1, mix(p0, p1, 1.0f/3.0f), mix(p0, p1, 2.0f/3.0f) };
+
+	channel_t best;
+	kernels.select_colors(block, palette.data(), palette_size, best, indices);
+
+	float error = 0.0f;
+	std::uint64_t bits = static_cast<std::uint64_t>(c0) | static_cast<std::uint64_t>(c1) << 16;
+	for(size_t i = 0; i < block_pixels; ++i) {
+		if(block.transparent[i]) {
+			indices[i] = 3;
+		} else {
+			error += best[i];
+		}
+		bits |= static_cast<std::uint64_t>(indices[i]) << (32+2*i);
+	}
+	return { bits, error };
+}
+
+// Solves the least squares problem for the endpoints, which minimizes the error for fixed indices.
+bool refine_colors(const block_t& block, const indices_t& indices, bool three_color, color_t& e0, color_t& e1) {
+	constexpr std::array<float, 4> four_color_weights { 1.0f, 0.0f, 2.0f/3.0f, 1.0f/3.0f };
+	constexpr std::array<float, 4> three_color_weights { 1.0f, 0.0f, 0.5f, 0.0f };
+	const auto& weights = three_color ? three_color_weights : four_color_weights;
+
+	float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+	color_t ax { 0.0f, 0.0f, 0.0f };
+	color_t bx { 0.0f, 0.0f, 0.0f };
+	for(size_t i = 0; i < block_pixels; ++i) {
+		if(block.transparent[i] || (three_color && indices[i] == 3)) continue;
+		const auto alpha = weights[indices[i]];
+		const auto beta = 1.0f-alpha;
+		aa += alpha*alpha;
+		ab += alpha*beta;
+		bb += beta*beta;
+		ax = { ax.r+alpha*block.r[i], ax.g+alpha*block.g[i], ax.b+alpha*block.b[i] };
+		bx = { bx.r+beta*block.r[i], bx.g+beta*block.g[i], bx.b+beta*block.b[i] };
+	}
+
+	const auto det = aa*bb-ab*ab;
+	if(std::abs(det) < 1e-6f) return false;
+	const auto solve = [&](float a, float b) {
+		return std::pair{ (bb*a-ab*b)/det, (aa*b-ab*a)/det };
+	};
+	const auto [r0, r1] = solve(ax.r, bx.r);
+	const auto [g0, g1] = solve(ax.g, bx.g);
+	const auto [b0, b1] = solve(ax.b, bx.b);
+	e0 = { r0, g0, b0 };
+	e1 = { r1, g1, b1 };
+	return true;
+}
+
+// Cheap endpoints from the bounding box, inset by 1/16 to reduce the influence of outliers.
+std::pair<color_t, color_t> bounding_box_endpoints(const statistics_t& stats) {
+	auto lo = stats.min;
+	auto hi = stats.max;
+	const color_t inset { (hi.r-lo.r)/16.0f, (hi.g-lo.g)/16.0f, (hi.b-lo.b)/16.0f };
+	lo = { lo.r+inset.r, lo.g+inset.g, lo.b+inset.b };
+	hi = { hi.r-inset.r, hi.g-inset.g, hi.b-inset.b };
+	// Select the diagonal of the box, which follows the correlation of the channels.
+	if(stats.covariance[1] < 0.0f) std::swap(lo.r, hi.r);
+	if(stats.covariance[4] < 0.0f) std::swap(lo.b, hi.b);
+	return { hi, lo };
+}
+
+// Endpoints along the principal axis of the colors, found by power iteration.
+std::pair<color_t, color_t> principal_axis_endpoints(const kernels_t& kernels, const block_t& block, const statistics_t& stats) {
+	const auto& c = stats.covariance;
+	color_t axis { stats.max.r-stats.min.r, stats.max.g-stats.min.g, stats.max.b-stats.min.b };
+	if(c[1] < 0.0f) axis.r = -axis.r;
+	if(c[4] < 0.0f) axis.b = -axis.b;
+	for(auto iteration = 0; iteration < 8; ++iteration) {
+		axis = {
+			c[0]*axis.r+c[1]*axis.g+c[2]*axis.b,
+			c[1]*axis.r+c[3]*axis.g+c[4]*axis.b,
+			c[2]*axis.r+c[4]*axis.g+c[5]*axis.b
+		};
+		const auto length = std::sqrt(axis.r*axis.r+axis.g*axis.g+axis.b*axis.b);
+		if(length < 1e-6f) return { stats.mean, stats.mean };
+		axis = { axis.r/length, axis.g/length, axis.b/length };
+	}
+
+	const auto [lo, hi] = kernels.project(block, stats.mean, axis);
+	return {
+		{ stats.mean.r+axis.r*hi, stats.mean.g+axis.g*hi, stats.mean.b+axis.b*hi },
+		{ stats.mean.r+axis.r*lo, stats.mean.g+axis.g*lo, stats.mean.b+axis.b*lo }
+	};
+}
+
+encoded_t encode_color_mode(const kernels_t& kernels, const block_t& block, const statistics_t& stats, bool three_color, compression_quality_t quality) {
+	auto [e0, e1] = quality == compression_quality_t::fast ?
+		bounding_box_endpoints(stats) :
+		principal_axis_endpoints(kernels, block, stats);
+
+	indices_t indices;
+	auto best = encode_colors(kernels, block, e0, e1, three_color, indices);
+	const auto iterations =
+		quality == compression_quality_t::fast ? 0 :
+		quality == compression_quality_t::normal ? 1 : 4;
+	for(auto iteration = 0; iteration < iterations && best.error > 0.0f; ++iteration) {
+		if(!refine_colors(block, indices, three_color, e0, e1)) break;
+		indices_t refined_indices;
+		const auto refined = encode_colors(kernels, block, e0, e1, three_color, refined_indices);
+		if(refined.error >= best.error) break;
+		best = refined;
+		indices = refined_indices;
+	}
+	return best;
+}
+
+std::uint64_t encode_bc1(const kernels_t& kernels, const block_t& block, bool four_color_only, compression_quality_t quality) {
+	const auto stats = kernels.statistics(block);
+	if(stats.count == 0) {
+		// Fully transparent block: three color mode with equal endpoints and all indices set to 3.
+		return 0xFFFFFFFF00000000ull;
+	}
+	const auto has_transparency = stats.count != block_pixels;
+	if(has_transparency) {
+		return encode_color_mode(kernels, block, stats, true, quality).bits;
+	}
+	auto best = encode_color_mode(kernels, block, stats, false, quality);
+	if(!four_color_only && quality == compression_quality_t::high) {
+		const auto three_color = encode_color_mode(kernels, block, stats, true, quality);
+		if(three_color.error < best.error) best = three_color;
+	}
+	return best.bits;
+}
+
+/* BC4 channels */
+
+encoded_t encode_channel(const kernels_t& kernels, const channel_t& values, float a0, float a1, bool six_values) {
+	std::array<float, 8> palette { a0, a1 };
+	if(six_values) {
+		for(auto i = 2; i < 6; ++i) palette[i] = ((6-i)*a0+(i-1)*a1)/5.0f;
+		palette[6] = 0.0f;
+		palette[7] = 255.0f;
+	} else {
+		for(auto i = 2; i < 8; ++i) palette[i] = ((8-i)*a0+(i-1)*a1)/7.0f;
+	}
+	// With equal endpoints the block is decoded in six value mode, only the first index is used.
+	const size_t palette_size = a0 == a1 ? 1 : 8;
+
+	channel_t best;
+	indices_t indices;
+	kernels.select_values(values, palette.data(), palette_size, best, indices);
+
+	float error = 0.0f;
+	std::uint64_t bits = static_cast<std::uint64_t>(a0) | static_cast<std::uint64_t>(a1) << 8;
+	for(size_t i = 0; i < block_pixels; ++i) {
+		error += best[i];
+		bits |= static_cast<std::uint64_t>(indices[i]) << (16+3*i);
+	}
+	return { bits, error };
+}
+
+std::uint64_t encode_bc4(const kernels_t& kernels, const channel_t& values, compression_quality_t quality) {
+	const auto [min, max] = std::minmax_element(values.begin(), values.end());
+	auto best = encode_channel(kernels, values, *max, *min, false);
+	if(quality != compression_quality_t::high || best.error == 0.0f) return best.bits;
+
+	// Shrinking the range often lowers the error, because the outermost values are represented
+	// exactly by the endpoints anyway.
+	for(auto hi = 0; hi < 4; ++hi) {
+		for(auto lo = 0; lo < 4; ++lo) {
+			const auto a0 = *max-static_cast<float>(hi);
+			const auto a1 = *min+static_cast<float>(lo);
+			if(a0 <= a1) continue;
+			const auto candidate = encode_channel(kernels, values, a0, a1, false);
+			if(candidate.error < best.error) best = candidate;
+		}
+	}
+
+	// The six value mode represents 0 and 255 exactly and interpolates between the remaining values.
+	auto inner_min = 255.0f;
+	auto inner_max = 0.0f;
+	for(const auto value : values) {
+		if(value == 0.0f || value == 255.0f) continue;
+		inner_min = std::min(inner_min, value);
+		inner_max = std::max(inner_max, value);
+	}
+	if(inner_min < inner_max) {
+		const auto candidate = encode_channel(kernels, values, inner_min, inner_max, true);
+		if(candidate.error < best.error) best = candidate;
+	}
+	return best.bits;
+}
+
+void encode_block(const kernels_t& kernels, const block_t& block, image_format_t format, compression_quality_t quality, std::byte* dst) {
+	switch(format) {
+		case image_format_t::bc1_rgb:
+		case image_format_t::bc1_srgb:
+			store(dst, encode_bc1(kernels, block, false, quality));
+			break;
+		case image_format_t::bc1_rgba:
+		case image_format_t::bc1_srgba: {
+			auto masked = block;
+			for(size_t i = 0; i < block_pixels; ++i) masked.transparent[i] = block.a[i] < 128.0f;
+			store(dst, encode_bc1(kernels, masked, false, quality));
+			break;
+		}
+		case image_format_t::bc3:
+		case image_format_t::bc3_srgba:
+			// The color block of BC3 is always decoded in four color mode.
+			store(dst, encode_bc4(kernels, block.a, quality));
+			store(dst+8, encode_bc1(kernels, block, true, quality));
+			break;
+		case image_format_t::bc4:
+			store(dst, encode_bc4(kernels, block.r, quality));
+			break;
+		case image_format_t::bc5:
+			store(dst, encode_bc4(kernels, block.r, quality));
+			store(dst+8, encode_bc4(kernels, block.g, quality));
+			break;
+		default:
+			throw std::runtime_error("Block compression into this image format is not supported.");
+	}
+}
+
+}
+
+std::vector<std::byte> compress_rgba8(
+	const std::uint8_t* rgba,
+	size_t width,
+	size_t height,
+	image_format_t format,
+	compression_quality_t quality
+) {
+	if(!is_encodable(format)) {
+		throw std::runtime_error("Block compression into this image format is not supported.");
+	}
+	std::vector<std::byte> result(compressed_image_size(format, width, height));
+	if(result.empty()) return result;
+
+	const auto blocks_x = (width+3)/4;
+	const auto blocks_y = (height+3)/4;
+	const auto block_size = compressed_block_size(format);
+	const auto& selected = kernels();
+	// Each block costs roughly as much as filtering a few hundred pixels.
+	parallel_rows(blocks_y, blocks_x*256, [&](size_t begin, size_t end) {
+		for(auto by = begin; by < end; ++by) {
+			for(size_t bx = 0; bx < blocks_x; ++bx) {
+				const auto block = load_block(rgba, width, height, bx, by);
+				encode_block(selected, block, format, quality, result.data()+(by*blocks_x+bx)*block_size);
+			}
+		}
+	});
+	return result;
+}
+
+}
@@ -0,0 +1,48 @@
+#include "glpp/core/object/compressed_image.hpp"
+#include <stdexcept>
+#include <string>
+
+namespace glpp::core::object {
+
+compressed_image_t::compressed_image_t(image_format_t format, std::vector<level_t> levels) :
+	m_format(format),
+	m_levels(std::move(levels))
+{
+	if(!is_block_compressed(format)) {
+		throw std::runtime_error("compressed_image_t requires a block compressed image format.");
+	}
+	if(m_levels.empty()) {
+		throw std::runtime_error("compressed_image_t requires at least one level.");
+	}
+	for(const auto& level : m_levels) {
+		if(level.data.size() != compressed_image_size(format, level.width, level.height)) {
+			throw std::runtime_error(
+				"Compressed level of size ["+std::to_string(level.width)+", "+std::to_string(level.height)+"]"
+				" holds "+std::to_string(level.data.size())+" bytes, expected "+
+				std::to_string(compressed_image_size(format, level.width, level.height))+"."
+			);
+		}
+	}
+}
+
+image_format_t compressed_image_t::format() const noexcept {
+	return m_format;
+}
+
+size_t compressed_image_t::width() const noexcept {
+	return m_levels.empty() ? 0 : m_levels.front().width;
+}
+
+size_t compressed_image_t::height() const noexcept {
+	return m_levels.empty() ? 0 : m_levels.front().height;
+}
+
+const std::vector<compressed_image_t::level_t>& compressed_image_t::levels() const noexcept {
+	return m_levels;
+}
+
+const compressed_image_t::level_t& compressed_image_t::level(size_t index) const {
+	return m_levels.at(index);
+}
+
+}
@@ -0,0 +1,52 @@
+#include "glpp/core/object/fence.hpp"
+#include <stdexcept>
+#include <utility>
+
+namespace glpp::core::object {
+
+fence_t::fence_t() :
+	m_sync(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0))
+{}
+
+fence_t::~fence_t() {
+	if(m_sync) {
+		glDeleteSync(m_sync);
+	}
+}
+
+fence_t::fence_t(fence_t&& mov) noexcept :
+	m_sync(std::exchange(mov.m_sync, GLsync{}))
+{}
+
+fence_t& fence_t::operator=(fence_t&& mov) noexcept {
+	if(this != &mov) {
+		if(m_sync) {
+			glDeleteSync(m_sync);
+		}
+		m_sync = std::exchange(mov.m_sync, GLsync{});
+	}
+	return *this;
+}
+
+bool fence_t::signaled() const {
+	return wait(std::chrono::nanoseconds::zero());
+}
+
+bool fence_t::wait(std::chrono::nanoseconds timeout) const {
+	const auto flags = timeout.count() > 0 ? GL_SYNC_FLUSH_COMMANDS_BIT : 0;
+	switch(glClientWaitSync(m_sync, flags, static_cast<GLuint64>(timeout.count()))) {
+		case GL_ALREADY_SIGNALED:
+		case GL_CONDITION_SATISFIED:
+			return true;
+		case GL_TIMEOUT_EXPIRED:
+			return false;
+		default:
+			throw std::runtime_error("Waiting for fence failed.");
+	}
+}
+
+GLsync fence_t::id() const noexcept {
+	return m_sync;
+}
+
+}
@@ -1,4 +1,6 @@
 #include "glpp/core/object/framebuffer.hpp"
+#include <algorithm>
+#include <string>
 
 namespace glpp::core::object {
 
@@ -52,9 +54,54 @@ void framebuffer_t::attach(const texture_t& texture, attachment_t attatchment) {
 	if(width() != texture.width() || height() != texture.height()) {
 		throw std::runtime_error("Can not attach texture with different resolution.");
 	}
+	attach_samples(attatchment, 0);
+	if(attatchment == attachment_t::color) {
+		m_integer_color = detail::is_integer_format(static_cast<GLenum>(texture.format()));
+	}
+	glNamedFramebufferTexture(id(), static_cast<GLenum>(attatchment), texture.id(), 0);
+}
+
+void framebuffer_t::attach(const multisample_texture_t& texture, attachment_t attatchment) {
+	if(width() != texture.width() || height() != texture.height()) {
+		throw std::runtime_error("Can not attach texture with different resolution.");
+	}
+	attach_samples(attatchment, texture.samples());
+	if(attatchment == attachment_t::color) {
+		m_integer_color = detail::is_integer_format(static_cast<GLenum>(texture.format()));
+	}
 	glNamedFramebufferTexture(id(), static_cast<GLenum>(attatchment), texture.id(), 0);
 }
 
+void framebuffer_t::attach(const renderbuffer_t& renderbuffer, attachment_t attatchment) {
+	if(width() != renderbuffer.width() || height() != renderbuffer.height()) {
+		throw std::runtime_error("Can not attach renderbuffer with different resolution.");
+	}
+	attach_samples(attatchment, renderbuffer.samples());
+	if(attatchment == attachment_t::color) {
+		m_integer_color = detail::is_integer_format(static_cast<GLenum>(renderbuffer.format()));
+	}
+	glNamedFramebufferRenderbuffer(id(), static_cast<GLenum>(attatchment), GL_RENDERBUFFER, renderbuffer.id());
+}
+
+void framebuffer_t::attach_samples(attachment_t attachment, size_t samples) {
+	// A depth stencil attachment occupies the depth and the stencil attachment point.
+	std::vector<GLenum> points { static_cast<GLenum>(attachment) };
+	if(attachment == attachment_t::depth_stencil) {
+		points = { GL_DEPTH_ATTACHMENT, GL_STENCIL_ATTACHMENT };
+	}
+	for(const auto& [point, attached] : m_attachment_samples) {
+		if(attached != samples && std::ranges::find(points, point) == points.end()) {
+			throw std::runtime_error(
+				"Can not attach a buffer with "+std::to_string(samples)+" samples to a framebuffer with "+std::to_string(attached)+" samples."
+			);
+		}
+	}
+	for(const auto point : points) {
+		m_attachment_samples[point] = samples;
+	}
+	m_samples = samples;
+}
+
 void framebuffer_t::bind(framebuffer_target_t target) {
 	if(glCheckNamedFramebufferStatus(id(), GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
 		throw std::runtime_error("Framebuffer is not complete and can not be bound. Attach at least one buffer before binding.");
@@ -66,6 +113,84 @@ void framebuffer_t::bind_default_framebuffer(framebuffer_target_t target) {
 	glBindFramebuffer(static_cast<GLenum>(target), 0);
 }
 
+void framebuffer_t::blit_to(
+	const framebuffer_t& target,
+	size_t x,
+	size_t y,
+	size_t width,
+	size_t height,
+	size_t target_x,
+	size_t target_y,
+	size_t target_width,
+	size_t target_height,
+	blit_mask_t mask,
+	filter_mode_t filter
+) const {
+	if(x+width > m_width || y+height > m_height || target_x+target_width > target.width() || target_y+target_height > target.height()) {
+		throw std::runtime_error("Trying to blit a framebuffer region out of range.");
+	}
+	if(mask != blit_mask_t::color && filter != filter_mode_t::nearest) {
+		throw std::runtime_error("Depth and stencil buffers can only be blitted with nearest filtering.");
+	}
+	if((m_samples > 0 || target.samples() > 0) && (width != target_width || height != target_height)) {
+		throw std::runtime_error("Multisampled framebuffers can only be blitted into regions of the same size.");
+	}
+	if(m_samples > 0 && target.samples() > 0 && m_samples != target.samples()) {
+		throw std::runtime_error("Multisampled framebuffers can only be blitted into framebuffers with the same number of samples.");
+	}
+	glBlitNamedFramebuffer(
+		id(),
+		target.id(),
+		x, y, x+width, y+height,
+		target_x, target_y, target_x+target_width, target_y+target_height,
+		static_cast<GLbitfield>(mask),
+		static_cast<GLenum>(filter)
+	);
+}
+
+void framebuffer_t::blit_to(const framebuffer_t& target, blit_mask_t mask, filter_mode_t filter) const {
+	// Depth and stencil are never filtered.
+	if(mask != blit_mask_t::color) {
+		filter = filter_mode_t::nearest;
+	}
+	blit_to(target, 0, 0, m_width, m_height, 0, 0, target.width(), target.height(), mask, filter);
+}
+
+void framebuffer_t::resolve(const framebuffer_t& target, blit_mask_t mask) const {
+	if(target.width() != m_width || target.height() != m_height) {
+		throw std::runtime_error("Framebuffers can only be resolved into framebuffers of the same size.");
+	}
+	blit_to(target, 0, 0, m_width, m_height, 0, 0, m_width, m_height, mask, filter_mode_t::nearest);
+}
+
+pixel_readback_t<float> framebuffer_t::async_depth_read(size_t x, size_t y, size_t width, size_t height) const {
+	return pixel_readback_t<float>(read_to_buffer(x, y, width, height, GL_DEPTH_COMPONENT, GL_FLOAT, sizeof(float)), width, height);
+}
+
+std::shared_ptr<const detail::readback_buffer_t> framebuffer_t::read_to_buffer(
+	size_t x,
+	size_t y,
+	size_t width,
+	size_t height,
+	GLenum format,
+	GLenum type,
+	size_t pixel_size
+) const {
+	// Errors of the copy would only show up as garbage a few frames later.
+	if(x+width > m_width || y+height > m_height) {
+		throw std::runtime_error("Trying to read pixels outside of the framebuffer.");
+	}
+	if(m_samples > 0) {
+		throw std::runtime_error("Multisampled framebuffers need to be resolved before reading pixels.");
+	}
+	auto buffer = m_readbacks.acquire(width*height*pixel_size);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, id());
+	detail::pack_pixels(*buffer, [&]() {
+		glReadPixels(x, y, width, height, format, type, nullptr);
+	});
+	return buffer;
+}
+
 size_t framebuffer_t::width() const {
 	return m_width;
 }
@@ -74,4 +199,69 @@ size_t framebuffer_t::height() const {
 	return m_height;
 }
 
+size_t framebuffer_t::samples() const {
+	return m_samples;
+}
+
+}
+
+namespace glpp::core::object::detail {
+
+frame_readback_ring_t::frame_readback_ring_t(size_t width, size_t height, GLenum format, size_t pixel_size, size_t depth) :
+	m_width(width),
+	m_height(height),
+	m_format(format)
+{
+	m_ring.reserve(depth);
+	for(size_t i = 0; i < depth; ++i) {
+		m_ring.emplace_back(width*height*pixel_size);
+	}
+}
+
+void frame_readback_ring_t::capture(const framebuffer_t& framebuffer) {
+	if(framebuffer.width() != m_width || framebuffer.height() != m_height) {
+		throw std::runtime_error(
+			"Framebuffer of size "+std::to_string(framebuffer.width())+"x"+std::to_string(framebuffer.height())+
+			" does not match the frames of size "+std::to_string(m_width)+"x"+std::to_string(m_height)+"."
+		);
+	}
+	if(framebuffer.samples() > 0) {
+		throw std::runtime_error("Multisampled framebuffers need to be resolved before they are captured.");
+	}
+	if(full()) {
+		throw std::runtime_error("All readback buffers are in use.");
+	}
+	// Pending copies always occupy consecutive buffers, so the next one is free.
+	const auto slot = m_next_slot;
+	m_next_slot = (m_next_slot+1)%m_ring.size();
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer.id());
+	glNamedFramebufferReadBuffer(framebuffer.id(), framebuffer.id() == 0 ? GL_BACK : GL_COLOR_ATTACHMENT0);
+	pack_pixels(m_ring[slot], [&]() {
+		glReadPixels(0, 0, m_width, m_height, m_format, GL_UNSIGNED_BYTE, nullptr);
+	});
+	m_pending.push_back(slot);
+}
+
+void frame_readback_ring_t::wait() const {
+	if(!m_pending.empty()) {
+		m_ring[m_pending.front()].wait();
+	}
+}
+
+bool frame_readback_ring_t::full() const {
+	return m_pending.size() == m_ring.size();
+}
+
+size_t frame_readback_ring_t::pending() const {
+	return m_pending.size();
+}
+
+size_t frame_readback_ring_t::width() const {
+	return m_width;
+}
+
+size_t frame_readback_ring_t::height() const {
+	return m_height;
+}
+
 }
@@ -3,6 +3,24 @@
 
 namespace glpp::core::object::texture_atlas {
 
+namespace detail {
+
+std::string clamp_uv(clamp_mode_t clamp_mode, glm::vec2 texel_width) {
+    switch(clamp_mode) {
+        case clamp_mode_t::clamp_to_border:
+            return fmt::format("uv+((uv-clamp(uv, vec2(-{0}, -{1}), vec2(1)+vec2({0}, {1})))*10000000000.0)", texel_width.x, texel_width.y);
+        case clamp_mode_t::clamp_to_edge:
+            return "clamp(uv, 0, 1)";
+        case clamp_mode_t::mirrored_repeat:
+            return "abs(uv-round(uv/2)*2)";
+        case clamp_mode_t::repeat:
+            return "mod(uv, vec2(1.0))";
+    }
+    return "";
+}
+
+}
+
 grid_policy_t::grid_policy_t(
     const std::uint32_t cols,
     const std::uint32_t rows,
@@ -17,10 +35,14 @@ grid_policy_t::grid_policy_t(
     m_rows(rows),
     m_cols(cols),
     m_width(sub_texture_width),
-    m_height(sub_texture_width),
+    m_height(sub_texture_height),
+    m_max_rows(rows),
     m_keys(rows*cols, false),
+    m_format(format),
     m_clamp_mode(clamp_mode),
     m_filter_mode(filter_mode),
+    m_mipmap_mode(mipmap_mode),
+    m_swizzle_mask(swizzle_mask),
     m_storage{
         storage_t::value_type{
             (sub_texture_width+padding())*cols,
@@ -70,24 +92,7 @@ std::string grid_policy_t::texture_id(const std::string_view name, const std::st
 }
 
 std::string grid_policy_t::declaration(const std::string_view name) const {
-    auto clamp_function = [this](clamp_mode_t clamp_mode) -> std::string {
-        const glm::vec2 texel_width = glm::vec2(1.0f)/glm::vec2(m_width, m_height);
-        switch(clamp_mode) {
-            case clamp_mode_t::clamp_to_border:
-                return fmt::format("uv+((uv-clamp(uv, vec2(-{0}, -{1}), vec2(1)+vec2({0}, {1})))*10000000000.0)", texel_width.x, texel_width.y);
-            case clamp_mode_t::clamp_to_edge:
-                return fmt::format(
-                    "clamp(uv, 0, 1)"
-                    // "vec2(clamp(uv.x, {}, {}), clamp(uv.y, {}, {}))",
-                    // texel_offset.x, 1.0f-texel_offset.x, texel_offset.y, 1.0f-texel_offset.y
-                );
-            case clamp_mode_t::mirrored_repeat:
-                return "abs(uv-round(uv/2)*2)";
-            case clamp_mode_t::repeat:
-                return "mod(uv, vec2(1.0))";
-        }
-        return "";
-    }(m_clamp_mode);
+    const auto clamp_function = detail::clamp_uv(m_clamp_mode, glm::vec2(1.0f)/glm::vec2(m_width, m_height));
 
     const auto sub_texture_width = glm::vec2(m_width+2, m_height+2);
     const auto border_scale = glm::vec2(m_width, m_height)/sub_texture_width;
@@ -113,6 +118,10 @@ std::string grid_policy_t::fetch(const std::string_view name, const std::string_
 grid_policy_t::key_t grid_policy_t::first_free_key() const {
     auto first_free_it = std::find(m_keys.begin(), m_keys.end(), false);
     if(first_free_it == m_keys.end()) {
+        if(m_rows < m_max_rows) {
+            // The first key of the next row, alloc grows the grid on demand.
+            return m_keys.size();
+        }
         throw std::runtime_error("bad_alloc: All texture atlas slots are already allocated.");
     }
     auto first_free_pos = std::distance(m_keys.begin(), first_free_it);
@@ -130,4 +139,69 @@ grid_policy_t::key_storage_t grid_policy_t::keys() const {
     return result;
 }
 
-} // namespace
+table_record_t grid_policy_t::record(const key_t key) const {
+    if(!contains(key)) {
+        throw std::runtime_error("Trying to access subtexture with key that is not allocated.");
+    }
+    const auto [col, row] = position(key);
+    const auto texture_width = static_cast<float>(m_storage[0].width());
+    const auto texture_height = static_cast<float>(m_storage[0].height());
+    const auto border = padding()/2;
+    return {
+        glm::vec4(
+            (col*(m_width+padding())+border)/texture_width,
+            (row*(m_height+padding())+border)/texture_height,
+            m_width/texture_width,
+            m_height/texture_height
+        ),
+        0,
+        detail::table_clamp_mode(m_clamp_mode),
+        1,
+        0
+    };
+}
+
+std::string grid_policy_t::table_sampler(const std::string_view name) const {
+    return detail::table_sampler_2d(name);
+}
+
+std::uint32_t grid_policy_t::rows() const {
+    return m_rows;
+}
+
+std::uint32_t grid_policy_t::max_rows() const {
+    return m_max_rows;
+}
+
+void grid_policy_t::set_max_rows(const std::uint32_t max_rows) {
+    m_max_rows = std::max(max_rows, m_rows);
+}
+
+void grid_policy_t::grow(const std::uint32_t rows) {
+    if(rows <= m_rows) {
+        return;
+    }
+    storage_t::value_type storage {
+        (m_width+padding())*m_cols,
+        (m_height+padding())*rows,
+        m_format,
+        m_clamp_mode,
+        m_filter_mode,
+        m_mipmap_mode,
+        m_swizzle_mask
+    };
+    // Keys are assigned row by row, so the existing cells keep their position in the larger texture.
+    storage.copy(m_storage[0], 0, 0, 0, 0, m_storage[0].width(), m_storage[0].height());
+    storage.generate_mipmaps();
+    m_storage[0] = std::move(storage);
+    m_rows = rows;
+    m_max_rows = std::max(m_max_rows, rows);
+    m_keys.resize(m_rows*m_cols, false);
+    m_relocations.notify(keys());
+}
+
+relocation_notifier_t<grid_policy_t::key_t>& grid_policy_t::relocations() {
+    return m_relocations;
+}
+
+} // namespace
\ No newline at end of file
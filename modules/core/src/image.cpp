@@ -0,0 +1,230 @@
+#include "glpp/core/object/image.hpp"
+#include "parallel.hpp"
+#include <array>
+#include <cmath>
+#include <numbers>
+
+namespace glpp::core::object::detail {
+
+namespace {
+
+struct filter_taps_t {
+	// For every destination pixel the range [offset[i], offset[i+1]) in index and weight.
+	std::vector<size_t> offset;
+	std::vector<size_t> index;
+	std::vector<float> weight;
+};
+
+double bessel_i0(double x) {
+	double sum = 1.0;
+	double term = 1.0;
+	for(int k = 1; k < 32; ++k) {
+		term *= (x/(2.0*k))*(x/(2.0*k));
+		sum += term;
+	}
+	return sum;
+}
+
+double sinc(double x) {
+	return x == 0.0 ? 1.0 : std::sin(std::numbers::pi*x)/(std::numbers::pi*x);
+}
+
+double kaiser_kernel(double x) {
+	constexpr double width = 3.0;
+	constexpr double alpha = 4.0;
+	if(std::abs(x) >= width) return 0.0;
+	const auto t = x/width;
+	const auto window = bessel_i0(alpha*std::sqrt(1.0-t*t))/bessel_i0(alpha);
+	return sinc(x)*window;
+}
+
+double triangle_kernel(double x) {
+	x = std::abs(x);
+	return x < 1.0 ? 1.0-x : 0.0;
+}
+
+// Catmull-Rom spline, interpolates the source pixels exactly when magnifying.
+double cubic_kernel(double x) {
+	x = std::abs(x);
+	if(x < 1.0) return (1.5*x-2.5)*x*x+1.0;
+	if(x < 2.0) return ((-0.5*x+2.5)*x-4.0)*x+2.0;
+	return 0.0;
+}
+
+double lanczos_kernel(double x) {
+	constexpr double width = 3.0;
+	if(std::abs(x) >= width) return 0.0;
+	return sinc(x)*sinc(x/width);
+}
+
+struct kernel_t {
+	double support;
+	double (*weight)(double x);
+};
+
+kernel_t kernel(mip_filter_t filter) {
+	switch(filter) {
+		case mip_filter_t::bilinear:
+			return { 1.0, triangle_kernel };
+		case mip_filter_t::bicubic:
+			return { 2.0, cubic_kernel };
+		case mip_filter_t::lanczos:
+			return { 3.0, lanczos_kernel };
+		default:
+			return { 3.0, kaiser_kernel };
+	}
+}
+
+filter_taps_t build_taps(size_t src_size, size_t dst_size, mip_filter_t filter) {
+	filter_taps_t taps;
+	taps.offset.reserve(dst_size+1);
+	taps.offset.push_back(0);
+
+	const auto scale = static_cast<double>(src_size)/static_cast<double>(dst_size);
+	for(size_t i = 0; i < dst_size; ++i) {
+		const auto begin = taps.index.size();
+		if(filter == mip_filter_t::box) {
+			// Exact area coverage of the destination pixel in source space.
+			const auto lo = i*scale;
+			const auto hi = (i+1)*scale;
+			for(auto j = static_cast<size_t>(lo); j < src_size && static_cast<double>(j) < hi; ++j) {
+				const auto coverage = std::min<double>(j+1, hi)-std::max<double>(j, lo);
+				if(coverage <= 0.0) continue;
+				taps.index.push_back(j);
+				taps.weight.push_back(static_cast<float>(coverage));
+			}
+		} else {
+			// Minification widens the kernel by the scale factor to stay band limited.
+			const auto [radius, weight_of] = kernel(filter);
+			const auto support = radius*std::max(scale, 1.0);
+			const auto center = (i+0.5)*scale;
+			const auto first = static_cast<std::ptrdiff_t>(std::floor(center-support));
+			const auto last = static_cast<std::ptrdiff_t>(std::ceil(center+support));
+			for(auto j = first; j <= last; ++j) {
+				const auto weight = weight_of((j+0.5-center)/std::max(scale, 1.0));
+				if(weight == 0.0) continue;
+				const auto clamped = static_cast<size_t>(std::clamp<std::ptrdiff_t>(j, 0, src_size-1));
+				taps.index.push_back(clamped);
+				taps.weight.push_back(static_cast<float>(weight));
+			}
+		}
+
+		float sum = 0.0f;
+		for(auto k = begin; k < taps.weight.size(); ++k) sum += taps.weight[k];
+		for(auto k = begin; k < taps.weight.size(); ++k) taps.weight[k] /= sum;
+		taps.offset.push_back(taps.index.size());
+	}
+	return taps;
+}
+
+// A fixed channel count lets the compiler unroll the inner loop, rgba rows use the conversion kernels.
+template <size_t Channels>
+void filter_row(const float* __restrict src, float* __restrict dst, const filter_taps_t& taps, size_t dst_width) {
+	for(size_t x = 0; x < dst_width; ++x) {
+		std::array<float, Channels> sum {};
+		for(auto k = taps.offset[x]; k < taps.offset[x+1]; ++k) {
+			const auto* in = src+taps.index[k]*Channels;
+			const auto weight = taps.weight[k];
+			for(size_t c = 0; c < Channels; ++c) {
+				sum[c] += weight*in[c];
+			}
+		}
+		std::copy(sum.begin(), sum.end(), dst+x*Channels);
+	}
+}
+
+void filter_row(const float* src, size_t src_width, float* dst, const filter_taps_t& taps, size_t dst_width, size_t channels) {
+	switch(channels) {
+		case 1: return filter_row<1>(src, dst, taps, dst_width);
+		case 2: return filter_row<2>(src, dst, taps, dst_width);
+		case 3: return filter_row<3>(src, dst, taps, dst_width);
+		// A pixel fills a vector register of the conversion kernels.
+		case 4: return conversion::filter_rgba(
+			std::span(src, src_width*4), std::span(dst, dst_width*4), taps.offset, taps.index, taps.weight
+		);
+	}
+	for(size_t x = 0; x < dst_width; ++x) {
+		auto* out = dst+x*channels;
+		std::fill_n(out, channels, 0.0f);
+		for(auto k = taps.offset[x]; k < taps.offset[x+1]; ++k) {
+			const auto* in = src+taps.index[k]*channels;
+			for(size_t c = 0; c < channels; ++c) {
+				out[c] += taps.weight[k]*in[c];
+			}
+		}
+	}
+}
+
+}
+
+void resample(
+	const float* src,
+	size_t src_width,
+	size_t src_height,
+	float* dst,
+	size_t dst_width,
+	size_t dst_height,
+	size_t channels,
+	mip_filter_t filter
+) {
+	const auto horizontal = build_taps(src_width, dst_width, filter);
+	const auto vertical = build_taps(src_height, dst_height, filter);
+	const auto row_size = dst_width*channels;
+
+	// Source rows used by each destination row. Both bounds never decrease from row to row.
+	std::vector<size_t> first(dst_height);
+	std::vector<size_t> last(dst_height);
+	size_t window = 1;
+	for(size_t y = 0; y < dst_height; ++y) {
+		const auto begin = vertical.index.begin()+vertical.offset[y];
+		const auto end = vertical.index.begin()+vertical.offset[y+1];
+		first[y] = *std::min_element(begin, end);
+		last[y] = *std::max_element(begin, end);
+		window = std::max(window, last[y]-first[y]+1);
+	}
+
+	// Each thread keeps only the horizontally filtered rows of the current destination row in a ring
+	// buffer instead of a whole intermediate image, so both passes work on data in the cache.
+	parallel_rows(dst_height, row_size*window, [&](size_t begin, size_t end) {
+		std::vector<float> ring(window*row_size);
+		auto next = first[begin];
+		for(auto y = begin; y < end; ++y) {
+			for(next = std::max(next, first[y]); next <= last[y]; ++next) {
+				filter_row(src+next*src_width*channels, src_width, ring.data()+next%window*row_size, horizontal, dst_width, channels);
+			}
+
+			// The vertical pass accumulates whole rows, independent of the number of channels.
+			const std::span out(dst+y*row_size, row_size);
+			std::fill(out.begin(), out.end(), 0.0f);
+			for(auto k = vertical.offset[y]; k < vertical.offset[y+1]; ++k) {
+				conversion::accumulate(std::span(ring.data()+vertical.index[k]%window*row_size, row_size), out, vertical.weight[k]);
+			}
+		}
+	});
+}
+
+namespace {
+
+bool is_alpha_channel(size_t channel, size_t channels) {
+	return (channels == 2 || channels == 4) && channel == channels-1;
+}
+
+}
+
+void srgb_to_linear(float* data, size_t pixels, size_t channels) {
+	for(size_t i = 0; i < pixels*channels; ++i) {
+		if(is_alpha_channel(i%channels, channels)) continue;
+		const auto v = data[i];
+		data[i] = v <= 0.04045f ? v/12.92f : std::pow((v+0.055f)/1.055f, 2.4f);
+	}
+}
+
+void linear_to_srgb(float* data, size_t pixels, size_t channels) {
+	for(size_t i = 0; i < pixels*channels; ++i) {
+		if(is_alpha_channel(i%channels, channels)) continue;
+		const auto v = std::max(data[i], 0.0f);
+		data[i] = v <= 0.0031308f ? v*12.92f : 1.055f*std::pow(v, 1.0f/2.4f)-0.055f;
+	}
+}
+
+}
@@ -0,0 +1,534 @@
+#include "glpp/core/object/image_analysis.hpp"
+#include "glpp/core/object/image_conversion.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+	#define GLPP_ANALYSIS_X86
+	#include <immintrin.h>
+	#if defined(__GNUC__)
+		#define GLPP_ANALYSIS_AVX2
+	#endif
+#endif
+
+namespace glpp::core::object::analysis {
+
+namespace {
+
+// Absolute differences of a range of 8 bit channels.
+struct byte_error_t {
+	std::uint64_t sum = 0;
+	std::uint64_t squared_sum = 0;
+	std::uint8_t max = 0;
+};
+
+struct kernels_t {
+	byte_error_t (*compare)(const std::uint8_t* lhs, const std::uint8_t* rhs, size_t count);
+	void (*absolute_difference)(const std::uint8_t* lhs, const std::uint8_t* rhs, std::uint8_t* dst, size_t count);
+};
+
+/*
+ * Scalar kernels, which define the results of all other instruction sets.
+ */
+namespace scalar {
+
+byte_error_t compare(const std::uint8_t* lhs, const std::uint8_t* rhs, size_t count) {
+	byte_error_t result;
+	for(size_t i = 0; i < count; ++i) {
+		const auto d = static_cast<std::uint8_t>(lhs[i] > rhs[i] ? lhs[i]-rhs[i] : rhs[i]-lhs[i]);
+		result.sum += d;
+		result.squared_sum += d*d;
+		result.max = std::max(result.max, d);
+	}
+	return result;
+}
+
+void absolute_difference(const std::uint8_t* lhs, const std::uint8_t* rhs, std::uint8_t* dst, size_t count) {
+	for(size_t i = 0; i < count; ++i) {
+		dst[i] = static_cast<std::uint8_t>(lhs[i] > rhs[i] ? lhs[i]-rhs[i] : rhs[i]-lhs[i]);
+	}
+}
+
+}
+
+constexpr kernels_t scalar_kernels {
+	scalar::compare,
+	scalar::absolute_difference
+};
+
+// The 32 bit lanes of the squared differences are flushed before they can overflow.
+constexpr size_t squares_per_flush = 1 << 17;
+
+#ifdef GLPP_ANALYSIS_X86
+
+namespace sse2 {
+
+__m128i absolute_difference(__m128i a, __m128i b) {
+	return _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+}
+
+byte_error_t compare(const std::uint8_t* lhs, const std::uint8_t* rhs, size_t count) {
+	const auto zero = _mm_setzero_si128();
+	auto max = zero;
+	auto sum = zero;
+	auto squared_sum = zero;
+	size_t i = 0;
+	while(i+16 <= count) {
+		auto squares = zero;
+		const auto end = std::min(count, i+squares_per_flush);
+		for(; i+16 <= end; i += 16) {
+			const auto d = absolute_difference(
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs+i)),
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs+i))
+			);
+			max = _mm_max_epu8(max, d);
+			sum = _mm_add_epi64(sum, _mm_sad_epu8(d, zero));
+			const auto lo = _mm_unpacklo_epi8(d, zero);
+			const auto hi = _mm_unpackhi_epi8(d, zero);
+			squares = _mm_add_epi32(squares, _mm_add_epi32(_mm_madd_epi16(lo, lo), _mm_madd_epi16(hi, hi)));
+		}
+		squared_sum = _mm_add_epi64(squared_sum, _mm_add_epi64(_mm_unpacklo_epi32(squares, zero), _mm_unpackhi_epi32(squares, zero)));
+	}
+
+	alignas(16) std::array<std::uint64_t, 2> sums;
+	alignas(16) std::array<std::uint64_t, 2> squared_sums;
+	alignas(16) std::array<std::uint8_t, 16> maxima;
+	_mm_store_si128(reinterpret_cast<__m128i*>(sums.data()), sum);
+	_mm_store_si128(reinterpret_cast<__m128i*>(squared_sums.data()), squared_sum);
+	_mm_store_si128(reinterpret_cast<__m128i*>(maxima.data()), max);
+
+	auto result = scalar::compare(lhs+i, rhs+i, count-i);
+	result.sum += sums[0]+sums[1];
+	result.squared_sum += squared_sums[0]+squared_sums[1];
+	result.max = std::max(result.max, *std::max_element(maxima.begin(), maxima.end()));
+	return result;
+}
+
+void absolute_difference(const std::uint8_t* lhs, const std::uint8_t* rhs, std::uint8_t* dst, size_t count) {
+	size_t i = 0;
+	for(; i+16 <= count; i += 16) {
+		const auto d = absolute_difference(
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs+i)),
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs+i))
+		);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst+i), d);
+	}
+	scalar::absolute_difference(lhs+i, rhs+i, dst+i, count-i);
+}
+
+}
+
+constexpr kernels_t sse2_kernels {
+	sse2::compare,
+	sse2::absolute_difference
+};
+
+#endif
+
+#ifdef GLPP_ANALYSIS_AVX2
+
+// Compiled for AVX2 independent of the target of the build, only called after the runtime check.
+#define GLPP_AVX2 __attribute__((target("avx2")))
+
+namespace avx2 {
+
+GLPP_AVX2 __m256i absolute_difference(__m256i a, __m256i b) {
+	return _mm256_or_si256(_mm256_subs_epu8(a, b), _mm256_subs_epu8(b, a));
+}
+
+GLPP_AVX2 byte_error_t compare(const std::uint8_t* lhs, const std::uint8_t* rhs, size_t count) {
+	const auto zero = _mm256_setzero_si256();
+	auto max = zero;
+	auto sum = zero;
+	auto squared_sum = zero;
+	size_t i = 0;
+	while(i+32 <= count) {
+		auto squares = zero;
+		const auto end = std::min(count, i+squares_per_flush);
+		for(; i+32 <= end; i += 32) {
+			const auto d = absolute_difference(
+				_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs+i)),
+				_mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs+i))
+			);
+			max = _mm256_max_epu8(max, d);
+			sum = _mm256_add_epi64(sum, _mm256_sad_epu8(d, zero));
+			// Unpacking works per 128 bit lane, which does not matter for a sum.
+			const auto lo = _mm256_unpacklo_epi8(d, zero);
+			const auto hi = _mm256_unpackhi_epi8(d, zero);
+			squares = _mm256_add_epi32(squares, _mm256_add_epi32(_mm256_madd_epi16(lo, lo), _mm256_madd_epi16(hi, hi)));
+		}
+		squared_sum = _mm256_add_epi64(squared_sum, _mm256_add_epi64(_mm256_unpacklo_epi32(squares, zero), _mm256_unpackhi_epi32(squares, zero)));
+	}
+
+	alignas(32) std::array<std::uint64_t, 4> sums;
+	alignas(32) std::array<std::uint64_t, 4> squared_sums;
+	alignas(32) std::array<std::uint8_t, 32> maxima;
+	_mm256_store_si256(reinterpret_cast<__m256i*>(sums.data()), sum);
+	_mm256_store_si256(reinterpret_cast<__m256i*>(squared_sums.data()), squared_sum);
+	_mm256_store_si256(reinterpret_cast<__m256i*>(maxima.data()), max);
+
+	auto result = scalar::compare(lhs+i, rhs+i, count-i);
+	for(size_t k = 0; k < 4; ++k) {
+		result.sum += sums[k];
+		result.squared_sum += squared_sums[k];
+	}
+	result.max = std::max(result.max, *std::max_element(maxima.begin(), maxima.end()));
+	return result;
+}
+
+GLPP_AVX2 void absolute_difference(const std::uint8_t* lhs, const std::uint8_t* rhs, std::uint8_t* dst, size_t count) {
+	size_t i = 0;
+	for(; i+32 <= count; i += 32) {
+		const auto d = absolute_difference(
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs+i)),
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs+i))
+		);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst+i), d);
+	}
+	scalar::absolute_difference(lhs+i, rhs+i, dst+i, count-i);
+}
+
+}
+
+constexpr kernels_t avx2_kernels {
+	avx2::compare,
+	avx2::absolute_difference
+};
+
+#endif
+
+const kernels_t& kernels() {
+	switch(conversion::simd_level()) {
+#ifdef GLPP_ANALYSIS_X86
+		case simd_level_t::sse2:
+			return sse2_kernels;
+#endif
+#ifdef GLPP_ANALYSIS_AVX2
+		case simd_level_t::avx2:
+			return avx2_kernels;
+#endif
+		default:
+			return scalar_kernels;
+	}
+}
+
+void check_size(size_t lhs, size_t rhs, size_t channels) {
+	if(lhs != rhs) {
+		throw std::runtime_error("Image analysis of "+std::to_string(lhs)+" and "+std::to_string(rhs)+" elements.");
+	}
+	if(channels == 0 || lhs%channels != 0) {
+		throw std::runtime_error("Image analysis of "+std::to_string(lhs)+" elements with "+std::to_string(channels)+" channels.");
+	}
+}
+
+// Runs functor(begin, end, block) for blocks of whole pixels on multiple threads.
+template <class Functor>
+void parallel_pixel_blocks(size_t count, size_t channels, Functor&& functor) {
+	const auto block = 4096*channels;
+	detail::parallel_rows((count+block-1)/block, block, [&](size_t begin, size_t end) {
+		for(auto b = begin; b < end; ++b) {
+			functor(b*block, std::min((b+1)*block, count), b);
+		}
+	});
+}
+
+template <class V>
+size_t different_pixels(const V* lhs, const V* rhs, size_t count, size_t channels) {
+	size_t different = 0;
+	for(size_t i = 0; i < count; i += channels) {
+		different += !std::equal(lhs+i, lhs+i+channels, rhs+i);
+	}
+	return different;
+}
+
+image_difference_t finish(double sum, double squared_sum, double max, size_t different, size_t count) {
+	image_difference_t result;
+	if(count == 0) return result;
+	result.max_error = max;
+	result.mean_error = sum/count;
+	result.mean_squared_error = squared_sum/count;
+	result.different_pixels = different;
+	if(result.mean_squared_error > 0.0) {
+		result.psnr = -10.0*std::log10(result.mean_squared_error);
+	}
+	return result;
+}
+
+/*
+ * SSIM of windows, which are built from the sums of 4x4 blocks like in x264. Every block is
+ * summed once and shared by the four windows covering it.
+ */
+constexpr size_t block_size = 4;
+constexpr double c1 = 0.01*0.01;
+constexpr double c2 = 0.03*0.03;
+
+template <class Sum>
+struct block_sums_t {
+	Sum lhs {};
+	Sum rhs {};
+	// Sum of the squares of both sides.
+	Sum squares {};
+	Sum products {};
+
+	block_sums_t& operator+=(const block_sums_t& rhs_sums) {
+		lhs += rhs_sums.lhs;
+		rhs += rhs_sums.rhs;
+		squares += rhs_sums.squares;
+		products += rhs_sums.products;
+		return *this;
+	}
+};
+
+// 8 bit blocks are summed exactly in integers and normalized per window.
+template <class V>
+using block_sum_t = std::conditional_t<std::is_same_v<V, std::uint8_t>, std::uint32_t, double>;
+
+template <class V>
+constexpr double ssim_scale = std::is_same_v<V, std::uint8_t> ? 1.0/255.0 : 1.0;
+
+template <class Sum>
+double window_ssim(const block_sums_t<Sum>& sums, double count, double scale) {
+	const auto mu_lhs = sums.lhs*scale/count;
+	const auto mu_rhs = sums.rhs*scale/count;
+	const auto variances = sums.squares*scale*scale/count-mu_lhs*mu_lhs-mu_rhs*mu_rhs;
+	const auto covariance = sums.products*scale*scale/count-mu_lhs*mu_rhs;
+	return (2.0*mu_lhs*mu_rhs+c1)*(2.0*covariance+c2)/((mu_lhs*mu_lhs+mu_rhs*mu_rhs+c1)*(variances+c2));
+}
+
+// A fixed channel count lets the compiler unroll and vectorize the inner loop.
+template <size_t Channels, class V, class Sum>
+void sum_rows(const V* lhs, const V* rhs, size_t columns, size_t rows, size_t stride, size_t channels, block_sums_t<Sum>* sums, size_t block_width) {
+	const auto count = Channels != 0 ? Channels : channels;
+	for(size_t y = 0; y < rows; ++y) {
+		const auto* a = lhs+y*stride;
+		const auto* b = rhs+y*stride;
+		for(size_t x = 0; x < columns; x += block_width) {
+			auto* block = sums+x/block_width*count;
+			for(size_t c = 0; c < count; ++c) {
+				block_sums_t<Sum> sum;
+				for(auto i = x*count+c; i < (x+block_width)*count; i += count) {
+					const Sum va = a[i];
+					const Sum vb = b[i];
+					sum.lhs += va;
+					sum.rhs += vb;
+					sum.squares += va*va+vb*vb;
+					sum.products += va*vb;
+				}
+				block[c] += sum;
+			}
+		}
+	}
+}
+
+template <class V, class Sum>
+void sum_rows(const V* lhs, const V* rhs, size_t columns, size_t rows, size_t stride, size_t channels, block_sums_t<Sum>* sums, size_t block_width) {
+	switch(channels) {
+		case 1: return sum_rows<1>(lhs, rhs, columns, rows, stride, channels, sums, block_width);
+		case 2: return sum_rows<2>(lhs, rhs, columns, rows, stride, channels, sums, block_width);
+		case 3: return sum_rows<3>(lhs, rhs, columns, rows, stride, channels, sums, block_width);
+		case 4: return sum_rows<4>(lhs, rhs, columns, rows, stride, channels, sums, block_width);
+	}
+	sum_rows<0>(lhs, rhs, columns, rows, stride, channels, sums, block_width);
+}
+
+template <class V>
+double ssim(std::span<const V> lhs, std::span<const V> rhs, size_t width, size_t height, size_t channels) {
+	using sum_t = block_sum_t<V>;
+	check_size(lhs.size(), rhs.size(), channels);
+	if(lhs.size() != width*height*channels) {
+		throw std::runtime_error("Image analysis of "+std::to_string(lhs.size())+" elements as "+std::to_string(width)+"x"+std::to_string(height)+" image.");
+	}
+	if(lhs.empty()) return 1.0;
+	const auto stride = width*channels;
+	constexpr auto scale = ssim_scale<V>;
+
+	if(width < 2*block_size || height < 2*block_size) {
+		std::vector<block_sums_t<double>> sums(channels);
+		sum_rows(lhs.data(), rhs.data(), width, height, stride, channels, sums.data(), width);
+		double result = 0.0;
+		for(const auto& channel : sums) {
+			result += window_ssim(channel, width*height, scale);
+		}
+		return result/channels;
+	}
+
+	const auto blocks_x = width/block_size;
+	const auto blocks_y = height/block_size;
+	const auto windows_x = blocks_x-1;
+	const auto windows_y = blocks_y-1;
+	std::vector<double> row_ssim(windows_y);
+
+	detail::parallel_rows(windows_y, 2*block_size*stride, [&](size_t begin, size_t end) {
+		std::vector<block_sums_t<sum_t>> top(blocks_x*channels);
+		std::vector<block_sums_t<sum_t>> bottom(blocks_x*channels);
+		const auto sum_block_row = [&](size_t y, std::vector<block_sums_t<sum_t>>& sums) {
+			std::fill(sums.begin(), sums.end(), block_sums_t<sum_t>{});
+			const auto offset = y*block_size*stride;
+			sum_rows(lhs.data()+offset, rhs.data()+offset, blocks_x*block_size, block_size, stride, channels, sums.data(), block_size);
+		};
+
+		sum_block_row(begin, bottom);
+		for(auto y = begin; y < end; ++y) {
+			std::swap(top, bottom);
+			sum_block_row(y+1, bottom);
+			double sum = 0.0;
+			for(size_t x = 0; x < windows_x; ++x) {
+				for(size_t c = 0; c < channels; ++c) {
+					auto window = top[x*channels+c];
+					window += top[(x+1)*channels+c];
+					window += bottom[x*channels+c];
+					window += bottom[(x+1)*channels+c];
+					sum += window_ssim(window, 4*block_size*block_size, scale);
+				}
+			}
+			row_ssim[y] = sum;
+		}
+	});
+
+	double sum = 0.0;
+	for(const auto row : row_ssim) {
+		sum += row;
+	}
+	return sum/(windows_x*windows_y*channels);
+}
+
+}
+
+image_difference_t compare(std::span<const std::uint8_t> lhs, std::span<const std::uint8_t> rhs, size_t channels) {
+	check_size(lhs.size(), rhs.size(), channels);
+	const auto& kernel = kernels();
+	const auto blocks = (lhs.size()+4096*channels-1)/(4096*channels);
+	std::vector<byte_error_t> errors(blocks);
+	std::vector<size_t> different(blocks);
+	parallel_pixel_blocks(lhs.size(), channels, [&](size_t begin, size_t end, size_t block) {
+		errors[block] = kernel.compare(lhs.data()+begin, rhs.data()+begin, end-begin);
+		// Most blocks of a regression test are identical, pixels are only counted in the others.
+		if(errors[block].sum > 0) {
+			different[block] = different_pixels(lhs.data()+begin, rhs.data()+begin, end-begin, channels);
+		}
+	});
+
+	byte_error_t total;
+	size_t different_total = 0;
+	for(size_t block = 0; block < blocks; ++block) {
+		total.sum += errors[block].sum;
+		total.squared_sum += errors[block].squared_sum;
+		total.max = std::max(total.max, errors[block].max);
+		different_total += different[block];
+	}
+	return finish(total.sum/255.0, total.squared_sum/(255.0*255.0), total.max/255.0, different_total, lhs.size());
+}
+
+image_difference_t compare(std::span<const float> lhs, std::span<const float> rhs, size_t channels) {
+	check_size(lhs.size(), rhs.size(), channels);
+	struct float_error_t {
+		double sum = 0.0;
+		double squared_sum = 0.0;
+		double max = 0.0;
+		size_t different = 0;
+	};
+	std::vector<float_error_t> errors((lhs.size()+4096*channels-1)/(4096*channels));
+	parallel_pixel_blocks(lhs.size(), channels, [&](size_t begin, size_t end, size_t block) {
+		auto& error = errors[block];
+		for(auto i = begin; i < end; i += channels) {
+			bool equal = true;
+			for(size_t c = 0; c < channels; ++c) {
+				const double d = std::abs(lhs[i+c]-rhs[i+c]);
+				error.sum += d;
+				error.squared_sum += d*d;
+				error.max = std::max(error.max, d);
+				equal &= lhs[i+c] == rhs[i+c];
+			}
+			error.different += !equal;
+		}
+	});
+
+	float_error_t total;
+	for(const auto& error : errors) {
+		total.sum += error.sum;
+		total.squared_sum += error.squared_sum;
+		total.max = std::max(total.max, error.max);
+		total.different += error.different;
+	}
+	return finish(total.sum, total.squared_sum, total.max, total.different, lhs.size());
+}
+
+void absolute_difference(std::span<const std::uint8_t> lhs, std::span<const std::uint8_t> rhs, std::span<std::uint8_t> dst) {
+	check_size(lhs.size(), rhs.size(), 1);
+	check_size(lhs.size(), dst.size(), 1);
+	const auto& kernel = kernels();
+	parallel_pixel_blocks(lhs.size(), 1, [&](size_t begin, size_t end, size_t) {
+		kernel.absolute_difference(lhs.data()+begin, rhs.data()+begin, dst.data()+begin, end-begin);
+	});
+}
+
+void absolute_difference(std::span<const float> lhs, std::span<const float> rhs, std::span<float> dst) {
+	check_size(lhs.size(), rhs.size(), 1);
+	check_size(lhs.size(), dst.size(), 1);
+	parallel_pixel_blocks(lhs.size(), 1, [&](size_t begin, size_t end, size_t) {
+		// Simple enough to be vectorized by the compiler, dst may alias one of the inputs.
+		for(auto i = begin; i < end; ++i) {
+			dst[i] = std::abs(lhs[i]-rhs[i]);
+		}
+	});
+}
+
+double ssim(std::span<const std::uint8_t> lhs, std::span<const std::uint8_t> rhs, size_t width, size_t height, size_t channels) {
+	return ssim<std::uint8_t>(lhs, rhs, width, height, channels);
+}
+
+double ssim(std::span<const float> lhs, std::span<const float> rhs, size_t width, size_t height, size_t channels) {
+	return ssim<float>(lhs, rhs, width, height, channels);
+}
+
+void histogram(std::span<const std::uint8_t> pixels, size_t channels, std::span<std::uint64_t> bins) {
+	check_size(pixels.size(), pixels.size(), channels);
+	if(bins.size() != channels*256) {
+		throw std::runtime_error("A histogram of "+std::to_string(channels)+" channels needs "+std::to_string(channels*256)+" bins.");
+	}
+	std::fill(bins.begin(), bins.end(), 0);
+	std::mutex mutex;
+	detail::parallel_rows(pixels.size()/channels, channels, [&](size_t begin, size_t end) {
+		// Counting into 32 bit bins keeps the tables of all channels in the L1 cache.
+		std::vector<std::uint32_t> local(channels*256);
+		const auto flush = [&] {
+			std::lock_guard lock(mutex);
+			for(size_t i = 0; i < local.size(); ++i) {
+				bins[i] += local[i];
+			}
+			std::fill(local.begin(), local.end(), 0);
+		};
+		constexpr size_t max_pixels = std::numeric_limits<std::uint32_t>::max();
+		for(auto first = begin; first < end; first += max_pixels) {
+			const auto last = std::min<size_t>(end, first+max_pixels);
+			const auto* data = pixels.data()+first*channels;
+			for(size_t i = 0; i < (last-first)*channels; i += channels) {
+				for(size_t c = 0; c < channels; ++c) {
+					++local[c*256+data[i+c]];
+				}
+			}
+			if(last < end) flush();
+		}
+		flush();
+	});
+}
+
+void flip_vertical(std::span<std::byte> pixels, size_t row_size) {
+	if(row_size == 0 || pixels.size()%row_size != 0) {
+		throw std::runtime_error("Image of "+std::to_string(pixels.size())+" bytes can not be flipped with rows of "+std::to_string(row_size)+" bytes.");
+	}
+	const auto rows = pixels.size()/row_size;
+	detail::parallel_rows(rows/2, 2*row_size, [&](size_t begin, size_t end) {
+		for(auto y = begin; y < end; ++y) {
+			auto* top = pixels.data()+y*row_size;
+			auto* bottom = pixels.data()+(rows-1-y)*row_size;
+			std::swap_ranges(top, top+row_size, bottom);
+		}
+	});
+}
+
+}
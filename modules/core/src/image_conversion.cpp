@@ -0,0 +1,923 @@
+#include "glpp/core/object/image_conversion.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+	#define GLPP_CONVERSION_X86
+	#include <immintrin.h>
+	#if defined(__GNUC__)
+		#define GLPP_CONVERSION_AVX2
+	#endif
+#elif defined(__aarch64__)
+	#define GLPP_CONVERSION_NEON
+	#include <arm_neon.h>
+#endif
+
+namespace glpp::core::object::conversion {
+
+namespace {
+
+struct kernels_t {
+	void (*u8_to_float)(const std::uint8_t* src, float* dst, size_t count);
+	void (*float_to_u8)(const float* src, std::uint8_t* dst, size_t count);
+	void (*u8_to_u16)(const std::uint8_t* src, std::uint16_t* dst, size_t count);
+	void (*u16_to_u8)(const std::uint16_t* src, std::uint8_t* dst, size_t count);
+	void (*float_to_half)(const float* src, std::uint16_t* dst, size_t count);
+	void (*half_to_float)(const std::uint16_t* src, float* dst, size_t count);
+	void (*rgb_to_rgba)(const std::uint8_t* src, std::uint8_t* dst, size_t pixels, std::uint8_t alpha);
+	void (*rgba_to_rgb)(const std::uint8_t* src, std::uint8_t* dst, size_t pixels);
+	void (*swizzle)(const std::uint8_t* src, std::uint8_t* dst, size_t pixels, const std::array<std::uint8_t, 4>& order);
+	void (*premultiply)(std::uint8_t* rgba, size_t pixels);
+	void (*accumulate)(const float* src, float* dst, size_t count, float weight);
+	void (*filter_rgba)(const float* src, float* dst, const size_t* offset, const size_t* index, const float* weight, size_t pixels);
+};
+
+/*
+ * Scalar kernels, which define the results of all other instruction sets bit by bit.
+ */
+namespace scalar {
+
+std::uint8_t to_u8(float v) {
+	// Written this way round, NaN becomes 0 like with the max instructions of the vector units.
+	v = v > 0.0f ? v : 0.0f;
+	v = v < 1.0f ? v : 1.0f;
+	return static_cast<std::uint8_t>(v*255.0f+0.5f);
+}
+
+// Exact round(t/255) for t <= 255*255.
+std::uint8_t div_255(std::uint32_t t) {
+	t += 128;
+	return static_cast<std::uint8_t>((t+(t >> 8)) >> 8);
+}
+
+void u8_to_float(const std::uint8_t* src, float* dst, size_t count) {
+	for(size_t i = 0; i < count; ++i) {
+		dst[i] = static_cast<float>(src[i])/255.0f;
+	}
+}
+
+void float_to_u8(const float* src, std::uint8_t* dst, size_t count) {
+	for(size_t i = 0; i < count; ++i) {
+		dst[i] = to_u8(src[i]);
+	}
+}
+
+void u8_to_u16(const std::uint8_t* src, std::uint16_t* dst, size_t count) {
+	for(size_t i = 0; i < count; ++i) {
+		dst[i] = static_cast<std::uint16_t>(src[i]*257);
+	}
+}
+
+void u16_to_u8(const std::uint16_t* src, std::uint8_t* dst, size_t count) {
+	// Exact round(v/257) with 16 bit saturating arithmetic.
+	for(size_t i = 0; i < count; ++i) {
+		const auto t = std::min<std::uint32_t>(src[i]+128u, 0xffff);
+		dst[i] = static_cast<std::uint8_t>((t-(t >> 8)) >> 8);
+	}
+}
+
+std::uint16_t float_to_half(float f) {
+	const auto bits = std::bit_cast<std::uint32_t>(f);
+	const auto sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000);
+	const auto abs = bits & 0x7fffffff;
+	if(abs >= 0x7f800000) {
+		// Infinity stays infinity, NaN stays a quiet NaN.
+		return sign | 0x7c00 | (abs > 0x7f800000 ? 0x200 | ((abs >> 13) & 0x3ff) : 0);
+	}
+	if(abs >= 0x477ff000) {
+		return sign | 0x7c00;
+	}
+	if(abs < 0x33000000) {
+		return sign;
+	}
+	if(abs < 0x38800000) {
+		// Subnormal half, round the mantissa including the implicit bit to nearest even.
+		const auto shift = 126-(abs >> 23);
+		const auto mantissa = (abs & 0x7fffff) | 0x800000;
+		const auto halfway = 1u << (shift-1);
+		const auto remainder = mantissa & ((1u << shift)-1);
+		auto result = mantissa >> shift;
+		if(remainder > halfway || (remainder == halfway && (result & 1))) {
+			++result;
+		}
+		return sign | static_cast<std::uint16_t>(result);
+	}
+	const auto rebased = abs-(112u << 23);
+	return sign | static_cast<std::uint16_t>((rebased+0xfff+((rebased >> 13) & 1)) >> 13);
+}
+
+float half_to_float(std::uint16_t h) {
+	const auto sign = static_cast<std::uint32_t>(h & 0x8000) << 16;
+	const auto exponent = (h >> 10) & 0x1f;
+	const auto mantissa = static_cast<std::uint32_t>(h & 0x3ff);
+	if(exponent == 0) {
+		const auto value = static_cast<float>(mantissa)/16777216.0f;
+		return sign ? -value : value;
+	}
+	if(exponent == 0x1f) {
+		return std::bit_cast<float>(sign | 0x7f800000 | (mantissa << 13));
+	}
+	return std::bit_cast<float>(sign | ((exponent+112) << 23) | (mantissa << 13));
+}
+
+void float_to_half(const float* src, std::uint16_t* dst, size_t count) {
+	for(size_t i = 0; i < count; ++i) {
+		dst[i] = float_to_half(src[i]);
+	}
+}
+
+void half_to_float(const std::uint16_t* src, float* dst, size_t count) {
+	for(size_t i = 0; i < count; ++i) {
+		dst[i] = half_to_float(src[i]);
+	}
+}
+
+void rgb_to_rgba(const std::uint8_t* src, std::uint8_t* dst, size_t pixels, std::uint8_t alpha) {
+	for(size_t i = 0; i < pixels; ++i) {
+		dst[i*4+0] = src[i*3+0];
+		dst[i*4+1] = src[i*3+1];
+		dst[i*4+2] = src[i*3+2];
+		dst[i*4+3] = alpha;
+	}
+}
+
+void rgba_to_rgb(const std::uint8_t* src, std::uint8_t* dst, size_t pixels) {
+	for(size_t i = 0; i < pixels; ++i) {
+		dst[i*3+0] = src[i*4+0];
+		dst[i*3+1] = src[i*4+1];
+		dst[i*3+2] = src[i*4+2];
+	}
+}
+
+void swizzle(const std::uint8_t* src, std::uint8_t* dst, size_t pixels, const std::array<std::uint8_t, 4>& order) {
+	for(size_t i = 0; i < pixels; ++i) {
+		const std::array<std::uint8_t, 4> pixel { src[i*4+0], src[i*4+1], src[i*4+2], src[i*4+3] };
+		for(size_t c = 0; c < 4; ++c) {
+			dst[i*4+c] = pixel[order[c]];
+		}
+	}
+}
+
+void premultiply(std::uint8_t* rgba, size_t pixels) {
+	for(size_t i = 0; i < pixels; ++i) {
+		const auto alpha = rgba[i*4+3];
+		for(size_t c = 0; c < 3; ++c) {
+			rgba[i*4+c] = div_255(rgba[i*4+c]*alpha);
+		}
+	}
+}
+
+void accumulate(const float* src, float* dst, size_t count, float weight) {
+	for(size_t i = 0; i < count; ++i) {
+		dst[i] += weight*src[i];
+	}
+}
+
+void filter_rgba(const float* src, float* dst, const size_t* offset, const size_t* index, const float* weight, size_t pixels) {
+	for(size_t x = 0; x < pixels; ++x) {
+		std::array<float, 4> sum {};
+		for(auto k = offset[x]; k < offset[x+1]; ++k) {
+			for(size_t c = 0; c < 4; ++c) {
+				sum[c] += weight[k]*src[index[k]*4+c];
+			}
+		}
+		std::copy(sum.begin(), sum.end(), dst+x*4);
+	}
+}
+
+}
+
+constexpr kernels_t scalar_kernels {
+	scalar::u8_to_float,
+	scalar::float_to_u8,
+	scalar::u8_to_u16,
+	scalar::u16_to_u8,
+	scalar::float_to_half,
+	scalar::half_to_float,
+	scalar::rgb_to_rgba,
+	scalar::rgba_to_rgb,
+	scalar::swizzle,
+	scalar::premultiply,
+	scalar::accumulate,
+	scalar::filter_rgba
+};
+
+#ifdef GLPP_CONVERSION_X86
+
+/*
+ * SSE2 is part of every x86-64 CPU. Byte shuffles and half floats need later extensions and fall back
+ * to the scalar kernels.
+ */
+namespace sse2 {
+
+__m128 clamp_scale(__m128 v) {
+	v = _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+	return _mm_add_ps(_mm_mul_ps(v, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f));
+}
+
+__m128i div_255(__m128i t) {
+	t = _mm_add_epi16(t, _mm_set1_epi16(128));
+	return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+void u8_to_float(const std::uint8_t* src, float* dst, size_t count) {
+	const auto zero = _mm_setzero_si128();
+	const auto scale = _mm_set1_ps(255.0f);
+	size_t i = 0;
+	for(; i+16 <= count; i += 16) {
+		const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src+i));
+		const auto lo = _mm_unpacklo_epi8(v, zero);
+		const auto hi = _mm_unpackhi_epi8(v, zero);
+		_mm_storeu_ps(dst+i+0, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+		_mm_storeu_ps(dst+i+4, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+		_mm_storeu_ps(dst+i+8, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+		_mm_storeu_ps(dst+i+12, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+	}
+	scalar::u8_to_float(src+i, dst+i, count-i);
+}
+
+void float_to_u8(const float* src, std::uint8_t* dst, size_t count) {
+	size_t i = 0;
+	for(; i+16 <= count; i += 16) {
+		const auto a = _mm_cvttps_epi32(clamp_scale(_mm_loadu_ps(src+i+0)));
+		const auto b = _mm_cvttps_epi32(clamp_scale(_mm_loadu_ps(src+i+4)));
+		const auto c = _mm_cvttps_epi32(clamp_scale(_mm_loadu_ps(src+i+8)));
+		const auto d = _mm_cvttps_epi32(clamp_scale(_mm_loadu_ps(src+i+12)));
+		const auto packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst+i), packed);
+	}
+	scalar::float_to_u8(src+i, dst+i, count-i);
+}
+
+void u8_to_u16(const std::uint8_t* src, std::uint16_t* dst, size_t count) {
+	size_t i = 0;
+	for(; i+16 <= count; i += 16) {
+		const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src+i));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst+i+0), _mm_unpacklo_epi8(v, v));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst+i+8), _mm_unpackhi_epi8(v, v));
+	}
+	scalar::u8_to_u16(src+i, dst+i, count-i);
+}
+
+__m128i u16_to_u8(__m128i v) {
+	const auto t = _mm_adds_epu16(v, _mm_set1_epi16(128));
+	return _mm_srli_epi16(_mm_sub_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+void u16_to_u8(const std::uint16_t* src, std::uint8_t* dst, size_t count) {
+	size_t i = 0;
+	for(; i+16 <= count; i += 16) {
+		const auto a = u16_to_u8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src+i+0)));
+		const auto b = u16_to_u8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src+i+8)));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst+i), _mm_packus_epi16(a, b));
+	}
+	scalar::u16_to_u8(src+i, dst+i, count-i);
+}
+
+__m128i premultiply(__m128i pixels) {
+	// Broadcast alpha to the color channels and keep alpha itself by multiplying it with 255.
+	auto alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, 0xff), 0xff);
+	alpha = _mm_or_si128(
+		_mm_and_si128(alpha, _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1)),
+		_mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0)
+	);
+	return div_255(_mm_mullo_epi16(pixels, alpha));
+}
+
+void premultiply(std::uint8_t* rgba, size_t pixels) {
+	const auto zero = _mm_setzero_si128();
+	size_t i = 0;
+	for(; i+4 <= pixels; i += 4) {
+		auto* address = reinterpret_cast<__m128i*>(rgba+i*4);
+		const auto v = _mm_loadu_si128(address);
+		const auto lo = premultiply(_mm_unpacklo_epi8(v, zero));
+		const auto hi = premultiply(_mm_unpackhi_epi8(v, zero));
+		_mm_storeu_si128(address, _mm_packus_epi16(lo, hi));
+	}
+	scalar::premultiply(rgba+i*4, pixels-i);
+}
+
+void accumulate(const float* src, float* dst, size_t count, float weight) {
+	const auto w = _mm_set1_ps(weight);
+	size_t i = 0;
+	for(; i+8 <= count; i += 8) {
+		_mm_storeu_ps(dst+i+0, _mm_add_ps(_mm_loadu_ps(dst+i+0), _mm_mul_ps(w, _mm_loadu_ps(src+i+0))));
+		_mm_storeu_ps(dst+i+4, _mm_add_ps(_mm_loadu_ps(dst+i+4), _mm_mul_ps(w, _mm_loadu_ps(src+i+4))));
+	}
+	scalar::accumulate(src+i, dst+i, count-i, weight);
+}
+
+// One rgba pixel fills a register, the taps of a pixel are summed in the order of the scalar kernel.
+void filter_rgba(const float* src, float* dst, const size_t* offset, const size_t* index, const float* weight, size_t pixels) {
+	for(size_t x = 0; x < pixels; ++x) {
+		auto sum = _mm_setzero_ps();
+		for(auto k = offset[x]; k < offset[x+1]; ++k) {
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weight[k]), _mm_loadu_ps(src+index[k]*4)));
+		}
+		_mm_storeu_ps(dst+x*4, sum);
+	}
+}
+
+}
+
+constexpr kernels_t sse2_kernels {
+	sse2::u8_to_float,
+	sse2::float_to_u8,
+	sse2::u8_to_u16,
+	sse2::u16_to_u8,
+	scalar::float_to_half,
+	scalar::half_to_float,
+	scalar::rgb_to_rgba,
+	scalar::rgba_to_rgb,
+	scalar::swizzle,
+	sse2::premultiply,
+	sse2::accumulate,
+	sse2::filter_rgba
+};
+
+#endif
+
+#ifdef GLPP_CONVERSION_AVX2
+
+// Compiled for AVX2 and F16C independent of the target of the build, only called after the runtime check.
+#define GLPP_AVX2 __attribute__((target("avx2,f16c")))
+
+namespace avx2 {
+
+GLPP_AVX2 __m256 clamp_scale(__m256 v) {
+	v = _mm256_min_ps(_mm256_max_ps(v, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+	return _mm256_add_ps(_mm256_mul_ps(v, _mm256_set1_ps(255.0f)), _mm256_set1_ps(0.5f));
+}
+
+GLPP_AVX2 void u8_to_float(const std::uint8_t* src, float* dst, size_t count) {
+	const auto scale = _mm256_set1_ps(255.0f);
+	size_t i = 0;
+	for(; i+16 <= count; i += 16) {
+		const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src+i));
+		_mm256_storeu_ps(dst+i+0, _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(v)), scale));
+		_mm256_storeu_ps(dst+i+8, _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(v, 8))), scale));
+	}
+	scalar::u8_to_float(src+i, dst+i, count-i);
+}
+
+GLPP_AVX2 void float_to_u8(const float* src, std::uint8_t* dst, size_t count) {
+	size_t i = 0;
+	for(; i+16 <= count; i += 16) {
+		const auto a = _mm256_cvttps_epi32(clamp_scale(_mm256_loadu_ps(src+i+0)));
+		const auto b = _mm256_cvttps_epi32(clamp_scale(_mm256_loadu_ps(src+i+8)));
+		// Packing works per 128 bit lane, the permutation restores the order of the elements.
+		const auto words = _mm256_permute4x64_epi64(_mm256_packus_epi32(a, b), 0xd8);
+		const auto bytes = _mm_packus_epi16(_mm256_castsi256_si128(words), _mm256_extracti128_si256(words, 1));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst+i), bytes);
+	}
+	scalar::float_to_u8(src+i, dst+i, count-i);
+}
+
+GLPP_AVX2 void u8_to_u16(const std::uint8_t* src, std::uint16_t* dst, size_t count) {
+	size_t i = 0;
+	for(; i+16 <= count; i += 16) {
+		const auto v = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src+i)));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst+i), _mm256_or_si256(v, _mm256_slli_epi16(v, 8)));
+	}
+	scalar::u8_to_u16(src+i, dst+i, count-i);
+}
+
+GLPP_AVX2 void u16_to_u8(const std::uint16_t* src, std::uint8_t* dst, size_t count) {
+	size_t i = 0;
+	for(; i+16 <= count; i += 16) {
+		const auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src+i));
+		const auto t = _mm256_adds_epu16(v, _mm256_set1_epi16(128));
+		const auto r = _mm256_srli_epi16(_mm256_sub_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+		const auto packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(r, r), 0xd8);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst+i), _mm256_castsi256_si128(packed));
+	}
+	scalar::u16_to_u8(src+i, dst+i, count-i);
+}
+
+GLPP_AVX2 void float_to_half(const float* src, std::uint16_t* dst, size_t count) {
+	size_t i = 0;
+	for(; i+8 <= count; i += 8) {
+		const auto half = _mm256_cvtps_ph(_mm256_loadu_ps(src+i), _MM_FROUND_TO_NEAREST_INT);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst+i), half);
+	}
+	scalar::float_to_half(src+i, dst+i, count-i);
+}
+
+GLPP_AVX2 void half_to_float(const std::uint16_t* src, float* dst, size_t count) {
+	size_t i = 0;
+	for(; i+8 <= count; i += 8) {
+		_mm256_storeu_ps(dst+i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src+i))));
+	}
+	scalar::half_to_float(src+i, dst+i, count-i);
+}
+
+GLPP_AVX2 void rgb_to_rgba(const std::uint8_t* src, std::uint8_t* dst, size_t pixels, std::uint8_t alpha) {
+	const auto shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+	const auto fill = _mm_and_si128(_mm_set1_epi8(static_cast<char>(alpha)), _mm_set1_epi32(static_cast<int>(0xff000000)));
+	size_t i = 0;
+	// Each iteration reads 16 bytes, but only consumes the 12 bytes of 4 pixels.
+	for(; i*3+16 <= pixels*3; i += 4) {
+		const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src+i*3));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst+i*4), _mm_or_si128(_mm_shuffle_epi8(v, shuffle), fill));
+	}
+	scalar::rgb_to_rgba(src+i*3, dst+i*4, pixels-i, alpha);
+}
+
+GLPP_AVX2 void rgba_to_rgb(const std::uint8_t* src, std::uint8_t* dst, size_t pixels) {
+	const auto shuffle = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+	size_t i = 0;
+	for(; i+4 <= pixels; i += 4) {
+		const auto v = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src+i*4)), shuffle);
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(dst+i*3), v);
+		const auto tail = _mm_cvtsi128_si32(_mm_srli_si128(v, 8));
+		std::memcpy(dst+i*3+8, &tail, 4);
+	}
+	scalar::rgba_to_rgb(src+i*4, dst+i*3, pixels-i);
+}
+
+GLPP_AVX2 void swizzle(const std::uint8_t* src, std::uint8_t* dst, size_t pixels, const std::array<std::uint8_t, 4>& order) {
+	alignas(32) std::array<std::uint8_t, 32> indices;
+	for(size_t i = 0; i < indices.size(); ++i) {
+		indices[i] = static_cast<std::uint8_t>((i%16)/4*4+order[i%4]);
+	}
+	const auto shuffle = _mm256_load_si256(reinterpret_cast<const __m256i*>(indices.data()));
+	size_t i = 0;
+	for(; i+8 <= pixels; i += 8) {
+		const auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src+i*4));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst+i*4), _mm256_shuffle_epi8(v, shuffle));
+	}
+	scalar::swizzle(src+i*4, dst+i*4, pixels-i, order);
+}
+
+GLPP_AVX2 void premultiply(std::uint8_t* rgba, size_t pixels) {
+	size_t i = 0;
+	for(; i+4 <= pixels; i += 4) {
+		auto* address = reinterpret_cast<__m128i*>(rgba+i*4);
+		const auto v = _mm256_cvtepu8_epi16(_mm_loadu_si128(address));
+		auto alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(v, 0xff), 0xff);
+		alpha = _mm256_blend_epi16(alpha, _mm256_set1_epi16(255), 0x88);
+		auto t = _mm256_add_epi16(_mm256_mullo_epi16(v, alpha), _mm256_set1_epi16(128));
+		t = _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+		const auto packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(t, t), 0xd8);
+		_mm_storeu_si128(address, _mm256_castsi256_si128(packed));
+	}
+	scalar::premultiply(rgba+i*4, pixels-i);
+}
+
+// Without FMA, which would round differently than the scalar kernel.
+GLPP_AVX2 void accumulate(const float* src, float* dst, size_t count, float weight) {
+	const auto w = _mm256_set1_ps(weight);
+	size_t i = 0;
+	for(; i+16 <= count; i += 16) {
+		_mm256_storeu_ps(dst+i+0, _mm256_add_ps(_mm256_loadu_ps(dst+i+0), _mm256_mul_ps(w, _mm256_loadu_ps(src+i+0))));
+		_mm256_storeu_ps(dst+i+8, _mm256_add_ps(_mm256_loadu_ps(dst+i+8), _mm256_mul_ps(w, _mm256_loadu_ps(src+i+8))));
+	}
+	scalar::accumulate(src+i, dst+i, count-i, weight);
+}
+
+}
+
+constexpr kernels_t avx2_kernels {
+	avx2::u8_to_float,
+	avx2::float_to_u8,
+	avx2::u8_to_u16,
+	avx2::u16_to_u8,
+	avx2::float_to_half,
+	avx2::half_to_float,
+	avx2::rgb_to_rgba,
+	avx2::rgba_to_rgb,
+	avx2::swizzle,
+	avx2::premultiply,
+	avx2::accumulate,
+	// Neighbouring pixels have different taps, a wider register does not help.
+	sse2::filter_rgba
+};
+
+#undef GLPP_AVX2
+
+#endif
+
+#ifdef GLPP_CONVERSION_NEON
+
+namespace neon {
+
+void u8_to_float(const std::uint8_t* src, float* dst, size_t count) {
+	const auto scale = vdupq_n_f32(255.0f);
+	size_t i = 0;
+	for(; i+16 <= count; i += 16) {
+		const auto v = vld1q_u8(src+i);
+		const auto lo = vmovl_u8(vget_low_u8(v));
+		const auto hi = vmovl_u8(vget_high_u8(v));
+		vst1q_f32(dst+i+0, vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(lo))), scale));
+		vst1q_f32(dst+i+4, vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(lo))), scale));
+		vst1q_f32(dst+i+8, vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(hi))), scale));
+		vst1q_f32(dst+i+12, vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(hi))), scale));
+	}
+	scalar::u8_to_float(src+i, dst+i, count-i);
+}
+
+uint16x4_t to_u16(const float* src) {
+	// vmaxnm returns the number, if one operand is NaN.
+	auto v = vminq_f32(vmaxnmq_f32(vld1q_f32(src), vdupq_n_f32(0.0f)), vdupq_n_f32(1.0f));
+	v = vaddq_f32(vmulq_f32(v, vdupq_n_f32(255.0f)), vdupq_n_f32(0.5f));
+	return vmovn_u32(vcvtq_u32_f32(v));
+}
+
+void float_to_u8(const float* src, std::uint8_t* dst, size_t count) {
+	size_t i = 0;
+	for(; i+16 <= count; i += 16) {
+		const auto lo = vcombine_u16(to_u16(src+i+0), to_u16(src+i+4));
+		const auto hi = vcombine_u16(to_u16(src+i+8), to_u16(src+i+12));
+		vst1q_u8(dst+i, vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+	}
+	scalar::float_to_u8(src+i, dst+i, count-i);
+}
+
+void u8_to_u16(const std::uint8_t* src, std::uint16_t* dst, size_t count) {
+	size_t i = 0;
+	for(; i+16 <= count; i += 16) {
+		const auto v = vld1q_u8(src+i);
+		vst1q_u16(dst+i+0, vmulq_n_u16(vmovl_u8(vget_low_u8(v)), 257));
+		vst1q_u16(dst+i+8, vmulq_n_u16(vmovl_u8(vget_high_u8(v)), 257));
+	}
+	scalar::u8_to_u16(src+i, dst+i, count-i);
+}
+
+void u16_to_u8(const std::uint16_t* src, std::uint8_t* dst, size_t count) {
+	size_t i = 0;
+	for(; i+8 <= count; i += 8) {
+		const auto t = vqaddq_u16(vld1q_u16(src+i), vdupq_n_u16(128));
+		vst1_u8(dst+i, vshrn_n_u16(vsubq_u16(t, vshrq_n_u16(t, 8)), 8));
+	}
+	scalar::u16_to_u8(src+i, dst+i, count-i);
+}
+
+void float_to_half(const float* src, std::uint16_t* dst, size_t count) {
+	size_t i = 0;
+	for(; i+4 <= count; i += 4) {
+		vst1_u16(dst+i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(src+i))));
+	}
+	scalar::float_to_half(src+i, dst+i, count-i);
+}
+
+void half_to_float(const std::uint16_t* src, float* dst, size_t count) {
+	size_t i = 0;
+	for(; i+4 <= count; i += 4) {
+		vst1q_f32(dst+i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(src+i))));
+	}
+	scalar::half_to_float(src+i, dst+i, count-i);
+}
+
+void rgb_to_rgba(const std::uint8_t* src, std::uint8_t* dst, size_t pixels, std::uint8_t alpha) {
+	size_t i = 0;
+	for(; i+16 <= pixels; i += 16) {
+		const auto rgb = vld3q_u8(src+i*3);
+		const uint8x16x4_t rgba { { rgb.val[0], rgb.val[1], rgb.val[2], vdupq_n_u8(alpha) } };
+		vst4q_u8(dst+i*4, rgba);
+	}
+	scalar::rgb_to_rgba(src+i*3, dst+i*4, pixels-i, alpha);
+}
+
+void rgba_to_rgb(const std::uint8_t* src, std::uint8_t* dst, size_t pixels) {
+	size_t i = 0;
+	for(; i+16 <= pixels; i += 16) {
+		const auto rgba = vld4q_u8(src+i*4);
+		const uint8x16x3_t rgb { { rgba.val[0], rgba.val[1], rgba.val[2] } };
+		vst3q_u8(dst+i*3, rgb);
+	}
+	scalar::rgba_to_rgb(src+i*4, dst+i*3, pixels-i);
+}
+
+void swizzle(const std::uint8_t* src, std::uint8_t* dst, size_t pixels, const std::array<std::uint8_t, 4>& order) {
+	size_t i = 0;
+	for(; i+16 <= pixels; i += 16) {
+		const auto in = vld4q_u8(src+i*4);
+		const uint8x16x4_t out { { in.val[order[0]], in.val[order[1]], in.val[order[2]], in.val[order[3]] } };
+		vst4q_u8(dst+i*4, out);
+	}
+	scalar::swizzle(src+i*4, dst+i*4, pixels-i, order);
+}
+
+uint8x16_t premultiply(uint8x16_t color, uint8x16_t alpha) {
+	// (t+128+((t+128) >> 8)) >> 8 like the scalar kernel.
+	const auto lo = vmull_u8(vget_low_u8(color), vget_low_u8(alpha));
+	const auto hi = vmull_u8(vget_high_u8(color), vget_high_u8(alpha));
+	return vcombine_u8(vrshrn_n_u16(vrsraq_n_u16(lo, lo, 8), 8), vrshrn_n_u16(vrsraq_n_u16(hi, hi, 8), 8));
+}
+
+void premultiply(std::uint8_t* rgba, size_t pixels) {
+	size_t i = 0;
+	for(; i+16 <= pixels; i += 16) {
+		auto v = vld4q_u8(rgba+i*4);
+		for(auto c = 0; c < 3; ++c) {
+			v.val[c] = premultiply(v.val[c], v.val[3]);
+		}
+		vst4q_u8(rgba+i*4, v);
+	}
+	scalar::premultiply(rgba+i*4, pixels-i);
+}
+
+// Multiplies and adds separately, a fused multiply add would round differently than the scalar kernel.
+void accumulate(const float* src, float* dst, size_t count, float weight) {
+	size_t i = 0;
+	for(; i+8 <= count; i += 8) {
+		vst1q_f32(dst+i+0, vaddq_f32(vld1q_f32(dst+i+0), vmulq_n_f32(vld1q_f32(src+i+0), weight)));
+		vst1q_f32(dst+i+4, vaddq_f32(vld1q_f32(dst+i+4), vmulq_n_f32(vld1q_f32(src+i+4), weight)));
+	}
+	scalar::accumulate(src+i, dst+i, count-i, weight);
+}
+
+void filter_rgba(const float* src, float* dst, const size_t* offset, const size_t* index, const float* weight, size_t pixels) {
+	for(size_t x = 0; x < pixels; ++x) {
+		auto sum = vdupq_n_f32(0.0f);
+		for(auto k = offset[x]; k < offset[x+1]; ++k) {
+			sum = vaddq_f32(sum, vmulq_n_f32(vld1q_f32(src+index[k]*4), weight[k]));
+		}
+		vst1q_f32(dst+x*4, sum);
+	}
+}
+
+}
+
+constexpr kernels_t neon_kernels {
+	neon::u8_to_float,
+	neon::float_to_u8,
+	neon::u8_to_u16,
+	neon::u16_to_u8,
+	neon::float_to_half,
+	neon::half_to_float,
+	neon::rgb_to_rgba,
+	neon::rgba_to_rgb,
+	neon::swizzle,
+	neon::premultiply,
+	neon::accumulate,
+	neon::filter_rgba
+};
+
+#endif
+
+simd_level_t best_level() {
+	for(const auto level : { simd_level_t::avx2, simd_level_t::sse2, simd_level_t::neon }) {
+		if(simd_supported(level)) {
+			return level;
+		}
+	}
+	return simd_level_t::scalar;
+}
+
+std::atomic<simd_level_t>& current_level() {
+	static std::atomic<simd_level_t> level { best_level() };
+	return level;
+}
+
+const kernels_t& kernels() {
+	switch(current_level().load(std::memory_order_relaxed)) {
+#ifdef GLPP_CONVERSION_X86
+		case simd_level_t::sse2:
+			return sse2_kernels;
+#endif
+#ifdef GLPP_CONVERSION_AVX2
+		case simd_level_t::avx2:
+			return avx2_kernels;
+#endif
+#ifdef GLPP_CONVERSION_NEON
+		case simd_level_t::neon:
+			return neon_kernels;
+#endif
+		default:
+			return scalar_kernels;
+	}
+}
+
+// Converts blocks of elements on multiple threads, once the input is large enough.
+template <class Functor>
+void parallel_blocks(size_t count, Functor&& functor) {
+	constexpr size_t block = 4096;
+	detail::parallel_rows((count+block-1)/block, block, [&](size_t begin, size_t end) {
+		functor(begin*block, std::min(end*block, count));
+	});
+}
+
+void check_size(size_t src, size_t dst) {
+	if(src != dst) {
+		throw std::runtime_error("Pixel conversion from "+std::to_string(src)+" to "+std::to_string(dst)+" elements.");
+	}
+}
+
+void check_pixels(size_t size, size_t channels) {
+	if(size%channels != 0) {
+		throw std::runtime_error("Pixel conversion of "+std::to_string(size)+" elements with "+std::to_string(channels)+" channels.");
+	}
+}
+
+template <class From, class To, class Kernel>
+void run(std::span<const From> src, std::span<To> dst, Kernel kernel) {
+	check_size(src.size(), dst.size());
+	parallel_blocks(src.size(), [&](size_t begin, size_t end) {
+		kernel(src.data()+begin, dst.data()+begin, end-begin);
+	});
+}
+
+bool is_alpha_channel(size_t channel, size_t channels) {
+	return (channels == 2 || channels == 4) && channel == channels-1;
+}
+
+float srgb_decode(float v) {
+	return v <= 0.04045f ? v/12.92f : std::pow((v+0.055f)/1.055f, 2.4f);
+}
+
+}
+
+bool simd_supported(simd_level_t level) {
+	switch(level) {
+		case simd_level_t::scalar:
+			return true;
+		case simd_level_t::sse2:
+#ifdef GLPP_CONVERSION_X86
+			return true;
+#else
+			return false;
+#endif
+		case simd_level_t::avx2:
+#ifdef GLPP_CONVERSION_AVX2
+			return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c");
+#else
+			return false;
+#endif
+		case simd_level_t::neon:
+#ifdef GLPP_CONVERSION_NEON
+			return true;
+#else
+			return false;
+#endif
+	}
+	return false;
+}
+
+simd_level_t simd_level() {
+	return current_level().load(std::memory_order_relaxed);
+}
+
+void set_simd_level(simd_level_t level) {
+	if(!simd_supported(level)) {
+		throw std::runtime_error("The instruction set is not supported by this CPU.");
+	}
+	current_level().store(level, std::memory_order_relaxed);
+}
+
+void convert(std::span<const std::uint8_t> src, std::span<float> dst) {
+	run(src, dst, kernels().u8_to_float);
+}
+
+void convert(std::span<const float> src, std::span<std::uint8_t> dst) {
+	run(src, dst, kernels().float_to_u8);
+}
+
+void convert(std::span<const std::uint8_t> src, std::span<std::uint16_t> dst) {
+	run(src, dst, kernels().u8_to_u16);
+}
+
+void convert(std::span<const std::uint16_t> src, std::span<std::uint8_t> dst) {
+	run(src, dst, kernels().u16_to_u8);
+}
+
+void float_to_half(std::span<const float> src, std::span<std::uint16_t> dst) {
+	run(src, dst, kernels().float_to_half);
+}
+
+void half_to_float(std::span<const std::uint16_t> src, std::span<float> dst) {
+	run(src, dst, kernels().half_to_float);
+}
+
+void rgb_to_rgba(std::span<const std::uint8_t> rgb, std::span<std::uint8_t> rgba, std::uint8_t alpha) {
+	check_pixels(rgb.size(), 3);
+	check_size(rgb.size()/3*4, rgba.size());
+	const auto kernel = kernels().rgb_to_rgba;
+	parallel_blocks(rgb.size()/3, [&](size_t begin, size_t end) {
+		kernel(rgb.data()+begin*3, rgba.data()+begin*4, end-begin, alpha);
+	});
+}
+
+void rgba_to_rgb(std::span<const std::uint8_t> rgba, std::span<std::uint8_t> rgb) {
+	check_pixels(rgba.size(), 4);
+	check_size(rgba.size()/4*3, rgb.size());
+	const auto kernel = kernels().rgba_to_rgb;
+	parallel_blocks(rgba.size()/4, [&](size_t begin, size_t end) {
+		kernel(rgba.data()+begin*4, rgb.data()+begin*3, end-begin);
+	});
+}
+
+void swizzle(std::span<const std::uint8_t> rgba, std::span<std::uint8_t> dst, std::array<std::uint8_t, 4> order) {
+	check_pixels(rgba.size(), 4);
+	check_size(rgba.size(), dst.size());
+	if(std::any_of(order.begin(), order.end(), [](auto channel) { return channel > 3; })) {
+		throw std::runtime_error("Swizzle order refers to a channel out of range.");
+	}
+	const auto kernel = kernels().swizzle;
+	parallel_blocks(rgba.size()/4, [&](size_t begin, size_t end) {
+		kernel(rgba.data()+begin*4, dst.data()+begin*4, end-begin, order);
+	});
+}
+
+void srgb_to_linear(std::span<const std::uint8_t> src, std::span<float> dst, size_t channels) {
+	check_pixels(src.size(), channels);
+	check_size(src.size(), dst.size());
+	// 256 entries cover every input, a table lookup is faster than any vectorized pow.
+	static const auto table = [] {
+		std::array<float, 256> table;
+		for(size_t i = 0; i < table.size(); ++i) {
+			table[i] = srgb_decode(static_cast<float>(i)/255.0f);
+		}
+		return table;
+	}();
+	parallel_blocks(src.size()/channels, [&](size_t begin, size_t end) {
+		for(auto i = begin*channels; i < end*channels; ++i) {
+			dst[i] = is_alpha_channel(i%channels, channels) ? static_cast<float>(src[i])/255.0f : table[src[i]];
+		}
+	});
+}
+
+void linear_to_srgb(std::span<const float> src, std::span<std::uint8_t> dst, size_t channels) {
+	check_pixels(src.size(), channels);
+	check_size(src.size(), dst.size());
+	// thresholds[k] is the smallest linear value encoded as k, a binary search finds the rounded
+	// result without evaluating pow for every channel.
+	static const auto thresholds = [] {
+		std::array<float, 256> thresholds {};
+		for(size_t k = 1; k < thresholds.size(); ++k) {
+			thresholds[k] = srgb_decode((static_cast<float>(k)-0.5f)/255.0f);
+		}
+		return thresholds;
+	}();
+	parallel_blocks(src.size()/channels, [&](size_t begin, size_t end) {
+		for(auto i = begin*channels; i < end*channels; ++i) {
+			if(is_alpha_channel(i%channels, channels)) {
+				dst[i] = scalar::to_u8(src[i]);
+				continue;
+			}
+			const auto v = src[i];
+			size_t k = 0;
+			for(size_t step = 128; step > 0; step /= 2) {
+				k += v >= thresholds[k+step] ? step : 0;
+			}
+			dst[i] = static_cast<std::uint8_t>(k);
+		}
+	});
+}
+
+void premultiply_alpha(std::span<std::uint8_t> rgba) {
+	check_pixels(rgba.size(), 4);
+	const auto kernel = kernels().premultiply;
+	parallel_blocks(rgba.size()/4, [&](size_t begin, size_t end) {
+		kernel(rgba.data()+begin*4, end-begin);
+	});
+}
+
+void accumulate(std::span<const float> src, std::span<float> dst, float weight) {
+	check_size(src.size(), dst.size());
+	kernels().accumulate(src.data(), dst.data(), src.size(), weight);
+}
+
+void filter_rgba(
+	std::span<const float> src,
+	std::span<float> dst,
+	std::span<const size_t> offset,
+	std::span<const size_t> index,
+	std::span<const float> weight
+) {
+	check_pixels(src.size(), 4);
+	if(offset.empty() || dst.size() != (offset.size()-1)*4 || index.size() != weight.size() || offset.back() > index.size()) {
+		throw std::runtime_error("Filter taps of "+std::to_string(offset.size())+" offsets do not match "+std::to_string(dst.size())+" elements.");
+	}
+	kernels().filter_rgba(src.data(), dst.data(), offset.data(), index.data(), weight.data(), dst.size()/4);
+}
+
+void unpremultiply_alpha(std::span<std::uint8_t> rgba) {
+	check_pixels(rgba.size(), 4);
+	// Integer division has no vector instruction, a reciprocal per alpha value keeps it exact.
+	static const auto reciprocals = [] {
+		std::array<std::uint32_t, 256> reciprocals {};
+		for(size_t alpha = 1; alpha < reciprocals.size(); ++alpha) {
+			reciprocals[alpha] = static_cast<std::uint32_t>(((255u << 16)+alpha-1)/alpha);
+		}
+		return reciprocals;
+	}();
+	parallel_blocks(rgba.size()/4, [&](size_t begin, size_t end) {
+		for(auto i = begin; i < end; ++i) {
+			auto* pixel = rgba.data()+i*4;
+			const auto alpha = pixel[3];
+			for(size_t c = 0; c < 3; ++c) {
+				const auto value = alpha == 0 ? 0u : (pixel[c]*reciprocals[alpha]+(1u << 15)) >> 16;
+				pixel[c] = static_cast<std::uint8_t>(std::min(value, 255u));
+			}
+		}
+	});
+}
+
+}
@@ -0,0 +1,424 @@
+#include "glpp/core/object/image_pipeline.hpp"
+#include <stdexcept>
+#include <string>
+
+namespace glpp::core::object {
+
+namespace {
+
+constexpr size_t group_size = 16;
+// Enough for the intermediate textures of a few pipelines with different sizes.
+constexpr size_t max_pooled_textures = 32;
+
+// Every pass reads its source with texelFetch and writes one pixel per invocation.
+constexpr const char* compute_header = R"(#version 430
+layout(local_size_x = 16, local_size_y = 16) in;
+layout(rgba32f, binding = 0) uniform writeonly image2D destination;
+uniform sampler2D source;
+)";
+
+constexpr const char* filter_code = R"(
+uniform bool horizontal;
+uniform int kernel;
+uniform float support;
+uniform float sigma;
+
+const float pi = 3.14159265358979;
+
+float sinc(float x) {
+	return x == 0.0 ? 1.0 : sin(pi*x)/(pi*x);
+}
+
+float bessel_i0(float x) {
+	float sum = 1.0;
+	float term = 1.0;
+	for(int k = 1; k < 32; ++k) {
+		term *= (x/(2.0*k))*(x/(2.0*k));
+		sum += term;
+	}
+	return sum;
+}
+
+// Same kernels as the resampling of image_t.
+float weight(float x) {
+	x = abs(x);
+	if(x >= support) return 0.0;
+	switch(kernel) {
+		case 1: {
+			float t = x/3.0;
+			return sinc(x)*bessel_i0(4.0*sqrt(1.0-t*t))/bessel_i0(4.0);
+		}
+		case 2:
+			return 1.0-x;
+		case 3:
+			return x < 1.0 ? (1.5*x-2.5)*x*x+1.0 : ((-0.5*x+2.5)*x-4.0)*x+2.0;
+		case 4:
+			return sinc(x)*sinc(x/3.0);
+		default:
+			return exp(-0.5*x*x/(sigma*sigma));
+	}
+}
+
+void main() {
+	ivec2 position = ivec2(gl_GlobalInvocationID.xy);
+	ivec2 size = imageSize(destination);
+	if(position.x >= size.x || position.y >= size.y) return;
+
+	int axis = horizontal ? 0 : 1;
+	int source_size = textureSize(source, 0)[axis];
+	float scale = float(source_size)/float(size[axis]);
+	vec4 sum = vec4(0.0);
+	float total = 0.0;
+	ivec2 tap = position;
+	if(kernel == 0) {
+		// Exact area coverage of the destination pixel.
+		float lo = float(position[axis])*scale;
+		float hi = lo+scale;
+		for(int j = int(lo); j < source_size && float(j) < hi; ++j) {
+			float coverage = min(float(j+1), hi)-max(float(j), lo);
+			if(coverage <= 0.0) continue;
+			tap[axis] = j;
+			sum += coverage*texelFetch(source, tap, 0);
+			total += coverage;
+		}
+	} else {
+		// Minification widens the kernel by the scale factor to stay band limited.
+		float widen = max(scale, 1.0);
+		float center = (float(position[axis])+0.5)*scale;
+		int first = int(floor(center-support*widen));
+		int last = int(ceil(center+support*widen));
+		for(int j = first; j <= last; ++j) {
+			float w = weight((float(j)+0.5-center)/widen);
+			if(w == 0.0) continue;
+			tap[axis] = clamp(j, 0, source_size-1);
+			sum += w*texelFetch(source, tap, 0);
+			total += w;
+		}
+	}
+	imageStore(destination, position, sum/total);
+}
+)";
+
+constexpr const char* convert_code = R"(
+uniform int conversion;
+
+vec3 srgb_to_linear(vec3 c) {
+	return mix(c/12.92, pow((c+0.055)/1.055, vec3(2.4)), greaterThan(c, vec3(0.04045)));
+}
+
+vec3 linear_to_srgb(vec3 c) {
+	c = max(c, vec3(0.0));
+	return mix(c*12.92, 1.055*pow(c, vec3(1.0/2.4))-0.055, greaterThan(c, vec3(0.0031308)));
+}
+
+void main() {
+	ivec2 position = ivec2(gl_GlobalInvocationID.xy);
+	ivec2 size = imageSize(destination);
+	if(position.x >= size.x || position.y >= size.y) return;
+
+	vec4 color = texelFetch(source, position, 0);
+	switch(conversion) {
+		case 0:
+			color.rgb = srgb_to_linear(color.rgb);
+			break;
+		case 1:
+			color.rgb = linear_to_srgb(color.rgb);
+			break;
+		default:
+			color.rgb = vec3(dot(color.rgb, vec3(0.2126, 0.7152, 0.0722)));
+	}
+	imageStore(destination, position, color);
+}
+)";
+
+constexpr const char* sharpen_code = R"(
+uniform sampler2D blurred;
+uniform float amount;
+
+void main() {
+	ivec2 position = ivec2(gl_GlobalInvocationID.xy);
+	ivec2 size = imageSize(destination);
+	if(position.x >= size.x || position.y >= size.y) return;
+
+	vec4 color = texelFetch(source, position, 0);
+	color.rgb += amount*(color.rgb-texelFetch(blurred, position, 0).rgb);
+	imageStore(destination, position, color);
+}
+)";
+
+struct kernel_t {
+	int id;
+	float support;
+};
+
+kernel_t kernel(mip_filter_t filter) {
+	switch(filter) {
+		case mip_filter_t::box:
+			return { 0, 0.0f };
+		case mip_filter_t::kaiser:
+			return { 1, 3.0f };
+		case mip_filter_t::bilinear:
+			return { 2, 1.0f };
+		case mip_filter_t::bicubic:
+			return { 3, 2.0f };
+		default:
+			return { 4, 3.0f };
+	}
+}
+
+constexpr int gaussian_kernel = 5;
+
+shader_program_t compute_program(const char* code) {
+	return shader_program_t { shader_t(shader_type_t::compute, std::string(compute_header)+code) };
+}
+
+}
+
+image_pipeline_t& image_pipeline_t::resample(size_t width, size_t height, mip_filter_t filter) {
+	if(width == 0 || height == 0) {
+		throw std::runtime_error("Images can not be resampled to "+std::to_string(width)+"x"+std::to_string(height)+" pixels.");
+	}
+	return add({ kind_t::resample, width, height, filter });
+}
+
+image_pipeline_t& image_pipeline_t::convert(color_conversion_t conversion) {
+	operation_t operation { kind_t::convert };
+	operation.conversion = conversion;
+	return add(operation);
+}
+
+image_pipeline_t& image_pipeline_t::blur(float sigma) {
+	if(!(sigma > 0.0f)) {
+		throw std::runtime_error("The sigma of a blur needs to be positive.");
+	}
+	operation_t operation { kind_t::blur };
+	operation.sigma = sigma;
+	return add(operation);
+}
+
+image_pipeline_t& image_pipeline_t::sharpen(float amount, float sigma) {
+	if(!(sigma > 0.0f)) {
+		throw std::runtime_error("The sigma of a blur needs to be positive.");
+	}
+	operation_t operation { kind_t::sharpen };
+	operation.sigma = sigma;
+	operation.amount = amount;
+	return add(operation);
+}
+
+image_pipeline_t& image_pipeline_t::generate_mipmaps() {
+	return add({ kind_t::mipmaps });
+}
+
+size_t image_pipeline_t::size() const {
+	return m_operations.size();
+}
+
+bool image_pipeline_t::empty() const {
+	return m_operations.empty();
+}
+
+image_pipeline_t& image_pipeline_t::add(operation_t operation) {
+	if(!m_operations.empty() && m_operations.back().kind == kind_t::mipmaps) {
+		throw std::runtime_error("generate_mipmaps() needs to be the last operation of an image pipeline.");
+	}
+	m_operations.push_back(operation);
+	return *this;
+}
+
+namespace detail {
+
+image_readback_t::image_readback_t(std::vector<level_t> levels, size_t size) :
+	readback_buffer_t(size),
+	m_levels(std::move(levels))
+{}
+
+const std::vector<image_readback_t::level_t>& image_readback_t::levels() const {
+	return m_levels;
+}
+
+}
+
+gpu_image_processor_t::gpu_image_processor_t() :
+	m_filter(compute_program(filter_code)),
+	m_convert(compute_program(convert_code)),
+	m_sharpen(compute_program(sharpen_code))
+{}
+
+size_t gpu_image_processor_t::pooled_textures() const {
+	return m_pool.size();
+}
+
+void gpu_image_processor_t::clear_pool() {
+	m_pool.clear();
+}
+
+std::shared_ptr<const detail::image_readback_t> gpu_image_processor_t::run(
+	pooled_texture_t source,
+	const image_pipeline_t& pipeline,
+	GLenum format,
+	GLenum type,
+	size_t pixel_size
+) {
+	using kind_t = image_pipeline_t::kind_t;
+	auto current = std::move(source);
+	const auto replace = [&](pooled_texture_t next) {
+		release(std::move(current));
+		current = std::move(next);
+	};
+
+	for(const auto& operation : pipeline.m_operations) {
+		switch(operation.kind) {
+			case kind_t::resample:
+				replace(filter(current, operation.width, operation.height, operation.filter));
+				break;
+			case kind_t::convert:
+			{
+				auto result = acquire(current.width, current.height);
+				const auto slot = current.texture.bind_to_texture_slot();
+				m_convert.set_texture("source", slot);
+				m_convert.set_uniform("conversion", static_cast<GLint>(operation.conversion));
+				m_convert.use();
+				dispatch(result);
+				replace(std::move(result));
+				break;
+			}
+			case kind_t::blur:
+				replace(blur(current, operation.sigma));
+				break;
+			case kind_t::sharpen:
+			{
+				auto blurred = blur(current, operation.sigma);
+				auto result = acquire(current.width, current.height);
+				const auto source_slot = current.texture.bind_to_texture_slot();
+				const auto blurred_slot = blurred.texture.bind_to_texture_slot();
+				m_sharpen.set_texture("source", source_slot);
+				m_sharpen.set_texture("blurred", blurred_slot);
+				m_sharpen.set_uniform("amount", operation.amount);
+				m_sharpen.use();
+				dispatch(result);
+				release(std::move(blurred));
+				replace(std::move(result));
+				break;
+			}
+			case kind_t::mipmaps:
+			{
+				auto result = acquire(current.width, current.height, true);
+				result.texture.copy(current.texture, 0, 0, 0, 0, current.width, current.height);
+				result.texture.generate_mipmaps();
+				replace(std::move(result));
+				break;
+			}
+		}
+	}
+
+	std::vector<detail::image_readback_t::level_t> levels;
+	size_t size = 0;
+	const auto level_count = current.mipmaps ? current.texture.levels() : 1;
+	for(size_t level = 0; level < level_count; ++level) {
+		const auto width = std::max<size_t>(current.width >> level, 1);
+		const auto height = std::max<size_t>(current.height >> level, 1);
+		levels.push_back({ width, height, size });
+		size += width*height*pixel_size;
+	}
+
+	auto readback = std::make_shared<detail::image_readback_t>(levels, size);
+	detail::pack_pixels(*readback, [&]() {
+		for(size_t level = 0; level < levels.size(); ++level) {
+			const auto offset = levels[level].offset;
+			glGetTextureImage(current.texture.id(), level, format, type, size-offset, reinterpret_cast<void*>(offset));
+		}
+	});
+	release(std::move(current));
+	return readback;
+}
+
+gpu_image_processor_t::pooled_texture_t gpu_image_processor_t::acquire(size_t width, size_t height, bool mipmaps) {
+	// Commands of later jobs are executed after the ones of earlier jobs, so textures can be reused right away.
+	const auto match = std::find_if(m_pool.rbegin(), m_pool.rend(), [&](const pooled_texture_t& texture) {
+		return texture.width == width && texture.height == height && texture.mipmaps == mipmaps;
+	});
+	if(match != m_pool.rend()) {
+		auto result = std::move(*match);
+		m_pool.erase(std::next(match).base());
+		return result;
+	}
+	return {
+		width,
+		height,
+		mipmaps,
+		texture_t(
+			width,
+			height,
+			image_format_t::rgba_32f,
+			clamp_mode_t::clamp_to_edge,
+			filter_mode_t::nearest,
+			mipmaps ? mipmap_mode_t::linear : mipmap_mode_t::none
+		)
+	};
+}
+
+void gpu_image_processor_t::release(pooled_texture_t texture) {
+	if(m_pool.size() == max_pooled_textures) {
+		m_pool.erase(m_pool.begin());
+	}
+	m_pool.push_back(std::move(texture));
+}
+
+gpu_image_processor_t::pooled_texture_t gpu_image_processor_t::filter(const pooled_texture_t& source, size_t width, size_t height, mip_filter_t filter) {
+	const auto [id, support] = kernel(filter);
+	// A pass at the same size is the identity for every kernel and skipped.
+	auto horizontal = acquire(width, source.height);
+	if(width != source.width) {
+		filter_pass(source, horizontal, true, id, support, 0.0f);
+	} else {
+		horizontal.texture.copy(source.texture, 0, 0, 0, 0, width, source.height);
+	}
+	if(height == source.height) {
+		return horizontal;
+	}
+	auto result = acquire(width, height);
+	filter_pass(horizontal, result, false, id, support, 0.0f);
+	release(std::move(horizontal));
+	return result;
+}
+
+gpu_image_processor_t::pooled_texture_t gpu_image_processor_t::blur(const pooled_texture_t& source, float sigma) {
+	auto horizontal = acquire(source.width, source.height);
+	filter_pass(source, horizontal, true, gaussian_kernel, 3.0f*sigma, sigma);
+	auto result = acquire(source.width, source.height);
+	filter_pass(horizontal, result, false, gaussian_kernel, 3.0f*sigma, sigma);
+	release(std::move(horizontal));
+	return result;
+}
+
+void gpu_image_processor_t::filter_pass(
+	const pooled_texture_t& source,
+	const pooled_texture_t& destination,
+	bool horizontal,
+	int kernel,
+	float support,
+	float sigma
+) {
+	const auto slot = source.texture.bind_to_texture_slot();
+	m_filter.set_texture("source", slot);
+	m_filter.set_uniform("horizontal", horizontal);
+	m_filter.set_uniform("kernel", static_cast<GLint>(kernel));
+	m_filter.set_uniform("support", support);
+	m_filter.set_uniform("sigma", sigma);
+	m_filter.use();
+	dispatch(destination);
+}
+
+void gpu_image_processor_t::dispatch(const pooled_texture_t& destination) {
+	glBindImageTexture(0, destination.texture.id(), 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA32F);
+	glDispatchCompute(
+		(destination.width+group_size-1)/group_size,
+		(destination.height+group_size-1)/group_size,
+		1
+	);
+	// The next pass samples the result, copies and readbacks access it as a texture.
+	glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT);
+}
+
+}
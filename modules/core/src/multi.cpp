@@ -1,4 +1,5 @@
 #include <glpp/core/object/texture_atlas/multi.hpp>
+#include <glpp/core/object/texture_unit_cache.hpp>
 
 namespace glpp::core::object::texture_atlas {
 
@@ -36,17 +37,19 @@ void multi_policy_t::free(const key_t key) {
 }
 
 multi_policy_t::slot_storage_t multi_policy_t::slots() const {
-    slot_storage_t result;
+    std::vector<texture_binding_t> bindings;
+    bindings.reserve(m_storage.size());
     std::transform(
         m_storage.begin(),
         m_storage.end(),
-        std::back_inserter(result),
+        std::back_inserter(bindings),
         [](const auto& value) {
             const auto& [key, tex] = value;
-            return tex.bind_to_texture_slot();
+            return texture_binding_t{ tex.id() };
         }
     );
-    return result;
+    // Textures, which are still resident from the last call, are not bound again.
+    return texture_unit_cache_t::current().acquire(bindings);
 }
 
 std::string multi_policy_t::texture_id(const std::string_view name, const std::string_view key) const {
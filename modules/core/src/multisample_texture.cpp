@@ -0,0 +1,73 @@
+#include "glpp/core/object/multisample_texture.hpp"
+#include "glpp/core/object/texture_unit_cache.hpp"
+#include <string>
+
+namespace glpp::core::object {
+
+multisample_texture_t::multisample_texture_t(
+	const size_t width,
+	const size_t height,
+	const size_t samples,
+	image_format_t format,
+	bool fixed_sample_locations
+) :
+	object_t<>(init(), destroy),
+	m_width(width),
+	m_height(height),
+	m_samples(samples),
+	m_format(static_cast<GLenum>(format))
+{
+	if(format == image_format_t::preferred || is_block_compressed(format)) {
+		throw std::runtime_error("Multisample textures need an uncompressed sized format.");
+	}
+	if(samples == 0) {
+		throw std::runtime_error("Multisample textures need at least one sample.");
+	}
+	glTextureStorage2DMultisample(
+		id(),
+		m_samples,
+		m_format,
+		width,
+		height,
+		fixed_sample_locations ? GL_TRUE : GL_FALSE
+	);
+}
+
+texture_slot_t multisample_texture_t::bind_to_texture_slot() const {
+	return texture_unit_cache_t::current().acquire(texture_binding_t{ id(), 0, GL_TEXTURE_2D_MULTISAMPLE });
+}
+
+size_t multisample_texture_t::width() const {
+	return m_width;
+}
+
+size_t multisample_texture_t::height() const {
+	return m_height;
+}
+
+size_t multisample_texture_t::samples() const {
+	return m_samples;
+}
+
+image_format_t multisample_texture_t::format() const {
+	return static_cast<image_format_t>(m_format);
+}
+
+size_t multisample_texture_t::max_samples() {
+	GLint samples = 0;
+	glGetIntegerv(GL_MAX_COLOR_TEXTURE_SAMPLES, &samples);
+	return samples;
+}
+
+GLuint multisample_texture_t::init() {
+	GLuint tex;
+	glCreateTextures(GL_TEXTURE_2D_MULTISAMPLE, 1, &tex);
+	return tex;
+}
+
+void multisample_texture_t::destroy(GLuint id) {
+	texture_unit_cache_t::current().evict_texture(id);
+	glDeleteTextures(1, &id);
+}
+
+}
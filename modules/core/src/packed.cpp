@@ -0,0 +1,425 @@
+#include <glpp/core/object/texture_atlas/packed.hpp>
+#include <limits>
+
+namespace glpp::core::object::texture_atlas {
+
+rect_packer_t::rect_packer_t(std::uint32_t width, std::uint32_t height) :
+    m_width(width),
+    m_height(height),
+    m_skyline{ segment_t{ 0, 0, width } }
+{}
+
+std::optional<rect_t> rect_packer_t::alloc(std::uint32_t width, std::uint32_t height) {
+    if(width == 0 || height == 0 || width > m_width || height > m_height) {
+        return std::nullopt;
+    }
+    auto rect = alloc_free(width, height);
+    if(!rect) {
+        rect = alloc_skyline(width, height);
+    }
+    if(rect) {
+        m_used_area += static_cast<std::uint64_t>(width)*height;
+    }
+    return rect;
+}
+
+void rect_packer_t::free(const rect_t& rect) {
+    m_used_area -= static_cast<std::uint64_t>(rect.width)*rect.height;
+    auto merged = rect;
+    // Merge with free neighbours sharing a full edge, so larger entries can reuse the space.
+    for(auto it = m_free.begin(); it != m_free.end();) {
+        const auto& other = it->second;
+        const auto horizontal = other.y == merged.y && other.height == merged.height &&
+            (other.x+other.width == merged.x || merged.x+merged.width == other.x);
+        const auto vertical = other.x == merged.x && other.width == merged.width &&
+            (other.y+other.height == merged.y || merged.y+merged.height == other.y);
+        if(horizontal) {
+            merged = { std::min(merged.x, other.x), merged.y, merged.width+other.width, merged.height };
+        } else if(vertical) {
+            merged = { merged.x, std::min(merged.y, other.y), merged.width, merged.height+other.height };
+        } else {
+            ++it;
+            continue;
+        }
+        m_free.erase(it);
+        it = m_free.begin();
+    }
+    m_free.emplace(static_cast<std::uint64_t>(merged.width)*merged.height, merged);
+}
+
+void rect_packer_t::grow(std::uint32_t width, std::uint32_t height) {
+    if(width > m_width) {
+        if(m_skyline.back().y == 0) {
+            m_skyline.back().width += width-m_width;
+        } else {
+            m_skyline.push_back(segment_t{ m_width, 0, width-m_width });
+        }
+        m_width = width;
+    }
+    m_height = std::max(m_height, height);
+}
+
+std::uint32_t rect_packer_t::width() const {
+    return m_width;
+}
+
+std::uint32_t rect_packer_t::height() const {
+    return m_height;
+}
+
+float rect_packer_t::fragmentation() const {
+    std::uint64_t area = 0;
+    for(const auto& segment : m_skyline) {
+        area += static_cast<std::uint64_t>(segment.width)*segment.y;
+    }
+    return area == 0 ? 0.0f : 1.0f-static_cast<float>(m_used_area)/static_cast<float>(area);
+}
+
+std::optional<rect_t> rect_packer_t::alloc_free(std::uint32_t width, std::uint32_t height) {
+    // The smallest free rectangles with a sufficient area are tried first.
+    for(auto it = m_free.lower_bound(static_cast<std::uint64_t>(width)*height); it != m_free.end(); ++it) {
+        const auto free = it->second;
+        if(free.width < width || free.height < height) continue;
+        m_free.erase(it);
+
+        // Guillotine split along the axis with the larger leftover.
+        rect_t right, bottom;
+        if(free.width-width > free.height-height) {
+            right = { free.x+width, free.y, free.width-width, free.height };
+            bottom = { free.x, free.y+height, width, free.height-height };
+        } else {
+            right = { free.x+width, free.y, free.width-width, height };
+            bottom = { free.x, free.y+height, free.width, free.height-height };
+        }
+        for(const auto& rest : { right, bottom }) {
+            if(rest.width > 0 && rest.height > 0) {
+                m_free.emplace(static_cast<std::uint64_t>(rest.width)*rest.height, rest);
+            }
+        }
+        return rect_t{ free.x, free.y, width, height };
+    }
+    return std::nullopt;
+}
+
+std::optional<rect_t> rect_packer_t::alloc_skyline(std::uint32_t width, std::uint32_t height) {
+    auto best_index = m_skyline.size();
+    auto best_y = std::numeric_limits<std::uint32_t>::max();
+    for(size_t i = 0; i < m_skyline.size(); ++i) {
+        const auto x = m_skyline[i].x;
+        if(x+width > m_width) break;
+        // The rectangle rests on the highest segment below it.
+        std::uint32_t y = 0;
+        std::uint32_t covered = 0;
+        for(auto j = i; covered < width; ++j) {
+            y = std::max(y, m_skyline[j].y);
+            covered += m_skyline[j].width;
+        }
+        if(y+height <= m_height && y < best_y) {
+            best_y = y;
+            best_index = i;
+        }
+    }
+    if(best_index == m_skyline.size()) {
+        return std::nullopt;
+    }
+
+    const rect_t rect { m_skyline[best_index].x, best_y, width, height };
+    const auto right = rect.x+width;
+    auto it = m_skyline.insert(m_skyline.begin()+best_index, segment_t{ rect.x, best_y+height, width });
+    for(++it; it != m_skyline.end() && it->x < right;) {
+        const auto overlap = right-it->x;
+        if(it->width <= overlap) {
+            it = m_skyline.erase(it);
+        } else {
+            it->x += overlap;
+            it->width -= overlap;
+            break;
+        }
+    }
+    for(size_t i = 1; i < m_skyline.size();) {
+        if(m_skyline[i-1].y == m_skyline[i].y) {
+            m_skyline[i-1].width += m_skyline[i].width;
+            m_skyline.erase(m_skyline.begin()+i);
+        } else {
+            ++i;
+        }
+    }
+    return rect;
+}
+
+packed_policy_t::packed_policy_t(
+    const std::size_t width,
+    const std::size_t height,
+    const std::size_t padding,
+    const image_format_t format,
+    const clamp_mode_t clamp_mode,
+    const filter_mode_t filter,
+    const mipmap_mode_t mipmap_mode,
+    const swizzle_mask_t swizzle_mask
+) :
+    m_padding(padding),
+    m_format(format),
+    m_clamp_mode(clamp_mode),
+    m_filter(filter),
+    m_mipmap_mode(mipmap_mode),
+    m_swizzle_mask(swizzle_mask),
+    m_max_width(width),
+    m_max_height(height),
+    m_packer(width, height),
+    m_storage{
+        storage_t::value_type{
+            width,
+            height,
+            format,
+            clamp_mode,
+            filter,
+            mipmap_mode,
+            swizzle_mask
+        }
+    },
+    m_rects(buffer_target_t::shader_storage_buffer, nullptr, sizeof(glm::vec4), buffer_usage_t::dynamic_draw)
+{}
+
+bool packed_policy_t::contains(const key_t key) const {
+    return m_entries.contains(key);
+}
+
+size_t packed_policy_t::size() const {
+    return m_entries.size();
+}
+
+size_t packed_policy_t::max_size() const {
+    return std::numeric_limits<key_t>::max();
+}
+
+void packed_policy_t::free(const key_t key) {
+    const auto it = m_entries.find(key);
+    if(it == m_entries.end()) {
+        throw std::runtime_error("Trying to free unallocated subtexture.");
+    }
+    m_defragmentation.reset();
+    m_rects_dirty = true;
+    m_packer.free(it->second);
+    m_entries.erase(it);
+}
+
+rect_t packed_policy_t::rect(const key_t key) const {
+    const auto& entry = m_entries.at(key);
+    const auto padding = static_cast<std::uint32_t>(m_padding);
+    return { entry.x+padding, entry.y+padding, entry.width-2*padding, entry.height-2*padding };
+}
+
+glm::vec4 packed_policy_t::uv_rect(const key_t key) const {
+    const auto entry = rect(key);
+    const auto width = static_cast<float>(m_packer.width());
+    const auto height = static_cast<float>(m_packer.height());
+    return glm::vec4(entry.x/width, entry.y/height, entry.width/width, entry.height/height);
+}
+
+packed_policy_t::slot_storage_t packed_policy_t::slots() const {
+    upload_rects();
+    m_rects.bind_base(m_rect_binding);
+    return { m_storage[0].bind_to_texture_slot() };
+}
+
+std::string packed_policy_t::texture_id(const std::string_view name, const std::string_view) const {
+    return std::string(name);
+}
+
+std::string packed_policy_t::declaration(const std::string_view name) const {
+    // The rectangles are read from a storage buffer, so the shader does not change with the entries.
+    return fmt::format(
+        "uniform sampler2D {0};\n"
+        "layout(std430, binding = {1}) readonly buffer glpp_{0}_rects_block {{\n"
+        "	vec4 glpp_{0}_rects[];\n"
+        "}};\n"
+        "vec4 glpp_fetch_{0}(in vec2 uv, in int index) {{\n"
+        "	vec2 uv_clamped = {2};\n"
+        "	vec4 rect = glpp_{0}_rects[index];\n"
+        "	return texture({0}, rect.xy+uv_clamped*rect.zw);\n"
+        "}}\n",
+        name, m_rect_binding, detail::clamp_uv(m_clamp_mode, glm::vec2(0.0f))
+    );
+}
+
+std::string packed_policy_t::fetch(const std::string_view name, const std::string_view key, const std::string_view uv) const {
+    return fmt::format("glpp_fetch_{}({}, {})", name, uv, key);
+}
+
+packed_policy_t::key_t packed_policy_t::first_free_key() const {
+    key_t key = 0;
+    for(const auto& [used, entry] : m_entries) {
+        if(used != key) break;
+        ++key;
+    }
+    return key;
+}
+
+packed_policy_t::key_storage_t packed_policy_t::keys() const {
+    key_storage_t result;
+    result.reserve(m_entries.size());
+    for(const auto& [key, entry] : m_entries) {
+        result.push_back(key);
+    }
+    return result;
+}
+
+table_record_t packed_policy_t::record(const key_t key) const {
+    return { uv_rect(key), 0, detail::table_clamp_mode(m_clamp_mode), 1, 0 };
+}
+
+std::string packed_policy_t::table_sampler(const std::string_view name) const {
+    return detail::table_sampler_2d(name);
+}
+
+std::size_t packed_policy_t::width() const {
+    return m_packer.width();
+}
+
+std::size_t packed_policy_t::height() const {
+    return m_packer.height();
+}
+
+void packed_policy_t::set_max_size(const std::size_t width, const std::size_t height) {
+    m_max_width = std::max<std::size_t>(width, m_packer.width());
+    m_max_height = std::max<std::size_t>(height, m_packer.height());
+}
+
+void packed_policy_t::grow(const std::size_t width, const std::size_t height) {
+    if(width <= m_packer.width() && height <= m_packer.height()) {
+        return;
+    }
+    m_defragmentation.reset();
+    m_rects_dirty = true;
+    auto storage = make_storage(std::max<std::size_t>(width, m_packer.width()), std::max<std::size_t>(height, m_packer.height()));
+    storage.copy(m_storage[0], 0, 0, 0, 0, m_packer.width(), m_packer.height());
+    storage.generate_mipmaps();
+    m_storage[0] = std::move(storage);
+    m_packer.grow(m_storage[0].width(), m_storage[0].height());
+    m_max_width = std::max(m_max_width, m_storage[0].width());
+    m_max_height = std::max(m_max_height, m_storage[0].height());
+    m_relocations.notify(keys());
+}
+
+float packed_policy_t::fragmentation() const {
+    return m_packer.fragmentation();
+}
+
+bool packed_policy_t::defragment(const std::chrono::nanoseconds budget) {
+    if(!m_defragmentation) {
+        if(m_entries.empty()) {
+            return true;
+        }
+        defragmentation_t defragmentation {
+            make_storage(m_packer.width(), m_packer.height()),
+            rect_packer_t{ m_packer.width(), m_packer.height() },
+            {},
+            keys()
+        };
+        // Tall entries first, like the batch insert of texture_atlas_t.
+        std::stable_sort(defragmentation.pending.begin(), defragmentation.pending.end(), [this](key_t lhs, key_t rhs) {
+            const auto& a = m_entries.at(lhs);
+            const auto& b = m_entries.at(rhs);
+            return std::pair(a.height, a.width) < std::pair(b.height, b.width);
+        });
+        m_defragmentation.emplace(std::move(defragmentation));
+    }
+
+    auto& defragmentation = *m_defragmentation;
+    const auto start = std::chrono::steady_clock::now();
+    do {
+        if(defragmentation.pending.empty()) {
+            break;
+        }
+        const auto key = defragmentation.pending.back();
+        const auto& source = m_entries.at(key);
+        const auto target = defragmentation.packer.alloc(source.width, source.height);
+        if(!target) {
+            // The repacked layout is not better than the current one, keep it.
+            m_defragmentation.reset();
+            return true;
+        }
+        defragmentation.storage.copy(m_storage[0], source.x, source.y, target->x, target->y, source.width, source.height);
+        defragmentation.entries.emplace(key, *target);
+        defragmentation.pending.pop_back();
+    } while(std::chrono::steady_clock::now()-start < budget);
+
+    if(!defragmentation.pending.empty()) {
+        return false;
+    }
+
+    std::vector<key_t> moved;
+    for(const auto& [key, entry] : defragmentation.entries) {
+        if(!(m_entries.at(key) == entry)) {
+            moved.push_back(key);
+        }
+    }
+    defragmentation.storage.generate_mipmaps();
+    m_storage[0] = std::move(defragmentation.storage);
+    m_packer = std::move(defragmentation.packer);
+    m_entries = std::move(defragmentation.entries);
+    m_defragmentation.reset();
+    m_rects_dirty = true;
+    m_relocations.notify(moved);
+    return true;
+}
+
+bool packed_policy_t::defragmenting() const {
+    return m_defragmentation.has_value();
+}
+
+relocation_notifier_t<packed_policy_t::key_t>& packed_policy_t::relocations() {
+    return m_relocations;
+}
+
+void packed_policy_t::set_rect_binding(const GLuint binding) {
+    m_rect_binding = binding;
+}
+
+GLuint packed_policy_t::rect_binding() const {
+    return m_rect_binding;
+}
+
+texture_t packed_policy_t::make_storage(const std::size_t width, const std::size_t height) const {
+    return { width, height, m_format, m_clamp_mode, m_filter, m_mipmap_mode, m_swizzle_mask };
+}
+
+void packed_policy_t::upload_rects() const {
+    if(!m_rects_dirty) {
+        return;
+    }
+    // The rectangles are indexed by key, unused keys map to an empty rectangle.
+    std::vector<glm::vec4> rects(m_entries.empty() ? 1 : m_entries.rbegin()->first+1, glm::vec4(0.0f));
+    for(const auto& [key, entry] : m_entries) {
+        rects[key] = uv_rect(key);
+    }
+    const auto size = rects.size()*sizeof(glm::vec4);
+    if(size > m_rects.size()) {
+        // Doubling keeps reallocations rare while keys are added one by one.
+        m_rects = buffer_t<glm::vec4>(buffer_target_t::shader_storage_buffer, nullptr, std::max(size, 2*m_rects.size()), buffer_usage_t::dynamic_draw);
+    }
+    m_rects.update(rects.data(), size);
+    m_rects_dirty = false;
+}
+
+rect_t packed_policy_t::reserve(std::uint32_t width, std::uint32_t height) {
+    auto rect = m_packer.alloc(width, height);
+    while(!rect && (m_packer.width() < m_max_width || m_packer.height() < m_max_height)) {
+        // Double the smaller side first, so the texture stays close to square.
+        auto new_width = m_packer.width();
+        auto new_height = m_packer.height();
+        if((new_width <= new_height || new_height >= m_max_height) && new_width < m_max_width) {
+            new_width = std::min<std::size_t>(new_width*2, m_max_width);
+        } else {
+            new_height = std::min<std::size_t>(new_height*2, m_max_height);
+        }
+        grow(new_width, new_height);
+        rect = m_packer.alloc(width, height);
+    }
+    if(!rect) {
+        throw std::runtime_error(fmt::format("bad_alloc: The packed texture atlas has no space left for an entry of size [{}, {}].", width, height));
+    }
+    return *rect;
+}
+
+} // namespace
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace glpp::core::object::detail {
+
+// Splits [0, rows) into contiguous chunks and runs functor(begin, end) for each chunk on its own
+// thread. Small workloads are executed on the calling thread.
+template <class Functor>
+void parallel_rows(size_t rows, size_t work_per_row, Functor&& functor) {
+	constexpr size_t min_work_per_thread = 1 << 16;
+	if(rows == 0) return;
+	const auto hardware = std::max(std::thread::hardware_concurrency(), 1u);
+	const auto threads = std::clamp<size_t>(rows*work_per_row/min_work_per_thread, 1, std::min<size_t>(hardware, rows));
+	if(threads == 1) {
+		functor(0, rows);
+		return;
+	}
+	std::vector<std::jthread> workers;
+	workers.reserve(threads-1);
+	const auto chunk = (rows+threads-1)/threads;
+	for(size_t begin = chunk; begin < rows; begin += chunk) {
+		workers.emplace_back(functor, begin, std::min(begin+chunk, rows));
+	}
+	functor(0, std::min(chunk, rows));
+}
+
+}
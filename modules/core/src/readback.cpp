@@ -0,0 +1,101 @@
+#include "glpp/core/object/readback.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace glpp::core::object::detail {
+
+readback_buffer_t::readback_buffer_t(size_t size) :
+	object_t(init(), destroy),
+	m_size(size),
+	// Empty storage is invalid, the buffer is never mapped past m_size anyways.
+	m_capacity(std::max<size_t>(size, 1))
+{
+	glNamedBufferStorage(id(), m_capacity, nullptr, GL_MAP_READ_BIT);
+}
+
+bool readback_buffer_t::ready() const {
+	return m_fence && m_fence->signaled();
+}
+
+bool readback_buffer_t::wait(std::chrono::nanoseconds timeout) const {
+	if(!m_fence) {
+		throw std::runtime_error("Waiting for a readback, which has not been issued.");
+	}
+	return m_fence->wait(timeout);
+}
+
+size_t readback_buffer_t::size() const {
+	return m_size;
+}
+
+size_t readback_buffer_t::capacity() const {
+	return m_capacity;
+}
+
+void readback_buffer_t::reuse(size_t size) {
+	if(size > m_capacity) {
+		throw std::runtime_error("Readback of "+std::to_string(size)+" bytes does not fit into a buffer of "+std::to_string(m_capacity)+" bytes.");
+	}
+	m_size = size;
+	m_fence.reset();
+}
+
+void readback_buffer_t::finish() {
+	m_fence = std::make_unique<fence_t>();
+	// Polls do not flush, without a flush the fence may never reach the GPU.
+	glFlush();
+}
+
+const std::byte* readback_buffer_t::map() const {
+	if(m_size == 0) {
+		return nullptr;
+	}
+	const auto* data = glMapNamedBufferRange(id(), 0, m_size, GL_MAP_READ_BIT);
+	if(data == nullptr) {
+		throw std::runtime_error("Mapping the buffer of a readback failed.");
+	}
+	return static_cast<const std::byte*>(data);
+}
+
+void readback_buffer_t::unmap() const {
+	if(m_size > 0) {
+		glUnmapNamedBuffer(id());
+	}
+}
+
+std::shared_ptr<readback_buffer_t> readback_pool_t::acquire(size_t size) {
+	// Buffers, whose handles are all gone, are only referenced by the pool.
+	const auto is_free = [](const auto& buffer) { return buffer.use_count() == 1; };
+	const auto fits = std::find_if(m_buffers.begin(), m_buffers.end(), [&](const auto& buffer) {
+		return is_free(buffer) && buffer->capacity() >= size;
+	});
+	if(fits != m_buffers.end()) {
+		(*fits)->reuse(size);
+		return *fits;
+	}
+	auto buffer = std::make_shared<readback_buffer_t>(size);
+	if(m_buffers.size() < max_buffers) {
+		m_buffers.push_back(buffer);
+	} else if(const auto small = std::find_if(m_buffers.begin(), m_buffers.end(), is_free); small != m_buffers.end()) {
+		// Reads grew, replaces a free buffer which is too small.
+		*small = buffer;
+	}
+	return buffer;
+}
+
+size_t readback_pool_t::size() const {
+	return m_buffers.size();
+}
+
+GLuint readback_buffer_t::init() {
+	GLuint id = 0;
+	glCreateBuffers(1, &id);
+	return id;
+}
+
+void readback_buffer_t::destroy(GLuint id) {
+	glDeleteBuffers(1, &id);
+}
+
+}
@@ -0,0 +1,57 @@
+#include "glpp/core/object/renderbuffer.hpp"
+#include "glpp/core/object/compressed_image.hpp"
+#include <stdexcept>
+
+namespace glpp::core::object {
+
+renderbuffer_t::renderbuffer_t(
+	const size_t width,
+	const size_t height,
+	image_format_t format,
+	const size_t samples
+) :
+	object_t<>(init(), destroy),
+	m_width(width),
+	m_height(height),
+	m_samples(samples),
+	m_format(static_cast<GLenum>(format))
+{
+	if(format == image_format_t::preferred || is_block_compressed(format)) {
+		throw std::runtime_error("Renderbuffers need an uncompressed sized format.");
+	}
+	glNamedRenderbufferStorageMultisample(id(), m_samples, m_format, width, height);
+}
+
+size_t renderbuffer_t::width() const {
+	return m_width;
+}
+
+size_t renderbuffer_t::height() const {
+	return m_height;
+}
+
+size_t renderbuffer_t::samples() const {
+	return m_samples;
+}
+
+image_format_t renderbuffer_t::format() const {
+	return static_cast<image_format_t>(m_format);
+}
+
+size_t renderbuffer_t::max_samples() {
+	GLint samples = 0;
+	glGetIntegerv(GL_MAX_SAMPLES, &samples);
+	return samples;
+}
+
+GLuint renderbuffer_t::init() {
+	GLuint id;
+	glCreateRenderbuffers(1, &id);
+	return id;
+}
+
+void renderbuffer_t::destroy(GLuint id) {
+	glDeleteRenderbuffers(1, &id);
+}
+
+}
@@ -1,4 +1,5 @@
 #include <glpp/core/object/shader_factory.hpp>
+#include <glpp/core/object/shader_template.hpp>
 #include <glm/glm.hpp>
 #include <streambuf>
 
@@ -17,47 +18,32 @@ shader_factory_t::shader_factory_t(const std::stringstream& code_template) :
 {}
 
 shader_factory_t::shader_factory_t(std::string code_template) :
-	m_code(code_template)
+	m_code(std::move(code_template))
 {}
 
-std::string to_string(const std::string& value) {
-	return value;
-}
-
-std::string to_string(const std::string_view& value) {
-	return std::string{ value };
-}
-
-
-template <class T, std::enable_if_t<std::is_arithmetic_v<T>>* = nullptr>
-std::string to_string(const T& value) {
-	return std::to_string(value);
-}
-
-template <class T, int N>
-std::string to_string(const glm::vec<N, T>& value) {
-	std::string result = "vec"+std::to_string(N)+"( ";
-	for(int i = 0; i < N; ++i) {
-		if(i != 0) {
-			result += ", ";
-		}
-		result += std::to_string(value[i]);
-	}
-	result += ")";
-	return result;
-}
-
 template<typename T>
 shader_factory_t& shader_factory_t::set(std::string_view key, const T& value)
 {
-	std::string::size_type pos = 0;
-	while((pos = m_code.find(key, pos)) != m_code.npos) {
-		const auto replace = to_string(value);
-		m_code.erase(pos, key.length());
-		m_code.insert(pos, replace);
-		pos += replace.length();
+	auto pos = m_code.find(key);
+	if(pos == m_code.npos) {
+		return *this;
 	}
 
+	// Build the result in a single pass instead of erasing and inserting in place, which would
+	// move the tail of the code for every occurrence of the key.
+	const auto replace = detail::to_glsl(value);
+	std::string result;
+	result.reserve(m_code.size()+replace.size());
+	std::string::size_type last = 0;
+	while(pos != m_code.npos) {
+		result.append(m_code, last, pos-last);
+		result += replace;
+		last = pos+key.length();
+		pos = m_code.find(key, last);
+	}
+	result.append(m_code, last);
+	m_code = std::move(result);
+
 	return *this;
 }
 
@@ -66,10 +52,14 @@ shader_factory_t& shader_factory_t::set(std::string_view key, const char* value)
 	return *this;
 }
 
-std::string shader_factory_t::code() const {
+const std::string& shader_factory_t::code() const & {
 	return m_code;
 }
 
+std::string shader_factory_t::code() && {
+	return std::move(m_code);
+}
+
 template shader_factory_t& shader_factory_t::set(std::string_view key, const float& value);
 template shader_factory_t& shader_factory_t::set(std::string_view key, const double& value);
 template shader_factory_t& shader_factory_t::set(std::string_view key, const std::string& value);
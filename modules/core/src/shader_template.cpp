@@ -0,0 +1,150 @@
+#include <glpp/core/object/shader_template.hpp>
+#include <glm/glm.hpp>
+#include <cstdint>
+
+namespace glpp::core::object {
+
+namespace detail {
+
+template <class T>
+std::string to_glsl(const T& value) {
+	if constexpr(std::is_same_v<T, std::string>) {
+		return value;
+	} else if constexpr(std::is_same_v<T, std::string_view>) {
+		return std::string{ value };
+	} else if constexpr(std::is_arithmetic_v<T>) {
+		return std::to_string(value);
+	} else {
+		constexpr auto N = T::length();
+		std::string result = "vec"+std::to_string(N)+"( ";
+		for(int i = 0; i < N; ++i) {
+			if(i != 0) {
+				result += ", ";
+			}
+			result += std::to_string(value[i]);
+		}
+		result += ")";
+		return result;
+	}
+}
+
+void render_shader_template(
+	std::string_view code,
+	std::span<const shader_template_segment_t> segments,
+	const shader_bindings_t& bindings,
+	std::string& output
+) {
+	std::size_t size = 0;
+	std::string missing;
+	for(const auto& segment : segments) {
+		const auto text = code.substr(segment.offset, segment.length);
+		if(!segment.placeholder) {
+			size += text.size();
+		} else if(const auto* value = bindings.find(text)) {
+			size += value->size();
+		} else if(missing.find(text) == missing.npos) {
+			missing += missing.empty() ? "" : ", ";
+			missing += text;
+		}
+	}
+	if(!missing.empty()) {
+		throw std::runtime_error("Shader template has unbound placeholders: "+missing+".");
+	}
+
+	output.clear();
+	output.reserve(size);
+	for(const auto& segment : segments) {
+		const auto text = code.substr(segment.offset, segment.length);
+		if(segment.placeholder) {
+			output += *bindings.find(text);
+		} else {
+			output += text;
+		}
+	}
+}
+
+std::vector<std::string_view> shader_template_placeholders(
+	std::string_view code,
+	std::span<const shader_template_segment_t> segments
+) {
+	std::vector<std::string_view> result;
+	for(const auto& segment : segments) {
+		if(!segment.placeholder) continue;
+		const auto text = code.substr(segment.offset, segment.length);
+		if(std::find(result.begin(), result.end(), text) == result.end()) {
+			result.emplace_back(text);
+		}
+	}
+	return result;
+}
+
+template std::string to_glsl(const float& value);
+template std::string to_glsl(const double& value);
+template std::string to_glsl(const std::string& value);
+template std::string to_glsl(const std::string_view& value);
+template std::string to_glsl(const glm::vec1& value);
+template std::string to_glsl(const glm::vec2& value);
+template std::string to_glsl(const glm::vec3& value);
+template std::string to_glsl(const glm::vec4& value);
+template std::string to_glsl(const glm::ivec1& value);
+template std::string to_glsl(const glm::ivec2& value);
+template std::string to_glsl(const glm::ivec3& value);
+template std::string to_glsl(const glm::ivec4& value);
+template std::string to_glsl(const glm::uvec1& value);
+template std::string to_glsl(const glm::uvec2& value);
+template std::string to_glsl(const glm::uvec3& value);
+template std::string to_glsl(const glm::uvec4& value);
+template std::string to_glsl(const glm::dvec1& value);
+template std::string to_glsl(const glm::dvec2& value);
+template std::string to_glsl(const glm::dvec3& value);
+template std::string to_glsl(const glm::dvec4& value);
+template std::string to_glsl(const std::int8_t& value);
+template std::string to_glsl(const std::int16_t& value);
+template std::string to_glsl(const std::int32_t& value);
+template std::string to_glsl(const std::int64_t& value);
+template std::string to_glsl(const std::uint8_t& value);
+template std::string to_glsl(const std::uint16_t& value);
+template std::string to_glsl(const std::uint32_t& value);
+template std::string to_glsl(const std::uint64_t& value);
+
+}
+
+shader_bindings_t& shader_bindings_t::set(std::string_view key, std::string value) {
+	const auto it = std::find_if(m_values.begin(), m_values.end(), [key](const auto& kv){ return kv.first == key; });
+	if(it != m_values.end()) {
+		it->second = std::move(value);
+	} else {
+		m_values.emplace_back(std::string(key), std::move(value));
+	}
+	return *this;
+}
+
+shader_bindings_t& shader_bindings_t::set(std::string_view key, const char* value) {
+	return set(key, std::string(value));
+}
+
+const std::string* shader_bindings_t::find(std::string_view key) const {
+	const auto it = std::find_if(m_values.begin(), m_values.end(), [key](const auto& kv){ return kv.first == key; });
+	return it != m_values.end() ? &it->second : nullptr;
+}
+
+bool shader_bindings_t::contains(std::string_view key) const {
+	return find(key) != nullptr;
+}
+
+std::size_t shader_bindings_t::size() const {
+	return m_values.size();
+}
+
+std::vector<std::string_view> shader_bindings_t::keys() const {
+	std::vector<std::string_view> result;
+	result.reserve(m_values.size());
+	for(const auto& [key, value] : m_values) {
+		result.emplace_back(key);
+	}
+	return result;
+}
+
+template class shader_template_t<>;
+
+}
@@ -0,0 +1,518 @@
+#include "glpp/core/object/shared_frame.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+#ifdef __linux__
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace glpp::core::object {
+
+namespace {
+
+constexpr size_t pixel_size = 4;
+constexpr std::uint64_t slot_mask = (std::uint64_t{ 1 } << shared_frame_header_t::slot_bits)-1;
+
+const std::byte* slot_data(const shared_frame_header_t* header, size_t slot) {
+	return reinterpret_cast<const std::byte*>(header)+header->data_offset+slot*header->slot_stride;
+}
+
+#ifdef __linux__
+
+std::uint64_t monotonic_now() {
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return static_cast<std::uint64_t>(now.tv_sec)*1'000'000'000u+static_cast<std::uint64_t>(now.tv_nsec);
+}
+
+sockaddr_un socket_address(const std::string& path) {
+	sockaddr_un address {};
+	address.sun_family = AF_UNIX;
+	if(path.empty() || path.size() >= sizeof(address.sun_path)) {
+		throw std::runtime_error("Socket path "+path+" is empty or too long.");
+	}
+	std::memcpy(address.sun_path, path.c_str(), path.size()+1);
+	return address;
+}
+
+std::string system_error(const std::string& message) {
+	return message+": "+std::strerror(errno);
+}
+
+// Timeouts beyond the range of poll wait forever.
+int poll_milliseconds(std::chrono::nanoseconds timeout) {
+	const auto milliseconds = std::chrono::ceil<std::chrono::milliseconds>(std::max(timeout, std::chrono::nanoseconds(0))).count();
+	return milliseconds > std::numeric_limits<int>::max() ? -1 : static_cast<int>(milliseconds);
+}
+
+#else
+
+std::uint64_t monotonic_now() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif
+
+}
+
+/* shared_frame_sink_t */
+
+#ifdef __linux__
+
+shared_frame_sink_t::shared_frame_sink_t(std::string socket_path, size_t width, size_t height, size_t slots) :
+	m_socket_path(std::move(socket_path)),
+	m_frame_size(width*height*pixel_size)
+{
+	if(width == 0 || height == 0) {
+		throw std::runtime_error("Frames of size "+std::to_string(width)+"x"+std::to_string(height)+" can not be shared.");
+	}
+	// The newest frame stays readable, so at least one further slot is needed for writing.
+	if(slots < 2 || slots > shared_frame_header_t::max_slots) {
+		throw std::runtime_error("Shared frames need 2 to "+std::to_string(shared_frame_header_t::max_slots)+" slots.");
+	}
+	const auto address = socket_address(m_socket_path);
+	const auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	const auto page_align = [&](size_t size) { return (size+page_size-1)/page_size*page_size; };
+	const auto data_offset = page_align(sizeof(shared_frame_header_t));
+	const auto slot_stride = page_align(m_frame_size);
+	m_mapping_size = data_offset+slots*slot_stride;
+
+	try {
+		m_memory = memfd_create("glpp_shared_frames", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+		if(m_memory < 0 || ftruncate(m_memory, m_mapping_size) != 0) {
+			throw std::runtime_error(system_error("Creating the shared frame memory failed"));
+		}
+		// Consumers can not resize the memory under the mapping of the producer.
+		fcntl(m_memory, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL);
+		auto* mapping = mmap(nullptr, m_mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_memory, 0);
+		if(mapping == MAP_FAILED) {
+			throw std::runtime_error(system_error("Mapping the shared frame memory failed"));
+		}
+		m_header = new(mapping) shared_frame_header_t();
+		m_header->magic = shared_frame_header_t::magic_value;
+		m_header->version = shared_frame_header_t::version_value;
+		m_header->width = width;
+		m_header->height = height;
+		m_header->pixel_size = pixel_size;
+		m_header->slots = slots;
+		m_header->slot_stride = slot_stride;
+		m_header->data_offset = data_offset;
+
+		m_listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+		if(m_listener < 0) {
+			throw std::runtime_error(system_error("Creating the socket failed"));
+		}
+		// A previous producer may have left its socket behind.
+		unlink(m_socket_path.c_str());
+		if(bind(m_listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(m_listener, 16) != 0) {
+			throw std::runtime_error(system_error("Listening on "+m_socket_path+" failed"));
+		}
+	} catch(...) {
+		close();
+		throw;
+	}
+}
+
+shared_frame_sink_t::~shared_frame_sink_t() {
+	close();
+}
+
+void shared_frame_sink_t::update_consumers() {
+	for(auto it = m_consumers.begin(); it != m_consumers.end();) {
+		char byte;
+		const auto received = recv(it->socket, &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+		if(received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+			// Releases the slots a crashed consumer did not release itself.
+			m_header->reading[it->index].store(0);
+			::close(it->socket);
+			::close(it->event);
+			it = m_consumers.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	while(true) {
+		const auto connection = accept4(m_listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if(connection < 0) return;
+		const auto used = [this](size_t index) {
+			return std::ranges::any_of(m_consumers, [&](const auto& consumer) { return consumer.index == index; });
+		};
+		size_t index = 0;
+		while(index < shared_frame_header_t::max_consumers && used(index)) ++index;
+		// Consumers beyond max_consumers have no reading mask, they see the closed connection.
+		const auto event = index < shared_frame_header_t::max_consumers ? eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK) : -1;
+		if(event < 0) {
+			::close(connection);
+			continue;
+		}
+
+		// Hands the memory and the eventfd to the consumer, the payload is the index of its reading mask.
+		m_header->reading[index].store(0);
+		char byte = static_cast<char>(index);
+		iovec payload { &byte, 1 };
+		alignas(cmsghdr) char control[CMSG_SPACE(2*sizeof(int))] {};
+		msghdr message {};
+		message.msg_iov = &payload;
+		message.msg_iovlen = 1;
+		message.msg_control = control;
+		message.msg_controllen = sizeof(control);
+		auto* header = CMSG_FIRSTHDR(&message);
+		header->cmsg_level = SOL_SOCKET;
+		header->cmsg_type = SCM_RIGHTS;
+		header->cmsg_len = CMSG_LEN(2*sizeof(int));
+		const int fds[2] { m_memory, event };
+		std::memcpy(CMSG_DATA(header), fds, sizeof(fds));
+		if(sendmsg(connection, &message, MSG_NOSIGNAL) != 1) {
+			::close(connection);
+			::close(event);
+			continue;
+		}
+		m_consumers.push_back({ connection, event, index });
+	}
+}
+
+size_t shared_frame_sink_t::accept(std::chrono::nanoseconds timeout) {
+	pollfd connection { m_listener, POLLIN, 0 };
+	poll(&connection, 1, poll_milliseconds(timeout));
+	update_consumers();
+	return m_consumers.size();
+}
+
+void shared_frame_sink_t::notify_consumers() {
+	const std::uint64_t frames = 1;
+	for(const auto& consumer : m_consumers) {
+		// Fails only if the counter would overflow, the consumer is signaled anyway.
+		[[maybe_unused]] const auto written = write(consumer.event, &frames, sizeof(frames));
+	}
+}
+
+void shared_frame_sink_t::close() {
+	for(const auto& consumer : m_consumers) {
+		::close(consumer.socket);
+		::close(consumer.event);
+	}
+	m_consumers.clear();
+	if(m_listener >= 0) {
+		::close(m_listener);
+		unlink(m_socket_path.c_str());
+		m_listener = -1;
+	}
+	if(m_header != nullptr) {
+		munmap(m_header, m_mapping_size);
+		m_header = nullptr;
+	}
+	if(m_memory >= 0) {
+		::close(m_memory);
+		m_memory = -1;
+	}
+}
+
+#else
+
+shared_frame_sink_t::shared_frame_sink_t(std::string, size_t, size_t, size_t) {
+	throw std::runtime_error("Shared frames are only supported on Linux.");
+}
+
+shared_frame_sink_t::~shared_frame_sink_t() = default;
+
+size_t shared_frame_sink_t::accept(std::chrono::nanoseconds) {
+	return 0;
+}
+
+void shared_frame_sink_t::update_consumers() {}
+void shared_frame_sink_t::notify_consumers() {}
+void shared_frame_sink_t::close() {}
+
+#endif
+
+void shared_frame_sink_t::capture(const framebuffer_t& framebuffer) {
+	if(!m_readbacks) {
+		m_readbacks.emplace(m_header->width, m_header->height, GL_RGBA, pixel_size, readback_depth);
+	}
+	const auto publish_frame = [this](std::span<const std::byte> pixels) { publish(pixels); };
+	m_readbacks->collect(false, publish_frame);
+	if(m_readbacks->full()) {
+		// Stalls until the oldest copy is finished, consumers prefer the newest frame anyway.
+		m_readbacks->wait();
+		m_readbacks->collect(false, publish_frame);
+	}
+	m_readbacks->capture(framebuffer);
+}
+
+void shared_frame_sink_t::flush() {
+	if(m_readbacks) {
+		m_readbacks->collect(true, [this](std::span<const std::byte> pixels) { publish(pixels); });
+	}
+}
+
+bool shared_frame_sink_t::publish(std::span<const std::byte> pixels) {
+	if(pixels.size() != m_frame_size) {
+		throw std::runtime_error(
+			"Frame of "+std::to_string(pixels.size())+" bytes does not match the shared frame size of "+std::to_string(m_frame_size)+" bytes."
+		);
+	}
+	update_consumers();
+
+	const auto read = [this](size_t index) {
+		const auto bit = std::uint32_t{ 1 } << index;
+		return std::ranges::any_of(m_consumers, [&](const auto& consumer) { return (m_header->reading[consumer.index].load() & bit) != 0; });
+	};
+	// The newest frame is never overwritten, consumers may be about to acquire it.
+	const auto slots = m_header->slots;
+	for(size_t i = 1; i < slots; ++i) {
+		const auto index = (m_last_slot+i)%slots;
+		auto& slot = m_header->slot[index];
+		if(read(index)) continue;
+		// Consumers mark the slot as read before checking the sequence, so either they see the invalidated
+		// sequence and back off, or the producer sees them and skips the slot.
+		slot.sequence.store(0);
+		if(read(index)) continue;
+
+		std::memcpy(const_cast<std::byte*>(slot_data(m_header, index)), pixels.data(), m_frame_size);
+		slot.timestamp.store(monotonic_now(), std::memory_order_relaxed);
+		++m_sequence;
+		slot.sequence.store(m_sequence, std::memory_order_release);
+		m_header->latest.store((m_sequence << shared_frame_header_t::slot_bits) | index, std::memory_order_release);
+		m_last_slot = index;
+		notify_consumers();
+		return true;
+	}
+	++m_dropped;
+	return false;
+}
+
+size_t shared_frame_sink_t::consumers() const {
+	return m_consumers.size();
+}
+
+size_t shared_frame_sink_t::published() const {
+	return m_sequence;
+}
+
+size_t shared_frame_sink_t::dropped() const {
+	return m_dropped;
+}
+
+size_t shared_frame_sink_t::frame_size() const {
+	return m_frame_size;
+}
+
+/* shared_frame_source_t */
+
+#ifdef __linux__
+
+shared_frame_source_t::shared_frame_source_t(const std::string& socket_path, std::chrono::nanoseconds timeout) {
+	const auto address = socket_address(socket_path);
+	const auto start = std::chrono::steady_clock::now();
+	const auto remaining = [&] { return timeout-(std::chrono::steady_clock::now()-start); };
+	try {
+		// The producer may not have created its socket yet.
+		while(true) {
+			m_socket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+			if(m_socket < 0) {
+				throw std::runtime_error(system_error("Creating the socket failed"));
+			}
+			if(connect(m_socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0) break;
+			if((errno != ENOENT && errno != ECONNREFUSED) || remaining() <= std::chrono::nanoseconds(0)) {
+				throw std::runtime_error(system_error("Connecting to "+socket_path+" failed"));
+			}
+			::close(m_socket);
+			m_socket = -1;
+			std::this_thread::sleep_for(std::min<std::chrono::nanoseconds>(remaining(), std::chrono::milliseconds(10)));
+		}
+
+		// The producer sends the descriptors once it accepts the consumer in accept() or publish().
+		pollfd accepted { m_socket, POLLIN, 0 };
+		if(poll(&accepted, 1, poll_milliseconds(remaining())) <= 0) {
+			throw std::runtime_error("The producer at "+socket_path+" did not accept the consumer in time.");
+		}
+
+		char byte;
+		iovec payload { &byte, 1 };
+		alignas(cmsghdr) char control[CMSG_SPACE(2*sizeof(int))] {};
+		msghdr message {};
+		message.msg_iov = &payload;
+		message.msg_iovlen = 1;
+		message.msg_control = control;
+		message.msg_controllen = sizeof(control);
+		if(recvmsg(m_socket, &message, MSG_CMSG_CLOEXEC) != 1) {
+			throw std::runtime_error(system_error("Receiving the shared frames from "+socket_path+" failed"));
+		}
+		const auto* header = CMSG_FIRSTHDR(&message);
+		if(header == nullptr || header->cmsg_type != SCM_RIGHTS || header->cmsg_len != CMSG_LEN(2*sizeof(int))) {
+			throw std::runtime_error("The producer at "+socket_path+" did not send the shared frames.");
+		}
+		int fds[2];
+		std::memcpy(fds, CMSG_DATA(header), sizeof(fds));
+		m_memory = fds[0];
+		m_event = fds[1];
+		m_consumer = static_cast<unsigned char>(byte);
+
+		struct stat status;
+		if(fstat(m_memory, &status) != 0 || static_cast<size_t>(status.st_size) < sizeof(shared_frame_header_t)) {
+			throw std::runtime_error("The shared frame memory of "+socket_path+" is invalid.");
+		}
+		m_mapping_size = status.st_size;
+		auto* mapping = mmap(nullptr, m_mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_memory, 0);
+		if(mapping == MAP_FAILED) {
+			throw std::runtime_error(system_error("Mapping the shared frames of "+socket_path+" failed"));
+		}
+		m_header = static_cast<shared_frame_header_t*>(mapping);
+		if(
+			m_header->magic != shared_frame_header_t::magic_value ||
+			m_header->version != shared_frame_header_t::version_value ||
+			m_header->slots > shared_frame_header_t::max_slots ||
+			m_consumer >= shared_frame_header_t::max_consumers ||
+			m_header->data_offset+m_header->slots*m_header->slot_stride > m_mapping_size
+		) {
+			throw std::runtime_error("The shared frame memory of "+socket_path+" has an unsupported layout.");
+		}
+	} catch(...) {
+		close();
+		throw;
+	}
+}
+
+shared_frame_source_t::~shared_frame_source_t() {
+	close();
+}
+
+bool shared_frame_source_t::wait(std::chrono::nanoseconds timeout) {
+	pollfd event { m_event, POLLIN, 0 };
+	if(poll(&event, 1, poll_milliseconds(timeout)) <= 0) return false;
+	std::uint64_t frames;
+	[[maybe_unused]] const auto received = read(m_event, &frames, sizeof(frames));
+	return true;
+}
+
+void shared_frame_source_t::close() {
+	if(m_header != nullptr) {
+		munmap(m_header, m_mapping_size);
+		m_header = nullptr;
+	}
+	for(auto* fd : { &m_event, &m_memory, &m_socket }) {
+		if(*fd >= 0) {
+			::close(*fd);
+			*fd = -1;
+		}
+	}
+}
+
+#else
+
+shared_frame_source_t::shared_frame_source_t(const std::string&, std::chrono::nanoseconds) {
+	throw std::runtime_error("Shared frames are only supported on Linux.");
+}
+
+shared_frame_source_t::~shared_frame_source_t() = default;
+
+bool shared_frame_source_t::wait(std::chrono::nanoseconds) {
+	return false;
+}
+
+void shared_frame_source_t::close() {}
+
+#endif
+
+std::optional<shared_frame_source_t::frame_t> shared_frame_source_t::acquire() {
+	while(true) {
+		const auto latest = m_header->latest.load(std::memory_order_acquire);
+		const auto sequence = latest >> shared_frame_header_t::slot_bits;
+		const auto index = latest & slot_mask;
+		if(sequence == m_last_sequence || index >= m_header->slots) {
+			return std::nullopt;
+		}
+		auto& reading = m_header->reading[m_consumer];
+		const auto bit = std::uint32_t{ 1 } << index;
+		reading.fetch_or(bit);
+		if(m_header->slot[index].sequence.load() == sequence) {
+			m_last_sequence = sequence;
+			return frame_t(m_header, m_consumer, index);
+		}
+		// The producer has started to overwrite the slot, a newer frame is on its way.
+		reading.fetch_and(~bit, std::memory_order_release);
+	}
+}
+
+size_t shared_frame_source_t::width() const {
+	return m_header->width;
+}
+
+size_t shared_frame_source_t::height() const {
+	return m_header->height;
+}
+
+/* shared_frame_source_t::frame_t */
+
+shared_frame_source_t::frame_t::frame_t(shared_frame_header_t* header, size_t consumer, size_t slot) :
+	m_header(header),
+	m_slot(&header->slot[slot]),
+	m_reading(&header->reading[consumer]),
+	m_bit(std::uint32_t{ 1 } << slot),
+	m_pixels(slot_data(header, slot), static_cast<size_t>(header->width)*header->height*header->pixel_size)
+{}
+
+shared_frame_source_t::frame_t::frame_t(frame_t&& mov) noexcept :
+	m_header(mov.m_header),
+	m_slot(mov.m_slot),
+	m_reading(std::exchange(mov.m_reading, nullptr)),
+	m_bit(mov.m_bit),
+	m_pixels(mov.m_pixels)
+{}
+
+shared_frame_source_t::frame_t& shared_frame_source_t::frame_t::operator=(frame_t&& mov) noexcept {
+	if(this != &mov) {
+		if(m_reading != nullptr) m_reading->fetch_and(~m_bit, std::memory_order_release);
+		m_header = mov.m_header;
+		m_slot = mov.m_slot;
+		m_reading = std::exchange(mov.m_reading, nullptr);
+		m_bit = mov.m_bit;
+		m_pixels = mov.m_pixels;
+	}
+	return *this;
+}
+
+shared_frame_source_t::frame_t::~frame_t() {
+	if(m_reading != nullptr) {
+		// Release ordering keeps the reads of the pixels before the producer can reuse the slot.
+		m_reading->fetch_and(~m_bit, std::memory_order_release);
+	}
+}
+
+std::uint64_t shared_frame_source_t::frame_t::sequence() const {
+	return m_slot->sequence.load(std::memory_order_relaxed);
+}
+
+std::chrono::nanoseconds shared_frame_source_t::frame_t::age() const {
+	return std::chrono::nanoseconds(monotonic_now()-m_slot->timestamp.load(std::memory_order_relaxed));
+}
+
+size_t shared_frame_source_t::frame_t::width() const {
+	return m_header->width;
+}
+
+size_t shared_frame_source_t::frame_t::height() const {
+	return m_header->height;
+}
+
+std::span<const std::byte> shared_frame_source_t::frame_t::pixels() const {
+	return m_pixels;
+}
+
+}
@@ -0,0 +1,61 @@
+#include <glpp/core/object/texture_atlas/table.hpp>
+#include <fmt/core.h>
+
+namespace glpp::core::object::texture_atlas::detail {
+
+std::string table_sampler_2d(const std::string_view name) {
+    return fmt::format(
+        "uniform sampler2D {0};\n"
+        "vec4 glpp_sample_{0}(in vec2 uv, in uint layer) {{\n"
+        "	return texture({0}, uv);\n"
+        "}}\n",
+        name
+    );
+}
+
+std::string table_sampler_2d_array(const std::string_view name) {
+    return fmt::format(
+        "uniform sampler2DArray {0};\n"
+        "vec4 glpp_sample_{0}(in vec2 uv, in uint layer) {{\n"
+        "	return texture({0}, vec3(uv, layer));\n"
+        "}}\n",
+        name
+    );
+}
+
+std::string table_lookup(const std::string_view name, const std::uint32_t binding) {
+    // The record struct is guarded, so several atlases can be declared in one shader.
+    return fmt::format(
+        "#ifndef GLPP_ATLAS_RECORD\n"
+        "#define GLPP_ATLAS_RECORD\n"
+        "struct glpp_atlas_record_t {{\n"
+        "	vec4 uv_rect;\n"
+        "	uint layer;\n"
+        "	uint clamp_mode;\n"
+        "	uint valid;\n"
+        "	uint padding;\n"
+        "}};\n"
+        "#endif\n"
+        "layout(std430, binding = {1}) readonly buffer glpp_{0}_table_block {{\n"
+        "	glpp_atlas_record_t glpp_{0}_table[];\n"
+        "}};\n"
+        "vec4 glpp_lookup_{0}(in vec2 uv, in uint key) {{\n"
+        "	if(key >= uint(glpp_{0}_table.length())) return vec4(0.0);\n"
+        "	const glpp_atlas_record_t record = glpp_{0}_table[key];\n"
+        "	if(record.valid == 0u) return vec4(0.0);\n"
+        "	vec2 uv_clamped;\n"
+        "	switch(record.clamp_mode) {{\n"
+        "		case 0u: uv_clamped = fract(uv); break;\n"
+        "		case 1u: uv_clamped = abs(uv-round(uv/2)*2); break;\n"
+        "		case 2u: uv_clamped = clamp(uv, 0.0, 1.0); break;\n"
+        "		default:\n"
+        "			if(any(lessThan(uv, vec2(0.0))) || any(greaterThan(uv, vec2(1.0)))) return vec4(0.0);\n"
+        "			uv_clamped = uv;\n"
+        "	}}\n"
+        "	return glpp_sample_{0}(record.uv_rect.xy+uv_clamped*record.uv_rect.zw, record.layer);\n"
+        "}}\n",
+        name, binding
+    );
+}
+
+} // namespace
@@ -1,46 +1,38 @@
 #include "glpp/core/object/texture.hpp"
+#include "glpp/core/object/texture_unit_cache.hpp"
+#include "glpp/core/object/texture_upload_queue.hpp"
 #include <algorithm>
+#include <cstdint>
 
 namespace glpp::core::object {
 
-texture_t::texture_t(
-	const size_t width,
-	const size_t height,
-	image_format_t format,
-	const clamp_mode_t clamp_mode,
-	const filter_mode_t filter,
-	const mipmap_mode_t mipmap_mode,
-	std::array<texture_channel_t, 4> swizzle_mask
-) :
-	object_t<>(init(), destroy),
-	m_width(width),
-	m_height(height),
-	m_format(static_cast<GLenum>(format))
-{
-	if(format == image_format_t::preferred) {
-		throw std::runtime_error("image_format_t::preferred can not be used in this overload of the constructor.");
-	}
+namespace detail {
 
-	glTextureParameteri(id(), GL_TEXTURE_WRAP_S, static_cast<GLenum>(clamp_mode));
-	glTextureParameteri(id(), GL_TEXTURE_WRAP_T, static_cast<GLenum>(clamp_mode));
+void set_texture_parameters(
+	GLuint texture,
+	clamp_mode_t clamp_mode,
+	filter_mode_t filter,
+	mipmap_mode_t mipmap_mode,
+	const swizzle_mask_t& swizzle_mask
+) {
+	glTextureParameteri(texture, GL_TEXTURE_WRAP_S, static_cast<GLenum>(clamp_mode));
+	glTextureParameteri(texture, GL_TEXTURE_WRAP_T, static_cast<GLenum>(clamp_mode));
 
+	glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, static_cast<GLenum>(filter));
 	switch(mipmap_mode) {
 		case mipmap_mode_t::none:
-			glTextureParameteri(id(), GL_TEXTURE_MIN_FILTER, static_cast<GLenum>(filter));
-			glTextureParameteri(id(), GL_TEXTURE_MAG_FILTER, static_cast<GLenum>(filter));
+			glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, static_cast<GLenum>(filter));
 			break;
 		case mipmap_mode_t::nearest:
 		{
-			const GLenum mode = filter==filter_mode_t::nearest ? GL_NEAREST_MIPMAP_NEAREST : GL_NEAREST_MIPMAP_LINEAR;
-			glTextureParameteri(id(), GL_TEXTURE_MIN_FILTER, static_cast<GLenum>(mode));
-			glTextureParameteri(id(), GL_TEXTURE_MAG_FILTER, static_cast<GLenum>(mode));
+			const GLenum mode = filter==filter_mode_t::nearest ? GL_NEAREST_MIPMAP_NEAREST : GL_LINEAR_MIPMAP_NEAREST;
+			glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, static_cast<GLenum>(mode));
 			break;
 		}
 		case mipmap_mode_t::linear:
 		{
-			const GLenum mode = filter==filter_mode_t::nearest ? GL_LINEAR_MIPMAP_NEAREST : GL_LINEAR_MIPMAP_LINEAR;
-			glTextureParameteri(id(), GL_TEXTURE_MIN_FILTER, static_cast<GLenum>(mode));
-			glTextureParameteri(id(), GL_TEXTURE_MAG_FILTER, static_cast<GLenum>(mode));
+			const GLenum mode = filter==filter_mode_t::nearest ? GL_NEAREST_MIPMAP_LINEAR : GL_LINEAR_MIPMAP_LINEAR;
+			glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, static_cast<GLenum>(mode));
 			break;
 		}
 	}
@@ -53,13 +45,112 @@ texture_t::texture_t(
 	};
 
 	if(swizzle_mask != default_swizzle) {
-		glTextureParameteriv(id(), GL_TEXTURE_SWIZZLE_RGBA, reinterpret_cast<const GLint*>(swizzle_mask.data()));
+		glTextureParameteriv(texture, GL_TEXTURE_SWIZZLE_RGBA, reinterpret_cast<const GLint*>(swizzle_mask.data()));
 	}
+}
+
+bool set_unpack_layout(const void* pixels, size_t width, size_t height, size_t row_stride, size_t pixel_size) {
+	constexpr std::array<size_t, 4> alignments { 8, 4, 2, 1 };
+	const auto address = reinterpret_cast<std::uintptr_t>(pixels);
+	const auto row_size = width*pixel_size;
+	if(height <= 1) row_stride = row_size;
+
+	// OpenGL rounds the size of each row up to the unpack alignment.
+	const auto padded = [row_size](size_t alignment) {
+		return (row_size+alignment-1)/alignment*alignment;
+	};
+	const auto apply = [](size_t alignment, size_t row_length) {
+		glPixelStorei(GL_UNPACK_ALIGNMENT, static_cast<GLint>(alignment));
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(row_length));
+		return true;
+	};
+
+	for(const auto alignment : alignments) {
+		if(address%alignment == 0 && padded(alignment) == row_stride) return apply(alignment, 0);
+	}
+	if(row_stride%pixel_size == 0) {
+		const auto alignment = *std::find_if(alignments.begin(), alignments.end(), [&](size_t alignment) {
+			return address%alignment == 0 && row_stride%alignment == 0;
+		});
+		return apply(alignment, row_stride/pixel_size);
+	}
+	// The alignment of the rows does not need to match the alignment of the address.
+	for(const auto alignment : alignments) {
+		if(padded(alignment) == row_stride) return apply(alignment, 0);
+	}
+	return false;
+}
+
+}
+
+texture_t::texture_t(
+	const size_t width,
+	const size_t height,
+	image_format_t format,
+	const clamp_mode_t clamp_mode,
+	const filter_mode_t filter,
+	const mipmap_mode_t mipmap_mode,
+	std::array<texture_channel_t, 4> swizzle_mask
+) :
+	texture_t(
+		width,
+		height,
+		format,
+		clamp_mode,
+		filter,
+		mipmap_mode,
+		swizzle_mask,
+		mipmap_mode == mipmap_mode_t::none ? 1 : mip_level_count(width, height)
+	)
+{}
+
+texture_t::texture_t(
+	const compressed_image_t& image,
+	const clamp_mode_t clamp_mode,
+	const filter_mode_t filter,
+	const mipmap_mode_t mipmap_mode,
+	std::array<texture_channel_t, 4> swizzle_mask
+) :
+	// Compressed formats can not be filled by glGenerateTextureMipmap, so the storage only covers the supplied levels.
+	texture_t(
+		image.width(),
+		image.height(),
+		image.format(),
+		clamp_mode,
+		filter,
+		mipmap_mode,
+		swizzle_mask,
+		mipmap_mode == mipmap_mode_t::none ? 1 : image.levels().size()
+	)
+{
+	update(image);
+}
+
+texture_t::texture_t(
+	const size_t width,
+	const size_t height,
+	image_format_t format,
+	const clamp_mode_t clamp_mode,
+	const filter_mode_t filter,
+	const mipmap_mode_t mipmap_mode,
+	std::array<texture_channel_t, 4> swizzle_mask,
+	size_t levels
+) :
+	object_t<>(init(), destroy),
+	m_width(width),
+	m_height(height),
+	m_format(static_cast<GLenum>(format)),
+	m_levels(levels)
+{
+	if(format == image_format_t::preferred) {
+		throw std::runtime_error("image_format_t::preferred can not be used in this overload of the constructor.");
+	}
+
+	detail::set_texture_parameters(id(), clamp_mode, filter, mipmap_mode, swizzle_mask);
 
-	constexpr int total_level_of_detail = 1;
 	glTextureStorage2D(
 		id(),
-		total_level_of_detail,
+		m_levels,
 		static_cast<GLenum>(format),
 		width,
 		height
@@ -77,6 +168,8 @@ GLuint texture_t::init() {
 }
 
 void texture_t::destroy(GLuint id) {
+	texture_unit_cache_t::current().evict_texture(id);
+	texture_upload_queue_t::evict_texture(id);
 	glDeleteTextures(1, &id);
 }
 
@@ -88,31 +181,127 @@ size_t texture_t::height() const {
 	return m_height;
 }
 
+size_t texture_t::levels() const {
+	return m_levels;
+}
+
+image_format_t texture_t::format() const {
+	return static_cast<image_format_t>(m_format);
+}
+
+void texture_t::update(const compressed_image_t& image) {
+	if(static_cast<GLenum>(image.format()) != m_format) {
+		throw std::runtime_error("Compressed image format does not match the texture format.");
+	}
+	const auto levels = std::min(m_levels, image.levels().size());
+	for(auto level = 0u; level < levels; ++level) {
+		const auto& data = image.level(level);
+		update_compressed_level(level, 0, 0, data.width, data.height, data.data);
+	}
+}
+
+void texture_t::update_compressed_level(
+	size_t level,
+	size_t xoffset,
+	size_t yoffset,
+	size_t width,
+	size_t height,
+	std::span<const std::byte> data
+) {
+	if(level >= m_levels) {
+		throw std::runtime_error("Trying to update mip level "+std::to_string(level)+" of a texture with "+std::to_string(m_levels)+" levels.");
+	}
+	glCompressedTextureSubImage2D(
+		id(),
+		level,
+		xoffset,
+		yoffset,
+		width,
+		height,
+		m_format,
+		data.size(),
+		data.data()
+	);
+}
+
+void texture_t::generate_mipmaps() {
+	if(m_levels > 1 && !is_block_compressed(static_cast<image_format_t>(m_format))) {
+		glGenerateTextureMipmap(id());
+	}
+}
+
+void texture_t::copy(
+	const texture_t& source,
+	size_t source_x,
+	size_t source_y,
+	size_t xoffset,
+	size_t yoffset,
+	size_t width,
+	size_t height
+) {
+	if(source_x+width > source.width() || source_y+height > source.height() || xoffset+width > m_width || yoffset+height > m_height) {
+		throw std::runtime_error("Trying to copy texture region out of range.");
+	}
+	glCopyImageSubData(
+		source.id(), GL_TEXTURE_2D, 0, source_x, source_y, 0,
+		id(), GL_TEXTURE_2D, 0, xoffset, yoffset, 0,
+		width, height, 1
+	);
+}
+
+void texture_t::copy_level(const texture_t& source, size_t source_level, size_t level) {
+	if(source_level >= source.levels() || level >= m_levels) {
+		throw std::runtime_error("Trying to copy a mip level out of range.");
+	}
+	const auto width = std::max<size_t>(source.width() >> source_level, 1);
+	const auto height = std::max<size_t>(source.height() >> source_level, 1);
+	if(width != std::max<size_t>(m_width >> level, 1) || height != std::max<size_t>(m_height >> level, 1)) {
+		throw std::runtime_error("Trying to copy between mip levels of different size.");
+	}
+	glCopyImageSubData(
+		source.id(), GL_TEXTURE_2D, source_level, 0, 0, 0,
+		id(), GL_TEXTURE_2D, level, 0, 0, 0,
+		width, height, 1
+	);
+}
+
 texture_slot_t::texture_slot_t(const texture_t& texture) :
-	m_id(next_free_id())
+	texture_slot_t(texture, 0)
+{}
+
+texture_slot_t::texture_slot_t(const texture_t& texture, GLuint sampler) :
+	texture_slot_t(texture_unit_cache_t::current().acquire({ texture.id(), sampler }))
+{}
+
+texture_slot_t::texture_slot_t(texture_unit_cache_t& cache, GLuint unit) :
+	m_cache(&cache),
+	m_id(unit)
 {
-	if(id() >= max_texture_units()) {
-		throw std::runtime_error("Trying to bind texture unit to an invalid offset.");
-	}
-	units[id()] = texture.id();
-	glBindTextureUnit(id(), texture.id());
+	m_cache->lock(unit);
 }
 
 texture_slot_t::texture_slot_t(texture_slot_t&& mov) :
+	m_cache(mov.m_cache),
 	m_id(mov.m_id)
 {
 	mov.m_id = -1;
 }
 
 texture_slot_t& texture_slot_t::operator=(texture_slot_t&& mov) {
-	m_id = mov.m_id;
-	mov.m_id = -1;
+	if(this != &mov) {
+		if(m_id >= 0) {
+			m_cache->unlock(m_id);
+		}
+		m_cache = mov.m_cache;
+		m_id = mov.m_id;
+		mov.m_id = -1;
+	}
 	return *this;
 }
 
 texture_slot_t::~texture_slot_t() {
 	if(m_id >= 0) {
-		units[id()] = -1;
+		m_cache->unlock(m_id);
 	}
 }
 
@@ -121,15 +310,6 @@ GLint texture_slot_t::id() const {
 	return m_id;
 }
 
-int texture_slot_t::next_free_id() {
-	auto it = std::find(units.begin(), units.end(), -1);
-	if(it == units.end()) {
-		units.emplace_back(-1);
-		it = units.end()-1;
-	}
-	return it - units.begin();
-}
-
 int max_texture_units_impl() {
 	int i;
 	glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &i);
@@ -141,6 +321,4 @@ int texture_slot_t::max_texture_units() {
 	return units;
 }
 
-std::vector<int> texture_slot_t::units;
-
 } // End of namespace glpp::object
@@ -0,0 +1,108 @@
+#include "glpp/core/object/texture_array.hpp"
+#include "glpp/core/object/texture_unit_cache.hpp"
+
+namespace glpp::core::object {
+
+texture_array_t::texture_array_t(
+	const size_t width,
+	const size_t height,
+	const size_t layers,
+	image_format_t format,
+	const clamp_mode_t clamp_mode,
+	const filter_mode_t filter,
+	const mipmap_mode_t mipmap_mode,
+	swizzle_mask_t swizzle_mask
+) :
+	object_t<>(init(), destroy),
+	m_width(width),
+	m_height(height),
+	m_layers(layers),
+	m_format(static_cast<GLenum>(format)),
+	m_levels(mipmap_mode == mipmap_mode_t::none ? 1 : mip_level_count(width, height))
+{
+	if(format == image_format_t::preferred) {
+		throw std::runtime_error("image_format_t::preferred can not be used for texture arrays.");
+	}
+	detail::set_texture_parameters(id(), clamp_mode, filter, mipmap_mode, swizzle_mask);
+	glTextureStorage3D(
+		id(),
+		m_levels,
+		m_format,
+		width,
+		height,
+		layers
+	);
+}
+
+texture_slot_t texture_array_t::bind_to_texture_slot() const {
+	return texture_unit_cache_t::current().acquire(texture_binding_t{ id(), 0, GL_TEXTURE_2D_ARRAY });
+}
+
+void texture_array_t::copy_layers(const texture_array_t& source, size_t source_layer, size_t layer, size_t count) {
+	if(source.width() != m_width || source.height() != m_height || source.format() != format()) {
+		throw std::runtime_error("Texture array layers can only be copied between arrays of the same size and format.");
+	}
+	if(source_layer+count > source.layers() || layer+count > m_layers) {
+		throw std::runtime_error("Trying to copy texture array layers out of range.");
+	}
+	const auto levels = std::min(m_levels, source.levels());
+	for(size_t level = 0; level < levels; ++level) {
+		glCopyImageSubData(
+			source.id(), GL_TEXTURE_2D_ARRAY, level, 0, 0, source_layer,
+			id(), GL_TEXTURE_2D_ARRAY, level, 0, 0, layer,
+			std::max<size_t>(m_width >> level, 1),
+			std::max<size_t>(m_height >> level, 1),
+			count
+		);
+	}
+}
+
+void texture_array_t::generate_mipmaps() {
+	if(m_levels > 1) {
+		glGenerateTextureMipmap(id());
+	}
+}
+
+size_t texture_array_t::width() const {
+	return m_width;
+}
+
+size_t texture_array_t::height() const {
+	return m_height;
+}
+
+size_t texture_array_t::layers() const {
+	return m_layers;
+}
+
+size_t texture_array_t::levels() const {
+	return m_levels;
+}
+
+image_format_t texture_array_t::format() const {
+	return static_cast<image_format_t>(m_format);
+}
+
+size_t max_layers_impl() {
+	GLint layers;
+	glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &layers);
+	return layers;
+}
+
+size_t texture_array_t::max_layers() {
+	static const size_t layers = max_layers_impl();
+	return layers;
+}
+
+GLuint texture_array_t::init() {
+	GLuint tex;
+	glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &tex);
+	return tex;
+}
+
+void texture_array_t::destroy(GLuint id) {
+	texture_unit_cache_t::current().evict_texture(id);
+	glDeleteTextures(1, &id);
+}
+
+}
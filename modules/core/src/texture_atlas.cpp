@@ -124,6 +124,16 @@ typename texture_atlas_t<AllocPolicy>::key_storage_t texture_atlas_t<AllocPolicy
     return m_alloc.keys();
 }
 
+template <class AllocPolicy>
+AllocPolicy& texture_atlas_t<AllocPolicy>::policy() {
+    return m_alloc;
+}
+
+template <class AllocPolicy>
+const AllocPolicy& texture_atlas_t<AllocPolicy>::policy() const {
+    return m_alloc;
+}
+
 template <class AllocPolicy>
 std::string texture_atlas_t<AllocPolicy>::declaration(const std::string_view name) const {
     return m_alloc.declaration(name);
@@ -177,4 +187,12 @@ template class texture_atlas_entry_t<texture_atlas::multi_policy_t>;
 template class texture_atlas_slot_t<texture_atlas::multi_policy_t>;
 template class texture_atlas_t<texture_atlas::multi_policy_t>;
 
+template class texture_atlas_entry_t<texture_atlas::array_policy_t>;
+template class texture_atlas_slot_t<texture_atlas::array_policy_t>;
+template class texture_atlas_t<texture_atlas::array_policy_t>;
+
+template class texture_atlas_entry_t<texture_atlas::packed_policy_t>;
+template class texture_atlas_slot_t<texture_atlas::packed_policy_t>;
+template class texture_atlas_t<texture_atlas::packed_policy_t>;
+
 }
\ No newline at end of file
@@ -0,0 +1,296 @@
+#include "glpp/core/object/texture_streamer.hpp"
+#include "glpp/core/object/compressed_image.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <unordered_set>
+
+namespace glpp::core::object {
+
+texture_streamer_t::texture_streamer_t(size_t budget, size_t resident_size) :
+	m_budget(budget),
+	m_resident_size(std::max<size_t>(resident_size, 1))
+{}
+
+texture_streamer_t::handle_t texture_streamer_t::add(
+	const compressed_image_t& image,
+	const clamp_mode_t clamp_mode,
+	const filter_mode_t filter,
+	const mipmap_mode_t mipmap_mode
+) {
+	if(image.levels().empty() || image.levels().size() != mip_level_count(image.width(), image.height())) {
+		throw std::runtime_error("Streamed compressed images require a full mip chain.");
+	}
+	auto levels = std::make_shared<const std::vector<compressed_image_t::level_t>>(image.levels());
+	return add(
+		image.width(),
+		image.height(),
+		0,
+		image.format(),
+		clamp_mode,
+		filter,
+		mipmap_mode,
+		[levels = std::move(levels)](texture_t& texture, size_t level, size_t source_level) {
+			const auto& data = (*levels)[source_level];
+			texture.update_compressed_level(level, 0, 0, data.width, data.height, data.data);
+		}
+	);
+}
+
+texture_streamer_t::handle_t texture_streamer_t::add(
+	size_t width,
+	size_t height,
+	size_t texel_size,
+	image_format_t format,
+	clamp_mode_t clamp_mode,
+	filter_mode_t filter,
+	mipmap_mode_t mipmap_mode,
+	level_loader_t loader
+) {
+	if(mipmap_mode == mipmap_mode_t::none) {
+		throw std::runtime_error("Streamed textures require a mipmap mode other than mipmap_mode_t::none.");
+	}
+	const auto levels = mip_level_count(width, height);
+	size_t min_level = 0;
+	while(min_level+1 < levels && std::max(width, height) >> min_level > m_resident_size) {
+		++min_level;
+	}
+
+	// The budget counts video memory, so the size follows the texture format. Only unsized formats,
+	// whose storage is up to the driver, fall back to the size of the client pixels.
+	const auto format_size = format_texel_size(format);
+	entry_t entry {
+		width,
+		height,
+		levels,
+		format_size > 0 ? format_size : texel_size,
+		format,
+		clamp_mode,
+		filter,
+		mipmap_mode,
+		std::move(loader),
+		texture_t(
+			std::max<size_t>(width >> min_level, 1),
+			std::max<size_t>(height >> min_level, 1),
+			format,
+			clamp_mode,
+			filter,
+			mipmap_mode
+		),
+		min_level,
+		min_level,
+		min_level
+	};
+	for(auto level = min_level; level < levels; ++level) {
+		entry.loader(entry.texture, level-min_level, level);
+	}
+
+	m_usage += resident_size(entry, min_level);
+	const auto handle = m_next_handle++;
+	m_entries.emplace(handle, std::move(entry));
+	return handle;
+}
+
+void texture_streamer_t::remove(handle_t handle) {
+	const auto it = m_entries.find(handle);
+	if(it == m_entries.end()) {
+		throw std::runtime_error("Trying to remove unknown streamed texture "+std::to_string(handle)+".");
+	}
+	m_usage -= resident_size(it->second, it->second.resident_level);
+	m_entries.erase(it);
+}
+
+void texture_streamer_t::request(handle_t handle, float screen_size) {
+	auto& entry = this->entry(handle);
+	const auto level = std::min(level_for_screen_size(entry.width, entry.height, screen_size), entry.min_level);
+	entry.requested_level = entry.last_used == m_frame ? std::min(entry.requested_level, level) : level;
+	entry.last_used = m_frame;
+}
+
+void texture_streamer_t::request(handle_t handle, float distance, float world_size, float fov_y, size_t viewport_height) {
+	request(handle, screen_size(distance, world_size, fov_y, viewport_height));
+}
+
+size_t texture_streamer_t::update(size_t max_levels) {
+	std::unordered_map<handle_t, size_t> targets;
+	for(const auto& [handle, entry] : m_entries) {
+		targets.emplace(handle, entry.resident_level);
+	}
+	auto usage = m_usage;
+
+	// Textures used in the current frame only give up levels finer than requested, unless the
+	// requested levels alone exceed the budget.
+	const auto evictable = [&](handle_t handle, const entry_t& entry, bool force) {
+		const auto target = targets[handle];
+		return target < entry.min_level && (force || entry.last_used != m_frame || target < entry.requested_level);
+	};
+	const auto evict = [&](std::optional<handle_t> exclude, bool force) {
+		std::optional<handle_t> victim;
+		for(const auto& [handle, entry] : m_entries) {
+			if(handle == exclude || !evictable(handle, entry, force)) {
+				continue;
+			}
+			if(!victim || entry.last_used < m_entries.at(*victim).last_used) {
+				victim = handle;
+			}
+		}
+		if(!victim) {
+			return false;
+		}
+		usage -= level_size(m_entries.at(*victim), targets[*victim]++);
+		return true;
+	};
+
+	while(usage > m_budget && evict(std::nullopt, false));
+	while(usage > m_budget && evict(std::nullopt, true));
+
+	size_t loaded = 0;
+	std::unordered_set<handle_t> skipped;
+	while(loaded < max_levels) {
+		std::optional<handle_t> candidate;
+		for(const auto& [handle, entry] : m_entries) {
+			const auto target = targets[handle];
+			if(entry.last_used != m_frame || target <= entry.requested_level || skipped.contains(handle)) {
+				continue;
+			}
+			const auto& current = m_entries.at(candidate.value_or(handle));
+			if(!candidate || std::max(entry.width, entry.height) >> target < std::max(current.width, current.height) >> targets[*candidate]) {
+				candidate = handle;
+			}
+		}
+		if(!candidate) {
+			break;
+		}
+
+		// Only evict for levels, which fit into the budget afterwards.
+		const auto cost = level_size(m_entries.at(*candidate), targets[*candidate]-1);
+		size_t freeable = 0;
+		for(const auto& [handle, entry] : m_entries) {
+			if(handle != *candidate && evictable(handle, entry, false)) {
+				const auto floor = entry.last_used == m_frame ? entry.requested_level : entry.min_level;
+				freeable += resident_size(entry, targets[handle])-resident_size(entry, floor);
+			}
+		}
+		if(usage+cost > m_budget+freeable) {
+			skipped.insert(*candidate);
+			continue;
+		}
+		while(usage+cost > m_budget && evict(candidate, false));
+		--targets[*candidate];
+		usage += cost;
+		++loaded;
+	}
+
+	for(auto& [handle, entry] : m_entries) {
+		if(targets[handle] != entry.resident_level) {
+			reallocate(entry, targets[handle]);
+		}
+	}
+	m_usage = usage;
+	++m_frame;
+	return loaded;
+}
+
+const texture_t& texture_streamer_t::texture(handle_t handle) const {
+	return entry(handle).texture;
+}
+
+size_t texture_streamer_t::levels(handle_t handle) const {
+	return entry(handle).levels;
+}
+
+size_t texture_streamer_t::resident_level(handle_t handle) const {
+	return entry(handle).resident_level;
+}
+
+size_t texture_streamer_t::requested_level(handle_t handle) const {
+	return entry(handle).requested_level;
+}
+
+size_t texture_streamer_t::size() const {
+	return m_entries.size();
+}
+
+size_t texture_streamer_t::usage() const {
+	return m_usage;
+}
+
+size_t texture_streamer_t::budget() const {
+	return m_budget;
+}
+
+void texture_streamer_t::set_budget(size_t bytes) {
+	m_budget = bytes;
+}
+
+size_t texture_streamer_t::level_for_screen_size(size_t width, size_t height, float screen_size) {
+	const auto levels = mip_level_count(width, height);
+	if(!(screen_size >= 1.0f)) {
+		return levels-1;
+	}
+	const auto level = std::floor(std::log2(static_cast<float>(std::max(width, height))/screen_size));
+	return std::clamp<size_t>(level > 0.0f ? static_cast<size_t>(level) : 0, 0, levels-1);
+}
+
+float texture_streamer_t::screen_size(float distance, float world_size, float fov_y, size_t viewport_height) {
+	if(distance <= 0.0f) {
+		return std::numeric_limits<float>::max();
+	}
+	return world_size/(2.0f*distance*std::tan(fov_y/2.0f))*viewport_height;
+}
+
+size_t texture_streamer_t::level_size(const entry_t& entry, size_t level) {
+	const auto width = std::max<size_t>(entry.width >> level, 1);
+	const auto height = std::max<size_t>(entry.height >> level, 1);
+	if(is_block_compressed(entry.format)) {
+		return compressed_image_size(entry.format, width, height);
+	}
+	return width*height*entry.texel_size;
+}
+
+size_t texture_streamer_t::resident_size(const entry_t& entry, size_t resident_level) {
+	size_t size = 0;
+	for(auto level = resident_level; level < entry.levels; ++level) {
+		size += level_size(entry, level);
+	}
+	return size;
+}
+
+texture_t texture_streamer_t::allocate(const entry_t& entry, size_t resident_level) {
+	return texture_t(
+		std::max<size_t>(entry.width >> resident_level, 1),
+		std::max<size_t>(entry.height >> resident_level, 1),
+		entry.format,
+		entry.clamp_mode,
+		entry.filter,
+		entry.mipmap_mode
+	);
+}
+
+void texture_streamer_t::reallocate(entry_t& entry, size_t resident_level) {
+	auto texture = allocate(entry, resident_level);
+	// Levels resident in both textures are copied on the GPU, only new levels are loaded.
+	for(auto level = std::max(resident_level, entry.resident_level); level < entry.levels; ++level) {
+		texture.copy_level(entry.texture, level-entry.resident_level, level-resident_level);
+	}
+	for(auto level = resident_level; level < entry.resident_level; ++level) {
+		entry.loader(texture, level-resident_level, level);
+	}
+	entry.texture = std::move(texture);
+	entry.resident_level = resident_level;
+}
+
+texture_streamer_t::entry_t& texture_streamer_t::entry(handle_t handle) {
+	const auto it = m_entries.find(handle);
+	if(it == m_entries.end()) {
+		throw std::runtime_error("Unknown streamed texture "+std::to_string(handle)+".");
+	}
+	return it->second;
+}
+
+const texture_streamer_t::entry_t& texture_streamer_t::entry(handle_t handle) const {
+	return const_cast<texture_streamer_t*>(this)->entry(handle);
+}
+
+}
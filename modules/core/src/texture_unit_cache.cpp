@@ -0,0 +1,269 @@
+#include "glpp/core/object/texture_unit_cache.hpp"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace glpp::core::object {
+
+namespace {
+
+// Marks a unit, whose binding is not known after invalidate().
+constexpr GLuint unknown = std::numeric_limits<GLuint>::max();
+
+// Calls function(first, count) for every range of consecutive units in the sorted list.
+template <class Function>
+void for_each_range(const std::vector<GLuint>& units, Function&& function) {
+	for(size_t begin = 0; begin < units.size();) {
+		auto end = begin+1;
+		while(end < units.size() && units[end] == units[end-1]+1) ++end;
+		function(begin, end-begin);
+		begin = end;
+	}
+}
+
+struct registry_t {
+	std::mutex mutex;
+	std::map<const void*, std::unique_ptr<texture_unit_cache_t>> caches;
+};
+
+registry_t& registry() {
+	static registry_t registry;
+	return registry;
+}
+
+// Cache of the context made current on this thread.
+thread_local texture_unit_cache_t* selected = nullptr;
+
+}
+
+texture_unit_cache_t::texture_unit_cache_t(size_t units) :
+	m_size(units)
+{}
+
+texture_unit_cache_t& texture_unit_cache_t::current() {
+	if(selected) {
+		return *selected;
+	}
+	thread_local texture_unit_cache_t cache;
+	return cache;
+}
+
+void texture_unit_cache_t::make_current(const void* context) {
+	// The unit state belongs to the context, which may be made current on several threads in turn.
+	auto& [mutex, caches] = registry();
+	std::lock_guard lock { mutex };
+	auto& cache = caches[context];
+	if(!cache) {
+		cache = std::make_unique<texture_unit_cache_t>();
+	}
+	selected = cache.get();
+}
+
+void texture_unit_cache_t::release(const void* context) {
+	auto& [mutex, caches] = registry();
+	std::lock_guard lock { mutex };
+	const auto it = caches.find(context);
+	if(it == caches.end()) {
+		return;
+	}
+	if(selected == it->second.get()) {
+		selected = nullptr;
+	}
+	caches.erase(it);
+}
+
+GLuint texture_unit_cache_t::bind(texture_binding_t binding) {
+	return bind(std::span(&binding, 1)).front();
+}
+
+std::vector<GLuint> texture_unit_cache_t::bind(std::span<const texture_binding_t> bindings) {
+	auto& state = units();
+	const auto batch = ++m_clock;
+
+	// A unit may hold textures of several targets, but a draw call can only sample one of them.
+	// Each unit therefore serves a single target of the batch.
+	std::vector<GLenum> claims(state.size(), GL_NONE);
+	const auto claim = [&](const texture_binding_t& binding) -> std::ptrdiff_t {
+		const auto unit = find(binding);
+		if(unit < 0 || (claims[unit] != GL_NONE && claims[unit] != binding.target)) return -1;
+		claims[unit] = binding.target;
+		state[unit].last_use = batch;
+		return unit;
+	};
+
+	// Resident bindings are marked first, so they are not evicted by other bindings of the batch.
+	std::vector<GLuint> result(bindings.size(), unknown);
+	for(size_t i = 0; i < bindings.size(); ++i) {
+		if(const auto unit = claim(bindings[i]); unit >= 0) {
+			result[i] = static_cast<GLuint>(unit);
+		}
+	}
+
+	std::vector<GLuint> texture_units;
+	std::vector<GLuint> sampler_units;
+	try {
+		for(size_t i = 0; i < bindings.size(); ++i) {
+			if(result[i] != unknown) continue;
+			const auto& binding = bindings[i];
+			// A binding may occur more than once in the batch.
+			if(const auto unit = claim(binding); unit >= 0) {
+				result[i] = static_cast<GLuint>(unit);
+				continue;
+			}
+			const auto unit = evict_candidate(batch);
+			auto& entry = state[unit];
+			if(entry.texture(binding.target) != binding.texture) texture_units.push_back(unit);
+			if(entry.sampler != binding.sampler) sampler_units.push_back(unit);
+			entry.set_texture(binding.target, binding.texture);
+			entry.sampler = binding.sampler;
+			entry.last_use = batch;
+			claims[unit] = binding.target;
+			result[i] = unit;
+		}
+	} catch(...) {
+		// Nothing was bound yet, the reassigned units hold their previous binding.
+		for(const auto unit : texture_units) {
+			state[unit].textures.clear();
+			state[unit].invalidated = true;
+		}
+		for(const auto unit : sampler_units) state[unit].sampler = unknown;
+		throw;
+	}
+
+	// Each unit got exactly one texture, the one of its claimed target.
+	std::sort(texture_units.begin(), texture_units.end());
+	std::vector<GLuint> names(texture_units.size());
+	std::transform(texture_units.begin(), texture_units.end(), names.begin(), [&](GLuint unit) { return state[unit].texture(claims[unit]); });
+	for_each_range(texture_units, [&](size_t offset, size_t count) {
+		if(count == 1) {
+			glBindTextureUnit(texture_units[offset], names[offset]);
+		} else {
+			glBindTextures(texture_units[offset], count, names.data()+offset);
+		}
+	});
+
+	std::sort(sampler_units.begin(), sampler_units.end());
+	names.resize(sampler_units.size());
+	std::transform(sampler_units.begin(), sampler_units.end(), names.begin(), [&](GLuint unit) { return state[unit].sampler; });
+	for_each_range(sampler_units, [&](size_t offset, size_t count) {
+		if(count == 1) {
+			glBindSampler(sampler_units[offset], names[offset]);
+		} else {
+			glBindSamplers(sampler_units[offset], count, names.data()+offset);
+		}
+	});
+	return result;
+}
+
+texture_slot_t texture_unit_cache_t::acquire(texture_binding_t binding) {
+	return texture_slot_t(*this, bind(binding));
+}
+
+std::vector<texture_slot_t> texture_unit_cache_t::acquire(std::span<const texture_binding_t> bindings) {
+	const auto bound = bind(bindings);
+	std::vector<texture_slot_t> result;
+	result.reserve(bound.size());
+	for(const auto unit : bound) {
+		result.push_back(texture_slot_t(*this, unit));
+	}
+	return result;
+}
+
+bool texture_unit_cache_t::resident(texture_binding_t binding) const {
+	return find(binding) >= 0;
+}
+
+void texture_unit_cache_t::evict_texture(GLuint texture) {
+	// Deleting a texture resets the units it is bound to, so the cache matches the context again.
+	for(auto& unit : m_units) {
+		const auto erased = std::erase_if(unit.textures, [&](const auto& entry) { return entry.second == texture; });
+		if(erased > 0 && unit.textures.empty() && !unit.invalidated) {
+			unit.last_use = 0;
+		}
+	}
+}
+
+void texture_unit_cache_t::evict_sampler(GLuint sampler) {
+	for(auto& unit : m_units) {
+		if(unit.sampler == sampler) {
+			unit.sampler = 0;
+		}
+	}
+}
+
+void texture_unit_cache_t::invalidate() {
+	for(auto& unit : m_units) {
+		unit.textures.clear();
+		unit.invalidated = true;
+		unit.sampler = unknown;
+	}
+}
+
+size_t texture_unit_cache_t::size() const {
+	return m_units.empty() ? m_size : m_units.size();
+}
+
+void texture_unit_cache_t::lock(GLuint unit) {
+	++units().at(unit).locks;
+}
+
+void texture_unit_cache_t::unlock(GLuint unit) {
+	auto& entry = units().at(unit);
+	assert(entry.locks > 0);
+	--entry.locks;
+}
+
+std::vector<texture_unit_cache_t::unit_t>& texture_unit_cache_t::units() {
+	if(m_units.empty()) {
+		m_units.resize(m_size > 0 ? m_size : texture_slot_t::max_texture_units());
+	}
+	return m_units;
+}
+
+std::ptrdiff_t texture_unit_cache_t::find(texture_binding_t binding) const {
+	const auto it = std::find_if(m_units.begin(), m_units.end(), [&](const unit_t& unit) {
+		return unit.texture(binding.target) == binding.texture && unit.sampler == binding.sampler;
+	});
+	return it == m_units.end() ? -1 : it-m_units.begin();
+}
+
+GLuint texture_unit_cache_t::unit_t::texture(GLenum target) const {
+	const auto it = std::find_if(textures.begin(), textures.end(), [&](const auto& entry) { return entry.first == target; });
+	if(it != textures.end()) return it->second;
+	return invalidated ? unknown : 0;
+}
+
+void texture_unit_cache_t::unit_t::set_texture(GLenum target, GLuint texture) {
+	// Binding texture 0 to a unit unbinds all of its targets.
+	if(texture == 0) {
+		textures.clear();
+		invalidated = false;
+		return;
+	}
+	const auto it = std::find_if(textures.begin(), textures.end(), [&](const auto& entry) { return entry.first == target; });
+	if(it != textures.end()) {
+		it->second = texture;
+	} else {
+		textures.emplace_back(target, texture);
+	}
+}
+
+GLuint texture_unit_cache_t::evict_candidate(std::uint64_t batch) const {
+	// Locked units and units used by the current batch must keep their binding.
+	auto best = m_units.end();
+	for(auto it = m_units.begin(); it != m_units.end(); ++it) {
+		if(it->locks > 0 || it->last_use == batch) continue;
+		if(best == m_units.end() || it->last_use < best->last_use) best = it;
+	}
+	if(best == m_units.end()) {
+		throw std::runtime_error("All "+std::to_string(m_units.size())+" texture units are in use.");
+	}
+	return static_cast<GLuint>(best-m_units.begin());
+}
+
+}
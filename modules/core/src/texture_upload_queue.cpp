@@ -0,0 +1,270 @@
+#include "glpp/core/object/texture_upload_queue.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace glpp::core::object {
+
+namespace {
+	// Keeps every staged upload at an offset that satisfies the largest pixel type alignment.
+	constexpr size_t staging_alignment = 16;
+
+	constexpr size_t align(size_t value) {
+		return (value+staging_alignment-1)/staging_alignment*staging_alignment;
+	}
+
+	constexpr GLbitfield mapping_flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+	// Queues of the calling thread. Textures are destroyed on the thread of their context, which
+	// is also the thread of the queues uploading into them.
+	std::vector<texture_upload_queue_t*>& queues() {
+		thread_local std::vector<texture_upload_queue_t*> registered;
+		return registered;
+	}
+}
+
+texture_upload_t::texture_upload_t(std::shared_ptr<const detail::texture_upload_state_t> state) :
+	m_state(std::move(state))
+{}
+
+bool texture_upload_t::issued() const {
+	return m_state->issued;
+}
+
+bool texture_upload_t::done() const {
+	if(!m_state->issued) return false;
+	return !m_state->fence || m_state->fence->signaled();
+}
+
+void texture_upload_t::wait() const {
+	if(!m_state->issued) {
+		throw std::runtime_error("Waiting for texture upload, that has not been issued yet.");
+	}
+	if(m_state->fence) {
+		m_state->fence->wait();
+	}
+}
+
+texture_upload_queue_t::texture_upload_queue_t(size_t capacity, size_t frame_budget) :
+	object_t(create(capacity), destroy),
+	m_mapping(static_cast<std::byte*>(glMapNamedBufferRange(id(), 0, capacity, mapping_flags))),
+	m_capacity(capacity),
+	m_frame_budget(frame_budget)
+{
+	if(m_mapping == nullptr) {
+		throw std::runtime_error("Mapping the texture upload buffer failed.");
+	}
+	queues().push_back(this);
+}
+
+texture_upload_queue_t::~texture_upload_queue_t() {
+	auto& registered = queues();
+	registered.erase(std::remove(registered.begin(), registered.end(), this), registered.end());
+}
+
+texture_upload_queue_t::texture_upload_queue_t(texture_upload_queue_t&& mov) noexcept :
+	object_t(std::move(mov)),
+	m_mapping(mov.m_mapping),
+	m_capacity(mov.m_capacity),
+	m_frame_budget(mov.m_frame_budget),
+	m_head(mov.m_head),
+	m_pending(std::move(mov.m_pending)),
+	m_in_flight(std::move(mov.m_in_flight))
+{
+	queues().push_back(this);
+}
+
+texture_upload_queue_t& texture_upload_queue_t::operator=(texture_upload_queue_t&& mov) noexcept {
+	object_t::operator=(std::move(mov));
+	m_mapping = mov.m_mapping;
+	m_capacity = mov.m_capacity;
+	m_frame_budget = mov.m_frame_budget;
+	m_head = mov.m_head;
+	m_pending = std::move(mov.m_pending);
+	m_in_flight = std::move(mov.m_in_flight);
+	return *this;
+}
+
+texture_upload_t texture_upload_queue_t::enqueue(request_t request, const std::byte* data, size_t row_stride, size_t row_size) {
+	std::byte* destination = nullptr;
+	// Ring space is handed out in the order of the uploads. Staging past an upload, which still waits
+	// for room, could take the space it waits for without ever being fenced before it is issued.
+	const auto waiting = std::any_of(m_pending.begin(), m_pending.end(), [this](const request_t& pending) {
+		return pending.offset == no_offset && pending.size > 0 && pending.size <= m_capacity;
+	});
+	if(!waiting && request.size > 0 && request.size <= m_capacity) {
+		reclaim();
+		size_t offset;
+		if(allocate(request.size, offset)) {
+			reserve(offset, request.size);
+			request.offset = offset;
+			destination = m_mapping+offset;
+		}
+	}
+	if(destination == nullptr) {
+		// The ring is full, too small or an earlier upload waits for room, the pixels are staged into the ring when the upload is issued.
+		request.pixels.resize(request.size);
+		destination = request.pixels.data();
+	}
+	const auto height = static_cast<size_t>(request.height);
+	for(size_t y = 0; y < height; ++y) {
+		std::memcpy(destination+y*row_size, data+y*row_stride, row_size);
+	}
+
+	auto state = std::make_shared<detail::texture_upload_state_t>();
+	request.state = state;
+	m_pending.push_back(std::move(request));
+	return texture_upload_t{ std::move(state) };
+}
+
+size_t texture_upload_queue_t::process() {
+	return issue(m_frame_budget, false);
+}
+
+void texture_upload_queue_t::flush() {
+	while(!m_pending.empty()) {
+		issue(m_capacity, true);
+	}
+}
+
+void texture_upload_queue_t::evict_texture(GLuint texture) {
+	// The staged pixels keep their ring space until the upload would have been issued.
+	for(auto* queue : queues()) {
+		for(auto& request : queue->m_pending) {
+			if(request.texture == texture) {
+				request.texture = 0;
+				request.pixels.clear();
+				request.pixels.shrink_to_fit();
+			}
+		}
+	}
+}
+
+size_t texture_upload_queue_t::pending() const {
+	return m_pending.size();
+}
+
+size_t texture_upload_queue_t::in_flight() const {
+	return m_in_flight.size();
+}
+
+size_t texture_upload_queue_t::capacity() const {
+	return m_capacity;
+}
+
+size_t texture_upload_queue_t::frame_budget() const {
+	return m_frame_budget;
+}
+
+void texture_upload_queue_t::set_frame_budget(size_t bytes) {
+	m_frame_budget = bytes;
+}
+
+void texture_upload_queue_t::reclaim() {
+	while(!m_in_flight.empty() && m_in_flight.front().fence && m_in_flight.front().fence->signaled()) {
+		m_in_flight.pop_front();
+	}
+}
+
+bool texture_upload_queue_t::allocate(size_t size, size_t& offset) const {
+	auto candidate = align(m_head);
+	if(candidate+size > m_capacity) {
+		candidate = 0;
+	}
+	for(const auto& region : m_in_flight) {
+		if(candidate < region.offset+region.size && region.offset < candidate+size) {
+			return false;
+		}
+	}
+	offset = candidate;
+	return true;
+}
+
+void texture_upload_queue_t::reserve(size_t offset, size_t size) {
+	m_head = offset+size;
+	m_in_flight.push_back({ offset, size, nullptr });
+}
+
+size_t texture_upload_queue_t::issue(size_t budget, bool block) {
+	reclaim();
+
+	size_t issued = 0;
+	std::vector<std::shared_ptr<detail::texture_upload_state_t>> batch;
+	std::vector<size_t> batch_offsets;
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, id());
+	while(!m_pending.empty()) {
+		auto& request = m_pending.front();
+		// The first upload of a call is always allowed, so single uploads larger than the budget still make progress.
+		if(issued > 0 && issued+request.size > budget) break;
+
+		if(request.texture == 0 && request.offset == no_offset) {
+			// Evicted before its pixels were staged into the ring.
+			request.state->issued = true;
+			m_pending.pop_front();
+			continue;
+		}
+		if(request.offset == no_offset && request.size > 0 && request.size <= m_capacity) {
+			size_t offset;
+			while(!allocate(request.size, offset)) {
+				// Regions without a fence are pending or part of the current batch and are released later.
+				if(!block || m_in_flight.empty() || !m_in_flight.front().fence) break;
+				m_in_flight.front().fence->wait();
+				m_in_flight.pop_front();
+			}
+			if(!allocate(request.size, offset)) break;
+			reserve(offset, request.size);
+			std::memcpy(m_mapping+offset, request.pixels.data(), request.size);
+			request.offset = offset;
+		}
+
+		const auto staged = request.offset != no_offset;
+		if(!staged) {
+			// Too large for the staging ring, falls back to a synchronous upload from client memory.
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		}
+		// Evicted uploads still pass through the batch, so their ring space is released with its fence.
+		if(request.texture != 0) {
+			const auto* pixels = staged ? reinterpret_cast<const std::byte*>(request.offset) : request.pixels.data();
+			detail::set_unpack_layout(pixels, request.width, request.height, request.width*request.pixel_size, request.pixel_size);
+			glTextureSubImage2D(request.texture, request.level, request.xoffset, request.yoffset, request.width, request.height, request.format, request.type, pixels);
+		}
+		if(staged) {
+			batch_offsets.push_back(request.offset);
+			batch.push_back(request.state);
+		} else {
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, id());
+			request.state->issued = true;
+		}
+		issued += request.size;
+		m_pending.pop_front();
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	if(!batch.empty()) {
+		const auto fence = std::make_shared<const fence_t>();
+		for(auto& region : m_in_flight) {
+			if(!region.fence && std::find(batch_offsets.begin(), batch_offsets.end(), region.offset) != batch_offsets.end()) {
+				region.fence = fence;
+			}
+		}
+		for(auto& state : batch) {
+			state->fence = fence;
+			state->issued = true;
+		}
+	}
+	return issued;
+}
+
+GLuint texture_upload_queue_t::create(size_t capacity) {
+	GLuint id;
+	glCreateBuffers(1, &id);
+	glNamedBufferStorage(id, capacity, nullptr, mapping_flags);
+	return id;
+}
+
+void texture_upload_queue_t::destroy(GLuint id) {
+	// Deleting the buffer implicitly releases the persistent mapping.
+	glDeleteBuffers(1, &id);
+}
+
+}
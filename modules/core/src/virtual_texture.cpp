@@ -0,0 +1,424 @@
+#include "glpp/core/object/virtual_texture.hpp"
+#include <fmt/core.h>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
+namespace glpp::core::object {
+
+namespace {
+
+size_t cache_side(size_t cache_pages) {
+	return static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(cache_pages))));
+}
+
+}
+
+struct virtual_texture_t::page_worker_t {
+	explicit page_worker_t(page_loader_t loader) :
+		loader(std::move(loader)),
+		thread([this](std::stop_token stop) { work(stop); })
+	{}
+
+	// Replaces the pages, which were not started yet. Returns the replaced pages.
+	std::deque<virtual_page_t> assign(std::deque<virtual_page_t> pages) {
+		std::lock_guard lock(mutex);
+		std::swap(queue, pages);
+		work_available.notify_one();
+		return pages;
+	}
+
+	std::deque<loaded_page_t> take() {
+		std::lock_guard lock(mutex);
+		return std::exchange(results, {});
+	}
+
+	void wait() {
+		std::unique_lock lock(mutex);
+		idle.wait(lock, [this] { return queue.empty() && !loading; });
+	}
+
+	void work(std::stop_token stop) {
+		std::unique_lock lock(mutex);
+		while(true) {
+			if(!work_available.wait(lock, stop, [this] { return !queue.empty(); })) return;
+
+			loaded_page_t result { queue.front(), {}, nullptr };
+			queue.pop_front();
+			loading = true;
+			lock.unlock();
+
+			try {
+				result.tile = loader(result.page);
+			} catch(...) {
+				result.error = std::current_exception();
+			}
+
+			lock.lock();
+			loading = false;
+			results.push_back(std::move(result));
+			idle.notify_all();
+		}
+	}
+
+	page_loader_t loader;
+	std::mutex mutex;
+	std::condition_variable_any work_available;
+	std::condition_variable idle;
+	std::deque<virtual_page_t> queue;
+	std::deque<loaded_page_t> results;
+	bool loading = false;
+	// Declared last, so the thread is stopped before the state it uses is destroyed.
+	std::jthread thread;
+};
+
+virtual_texture_t::virtual_texture_t(
+	size_t width,
+	size_t height,
+	size_t cache_pages,
+	page_loader_t loader,
+	size_t page_size,
+	size_t border
+) :
+	m_width(width),
+	m_height(height),
+	m_page_size(page_size),
+	m_border(border),
+	m_levels(0),
+	m_cache_pages(cache_pages),
+	m_loader(std::move(loader)),
+	m_cache(
+		cache_side(cache_pages)*(page_size+2*border),
+		cache_side(cache_pages)*(page_size+2*border),
+		image_format_t::rgba_8,
+		clamp_mode_t::clamp_to_edge,
+		filter_mode_t::linear
+	),
+	m_page_table(
+		std::max<size_t>(width/std::max<size_t>(page_size, 1), 1),
+		std::max<size_t>(height/std::max<size_t>(page_size, 1), 1),
+		image_format_t::rgba_8,
+		clamp_mode_t::clamp_to_edge,
+		filter_mode_t::nearest,
+		mipmap_mode_t::nearest
+	),
+	m_slots(cache_pages)
+{
+	if(page_size == 0 || width%page_size != 0 || height%page_size != 0) {
+		throw std::runtime_error("The size of a virtual texture needs to be a multiple of the page size.");
+	}
+	const auto pages_x = width/page_size;
+	const auto pages_y = height/page_size;
+	// The feedback pass encodes page coordinates in 8 bit channels.
+	if(!std::has_single_bit(pages_x) || !std::has_single_bit(pages_y) || pages_x > 256 || pages_y > 256) {
+		throw std::runtime_error("A virtual texture needs a power of two number of pages per side, but at most 256.");
+	}
+	if(cache_pages < 2 || cache_side(cache_pages) > 256) {
+		throw std::runtime_error("The page cache of a virtual texture needs between 2 and 65536 pages.");
+	}
+	m_levels = std::bit_width(std::max(pages_x, pages_y));
+
+	// The coarsest page stays in the first slot, so every lookup has a fallback.
+	const virtual_page_t root { 0, 0, static_cast<std::uint32_t>(m_levels-1) };
+	upload(m_loader(root), 0);
+	m_slots[0] = { root, 0, true };
+	m_resident.emplace(page_key(root), 0);
+	update_page_table();
+	m_worker = std::make_unique<page_worker_t>(m_loader);
+}
+
+virtual_texture_t::virtual_texture_t(virtual_texture_t&& mov) noexcept = default;
+virtual_texture_t& virtual_texture_t::operator=(virtual_texture_t&& mov) noexcept = default;
+virtual_texture_t::~virtual_texture_t() = default;
+
+virtual_texture_t::page_loader_t virtual_texture_t::image_loader(const image_t<glm::u8vec4>& image, size_t page_size, size_t border) {
+	const auto chain = std::make_shared<const std::vector<image_t<glm::u8vec4>>>(image.mip_chain());
+	const auto pages_x = std::max<size_t>(image.width()/page_size, 1);
+	const auto pages_y = std::max<size_t>(image.height()/page_size, 1);
+	return [chain, pages_x, pages_y, page_size, border](const virtual_page_t& page) {
+		const auto& level = (*chain)[std::min<size_t>(page.level, chain->size()-1)];
+		// Coarse levels of non square textures are smaller than their page and get stretched.
+		const auto level_pages_x = std::max<size_t>(pages_x >> page.level, 1);
+		const auto level_pages_y = std::max<size_t>(pages_y >> page.level, 1);
+		const auto scale_x = static_cast<double>(level.width())/static_cast<double>(level_pages_x*page_size);
+		const auto scale_y = static_cast<double>(level.height())/static_cast<double>(level_pages_y*page_size);
+
+		const auto size = page_size+2*border;
+		image_t<glm::u8vec4> tile(size, size);
+		for(size_t y = 0; y < size; ++y) {
+			const auto virtual_y = static_cast<double>(page.y*page_size+y)-static_cast<double>(border)+0.5;
+			const auto source_y = std::clamp<std::ptrdiff_t>(static_cast<std::ptrdiff_t>(std::floor(virtual_y*scale_y)), 0, level.height()-1);
+			for(size_t x = 0; x < size; ++x) {
+				const auto virtual_x = static_cast<double>(page.x*page_size+x)-static_cast<double>(border)+0.5;
+				const auto source_x = std::clamp<std::ptrdiff_t>(static_cast<std::ptrdiff_t>(std::floor(virtual_x*scale_x)), 0, level.width()-1);
+				tile.get(x, y) = level.get(source_x, source_y);
+			}
+		}
+		return tile;
+	};
+}
+
+void virtual_texture_t::read_feedback(const framebuffer_t& feedback) {
+	// The ring is persistent and only recreated, if the feedback pass changes its size.
+	if(!m_feedback || m_feedback->width() != feedback.width() || m_feedback->height() != feedback.height()) {
+		m_feedback.emplace(feedback.width(), feedback.height(), GL_RGBA, sizeof(glm::u8vec4), feedback_depth);
+	}
+	// Older readbacks are still in flight, the feedback of this frame is dropped.
+	if(m_feedback->full()) {
+		return;
+	}
+	m_feedback->capture(feedback);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+}
+
+void virtual_texture_t::request(const virtual_page_t& page) {
+	if(page.level >= m_levels || page.x >= pages_x(page.level) || page.y >= pages_y(page.level)) {
+		return;
+	}
+	for(auto level = page.level; level < m_levels; ++level) {
+		const auto shift = level-page.level;
+		const virtual_page_t ancestor { page.x >> shift, page.y >> shift, static_cast<std::uint32_t>(level) };
+		// The ancestors of a requested page have already been requested.
+		if(!m_requested.insert(page_key(ancestor)).second) {
+			break;
+		}
+		m_requests.push_back(ancestor);
+	}
+}
+
+size_t virtual_texture_t::update(size_t max_pages) {
+	if(m_feedback) {
+		m_feedback->collect(false, [this](std::span<const std::byte> texels) {
+			process_feedback(texels);
+		});
+	}
+
+	// Pages queued but not started are replaced by the requests of this frame.
+	for(const auto& page : m_worker->assign({})) {
+		m_loading.erase(page_key(page));
+	}
+
+	std::vector<virtual_page_t> missing;
+	for(const auto& page : m_requests) {
+		if(const auto it = m_resident.find(page_key(page)); it != m_resident.end()) {
+			m_slots[it->second].last_used = m_frame;
+		} else if(!m_loading.contains(page_key(page))) {
+			missing.push_back(page);
+		}
+	}
+	// Coarse pages cover more of the screen and are the fallback of the finer ones.
+	std::stable_sort(missing.begin(), missing.end(), [](const auto& lhs, const auto& rhs) {
+		return lhs.level > rhs.level;
+	});
+
+	for(auto& page : m_worker->take()) {
+		m_loaded.push_back(std::move(page));
+	}
+	size_t uploaded = 0;
+	while(!m_loaded.empty() && uploaded < max_pages) {
+		size_t slot;
+		if(!find_slot(slot)) {
+			break;
+		}
+		const auto loaded = std::move(m_loaded.front());
+		m_loaded.pop_front();
+		m_loading.erase(page_key(loaded.page));
+		if(loaded.error) {
+			std::rethrow_exception(loaded.error);
+		}
+		upload(loaded.tile, slot);
+		if(m_slots[slot].used) {
+			m_resident.erase(page_key(m_slots[slot].page));
+		}
+		m_slots[slot] = { loaded.page, m_frame, true };
+		m_resident.emplace(page_key(loaded.page), slot);
+		m_page_table_dirty = true;
+		++uploaded;
+	}
+
+	std::deque<virtual_page_t> queue;
+	for(const auto& page : missing) {
+		if(queue.size() >= max_pages) break;
+		queue.push_back(page);
+		m_loading.insert(page_key(page));
+	}
+	m_worker->assign(std::move(queue));
+
+	m_requests.clear();
+	m_requested.clear();
+	++m_frame;
+	if(m_page_table_dirty) {
+		update_page_table();
+	}
+	return uploaded;
+}
+
+void virtual_texture_t::wait_for_pages() const {
+	m_worker->wait();
+}
+
+bool virtual_texture_t::resident(const virtual_page_t& page) const {
+	return m_resident.contains(page_key(page));
+}
+
+size_t virtual_texture_t::resident_pages() const {
+	return m_resident.size();
+}
+
+size_t virtual_texture_t::loading_pages() const {
+	return m_loading.size();
+}
+
+size_t virtual_texture_t::pending_readbacks() const {
+	return m_feedback ? m_feedback->pending() : 0;
+}
+
+size_t virtual_texture_t::width() const {
+	return m_width;
+}
+
+size_t virtual_texture_t::height() const {
+	return m_height;
+}
+
+size_t virtual_texture_t::page_size() const {
+	return m_page_size;
+}
+
+size_t virtual_texture_t::border() const {
+	return m_border;
+}
+
+size_t virtual_texture_t::levels() const {
+	return m_levels;
+}
+
+size_t virtual_texture_t::pages_x(size_t level) const {
+	return std::max<size_t>((m_width/m_page_size) >> level, 1);
+}
+
+size_t virtual_texture_t::pages_y(size_t level) const {
+	return std::max<size_t>((m_height/m_page_size) >> level, 1);
+}
+
+const texture_t& virtual_texture_t::cache() const {
+	return m_cache;
+}
+
+const texture_t& virtual_texture_t::page_table() const {
+	return m_page_table;
+}
+
+std::string virtual_texture_t::declaration(const std::string_view name) const {
+	const auto slot_size = m_page_size+2*m_border;
+	return fmt::format(
+		"uniform sampler2D {0}_cache;\n"
+		"uniform sampler2D {0}_pages;\n"
+		"float glpp_vt_level_{0}(in vec2 uv, in float bias) {{\n"
+		"	vec2 texel = uv*vec2({1}, {2});\n"
+		"	float lod = log2(max(length(dFdx(texel)), length(dFdy(texel))))+bias;\n"
+		"	return clamp(floor(lod), 0.0, {3}.0);\n"
+		"}}\n"
+		"vec2 glpp_vt_pages_{0}(in float level) {{\n"
+		"	return max(floor(vec2({4}, {5})/exp2(level)), vec2(1.0));\n"
+		"}}\n"
+		"vec4 glpp_vt_{0}(in vec2 uv) {{\n"
+		"	uv = clamp(uv, vec2(0.0), vec2(0.99999));\n"
+		"	float level = glpp_vt_level_{0}(uv, 0.0);\n"
+		"	vec4 entry = round(texelFetch({0}_pages, ivec2(uv*glpp_vt_pages_{0}(level)), int(level))*255.0);\n"
+		"	vec2 in_page = fract(uv*glpp_vt_pages_{0}(entry.z));\n"
+		"	vec2 texel = entry.xy*{6}.0+vec2({7}.0)+in_page*{8}.0;\n"
+		"	return textureLod({0}_cache, texel/vec2({9}, {10}), 0.0);\n"
+		"}}\n"
+		"vec4 glpp_vt_feedback_{0}(in vec2 uv, in float bias) {{\n"
+		"	uv = clamp(uv, vec2(0.0), vec2(0.99999));\n"
+		"	float level = glpp_vt_level_{0}(uv, bias);\n"
+		"	return vec4(floor(uv*glpp_vt_pages_{0}(level)), level, 255.0)/255.0;\n"
+		"}}\n",
+		name,
+		m_width,
+		m_height,
+		m_levels-1,
+		pages_x(),
+		pages_y(),
+		slot_size,
+		m_border,
+		m_page_size,
+		m_cache.width(),
+		m_cache.height()
+	);
+}
+
+std::uint64_t virtual_texture_t::page_key(const virtual_page_t& page) const {
+	return static_cast<std::uint64_t>(page.level) << 48 | static_cast<std::uint64_t>(page.y) << 24 | page.x;
+}
+
+void virtual_texture_t::upload(const image_t<glm::u8vec4>& tile, size_t slot) {
+	const auto size = m_page_size+2*m_border;
+	if(tile.width() != size || tile.height() != size) {
+		throw std::runtime_error(fmt::format("The page loader returned a tile of size [{}, {}] instead of [{}, {}].", tile.width(), tile.height(), size, size));
+	}
+	const auto side = cache_side(m_cache_pages);
+	m_cache.update(tile, (slot%side)*size, (slot/side)*size, size, size);
+}
+
+bool virtual_texture_t::find_slot(size_t& slot) const {
+	// Free slots first, otherwise the least recently used page, that was not requested this frame.
+	auto oldest = m_frame;
+	auto found = false;
+	for(size_t i = 1; i < m_slots.size(); ++i) {
+		if(!m_slots[i].used) {
+			slot = i;
+			return true;
+		}
+		if(m_slots[i].last_used < oldest) {
+			oldest = m_slots[i].last_used;
+			slot = i;
+			found = true;
+		}
+	}
+	return found;
+}
+
+void virtual_texture_t::process_feedback(std::span<const std::byte> data) {
+	const std::span texels(reinterpret_cast<const glm::u8vec4*>(data.data()), data.size()/sizeof(glm::u8vec4));
+	for(const auto& texel : texels) {
+		// Texels not covered by the feedback pass keep the cleared alpha of zero.
+		if(texel.w == 255) {
+			request({ texel.x, texel.y, texel.z });
+		}
+	}
+}
+
+void virtual_texture_t::update_page_table() {
+	const auto side = cache_side(m_cache_pages);
+	std::vector<glm::u8vec4> parent;
+	for(auto level = m_levels; level-- > 0;) {
+		const auto width = pages_x(level);
+		const auto height = pages_y(level);
+		std::vector<glm::u8vec4> entries(width*height);
+		for(size_t y = 0; y < height; ++y) {
+			for(size_t x = 0; x < width; ++x) {
+				const virtual_page_t page { static_cast<std::uint32_t>(x), static_cast<std::uint32_t>(y), static_cast<std::uint32_t>(level) };
+				if(const auto it = m_resident.find(page_key(page)); it != m_resident.end()) {
+					entries[x+y*width] = glm::u8vec4(it->second%side, it->second/side, level, 255);
+				} else {
+					// Pages without a resident copy use their closest resident ancestor.
+					entries[x+y*width] = parent[(x >> 1)+(y >> 1)*pages_x(level+1)];
+				}
+			}
+		}
+		m_page_table.update_level(level, 0, 0, width, height, entries.data(), image_format_t::rgba);
+		parent = std::move(entries);
+	}
+	m_page_table_dirty = false;
+}
+
+}
@@ -1811,6 +1811,15 @@ auto make_constants() {
     constants.emplace_back(constant_definition_t{"GLenum","GL_MAX_TEXTURE_MAX_ANISOTROPY","0x84FF"});
     constants.emplace_back(constant_definition_t{"GLenum","GL_TRANSFORM_FEEDBACK_OVERFLOW","0x82EC"});
     constants.emplace_back(constant_definition_t{"GLenum","GL_TRANSFORM_FEEDBACK_STREAM_OVERFLOW","0x82ED"});
+    // EXT_texture_compression_s3tc and EXT_texture_sRGB, supported by every desktop driver
+    constants.emplace_back(constant_definition_t{"GLenum","GL_COMPRESSED_RGB_S3TC_DXT1_EXT","0x83F0"});
+    constants.emplace_back(constant_definition_t{"GLenum","GL_COMPRESSED_RGBA_S3TC_DXT1_EXT","0x83F1"});
+    constants.emplace_back(constant_definition_t{"GLenum","GL_COMPRESSED_RGBA_S3TC_DXT3_EXT","0x83F2"});
+    constants.emplace_back(constant_definition_t{"GLenum","GL_COMPRESSED_RGBA_S3TC_DXT5_EXT","0x83F3"});
+    constants.emplace_back(constant_definition_t{"GLenum","GL_COMPRESSED_SRGB_S3TC_DXT1_EXT","0x8C4C"});
+    constants.emplace_back(constant_definition_t{"GLenum","GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT","0x8C4D"});
+    constants.emplace_back(constant_definition_t{"GLenum","GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT","0x8C4E"});
+    constants.emplace_back(constant_definition_t{"GLenum","GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT","0x8C4F"});
 
     return constants;
 }
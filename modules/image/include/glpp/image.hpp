@@ -0,0 +1,4 @@
+#pragma once
+
+#include "image/frame_recorder.hpp"
+#include "image/image_loader.hpp"
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "glpp/core/object/framebuffer.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace glpp::core::object {
+
+enum class video_format_t {
+	// YUV4MPEG2 with full range 4:2:0 chroma, understood by ffmpeg, mpv and x264.
+	y4m,
+	// Tightly packed rgb24 frames, e.g. for ffmpeg -f rawvideo -pix_fmt rgb24.
+	raw_rgb,
+	// One image per frame, written with image_t::write.
+	qoi_sequence,
+	png_sequence
+};
+
+enum class frame_overflow_t {
+	// capture() waits for the encoders, the frame rate drops to the encoding rate.
+	block,
+	// Frames, which do not fit into the queue, are skipped.
+	drop
+};
+
+/*
+ * Records the color attachment of a framebuffer as video. Frames are read back through a ring of
+ * pixel pack buffers and encoded by a pool of worker threads, so capture() only queues a copy and
+ * collects the copies the GPU has finished since the last frame. At most max_queued frames are
+ * waiting for or being encoded, the overflow policy decides what happens to further frames.
+ * Needs to be linked against glpp::image.
+ */
+class frame_recorder_t {
+public:
+	// Receives the encoded stream in order, called on the encoder threads.
+	using sink_t = std::function<void(std::span<const std::byte>)>;
+
+	static constexpr size_t readback_depth = 3;
+	static constexpr size_t default_max_queued = 8;
+
+	// Streams to a file. Sequences use filename as pattern of the frame index, e.g. "frame_{:05}.png".
+	frame_recorder_t(
+		std::string filename,
+		size_t width,
+		size_t height,
+		video_format_t format = video_format_t::y4m,
+		size_t fps = 60,
+		frame_overflow_t overflow = frame_overflow_t::block,
+		size_t max_queued = default_max_queued,
+		size_t threads = 0
+	);
+
+	// Streams y4m or raw rgb to sink, e.g. into a pipe to an encoder.
+	frame_recorder_t(
+		sink_t sink,
+		size_t width,
+		size_t height,
+		video_format_t format = video_format_t::y4m,
+		size_t fps = 60,
+		frame_overflow_t overflow = frame_overflow_t::block,
+		size_t max_queued = default_max_queued,
+		size_t threads = 0
+	);
+
+	~frame_recorder_t();
+
+	frame_recorder_t(const frame_recorder_t& cpy) = delete;
+	frame_recorder_t& operator=(const frame_recorder_t& cpy) = delete;
+
+	// Call after rendering the frame, for the default framebuffer before the buffers are swapped.
+	void capture(const framebuffer_t& framebuffer);
+	// Encodes all captured frames and rethrows the first error of the encoders.
+	void finish();
+
+	size_t captured() const;
+	size_t written() const;
+	size_t dropped() const;
+
+private:
+	struct frame_t {
+		size_t sequence;
+		std::vector<std::byte> pixels;
+	};
+
+	frame_recorder_t(
+		sink_t sink,
+		std::string pattern,
+		size_t width,
+		size_t height,
+		video_format_t format,
+		size_t fps,
+		frame_overflow_t overflow,
+		size_t max_queued,
+		size_t threads
+	);
+
+	void collect(bool wait);
+	void enqueue(std::vector<std::byte> pixels, bool block);
+	void work(std::stop_token stop);
+	// Returns the bytes for the stream, sequences write their files directly.
+	std::vector<std::byte> encode(const frame_t& frame) const;
+	void write(size_t sequence, std::span<const std::byte> data);
+	void rethrow();
+
+	size_t m_width;
+	size_t m_height;
+	video_format_t m_format;
+	frame_overflow_t m_overflow;
+	size_t m_max_queued;
+	std::ofstream m_file;
+	sink_t m_sink;
+	std::string m_pattern;
+
+	detail::frame_readback_ring_t m_readbacks;
+	size_t m_captured = 0;
+
+	mutable std::mutex m_mutex;
+	std::condition_variable_any m_work_available;
+	std::condition_variable m_progress;
+	std::deque<frame_t> m_queue;
+	size_t m_encoding = 0;
+	size_t m_next_sequence = 0;
+	size_t m_next_write = 0;
+	size_t m_dropped = 0;
+	std::exception_ptr m_error;
+	// Declared last, so the workers are stopped before the state they use is destroyed.
+	std::vector<std::jthread> m_workers;
+};
+
+}
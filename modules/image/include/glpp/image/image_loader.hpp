@@ -0,0 +1,197 @@
+#pragma once
+
+#include "glpp/core/object/image.hpp"
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace glpp::core::object {
+
+/*
+ * Decodes image files on a pool of worker threads. Finished images are returned in completion order.
+ * At most max_in_flight images are decoded or waiting to be collected at the same time, so memory stays
+ * bounded when the consumer is slower than the workers.
+ */
+template <class T>
+class image_loader_t {
+public:
+	struct result_t {
+		size_t index;
+		std::string filename;
+		image_t<T> image;
+		// Set instead of image, if the file could not be decoded.
+		std::exception_ptr error;
+	};
+
+	// Zero threads use one thread per core, zero max_in_flight allows two images per thread.
+	explicit image_loader_t(size_t threads = 0, size_t max_in_flight = 0);
+
+	image_loader_t(const image_loader_t& cpy) = delete;
+	image_loader_t& operator=(const image_loader_t& cpy) = delete;
+
+	// Returns the index of the file, which is passed back with its result.
+	size_t enqueue(std::string filename);
+	size_t enqueue(const std::vector<std::string>& filenames);
+
+	std::optional<result_t> try_pop();
+	// Blocks until an image is finished. Returns nothing, if no file is left.
+	std::optional<result_t> pop();
+
+	// Passes up to max_results finished images to functor(result_t&&) on the calling thread, e.g. to
+	// upload them on the GL thread as soon as they are decoded. Returns the number of processed images.
+	template <class Functor>
+	size_t process(Functor&& functor, size_t max_results = std::numeric_limits<size_t>::max());
+
+	size_t pending() const;
+	size_t in_flight() const;
+	size_t threads() const;
+	size_t max_in_flight() const;
+
+private:
+	void work(std::stop_token stop);
+	result_t take();
+
+	mutable std::mutex m_mutex;
+	std::condition_variable_any m_work_available;
+	std::condition_variable m_result_available;
+	std::deque<std::pair<size_t, std::string>> m_queue;
+	std::deque<result_t> m_results;
+	size_t m_decoding = 0;
+	size_t m_next_index = 0;
+	size_t m_max_in_flight;
+	// Declared last, so the workers are stopped before the state they use is destroyed.
+	std::vector<std::jthread> m_workers;
+};
+
+/*
+ * Implementation
+ */
+
+template <class T>
+image_loader_t<T>::image_loader_t(size_t threads, size_t max_in_flight) {
+	if(threads == 0) {
+		threads = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+	m_max_in_flight = max_in_flight == 0 ? 2*threads : max_in_flight;
+	m_workers.reserve(threads);
+	for(size_t i = 0; i < threads; ++i) {
+		m_workers.emplace_back([this](std::stop_token stop) { work(stop); });
+	}
+}
+
+template <class T>
+size_t image_loader_t<T>::enqueue(std::string filename) {
+	std::lock_guard lock(m_mutex);
+	const auto index = m_next_index++;
+	m_queue.emplace_back(index, std::move(filename));
+	m_work_available.notify_one();
+	return index;
+}
+
+template <class T>
+size_t image_loader_t<T>::enqueue(const std::vector<std::string>& filenames) {
+	std::lock_guard lock(m_mutex);
+	const auto first = m_next_index;
+	for(const auto& filename : filenames) {
+		m_queue.emplace_back(m_next_index++, filename);
+	}
+	m_work_available.notify_all();
+	return first;
+}
+
+template <class T>
+std::optional<typename image_loader_t<T>::result_t> image_loader_t<T>::try_pop() {
+	std::lock_guard lock(m_mutex);
+	if(m_results.empty()) return std::nullopt;
+	return take();
+}
+
+template <class T>
+std::optional<typename image_loader_t<T>::result_t> image_loader_t<T>::pop() {
+	std::unique_lock lock(m_mutex);
+	m_result_available.wait(lock, [this] {
+		return !m_results.empty() || (m_queue.empty() && m_decoding == 0);
+	});
+	if(m_results.empty()) return std::nullopt;
+	return take();
+}
+
+template <class T>
+template <class Functor>
+size_t image_loader_t<T>::process(Functor&& functor, size_t max_results) {
+	size_t processed = 0;
+	for(; processed < max_results; ++processed) {
+		auto result = try_pop();
+		if(!result) break;
+		functor(std::move(*result));
+	}
+	return processed;
+}
+
+template <class T>
+size_t image_loader_t<T>::pending() const {
+	std::lock_guard lock(m_mutex);
+	return m_queue.size()+m_decoding+m_results.size();
+}
+
+template <class T>
+size_t image_loader_t<T>::in_flight() const {
+	std::lock_guard lock(m_mutex);
+	return m_decoding+m_results.size();
+}
+
+template <class T>
+size_t image_loader_t<T>::threads() const {
+	return m_workers.size();
+}
+
+template <class T>
+size_t image_loader_t<T>::max_in_flight() const {
+	return m_max_in_flight;
+}
+
+template <class T>
+void image_loader_t<T>::work(std::stop_token stop) {
+	std::unique_lock lock(m_mutex);
+	while(true) {
+		const auto ready = m_work_available.wait(lock, stop, [this] {
+			return !m_queue.empty() && m_decoding+m_results.size() < m_max_in_flight;
+		});
+		if(!ready) return;
+
+		auto [index, filename] = std::move(m_queue.front());
+		m_queue.pop_front();
+		++m_decoding;
+		lock.unlock();
+
+		result_t result { index, std::move(filename), {}, nullptr };
+		try {
+			result.image.load(result.filename.c_str());
+		} catch(...) {
+			result.error = std::current_exception();
+		}
+
+		lock.lock();
+		--m_decoding;
+		m_results.push_back(std::move(result));
+		m_result_available.notify_all();
+	}
+}
+
+template <class T>
+typename image_loader_t<T>::result_t image_loader_t<T>::take() {
+	auto result = std::move(m_results.front());
+	m_results.pop_front();
+	// A slot for another decode is free now.
+	m_work_available.notify_one();
+	return result;
+}
+
+}
@@ -0,0 +1,217 @@
+#include "glpp/core/object/compressed_image.hpp"
+#include "mapped_file.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace glpp::core::object {
+
+namespace {
+
+template <class T>
+T read(std::span<const std::byte> data, size_t offset) {
+	if(offset > data.size() || sizeof(T) > data.size()-offset) {
+		throw std::runtime_error("Unexpected end of compressed image data.");
+	}
+	T value;
+	std::memcpy(&value, data.data()+offset, sizeof(T));
+	return value;
+}
+
+constexpr std::uint32_t four_cc(const char (&code)[5]) {
+	return
+		static_cast<std::uint32_t>(code[0]) |
+		static_cast<std::uint32_t>(code[1]) << 8 |
+		static_cast<std::uint32_t>(code[2]) << 16 |
+		static_cast<std::uint32_t>(code[3]) << 24;
+}
+
+constexpr std::array<std::uint8_t, 12> ktx2_identifier {
+	0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+};
+
+bool is_ktx2(std::span<const std::byte> data) {
+	return data.size() >= ktx2_identifier.size() && std::equal(
+		ktx2_identifier.begin(),
+		ktx2_identifier.end(),
+		data.begin(),
+		[](std::uint8_t lhs, std::byte rhs) { return lhs == static_cast<std::uint8_t>(rhs); }
+	);
+}
+
+bool is_dds(std::span<const std::byte> data) {
+	return data.size() >= 4 && read<std::uint32_t>(data, 0) == four_cc("DDS ");
+}
+
+image_format_t from_vk_format(std::uint32_t vk_format) {
+	switch(vk_format) {
+		case 131: return image_format_t::bc1_rgb;
+		case 132: return image_format_t::bc1_srgb;
+		case 133: return image_format_t::bc1_rgba;
+		case 134: return image_format_t::bc1_srgba;
+		case 135: return image_format_t::bc2;
+		case 136: return image_format_t::bc2_srgba;
+		case 137: return image_format_t::bc3;
+		case 138: return image_format_t::bc3_srgba;
+		case 139: return image_format_t::bc4;
+		case 140: return image_format_t::bc4_s;
+		case 141: return image_format_t::bc5;
+		case 142: return image_format_t::bc5_s;
+		case 143: return image_format_t::bc6h_uf;
+		case 144: return image_format_t::bc6h_sf;
+		case 145: return image_format_t::bc7;
+		case 146: return image_format_t::bc7_srgba;
+		case 147: return image_format_t::etc2_rgb;
+		case 148: return image_format_t::etc2_srgb;
+		case 149: return image_format_t::etc2_rgb_a1;
+		case 150: return image_format_t::etc2_srgb_a1;
+		case 151: return image_format_t::etc2_rgba;
+		case 152: return image_format_t::etc2_srgba;
+		case 153: return image_format_t::eac_r11;
+		case 154: return image_format_t::eac_r11_s;
+		case 155: return image_format_t::eac_rg11;
+		case 156: return image_format_t::eac_rg11_s;
+	}
+	throw std::runtime_error("KTX2 vkFormat "+std::to_string(vk_format)+" is not a supported block compressed format.");
+}
+
+image_format_t from_dxgi_format(std::uint32_t dxgi_format) {
+	switch(dxgi_format) {
+		case 71: return image_format_t::bc1_rgba;
+		case 72: return image_format_t::bc1_srgba;
+		case 74: return image_format_t::bc2;
+		case 75: return image_format_t::bc2_srgba;
+		case 77: return image_format_t::bc3;
+		case 78: return image_format_t::bc3_srgba;
+		case 80: return image_format_t::bc4;
+		case 81: return image_format_t::bc4_s;
+		case 83: return image_format_t::bc5;
+		case 84: return image_format_t::bc5_s;
+		case 95: return image_format_t::bc6h_uf;
+		case 96: return image_format_t::bc6h_sf;
+		case 98: return image_format_t::bc7;
+		case 99: return image_format_t::bc7_srgba;
+	}
+	throw std::runtime_error("DDS DXGI format "+std::to_string(dxgi_format)+" is not a supported block compressed format.");
+}
+
+image_format_t from_four_cc(std::uint32_t code) {
+	if(code == four_cc("DXT1")) return image_format_t::bc1_rgba;
+	if(code == four_cc("DXT3")) return image_format_t::bc2;
+	if(code == four_cc("DXT5")) return image_format_t::bc3;
+	if(code == four_cc("ATI1") || code == four_cc("BC4U")) return image_format_t::bc4;
+	if(code == four_cc("BC4S")) return image_format_t::bc4_s;
+	if(code == four_cc("ATI2") || code == four_cc("BC5U")) return image_format_t::bc5;
+	if(code == four_cc("BC5S")) return image_format_t::bc5_s;
+	throw std::runtime_error("DDS pixel format is not a supported block compressed format.");
+}
+
+// Offsets and sizes come from the file, their sum may overflow.
+compressed_image_t::level_t copy_level(std::span<const std::byte> data, std::uint64_t offset, std::uint64_t size, size_t width, size_t height) {
+	if(offset > data.size() || size > data.size()-offset) {
+		throw std::runtime_error("Unexpected end of compressed image data.");
+	}
+	const auto begin = data.begin()+static_cast<std::ptrdiff_t>(offset);
+	return { width, height, std::vector<std::byte>(begin, begin+static_cast<std::ptrdiff_t>(size)) };
+}
+
+void check_level_count(size_t level_count, size_t width, size_t height) {
+	if(level_count > mip_level_count(width, height)) {
+		throw std::runtime_error(
+			std::to_string(level_count)+" mip levels exceed the full mip chain of a "+
+			std::to_string(width)+"x"+std::to_string(height)+" image."
+		);
+	}
+}
+
+}
+
+compressed_image_t::compressed_image_t(const char* filename) {
+	const detail::mapped_file_t file(filename);
+	*this = from_memory(file.data());
+}
+
+compressed_image_t compressed_image_t::from_memory(std::span<const std::byte> data) {
+	if(is_ktx2(data)) return from_ktx2(data);
+	if(is_dds(data)) return from_dds(data);
+	throw std::runtime_error("Unknown compressed image container.");
+}
+
+compressed_image_t compressed_image_t::from_ktx2(std::span<const std::byte> data) {
+	if(!is_ktx2(data)) {
+		throw std::runtime_error("Data is not a KTX2 container.");
+	}
+	const auto vk_format = read<std::uint32_t>(data, 12);
+	const auto width = read<std::uint32_t>(data, 20);
+	const auto height = read<std::uint32_t>(data, 24);
+	const auto depth = read<std::uint32_t>(data, 28);
+	const auto layers = read<std::uint32_t>(data, 32);
+	const auto faces = read<std::uint32_t>(data, 36);
+	const auto level_count = std::max<std::uint32_t>(read<std::uint32_t>(data, 40), 1);
+	const auto supercompression = read<std::uint32_t>(data, 44);
+
+	if(depth > 1 || layers > 1 || faces != 1) {
+		throw std::runtime_error("Only single 2D KTX2 textures are supported.");
+	}
+	if(supercompression != 0) {
+		throw std::runtime_error("Supercompressed KTX2 textures are not supported.");
+	}
+
+	const auto format = from_vk_format(vk_format);
+	check_level_count(level_count, width, height);
+	// The level index starts after the 48 byte header and the 32 byte section index.
+	constexpr size_t level_index = 80;
+	std::vector<level_t> levels;
+	levels.reserve(level_count);
+	for(size_t i = 0; i < level_count; ++i) {
+		const auto offset = read<std::uint64_t>(data, level_index+i*24);
+		const auto size = read<std::uint64_t>(data, level_index+i*24+8);
+		const auto level_width = std::max<size_t>(width >> i, 1);
+		const auto level_height = std::max<size_t>(height >> i, 1);
+		levels.push_back(copy_level(data, offset, size, level_width, level_height));
+	}
+	return { format, std::move(levels) };
+}
+
+compressed_image_t compressed_image_t::from_dds(std::span<const std::byte> data) {
+	if(!is_dds(data)) {
+		throw std::runtime_error("Data is not a DDS container.");
+	}
+	constexpr std::uint32_t pixel_format_four_cc = 0x4;
+	const auto height = read<std::uint32_t>(data, 12);
+	const auto width = read<std::uint32_t>(data, 16);
+	const auto level_count = std::max<std::uint32_t>(read<std::uint32_t>(data, 28), 1);
+	const auto pixel_format_flags = read<std::uint32_t>(data, 80);
+	const auto code = read<std::uint32_t>(data, 84);
+
+	if((pixel_format_flags & pixel_format_four_cc) == 0) {
+		throw std::runtime_error("Uncompressed DDS files are not supported.");
+	}
+	check_level_count(level_count, width, height);
+
+	image_format_t format;
+	size_t offset = 128;
+	if(code == four_cc("DX10")) {
+		format = from_dxgi_format(read<std::uint32_t>(data, 128));
+		offset += 20;
+	} else {
+		format = from_four_cc(code);
+	}
+
+	// Only the first array element or cube face is read, its levels are stored consecutively.
+	std::vector<level_t> levels;
+	levels.reserve(level_count);
+	for(size_t i = 0; i < level_count; ++i) {
+		const auto level_width = std::max<size_t>(width >> i, 1);
+		const auto level_height = std::max<size_t>(height >> i, 1);
+		const auto size = compressed_image_size(format, level_width, level_height);
+		levels.push_back(copy_level(data, offset, size, level_width, level_height));
+		offset += size;
+	}
+	return { format, std::move(levels) };
+}
+
+}
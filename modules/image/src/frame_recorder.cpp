@@ -0,0 +1,308 @@
+#include "glpp/image/frame_recorder.hpp"
+#include "glpp/core/object/image.hpp"
+#include <fmt/core.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace glpp::core::object {
+
+namespace {
+
+constexpr size_t pixel_size = 3;
+
+bool is_sequence(video_format_t format) {
+	return format == video_format_t::qoi_sequence || format == video_format_t::png_sequence;
+}
+
+// Full range BT.601 like JPEG, the weights of each row sum up to 256 or 0.
+// Saturated blue or red rounds up to 256, so chroma is clamped.
+std::uint8_t luma(int r, int g, int b) {
+	return static_cast<std::uint8_t>((77*r+150*g+29*b+128) >> 8);
+}
+
+std::uint8_t chroma_blue(int r, int g, int b) {
+	return static_cast<std::uint8_t>(std::clamp((-43*r-85*g+128*b+32768+128) >> 8, 0, 255));
+}
+
+std::uint8_t chroma_red(int r, int g, int b) {
+	return static_cast<std::uint8_t>(std::clamp((128*r-107*g-21*b+32768+128) >> 8, 0, 255));
+}
+
+}
+
+frame_recorder_t::frame_recorder_t(
+	std::string filename,
+	size_t width,
+	size_t height,
+	video_format_t format,
+	size_t fps,
+	frame_overflow_t overflow,
+	size_t max_queued,
+	size_t threads
+) :
+	frame_recorder_t(nullptr, std::move(filename), width, height, format, fps, overflow, max_queued, threads)
+{}
+
+frame_recorder_t::frame_recorder_t(
+	sink_t sink,
+	size_t width,
+	size_t height,
+	video_format_t format,
+	size_t fps,
+	frame_overflow_t overflow,
+	size_t max_queued,
+	size_t threads
+) :
+	frame_recorder_t(std::move(sink), {}, width, height, format, fps, overflow, max_queued, threads)
+{
+	if(is_sequence(format)) {
+		throw std::runtime_error("Image sequences can only be written to files.");
+	}
+}
+
+frame_recorder_t::frame_recorder_t(
+	sink_t sink,
+	std::string pattern,
+	size_t width,
+	size_t height,
+	video_format_t format,
+	size_t fps,
+	frame_overflow_t overflow,
+	size_t max_queued,
+	size_t threads
+) :
+	m_width(width),
+	m_height(height),
+	m_format(format),
+	m_overflow(overflow),
+	m_max_queued(std::max<size_t>(max_queued, 1)),
+	m_sink(std::move(sink)),
+	m_pattern(std::move(pattern)),
+	m_readbacks(width, height, GL_RGB, pixel_size, readback_depth)
+{
+	if(width == 0 || height == 0) {
+		throw std::runtime_error("Frames of size "+std::to_string(width)+"x"+std::to_string(height)+" can not be recorded.");
+	}
+	if(!m_sink && !is_sequence(format)) {
+		m_file.open(m_pattern, std::ios::binary);
+		if(!m_file) {
+			throw std::runtime_error("Unable to open "+m_pattern+" for recording.");
+		}
+		m_sink = [this](std::span<const std::byte> data) {
+			m_file.write(reinterpret_cast<const char*>(data.data()), data.size());
+			if(!m_file) {
+				throw std::runtime_error("Writing the recording to "+m_pattern+" failed.");
+			}
+		};
+	}
+	if(format == video_format_t::y4m) {
+		const auto header = fmt::format("YUV4MPEG2 W{} H{} F{}:1 Ip A1:1 C420jpeg\n", width, height, fps);
+		m_sink(std::as_bytes(std::span(header.data(), header.size())));
+	}
+
+	if(threads == 0) {
+		threads = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+	m_workers.reserve(threads);
+	for(size_t i = 0; i < threads; ++i) {
+		m_workers.emplace_back([this](std::stop_token stop) { work(stop); });
+	}
+}
+
+frame_recorder_t::~frame_recorder_t() {
+	try {
+		finish();
+	} catch(...) {
+		// Errors are only reported by an explicit finish().
+	}
+}
+
+void frame_recorder_t::capture(const framebuffer_t& framebuffer) {
+	rethrow();
+	collect(false);
+	if(m_readbacks.full()) {
+		// The GPU is several frames behind, the oldest copy is still running.
+		if(m_overflow == frame_overflow_t::drop) {
+			std::lock_guard lock(m_mutex);
+			++m_captured;
+			++m_dropped;
+			return;
+		}
+		m_readbacks.wait();
+		collect(false);
+	}
+	m_readbacks.capture(framebuffer);
+	std::lock_guard lock(m_mutex);
+	++m_captured;
+}
+
+void frame_recorder_t::finish() {
+	collect(true);
+	{
+		std::unique_lock lock(m_mutex);
+		m_progress.wait(lock, [this] { return m_queue.empty() && m_encoding == 0; });
+	}
+	if(m_file.is_open()) {
+		m_file.flush();
+	}
+	rethrow();
+}
+
+size_t frame_recorder_t::captured() const {
+	std::lock_guard lock(m_mutex);
+	return m_captured;
+}
+
+size_t frame_recorder_t::written() const {
+	std::lock_guard lock(m_mutex);
+	return m_next_write;
+}
+
+size_t frame_recorder_t::dropped() const {
+	std::lock_guard lock(m_mutex);
+	return m_dropped;
+}
+
+void frame_recorder_t::collect(bool wait) {
+	m_readbacks.collect(wait, [&](std::span<const std::byte> pixels) {
+		// Frames collected by finish() are always encoded.
+		enqueue(std::vector<std::byte>(pixels.begin(), pixels.end()), wait || m_overflow == frame_overflow_t::block);
+	});
+}
+
+void frame_recorder_t::enqueue(std::vector<std::byte> pixels, bool block) {
+	std::unique_lock lock(m_mutex);
+	const auto full = [this] { return m_queue.size()+m_encoding >= m_max_queued; };
+	if(full()) {
+		if(!block) {
+			++m_dropped;
+			return;
+		}
+		m_progress.wait(lock, [&] { return !full(); });
+	}
+	m_queue.push_back({ m_next_sequence++, std::move(pixels) });
+	m_work_available.notify_one();
+}
+
+void frame_recorder_t::work(std::stop_token stop) {
+	std::unique_lock lock(m_mutex);
+	while(true) {
+		const auto ready = m_work_available.wait(lock, stop, [this] { return !m_queue.empty(); });
+		if(!ready) return;
+
+		auto frame = std::move(m_queue.front());
+		m_queue.pop_front();
+		++m_encoding;
+		lock.unlock();
+
+		std::vector<std::byte> encoded;
+		try {
+			encoded = encode(frame);
+		} catch(...) {
+			std::lock_guard error_lock(m_mutex);
+			if(!m_error) m_error = std::current_exception();
+		}
+		// Also called for failed frames, so the following frames are not waiting forever.
+		write(frame.sequence, encoded);
+
+		lock.lock();
+		--m_encoding;
+		m_progress.notify_all();
+	}
+}
+
+std::vector<std::byte> frame_recorder_t::encode(const frame_t& frame) const {
+	const auto row_size = m_width*pixel_size;
+	// Framebuffers are read bottom up, videos and images start with the top row.
+	const auto row = [&](size_t y) {
+		return reinterpret_cast<const std::uint8_t*>(frame.pixels.data())+(m_height-1-y)*row_size;
+	};
+
+	if(m_format == video_format_t::raw_rgb) {
+		std::vector<std::byte> result(frame.pixels.size());
+		for(size_t y = 0; y < m_height; ++y) {
+			std::memcpy(result.data()+y*row_size, row(y), row_size);
+		}
+		return result;
+	}
+
+	if(is_sequence(m_format)) {
+		image_t<glm::u8vec3> image(m_width, m_height);
+		for(size_t y = 0; y < m_height; ++y) {
+			std::memcpy(image.data()+y*m_width, row(y), row_size);
+		}
+		image.write(fmt::format(fmt::runtime(m_pattern), frame.sequence).c_str());
+		return {};
+	}
+
+	constexpr std::string_view marker = "FRAME\n";
+	const auto chroma_width = (m_width+1)/2;
+	const auto chroma_height = (m_height+1)/2;
+	const auto luma_size = m_width*m_height;
+	const auto chroma_size = chroma_width*chroma_height;
+	std::vector<std::byte> result(marker.size()+luma_size+2*chroma_size);
+	std::memcpy(result.data(), marker.data(), marker.size());
+	auto* y_plane = reinterpret_cast<std::uint8_t*>(result.data()+marker.size());
+	auto* u_plane = y_plane+luma_size;
+	auto* v_plane = u_plane+chroma_size;
+
+	for(size_t y = 0; y < m_height; ++y) {
+		const auto* pixels = row(y);
+		for(size_t x = 0; x < m_width; ++x) {
+			y_plane[y*m_width+x] = luma(pixels[3*x], pixels[3*x+1], pixels[3*x+2]);
+		}
+	}
+	// Chroma of the average of each 2x2 block, blocks at odd edges average fewer pixels.
+	for(size_t cy = 0; cy < chroma_height; ++cy) {
+		const auto y_end = std::min(2*cy+2, m_height);
+		for(size_t cx = 0; cx < chroma_width; ++cx) {
+			const auto x_end = std::min(2*cx+2, m_width);
+			int r = 0, g = 0, b = 0, count = 0;
+			for(auto y = 2*cy; y < y_end; ++y) {
+				const auto* pixels = row(y);
+				for(auto x = 2*cx; x < x_end; ++x) {
+					r += pixels[3*x];
+					g += pixels[3*x+1];
+					b += pixels[3*x+2];
+					++count;
+				}
+			}
+			r = (r+count/2)/count;
+			g = (g+count/2)/count;
+			b = (b+count/2)/count;
+			u_plane[cy*chroma_width+cx] = chroma_blue(r, g, b);
+			v_plane[cy*chroma_width+cx] = chroma_red(r, g, b);
+		}
+	}
+	return result;
+}
+
+void frame_recorder_t::write(size_t sequence, std::span<const std::byte> data) {
+	std::unique_lock lock(m_mutex);
+	m_progress.wait(lock, [&] { return m_next_write == sequence; });
+	lock.unlock();
+	// Only this thread can write until m_next_write is advanced.
+	if(!data.empty()) {
+		try {
+			m_sink(data);
+		} catch(...) {
+			std::lock_guard error_lock(m_mutex);
+			if(!m_error) m_error = std::current_exception();
+		}
+	}
+	lock.lock();
+	++m_next_write;
+	m_progress.notify_all();
+}
+
+void frame_recorder_t::rethrow() {
+	std::lock_guard lock(m_mutex);
+	if(m_error) {
+		std::rethrow_exception(std::exchange(m_error, nullptr));
+	}
+}
+
+}
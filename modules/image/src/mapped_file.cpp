@@ -0,0 +1,81 @@
+#include "mapped_file.hpp"
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace glpp::core::object::detail {
+
+#ifdef _WIN32
+
+mapped_file_t::mapped_file_t(const char* filename) :
+	m_file(CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr))
+{
+	LARGE_INTEGER size;
+	if(m_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(m_file, &size)) {
+		if(m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+		throw std::runtime_error(std::string("File ")+filename+" could not be found or opened.");
+	}
+	m_size = static_cast<size_t>(size.QuadPart);
+	if(m_size == 0) return;
+	m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if(m_mapping != nullptr) {
+		m_data = static_cast<const std::byte*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+	}
+	if(m_data == nullptr) {
+		if(m_mapping != nullptr) CloseHandle(m_mapping);
+		CloseHandle(m_file);
+		throw std::runtime_error(std::string("File ")+filename+" could not be mapped.");
+	}
+}
+
+mapped_file_t::~mapped_file_t() {
+	if(m_data != nullptr) UnmapViewOfFile(m_data);
+	if(m_mapping != nullptr) CloseHandle(m_mapping);
+	CloseHandle(m_file);
+}
+
+#else
+
+mapped_file_t::mapped_file_t(const char* filename) {
+	const auto file = open(filename, O_RDONLY | O_CLOEXEC);
+	struct stat status;
+	if(file < 0 || fstat(file, &status) != 0) {
+		if(file >= 0) close(file);
+		throw std::runtime_error(std::string("File ")+filename+" could not be found or opened.");
+	}
+	m_size = static_cast<size_t>(status.st_size);
+	if(m_size > 0) {
+		auto* mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+		if(mapping == MAP_FAILED) {
+			close(file);
+			throw std::runtime_error(std::string("File ")+filename+" could not be mapped.");
+		}
+		// Decoders read the file front to back.
+		madvise(mapping, m_size, MADV_SEQUENTIAL);
+		m_data = static_cast<const std::byte*>(mapping);
+	}
+	// The mapping keeps the file alive.
+	close(file);
+}
+
+mapped_file_t::~mapped_file_t() {
+	if(m_data != nullptr) munmap(const_cast<std::byte*>(m_data), m_size);
+}
+
+#endif
+
+std::span<const std::byte> mapped_file_t::data() const {
+	return { m_data, m_size };
+}
+
+}
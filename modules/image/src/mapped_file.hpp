@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+namespace glpp::core::object::detail {
+
+// Read only memory mapping of a whole file, pages are only read when they are accessed.
+class mapped_file_t {
+public:
+	explicit mapped_file_t(const char* filename);
+	~mapped_file_t();
+
+	mapped_file_t(const mapped_file_t& cpy) = delete;
+	mapped_file_t& operator=(const mapped_file_t& cpy) = delete;
+
+	std::span<const std::byte> data() const;
+
+private:
+	const std::byte* m_data = nullptr;
+	size_t m_size = 0;
+#ifdef _WIN32
+	void* m_file = nullptr;
+	void* m_mapping = nullptr;
+#endif
+};
+
+}
@@ -0,0 +1,304 @@
+#include "qoi.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace glpp::core::object::detail::qoi {
+
+namespace {
+
+// See https://qoiformat.org/qoi-specification.pdf
+constexpr std::array<std::uint8_t, 4> magic { 'q', 'o', 'i', 'f' };
+constexpr size_t header_size = 14;
+constexpr std::array<std::uint8_t, 8> end_marker { 0, 0, 0, 0, 0, 0, 0, 1 };
+// Same limit as the reference implementation, keeps w*h*4 far away from overflowing.
+constexpr size_t max_pixels = 400000000;
+
+constexpr std::uint8_t op_index = 0x00;
+constexpr std::uint8_t op_diff = 0x40;
+constexpr std::uint8_t op_luma = 0x80;
+constexpr std::uint8_t op_run = 0xc0;
+constexpr std::uint8_t op_rgb = 0xfe;
+constexpr std::uint8_t op_rgba = 0xff;
+constexpr std::uint8_t mask = 0xc0;
+constexpr size_t max_run = 62;
+
+// Bands smaller than this cost more to restart than they gain on another thread.
+constexpr size_t min_band_pixels = 1 << 18;
+
+struct pixel_t {
+	std::uint8_t r, g, b, a;
+
+	bool operator==(const pixel_t& rhs) const = default;
+};
+
+size_t hash(pixel_t px) {
+	return (px.r*3u+px.g*5u+px.b*7u+px.a*11u)%64u;
+}
+
+std::uint32_t read_u32(const std::uint8_t* data) {
+	return std::uint32_t(data[0]) << 24 | std::uint32_t(data[1]) << 16 | std::uint32_t(data[2]) << 8 | data[3];
+}
+
+void write_u32(std::uint8_t* data, std::uint32_t value) {
+	data[0] = static_cast<std::uint8_t>(value >> 24);
+	data[1] = static_cast<std::uint8_t>(value >> 16);
+	data[2] = static_cast<std::uint8_t>(value >> 8);
+	data[3] = static_cast<std::uint8_t>(value);
+}
+
+template <int Channels>
+pixel_t load(const unsigned char* in) {
+	if constexpr(Channels == 1) return { in[0], in[0], in[0], 255 };
+	if constexpr(Channels == 2) return { in[0], in[0], in[0], in[1] };
+	if constexpr(Channels == 3) return { in[0], in[1], in[2], 255 };
+	if constexpr(Channels == 4) return { in[0], in[1], in[2], in[3] };
+}
+
+template <int Channels>
+void store(unsigned char* out, pixel_t px) {
+	if constexpr(Channels <= 2) {
+		// Same luminance weights as stb_image, gray images written by encode survive unchanged.
+		out[0] = static_cast<unsigned char>((px.r*77u+px.g*150u+px.b*29u) >> 8);
+		if constexpr(Channels == 2) out[1] = px.a;
+	} else {
+		out[0] = px.r;
+		out[1] = px.g;
+		out[2] = px.b;
+		if constexpr(Channels == 4) out[3] = px.a;
+	}
+}
+
+/*
+ * Encodes the pixels [begin, end) as an independent sequence of chunks. Every band after the first
+ * starts with an explicit rgba chunk and only refers to index entries it has written itself, so
+ * the decoder state left behind by the previous band never matters and the concatenation of all
+ * bands is a valid stream. Capacity for the worst case is reserved, so the loop never reallocates.
+ */
+template <int Channels>
+size_t encode_band(const unsigned char* pixels, size_t begin, size_t end, bool first, std::uint8_t* out) {
+	std::array<pixel_t, 64> index {};
+	// The decoder of the first band starts with a zeroed index like this one.
+	std::array<bool, 64> valid {};
+	valid.fill(first);
+	pixel_t prev { 0, 0, 0, 255 };
+	bool has_prev = first;
+	size_t run = 0;
+	auto* const start = out;
+
+	for(auto i = begin; i < end; ++i) {
+		const auto px = load<Channels>(pixels+i*Channels);
+		if(has_prev && px == prev) {
+			if(++run == max_run) {
+				*out++ = op_run | (run-1);
+				run = 0;
+			}
+			continue;
+		}
+		if(run > 0) {
+			*out++ = op_run | (run-1);
+			run = 0;
+		}
+
+		const auto slot = hash(px);
+		if(valid[slot] && index[slot] == px) {
+			*out++ = op_index | slot;
+		} else {
+			index[slot] = px;
+			valid[slot] = true;
+			if(has_prev && px.a == prev.a) {
+				const std::int8_t dr = px.r-prev.r;
+				const std::int8_t dg = px.g-prev.g;
+				const std::int8_t db = px.b-prev.b;
+				const std::int8_t dr_dg = dr-dg;
+				const std::int8_t db_dg = db-dg;
+				if(dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+					*out++ = op_diff | (dr+2) << 4 | (dg+2) << 2 | (db+2);
+				} else if(dg >= -32 && dg <= 31 && dr_dg >= -8 && dr_dg <= 7 && db_dg >= -8 && db_dg <= 7) {
+					*out++ = op_luma | (dg+32);
+					*out++ = (dr_dg+8) << 4 | (db_dg+8);
+				} else {
+					*out++ = op_rgb;
+					*out++ = px.r;
+					*out++ = px.g;
+					*out++ = px.b;
+				}
+			} else {
+				*out++ = op_rgba;
+				*out++ = px.r;
+				*out++ = px.g;
+				*out++ = px.b;
+				*out++ = px.a;
+			}
+		}
+		prev = px;
+		has_prev = true;
+	}
+	if(run > 0) {
+		*out++ = op_run | (run-1);
+	}
+	return out-start;
+}
+
+template <int Channels>
+void encode_bands(const unsigned char* pixels, size_t count, int file_channels, std::vector<std::byte>& result) {
+	const auto hardware = std::max(std::thread::hardware_concurrency(), 1u);
+	const auto bands = std::clamp<size_t>(count/min_band_pixels, 1, hardware);
+	const auto band_size = (count+bands-1)/bands;
+	const auto worst_case = [file_channels](size_t pixels) { return pixels*(file_channels+1); };
+
+	std::vector<std::vector<std::uint8_t>> encoded(bands);
+	std::vector<size_t> sizes(bands);
+	const auto encode = [&](size_t band) {
+		const auto begin = band*band_size;
+		const auto end = std::min(begin+band_size, count);
+		encoded[band].resize(worst_case(end-begin));
+		sizes[band] = encode_band<Channels>(pixels, begin, end, band == 0, encoded[band].data());
+	};
+	{
+		std::vector<std::jthread> threads;
+		threads.reserve(bands-1);
+		for(size_t band = 1; band < bands; ++band) {
+			threads.emplace_back(encode, band);
+		}
+		encode(0);
+	}
+
+	for(size_t band = 0; band < bands; ++band) {
+		const auto* data = reinterpret_cast<const std::byte*>(encoded[band].data());
+		result.insert(result.end(), data, data+sizes[band]);
+	}
+}
+
+template <int Channels>
+void decode_chunks(const std::uint8_t* data, const std::uint8_t* data_end, unsigned char* out, size_t count) {
+	std::array<pixel_t, 64> index {};
+	pixel_t px { 0, 0, 0, 255 };
+	const auto truncated = [&](size_t bytes) {
+		if(static_cast<size_t>(data_end-data) < bytes) {
+			throw std::runtime_error("QOI data is truncated.");
+		}
+	};
+
+	for(size_t i = 0; i < count;) {
+		truncated(1);
+		const auto b1 = *data++;
+		if(b1 == op_rgb) {
+			truncated(3);
+			px.r = data[0];
+			px.g = data[1];
+			px.b = data[2];
+			data += 3;
+		} else if(b1 == op_rgba) {
+			truncated(4);
+			px = { data[0], data[1], data[2], data[3] };
+			data += 4;
+		} else if((b1 & mask) == op_index) {
+			px = index[b1];
+		} else if((b1 & mask) == op_diff) {
+			px.r += ((b1 >> 4) & 0x03)-2;
+			px.g += ((b1 >> 2) & 0x03)-2;
+			px.b += (b1 & 0x03)-2;
+		} else if((b1 & mask) == op_luma) {
+			truncated(1);
+			const auto b2 = *data++;
+			const int dg = (b1 & 0x3f)-32;
+			px.r += dg-8+((b2 >> 4) & 0x0f);
+			px.g += dg;
+			px.b += dg-8+(b2 & 0x0f);
+		} else {
+			// Only matters for a run of the initial pixel, which has not been seen before.
+			index[hash(px)] = px;
+			const auto run = std::min<size_t>((b1 & 0x3f)+1, count-i);
+			for(size_t r = 0; r < run; ++r) {
+				store<Channels>(out+(i+r)*Channels, px);
+			}
+			i += run;
+			continue;
+		}
+		index[hash(px)] = px;
+		store<Channels>(out+i*Channels, px);
+		++i;
+	}
+}
+
+}
+
+bool is_qoi(std::span<const std::byte> data) {
+	return data.size() >= header_size && std::memcmp(data.data(), magic.data(), magic.size()) == 0;
+}
+
+unsigned char* decode(std::span<const std::byte> data, int channels, size_t& width, size_t& height) {
+	if(!is_qoi(data)) {
+		throw std::runtime_error("Data is not a QOI image.");
+	}
+	const auto* bytes = reinterpret_cast<const std::uint8_t*>(data.data());
+	width = read_u32(bytes+4);
+	height = read_u32(bytes+8);
+	const auto file_channels = bytes[12];
+	if(width == 0 || height == 0 || width*height > max_pixels || file_channels < 3 || file_channels > 4) {
+		throw std::runtime_error("QOI header is invalid.");
+	}
+	if(channels < 1 || channels > 4) {
+		throw std::runtime_error("QOI images can only be decoded with 1 to 4 channels.");
+	}
+
+	const auto count = width*height;
+	// Released with stbi_image_free like all other decoded images, which calls free.
+	auto* out = static_cast<unsigned char*>(std::malloc(count*channels));
+	if(out == nullptr) {
+		throw std::bad_alloc();
+	}
+	try {
+		const auto* chunks = bytes+header_size;
+		const auto* chunks_end = bytes+data.size();
+		switch(channels) {
+			case 1: decode_chunks<1>(chunks, chunks_end, out, count); break;
+			case 2: decode_chunks<2>(chunks, chunks_end, out, count); break;
+			case 3: decode_chunks<3>(chunks, chunks_end, out, count); break;
+			case 4: decode_chunks<4>(chunks, chunks_end, out, count); break;
+		}
+	} catch(...) {
+		std::free(out);
+		throw;
+	}
+	return out;
+}
+
+std::vector<std::byte> encode(const unsigned char* pixels, size_t width, size_t height, int channels) {
+	if(channels < 1 || channels > 4) {
+		throw std::runtime_error("QOI images can only be encoded from 1 to 4 channels.");
+	}
+	const auto count = width*height;
+	if(width == 0 || height == 0 || count > max_pixels || width > std::numeric_limits<std::uint32_t>::max() || height > std::numeric_limits<std::uint32_t>::max()) {
+		throw std::runtime_error("Image size "+std::to_string(width)+"x"+std::to_string(height)+" can not be stored as QOI.");
+	}
+	const std::uint8_t file_channels = channels == 1 || channels == 3 ? 3 : 4;
+
+	std::vector<std::byte> result(header_size);
+	auto* header = reinterpret_cast<std::uint8_t*>(result.data());
+	std::copy(magic.begin(), magic.end(), header);
+	write_u32(header+4, static_cast<std::uint32_t>(width));
+	write_u32(header+8, static_cast<std::uint32_t>(height));
+	header[12] = file_channels;
+	// sRGB with linear alpha, the format does not change the pixels in any way.
+	header[13] = 0;
+
+	switch(channels) {
+		case 1: encode_bands<1>(pixels, count, file_channels, result); break;
+		case 2: encode_bands<2>(pixels, count, file_channels, result); break;
+		case 3: encode_bands<3>(pixels, count, file_channels, result); break;
+		case 4: encode_bands<4>(pixels, count, file_channels, result); break;
+	}
+	const auto* end = reinterpret_cast<const std::byte*>(end_marker.data());
+	result.insert(result.end(), end, end+end_marker.size());
+	return result;
+}
+
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace glpp::core::object::detail::qoi {
+
+	bool is_qoi(std::span<const std::byte> data);
+
+	// Decodes into memory allocated with malloc, converted to channels between 1 and 4.
+	unsigned char* decode(std::span<const std::byte> data, int channels, size_t& width, size_t& height);
+
+	// Encodes pixels with 1 to 4 channels. Gray images are stored as rgb, gray alpha images as rgba.
+	// Bands of rows are encoded on multiple threads, the result is a single standard QOI stream.
+	std::vector<std::byte> encode(const unsigned char* pixels, size_t width, size_t height, int channels);
+
+}
@@ -1,26 +1,80 @@
 #include "glpp/core/object/image.hpp"
+#include "mapped_file.hpp"
+#include "qoi.hpp"
 #include <stb_image.h>
 #include <stb_image_write.h>
+#include <fstream>
 #include <memory>
 #include <cstring>
+#include <limits>
 #include <string_view>
 
 namespace glpp::core::object {
 namespace detail {
 
-stbi_image_t::stbi_image_t(const char* filename, int channels)
+decoded_image_t::decoded_image_t(const char* filename, int channels, decoded_type_t max_type) :
+	m_channels(channels)
 {
-	m_storage = stbi_load(
-		filename,
-		&m_width,
-		&m_height,
-		&m_channels,
-		channels
-	);
+	const mapped_file_t file(filename);
+	decode(file.data(), max_type, filename);
+}
+
+decoded_image_t::decoded_image_t(std::span<const std::byte> data, int channels, decoded_type_t max_type) :
+	m_channels(channels)
+{
+	decode(data, max_type, "data");
+}
+
+decoded_image_t::~decoded_image_t() {
+	stbi_image_free(m_storage);
+}
+
+void decoded_image_t::decode(std::span<const std::byte> data, decoded_type_t max_type, const char* name) {
+	if(data.size() > static_cast<size_t>(std::numeric_limits<int>::max())) {
+		throw std::runtime_error(std::string("Image ")+name+" is too large to be decoded.");
+	}
+	if(qoi::is_qoi(data)) {
+		try {
+			m_type = decoded_type_t::u8;
+			m_storage = qoi::decode(data, static_cast<int>(m_channels), m_width, m_height);
+		} catch(const std::runtime_error& error) {
+			throw std::runtime_error(std::string("Image ")+name+" could not be decoded: "+error.what());
+		}
+		return;
+	}
+	const auto* buffer = reinterpret_cast<const stbi_uc*>(data.data());
+	const auto size = static_cast<int>(data.size());
+	const auto channels = static_cast<int>(m_channels);
+	int width = 0;
+	int height = 0;
+	int components = 0;
+	if(max_type == decoded_type_t::f32 && stbi_is_hdr_from_memory(buffer, size)) {
+		m_type = decoded_type_t::f32;
+		m_storage = stbi_loadf_from_memory(buffer, size, &width, &height, &components, channels);
+	} else if(max_type != decoded_type_t::u8 && stbi_is_16_bit_from_memory(buffer, size)) {
+		m_type = decoded_type_t::u16;
+		m_storage = stbi_load_16_from_memory(buffer, size, &width, &height, &components, channels);
+	} else {
+		m_type = decoded_type_t::u8;
+		m_storage = stbi_load_from_memory(buffer, size, &width, &height, &components, channels);
+	}
 	if(m_storage == nullptr) {
-		throw std::runtime_error(std::string("Image ")+filename+" could not be found or opened.");
-	} 
-	m_channels = channels;
+		throw std::runtime_error(std::string("Image ")+name+" could not be decoded: "+stbi_failure_reason());
+	}
+	m_width = static_cast<size_t>(width);
+	m_height = static_cast<size_t>(height);
+}
+
+size_t decoded_image_t::width() const {
+	return m_width;
+}
+
+size_t decoded_image_t::height() const {
+	return m_height;
+}
+
+decoded_type_t decoded_image_t::type() const {
+	return m_type;
 }
 
 stbi_image_t::stbi_image_t(size_t width, size_t height, int channels) :
@@ -46,6 +100,13 @@ int jpg_write_adapter(const char* filename, int w, int h, int comp, const void*
 	return stbi_write_jpg(filename, w, h , comp, data, 99);
 }
 
+int qoi_write_adapter(const char* filename, int w, int h, int comp, const void* data) {
+	const auto encoded = qoi::encode(static_cast<const unsigned char*>(data), w, h, comp);
+	std::ofstream file(filename, std::ios::binary);
+	file.write(reinterpret_cast<const char*>(encoded.data()), encoded.size());
+	return file.good();
+}
+
 void stbi_image_t::write(const char* filename) const {
 	using write_function_t = int (*)(const char*, int, int, int, const void*);
 	using write_function_map_t = std::unordered_map<std::string_view, write_function_t>;
@@ -55,7 +116,8 @@ void stbi_image_t::write(const char* filename) const {
 		{ "png", png_write_adapter },
 		{ "tga", stbi_write_tga },
 		{ "jpg", jpg_write_adapter },
-		{ "jpeg", jpg_write_adapter }
+		{ "jpeg", jpg_write_adapter },
+		{ "qoi", qoi_write_adapter }
 	};
 
 	const std::string_view filename_sv = filename;
@@ -2,6 +2,7 @@
 
 #include <string_view>
 #include <glpp/gl/context.hpp>
+#include <glpp/core/object/texture_unit_cache.hpp>
 #include <GLFW/glfw3.h>
 #include <fmt/format.h>
 
@@ -70,6 +71,7 @@ window_t::window_t(unsigned int width, unsigned int height, const std::string& n
 
 	// load dynamic opengl functions
 	glpp::init(&glfwGetProcAddress);
+	glpp::core::object::texture_unit_cache_t::make_current(m_window);
 	
 	//Check GL context
 	GLint glMajor = 0;
@@ -117,9 +119,6 @@ window_t::window_t(unsigned int width, unsigned int height, const std::string& n
 	// Enable Antialiasing by multisampling
 	glEnable(GL_MULTISAMPLE);
 
-	// Texture input aligned bytewise // this is the slowest, but safest way to upload textures
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // Disable byte-alignment restriction
-
 }
 
 window_t::window_t(window_t&& mov) :
@@ -138,6 +137,7 @@ window_t::window_t(window_t&& mov) :
 window_t::~window_t()
 {
 	if(m_window != nullptr) {
+		glpp::core::object::texture_unit_cache_t::release(m_window);
 		glfwDestroyWindow(m_window);
 	}
 }
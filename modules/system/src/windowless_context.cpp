@@ -7,6 +7,7 @@
 #include <glpp/system/windowless_context.hpp>
 #include <glpp/gl.hpp>
 #include <glpp/gl/context.hpp>
+#include <glpp/core/object/texture_unit_cache.hpp>
 
 namespace glpp::system {
 
@@ -114,6 +115,7 @@ windowless_context_t::windowless_context_t(const driver_t driver) {
     assertEGLError("make context current");
     
     glpp::init(&eglGetProcAddress);
+    glpp::core::object::texture_unit_cache_t::make_current(context);
 
     int major, minor;
     glGetIntegerv(GL_MAJOR_VERSION, &major);
@@ -132,6 +134,7 @@ windowless_context_t::windowless_context_t(const driver_t driver) {
 windowless_context_t::~windowless_context_t() {
     if(display != nullptr) {
         if(context != nullptr) {
+            glpp::core::object::texture_unit_cache_t::release(context);
             eglDestroyContext(display, context);
             assertEGLError("destroy context");
         }
@@ -36,6 +36,11 @@ public:
         return m_framebuffer.pixel_read<Color>();
     }
 
+    // Render target of the context, e.g. to capture it with a frame_recorder_t.
+    const core::object::framebuffer_t& framebuffer() const {
+        return m_framebuffer;
+    }
+
 private:
     Driver m_driver;
     core::object::framebuffer_t m_framebuffer;
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <glpp/gl/constants.hpp>
+#include <glpp/gl/context.hpp>
+#include <cstddef>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace glpp::test {
+
+/*
+ * Replaces the current gl context with a mock_context_t, which emulates the state most unit
+ * tests rely on: object names, buffer storage, buffer bindings, pixel store parameters and their
+ * queries, fences and texture unit bindings. Tests override single functions of glpp::gl::context afterwards.
+ */
+struct mock_gl_t {
+    enum class fence_mode_t {
+        // Fences are signaled as soon as they are created.
+        signaled,
+        // Fences are signaled by the first wait with a timeout, polls without timeout expire before.
+        on_wait
+    };
+
+    struct bind_call_t {
+        GLuint first;
+        std::vector<GLuint> names;
+
+        bool operator==(const bind_call_t&) const = default;
+    };
+
+    explicit mock_gl_t(fence_mode_t fence_mode = fence_mode_t::signaled);
+
+    mock_gl_t(const mock_gl_t& cpy) = delete;
+    mock_gl_t& operator=(const mock_gl_t& cpy) = delete;
+
+    // Last created object names, names start at 1 for each kind of object.
+    GLuint buffer_names = 0;
+    GLuint texture_names = 0;
+    GLuint framebuffer_names = 0;
+    GLuint renderbuffer_names = 0;
+
+    // Texture targets by texture name.
+    std::map<GLuint, GLenum> texture_targets;
+
+    // Storage of all buffers, which have not been deleted.
+    std::map<GLuint, std::vector<std::byte>> buffers;
+    std::map<GLenum, GLuint> bound_buffers;
+    std::map<std::pair<GLenum, GLuint>, GLuint> indexed_buffers;
+    int maps = 0;
+
+    std::map<GLenum, GLint> pixel_store {
+        { GL_PACK_ALIGNMENT, 4 }, { GL_UNPACK_ALIGNMENT, 4 },
+        { GL_PACK_ROW_LENGTH, 0 }, { GL_UNPACK_ROW_LENGTH, 0 }
+    };
+
+    fence_mode_t fence_mode;
+    GLsync fences = 0;
+    std::set<GLsync> signaled;
+    int fences_deleted = 0;
+    int flushes = 0;
+
+    std::vector<bind_call_t> texture_binds;
+    std::vector<bind_call_t> sampler_binds;
+
+    GLuint bound(GLenum target) const;
+    std::vector<std::byte>& storage(GLuint buffer);
+};
+
+}
@@ -0,0 +1,134 @@
+#include <glpp/testing/mock_gl.hpp>
+#include <cstring>
+#include <stdexcept>
+
+namespace glpp::test {
+
+using glpp::gl::context;
+
+mock_gl_t::mock_gl_t(fence_mode_t fence_mode) :
+    fence_mode(fence_mode)
+{
+    context = glpp::gl::mock_context_t{};
+
+    context.glCreateBuffers = [this](GLsizei n, GLuint* names) {
+        for(GLsizei i = 0; i < n; ++i) {
+            names[i] = ++buffer_names;
+            buffers[names[i]];
+        }
+    };
+    context.glDeleteBuffers = [this](GLsizei n, const GLuint* names) {
+        for(GLsizei i = 0; i < n; ++i) {
+            buffers.erase(names[i]);
+        }
+    };
+    context.glCreateTextures = [this](GLenum target, GLsizei n, GLuint* names) {
+        for(GLsizei i = 0; i < n; ++i) {
+            names[i] = ++texture_names;
+            texture_targets[names[i]] = target;
+        }
+    };
+    context.glCreateFramebuffers = [this](GLsizei n, GLuint* names) {
+        for(GLsizei i = 0; i < n; ++i) {
+            names[i] = ++framebuffer_names;
+        }
+    };
+    context.glCreateRenderbuffers = [this](GLsizei n, GLuint* names) {
+        for(GLsizei i = 0; i < n; ++i) {
+            names[i] = ++renderbuffer_names;
+        }
+    };
+
+    const auto allocate = [this](GLuint buffer, GLsizeiptr size, const void* data) {
+        auto& bytes = storage(buffer);
+        bytes.assign(size, std::byte{ 0 });
+        if(data) {
+            std::memcpy(bytes.data(), data, size);
+        }
+    };
+    context.glNamedBufferStorage = [allocate](GLuint buffer, GLsizeiptr size, const void* data, GLbitfield) {
+        allocate(buffer, size, data);
+    };
+    context.glNamedBufferData = [allocate](GLuint buffer, GLsizeiptr size, const void* data, GLenum) {
+        allocate(buffer, size, data);
+    };
+    context.glNamedBufferSubData = [this](GLuint buffer, GLintptr offset, GLsizeiptr size, const void* data) {
+        std::memcpy(storage(buffer).data()+offset, data, size);
+    };
+    context.glGetNamedBufferSubData = [this](GLuint buffer, GLintptr offset, GLsizeiptr size, void* data) {
+        std::memcpy(data, storage(buffer).data()+offset, size);
+    };
+    context.glCopyNamedBufferSubData = [this](GLuint read, GLuint write, GLintptr read_offset, GLintptr write_offset, GLsizeiptr size) {
+        std::memmove(storage(write).data()+write_offset, storage(read).data()+read_offset, size);
+    };
+    context.glMapNamedBufferRange = [this](GLuint buffer, GLintptr offset, GLsizeiptr, GLbitfield) -> void* {
+        ++maps;
+        return storage(buffer).data()+offset;
+    };
+    context.glUnmapNamedBuffer = [](GLuint) -> GLboolean { return GL_TRUE; };
+    context.glBindBuffer = [this](GLenum target, GLuint buffer) {
+        bound_buffers[target] = buffer;
+    };
+    context.glBindBufferBase = [this](GLenum target, GLuint index, GLuint buffer) {
+        indexed_buffers[{ target, index }] = buffer;
+    };
+
+    context.glPixelStorei = [this](GLenum name, GLint value) {
+        pixel_store[name] = value;
+    };
+    context.glGetIntegerv = [this](GLenum name, GLint* value) {
+        const auto it = pixel_store.find(name);
+        if(it != pixel_store.end()) {
+            *value = it->second;
+        }
+    };
+
+    context.glFenceSync = [this](GLenum, GLbitfield) {
+        ++fences;
+        if(this->fence_mode == fence_mode_t::signaled) {
+            signaled.insert(fences);
+        }
+        return fences;
+    };
+    context.glDeleteSync = [this](GLsync) { ++fences_deleted; };
+    context.glClientWaitSync = [this](GLsync sync, GLbitfield, GLuint64 timeout) -> GLenum {
+        if(signaled.contains(sync)) return GL_ALREADY_SIGNALED;
+        if(timeout > 0) {
+            signaled.insert(sync);
+            return GL_CONDITION_SATISFIED;
+        }
+        return GL_TIMEOUT_EXPIRED;
+    };
+    context.glFlush = [this] { ++flushes; };
+
+    context.glGetShaderiv = [](GLuint, GLenum, GLint* value) { *value = GL_TRUE; };
+    context.glGetProgramiv = [](GLuint, GLenum, GLint* value) { *value = GL_TRUE; };
+
+    context.glBindTextureUnit = [this](GLuint unit, GLuint texture) {
+        texture_binds.push_back({ unit, { texture } });
+    };
+    context.glBindTextures = [this](GLuint first, GLsizei count, const GLuint* names) {
+        texture_binds.push_back({ first, std::vector<GLuint>(names, names+count) });
+    };
+    context.glBindSampler = [this](GLuint unit, GLuint sampler) {
+        sampler_binds.push_back({ unit, { sampler } });
+    };
+    context.glBindSamplers = [this](GLuint first, GLsizei count, const GLuint* names) {
+        sampler_binds.push_back({ first, std::vector<GLuint>(names, names+count) });
+    };
+}
+
+GLuint mock_gl_t::bound(GLenum target) const {
+    const auto it = bound_buffers.find(target);
+    return it == bound_buffers.end() ? 0 : it->second;
+}
+
+std::vector<std::byte>& mock_gl_t::storage(GLuint buffer) {
+    const auto it = buffers.find(buffer);
+    if(it == buffers.end()) {
+        throw std::runtime_error("Buffer does not exist.");
+    }
+    return it->second;
+}
+
+}
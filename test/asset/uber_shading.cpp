@@ -0,0 +1,177 @@
+#include <catch2/catch_all.hpp>
+#include <glpp/asset.hpp>
+#include <glpp/asset/render/uber_scene_renderer.hpp>
+#include <glpp/asset/shading/flat_uber.hpp>
+#include <glpp/gl/context.hpp>
+#include <glpp/testing/mock_gl.hpp>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace glpp::asset;
+using namespace glpp::core::object;
+using namespace glpp::gl;
+
+namespace {
+
+template <class T>
+T read(const std::vector<std::byte>& bytes, size_t offset) {
+    REQUIRE(offset+sizeof(T) <= bytes.size());
+    T value;
+    std::memcpy(&value, bytes.data()+offset, sizeof(T));
+    return value;
+}
+
+material_t material(float value, texture_stack_t diffuse_textures = {}) {
+    material_t result;
+    result.ambient = glm::vec3(value, 0.0f, 0.0f);
+    result.diffuse = glm::vec3(0.0f, value, 0.0f);
+    result.specular = glm::vec3(0.0f, 0.0f, value);
+    result.emissive = glm::vec3(value);
+    result.diffuse_textures = std::move(diffuse_textures);
+    result.shininess = value*10.0f;
+    return result;
+}
+
+mesh_t quad(unsigned int material_index, float x) {
+    glm::mat4 model_matrix { 1.0f };
+    model_matrix[3][0] = x;
+    return mesh_t {
+        mesh_t::model_t {
+            {
+                { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f } },
+                { { 1.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 1.0f, 0.0f } },
+                { { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f } }
+            },
+            { 0, 1, 2 }
+        },
+        model_matrix,
+        material_index
+    };
+}
+
+}
+
+TEST_CASE("material_buffer_t packs materials in the std430 layout of its declaration", "[asset][unit]") {
+    glpp::test::mock_gl_t gl;
+
+    const std::vector<material_t> materials {
+        material(0.5f, { { 3, 0.25f, op_t::multiplication }, { 7, 1.0f, op_t::addition } }),
+        material(1.0f, { { 4, 0.5f, op_t::signed_addition } })
+    };
+    shading::material_buffer_t buffer { materials };
+    REQUIRE(buffer.size() == 2);
+    buffer.bind(2, 5);
+    const auto declaration = shading::material_buffer_t::declaration(2, 5);
+    REQUIRE(declaration.find("layout(std430, binding = 2) readonly buffer glpp_materials_block") != std::string::npos);
+    REQUIRE(declaration.find("layout(std430, binding = 5) readonly buffer glpp_texture_stack_block") != std::string::npos);
+
+    // Records are 112 bytes: 4 vec4 colors, 2 uvec4 stack ranges and shininess padded to 16 bytes.
+    const auto& records = gl.storage(gl.indexed_buffers.at({ GL_SHADER_STORAGE_BUFFER, 2 }));
+    REQUIRE(records.size() == 2*112);
+    REQUIRE(read<glm::vec4>(records, 0) == glm::vec4(0.5f, 0.0f, 0.0f, 1.0f));
+    REQUIRE(read<glm::vec4>(records, 16) == glm::vec4(0.0f, 0.5f, 0.0f, 1.0f));
+    REQUIRE(read<glm::vec4>(records, 32) == glm::vec4(0.0f, 0.0f, 0.5f, 1.0f));
+    REQUIRE(read<glm::vec4>(records, 48) == glm::vec4(0.5f, 0.5f, 0.5f, 1.0f));
+    REQUIRE(read<glm::uvec4>(records, 64) == glm::uvec4(0, 0, 2, 2));
+    REQUIRE(read<glm::uvec4>(records, 80) == glm::uvec4(0, 2, 0, 0));
+    REQUIRE(read<float>(records, 96) == 5.0f);
+    // The stacks of the second material follow the ones of the first.
+    REQUIRE(read<glm::vec4>(records, 112+16) == glm::vec4(0.0f, 1.0f, 0.0f, 1.0f));
+    REQUIRE(read<glm::uvec4>(records, 112+64) == glm::uvec4(2, 2, 3, 3));
+    REQUIRE(read<glm::uvec4>(records, 112+80) == glm::uvec4(0, 1, 0, 0));
+    REQUIRE(read<float>(records, 112+96) == 10.0f);
+
+    // Stack entries are 16 bytes: key, strength, op and padding.
+    const auto& stack = gl.storage(gl.indexed_buffers.at({ GL_SHADER_STORAGE_BUFFER, 5 }));
+    REQUIRE(stack.size() == 3*16);
+    REQUIRE(read<std::uint32_t>(stack, 0) == 3);
+    REQUIRE(read<float>(stack, 4) == 0.25f);
+    REQUIRE(read<std::uint32_t>(stack, 8) == static_cast<std::uint32_t>(op_t::multiplication));
+    REQUIRE(read<std::uint32_t>(stack, 16) == 7);
+    REQUIRE(read<std::uint32_t>(stack, 32) == 4);
+    REQUIRE(read<std::uint32_t>(stack, 40) == static_cast<std::uint32_t>(op_t::signed_addition));
+
+    // Empty scenes still get bindable buffers with one record each.
+    buffer.update({});
+    REQUIRE(buffer.size() == 0);
+    buffer.bind();
+    REQUIRE(gl.storage(gl.indexed_buffers.at({ GL_SHADER_STORAGE_BUFFER, 0 })).size() == 112);
+    REQUIRE(gl.storage(gl.indexed_buffers.at({ GL_SHADER_STORAGE_BUFFER, 1 })).size() == 16);
+}
+
+TEST_CASE("flat_uber_t reads the selected channel of the material from the buffer", "[asset][unit]") {
+    glpp::test::mock_gl_t gl;
+    const texture_atlas_t<texture_atlas::multi_policy_t> textures;
+
+    const std::map<shading::flat_shading_channel_t, std::string> channels {
+        { shading::flat_shading_channel_t::ambient, "material.ambient" },
+        { shading::flat_shading_channel_t::diffuse, "material.diffuse" },
+        { shading::flat_shading_channel_t::specular, "material.specular" },
+        { shading::flat_shading_channel_t::emission, "material.emissive" }
+    };
+    for(const auto& [channel, name] : channels) {
+        const shading::flat_uber_t flat { textures, channel };
+        const auto code = flat.fragment_shader_code();
+        const auto index = std::to_string(static_cast<int>(channel));
+        REQUIRE(code.find("glpp_materials[material_id]") != std::string::npos);
+        REQUIRE(code.find(shading::material_buffer_t::declaration()) != std::string::npos);
+        REQUIRE(code.find("FragColor = vec4("+name+".xyz, 1.0);") != std::string::npos);
+        REQUIRE(code.find("material.stack_offset["+index+"]") != std::string::npos);
+        REQUIRE(code.find("material.stack_size["+index+"]") != std::string::npos);
+        // An empty atlas has nothing to fetch from.
+        REQUIRE(code.find("return vec4(0.0);") != std::string::npos);
+        REQUIRE(code.find("<channel") == std::string::npos);
+    }
+}
+
+TEST_CASE("uber_scene_renderer_t draws each material group with its material_id", "[asset][unit]") {
+    glpp::test::mock_gl_t gl;
+
+    std::map<std::string, GLint> locations;
+    context.glGetUniformLocation = [&](GLuint, const GLchar* name) -> GLint {
+        return locations.emplace(name, static_cast<GLint>(locations.size())).first->second;
+    };
+    GLint material_id = -1;
+    float model_x = 0.0f;
+    std::vector<std::pair<GLint, float>> draws;
+    context.glProgramUniform1i = [&](GLuint, GLint location, GLint value) {
+        REQUIRE(location == locations.at("material_id"));
+        material_id = value;
+    };
+    context.glProgramUniformMatrix4fv = [&](GLuint, GLint location, GLsizei, GLboolean, const GLfloat* value) {
+        if(location == locations.at("model_matrix")) {
+            model_x = value[12];
+        }
+    };
+    context.glDrawElements = [&](GLenum, GLsizei, GLenum, const void*) {
+        draws.emplace_back(material_id, model_x);
+    };
+
+    scene_t scene;
+    scene.materials = { material(0.0f), material(1.0f), material(2.0f) };
+    scene.meshes.push_back(quad(2, 1.0f));
+    scene.meshes.push_back(quad(0, 2.0f));
+    scene.meshes.push_back(quad(2, 3.0f));
+
+    const texture_atlas_t<texture_atlas::multi_policy_t> textures;
+    const shading::flat_uber_t flat { textures };
+    render::uber_scene_renderer_t renderer { flat, scene };
+    const render::scene_view_t view { scene };
+    renderer.render(view);
+
+    // One program for all materials, material 1 has no meshes and is skipped.
+    const std::vector<std::pair<GLint, float>> expected { { 0, 2.0f }, { 2, 1.0f }, { 2, 3.0f } };
+    REQUIRE(draws == expected);
+    const auto materials = gl.indexed_buffers.at({ GL_SHADER_STORAGE_BUFFER, shading::material_buffer_t::default_material_binding });
+    REQUIRE(gl.storage(materials).size() == 3*sizeof(shading::gpu_material_t));
+
+    // Groups without a material record are not drawn.
+    draws.clear();
+    scene_t fewer;
+    fewer.materials = { material(0.0f) };
+    renderer.update_materials(fewer);
+    renderer.render(view);
+    REQUIRE(draws == std::vector<std::pair<GLint, float>> { { 0, 2.0f } });
+}
@@ -0,0 +1,223 @@
+#include <catch2/catch_all.hpp>
+#include <glpp/core/object/block_compression.hpp>
+#include <glpp/core/object/image_conversion.hpp>
+#include <array>
+#include <cmath>
+#include <random>
+
+using namespace glpp::core::object;
+using ubyte4 = glm::vec<4, unsigned char>;
+
+namespace {
+
+std::uint64_t load(const std::byte* data) {
+    std::uint64_t bits = 0;
+    for(size_t i = 0; i < 8; ++i) {
+        bits |= static_cast<std::uint64_t>(data[i]) << (8*i);
+    }
+    return bits;
+}
+
+std::array<float, 3> expand_565(std::uint64_t c) {
+    const auto r = (c >> 11) & 31;
+    const auto g = (c >> 5) & 63;
+    const auto b = c & 31;
+    return {
+        static_cast<float>(r << 3 | r >> 2),
+        static_cast<float>(g << 2 | g >> 4),
+        static_cast<float>(b << 3 | b >> 2)
+    };
+}
+
+// Reference decoders following the S3TC and RGTC specifications.
+std::array<std::array<float, 4>, 16> decode_bc1(const std::byte* data, bool four_color_only) {
+    const auto bits = load(data);
+    const auto c0 = bits & 0xFFFF;
+    const auto c1 = (bits >> 16) & 0xFFFF;
+    const auto p0 = expand_565(c0);
+    const auto p1 = expand_565(c1);
+    std::array<std::array<float, 4>, 4> palette;
+    palette[0] = { p0[0], p0[1], p0[2], 255.0f };
+    palette[1] = { p1[0], p1[1], p1[2], 255.0f };
+    for(size_t c = 0; c < 3; ++c) {
+        if(c0 > c1 || four_color_only) {
+            palette[2][c] = (2*p0[c]+p1[c])/3;
+            palette[3][c] = (p0[c]+2*p1[c])/3;
+        } else {
+            palette[2][c] = (p0[c]+p1[c])/2;
+            palette[3][c] = 0.0f;
+        }
+    }
+    palette[2][3] = 255.0f;
+    palette[3][3] = c0 > c1 || four_color_only ? 255.0f : 0.0f;
+
+    std::array<std::array<float, 4>, 16> result;
+    for(size_t i = 0; i < 16; ++i) {
+        result[i] = palette[(bits >> (32+2*i)) & 3];
+    }
+    return result;
+}
+
+std::array<float, 16> decode_bc4(const std::byte* data) {
+    const auto bits = load(data);
+    const auto a0 = static_cast<float>(bits & 0xFF);
+    const auto a1 = static_cast<float>((bits >> 8) & 0xFF);
+    std::array<float, 8> palette { a0, a1 };
+    if(a0 > a1) {
+        for(auto i = 2; i < 8; ++i) palette[i] = ((8-i)*a0+(i-1)*a1)/7;
+    } else {
+        for(auto i = 2; i < 6; ++i) palette[i] = ((6-i)*a0+(i-1)*a1)/5;
+        palette[6] = 0.0f;
+        palette[7] = 255.0f;
+    }
+    std::array<float, 16> result;
+    for(size_t i = 0; i < 16; ++i) {
+        result[i] = palette[(bits >> (16+3*i)) & 7];
+    }
+    return result;
+}
+
+// Decodes the first block of every image and returns the RGBA values of the 4x4 pixels.
+std::array<std::array<float, 4>, 16> decode_first_block(const compressed_image_t& image) {
+    const auto* data = image.level(0).data.data();
+    switch(image.format()) {
+        case image_format_t::bc3: {
+            auto result = decode_bc1(data+8, true);
+            const auto alpha = decode_bc4(data);
+            for(size_t i = 0; i < 16; ++i) result[i][3] = alpha[i];
+            return result;
+        }
+        case image_format_t::bc5: {
+            const auto r = decode_bc4(data);
+            const auto g = decode_bc4(data+8);
+            std::array<std::array<float, 4>, 16> result;
+            for(size_t i = 0; i < 16; ++i) result[i] = { r[i], g[i], 0.0f, 255.0f };
+            return result;
+        }
+        default:
+            return decode_bc1(data, false);
+    }
+}
+
+float rms_error(const image_t<ubyte4>& image, const compressed_image_t& compressed, size_t channels) {
+    const auto decoded = decode_first_block(compressed);
+    float error = 0.0f;
+    for(size_t i = 0; i < 16; ++i) {
+        const auto& pixel = image.get(i%4, i/4);
+        for(size_t c = 0; c < channels; ++c) {
+            const auto d = decoded[i][c]-static_cast<float>(pixel[c]);
+            error += d*d;
+        }
+    }
+    return std::sqrt(error/(16*channels));
+}
+
+image_t<ubyte4> gradient() {
+    image_t<ubyte4> image(4, 4);
+    for(size_t y = 0; y < 4; ++y) {
+        for(size_t x = 0; x < 4; ++x) {
+            const auto t = static_cast<unsigned char>((y*4+x)*17);
+            image.get(x, y) = ubyte4(t, 255-t, t/2, 255);
+        }
+    }
+    return image;
+}
+
+}
+
+TEST_CASE("block compression encodes solid colors within the endpoint precision", "[core][unit]") {
+    const auto quality = GENERATE(compression_quality_t::fast, compression_quality_t::normal, compression_quality_t::high);
+    const image_t<ubyte4> image(4, 4, ubyte4(200, 100, 50, 255));
+
+    const auto compressed = compress(image, image_format_t::bc1_rgb, quality);
+    REQUIRE(compressed.format() == image_format_t::bc1_rgb);
+    REQUIRE(compressed.level(0).data.size() == 8);
+    for(const auto& pixel : decode_first_block(compressed)) {
+        REQUIRE(std::abs(pixel[0]-200.0f) <= 4.0f);
+        REQUIRE(std::abs(pixel[1]-100.0f) <= 2.0f);
+        REQUIRE(std::abs(pixel[2]-50.0f) <= 4.0f);
+    }
+}
+
+TEST_CASE("block compression quality presets bound the error of gradients", "[core][unit]") {
+    const auto image = gradient();
+    const auto fast = rms_error(image, compress(image, image_format_t::bc1_rgb, compression_quality_t::fast), 3);
+    const auto normal = rms_error(image, compress(image, image_format_t::bc1_rgb, compression_quality_t::normal), 3);
+    const auto high = rms_error(image, compress(image, image_format_t::bc1_rgb, compression_quality_t::high), 3);
+
+    REQUIRE(fast < 24.0f);
+    REQUIRE(normal < 20.0f);
+    REQUIRE(high <= normal);
+
+    const auto bc3 = rms_error(image, compress(image, image_format_t::bc3, compression_quality_t::normal), 4);
+    REQUIRE(bc3 < 20.0f);
+}
+
+TEST_CASE("block compression encodes punch through alpha for bc1 with alpha", "[core][unit]") {
+    auto image = gradient();
+    image.get(1, 2) = ubyte4(0, 0, 0, 0);
+    image.get(3, 3) = ubyte4(255, 255, 255, 10);
+
+    const auto decoded = decode_first_block(compress(image, image_format_t::bc1_rgba));
+    for(size_t i = 0; i < 16; ++i) {
+        const auto transparent = image.get(i%4, i/4)[3] < 128;
+        REQUIRE(decoded[i][3] == (transparent ? 0.0f : 255.0f));
+    }
+}
+
+TEST_CASE("block compression encodes bc4 and bc5 channels", "[core][unit]") {
+    image_t<std::uint8_t> red(4, 4);
+    for(size_t i = 0; i < 16; ++i) red.data()[i] = static_cast<std::uint8_t>(i*i);
+
+    const auto quality = GENERATE(compression_quality_t::fast, compression_quality_t::high);
+    const auto bc4 = compress(red, image_format_t::bc4, quality);
+    const auto decoded = decode_bc4(bc4.level(0).data.data());
+    for(size_t i = 0; i < 16; ++i) {
+        // Half a palette step of the range [0, 225] split into 7 intervals.
+        REQUIRE(std::abs(decoded[i]-static_cast<float>(i*i)) <= 16.1f);
+    }
+
+    const auto image = gradient();
+    REQUIRE(rms_error(image, compress(image, image_format_t::bc5, quality), 2) < 12.0f);
+}
+
+TEST_CASE("block compression pads partial blocks and compresses mip chains", "[core][unit]") {
+    const image_t<ubyte4> image(6, 5, ubyte4(10, 20, 30, 255));
+    const auto chain = image.mip_chain();
+    const auto compressed = compress(chain, image_format_t::bc3);
+
+    REQUIRE(compressed.levels().size() == 3);
+    REQUIRE(compressed.width() == 6);
+    REQUIRE(compressed.height() == 5);
+    REQUIRE(compressed.level(0).data.size() == 2*2*16);
+    REQUIRE(compressed.level(2).data.size() == 16);
+    REQUIRE_THROWS(compress(image, image_format_t::bc7));
+    REQUIRE_THROWS(compress(image, image_format_t::rgba));
+}
+
+TEST_CASE("block compression kernels match on all instruction sets", "[core][unit]") {
+    // Noise with smooth regions and transparent pixels covers all block modes.
+    std::mt19937 random { 11 };
+    std::uniform_int_distribution<int> distribution { 0, 255 };
+    image_t<ubyte4> image(37, 23);
+    for(size_t y = 0; y < image.height(); ++y) {
+        for(size_t x = 0; x < image.width(); ++x) {
+            const auto noise = x%8 < 4 ? distribution(random) : static_cast<int>(x*7+y*3);
+            image.get(x, y) = ubyte4(noise, 255-noise, (noise*3)%256, distribution(random));
+        }
+    }
+
+    const auto best = conversion::simd_level();
+    for(const auto format : { image_format_t::bc1_rgb, image_format_t::bc1_rgba, image_format_t::bc3, image_format_t::bc4, image_format_t::bc5 }) {
+        for(const auto quality : { compression_quality_t::fast, compression_quality_t::normal, compression_quality_t::high }) {
+            conversion::set_simd_level(simd_level_t::scalar);
+            const auto reference = compress(image, format, quality).level(0).data;
+            for(const auto level : { simd_level_t::sse2, simd_level_t::avx2, simd_level_t::neon }) {
+                if(!conversion::simd_supported(level)) continue;
+                conversion::set_simd_level(level);
+                REQUIRE(compress(image, format, quality).level(0).data == reference);
+            }
+        }
+    }
+    conversion::set_simd_level(best);
+}
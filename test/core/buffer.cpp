@@ -69,6 +69,30 @@ TEST_CASE("buffer bind", "[core][unit]") {
     REQUIRE(bind_called == 1);
 }
 
+TEST_CASE("buffer bind to indexed binding point", "[core][unit]") {
+    
+    context.enable_throw();
+    auto bind_called = 0;
+
+    context.glCreateBuffers = [](GLsizei, GLuint* id) {
+        *id = 42;
+    };
+    context.glNamedBufferData = [](auto...) {};
+    context.glDeleteBuffers = [](auto...){};
+    context.glBindBufferBase = [&bind_called](GLenum target, GLuint index, GLuint buffer){
+        ++bind_called;
+        REQUIRE(buffer == 42);
+        REQUIRE(index == 3);
+        REQUIRE(target == GL_SHADER_STORAGE_BUFFER);
+    };
+
+    std::vector vert { 13.37f };
+    buffer_t buffer{ buffer_target_t::shader_storage_buffer, vert.data(), vert.size()*sizeof(float), buffer_usage_t::static_draw };
+    buffer.bind_base(3);
+
+    REQUIRE(bind_called == 1);
+}
+
 TEST_CASE("buffer copy to and from gpu mem", "[core][system][xorg]") {
     glpp::test::context_t<glpp::test::offscreen_driver_t> context(1,1);
     
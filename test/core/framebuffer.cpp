@@ -214,6 +214,185 @@ TEST_CASE("framebuffer_t check default framebuffer is not deleted", "[core][unit
     REQUIRE(call_read_pixels == 1);
 }
 
+TEST_CASE("framebuffer attach renderbuffer", "[core][unit]") {
+    context.enable_throw();
+
+    auto calls_storage = 0;
+    auto calls_attach = 0;
+    auto calls_delete = 0;
+    context.glCreateFramebuffers = [](GLsizei, GLuint* buffers) { *buffers = 42; };
+    context.glDeleteFramebuffers = [](auto...){};
+    context.glCreateRenderbuffers = [](GLsizei n, GLuint* buffers) {
+        REQUIRE(n == 1);
+        *buffers = 44;
+    };
+    context.glDeleteRenderbuffers = [&calls_delete](GLsizei, const GLuint* buffers) {
+        ++calls_delete;
+        REQUIRE(*buffers == 44);
+    };
+    context.glNamedRenderbufferStorageMultisample = [&calls_storage](GLuint buffer, GLsizei samples, GLenum format, GLsizei width, GLsizei height) {
+        ++calls_storage;
+        REQUIRE(buffer == 44);
+        REQUIRE(samples == 0);
+        REQUIRE(format == GL_DEPTH24_STENCIL8);
+        REQUIRE(height == 15);
+        (void)width;
+    };
+    context.glNamedFramebufferRenderbuffer = [&calls_attach](GLuint framebuffer, GLenum attachment, GLenum target, GLuint buffer) {
+        ++calls_attach;
+        REQUIRE(framebuffer == 42);
+        REQUIRE(attachment == GL_DEPTH_STENCIL_ATTACHMENT);
+        REQUIRE(target == GL_RENDERBUFFER);
+        REQUIRE(buffer == 44);
+    };
+
+    {
+        framebuffer_t framebuffer { 12, 15 };
+        const renderbuffer_t depth_stencil { 12, 15 };
+        REQUIRE(depth_stencil.width() == 12);
+        REQUIRE(depth_stencil.format() == image_format_t::d_24i_s_8i);
+        framebuffer.attach(depth_stencil, attachment_t::depth_stencil);
+        REQUIRE(framebuffer.samples() == 0);
+        REQUIRE_THROWS(framebuffer.attach(renderbuffer_t { 6, 15 }, attachment_t::depth));
+    }
+
+    REQUIRE(calls_storage == 2);
+    REQUIRE(calls_attach == 1);
+    REQUIRE(calls_delete == 2);
+}
+
+TEST_CASE("framebuffer resolve multisampled attachments", "[core][unit]") {
+    context.enable_throw();
+
+    GLuint next_id = 40;
+    auto calls_blit = 0;
+    context.glCreateFramebuffers = [&next_id](GLsizei, GLuint* buffers) { *buffers = ++next_id; };
+    context.glDeleteFramebuffers = [](auto...){};
+    context.glCreateTextures = [&next_id](GLenum target, GLsizei, GLuint* textures) {
+        REQUIRE((target == GL_TEXTURE_2D || target == GL_TEXTURE_2D_MULTISAMPLE));
+        *textures = ++next_id;
+    };
+    context.glDeleteTextures = [](auto...){};
+    context.glTextureParameteri = [](auto...){};
+    context.glTextureStorage2D = [](auto...){};
+    context.glTextureStorage2DMultisample = [](GLuint, GLsizei samples, GLenum format, GLsizei width, GLsizei height, GLboolean fixed) {
+        REQUIRE(samples == 4);
+        REQUIRE(format == GL_RGBA8);
+        REQUIRE(width == 12);
+        REQUIRE(height == 15);
+        REQUIRE(fixed == GL_TRUE);
+    };
+    context.glCreateRenderbuffers = [&next_id](GLsizei, GLuint* buffers) { *buffers = ++next_id; };
+    context.glDeleteRenderbuffers = [](auto...){};
+    context.glNamedRenderbufferStorageMultisample = [](GLuint, GLsizei samples, auto...) {
+        REQUIRE(samples == 4);
+    };
+    context.glNamedFramebufferTexture = [](auto...){};
+    context.glNamedFramebufferRenderbuffer = [](auto...){};
+
+    const multisample_texture_t color { 12, 15, 4 };
+    const renderbuffer_t depth { 12, 15, image_format_t::d_24i, 4 };
+    framebuffer_t multisampled { 12, 15 };
+    multisampled.attach(color, attachment_t::color);
+    multisampled.attach(depth, attachment_t::depth);
+    REQUIRE(multisampled.samples() == 4);
+
+    const texture_t resolved_color { 12, 15, image_format_t::rgba_8 };
+    const framebuffer_t resolved {{ resolved_color, attachment_t::color }};
+
+    context.glBlitNamedFramebuffer = [&](
+        GLuint read, GLuint draw,
+        GLint src_x0, GLint src_y0, GLint src_x1, GLint src_y1,
+        GLint dst_x0, GLint dst_y0, GLint dst_x1, GLint dst_y1,
+        GLbitfield mask, GLenum filter
+    ) {
+        ++calls_blit;
+        REQUIRE(read == multisampled.id());
+        REQUIRE(draw == resolved.id());
+        REQUIRE(src_x0 == 0);
+        REQUIRE(src_y0 == 0);
+        REQUIRE(src_x1 == 12);
+        REQUIRE(src_y1 == 15);
+        REQUIRE(dst_x0 == 0);
+        REQUIRE(dst_y0 == 0);
+        REQUIRE(dst_x1 == 12);
+        REQUIRE(dst_y1 == 15);
+        REQUIRE(mask == (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+        REQUIRE(filter == GL_NEAREST);
+    };
+    multisampled.resolve(resolved, blit_mask_t::color | blit_mask_t::depth);
+    REQUIRE(calls_blit == 1);
+
+    // Samples can not be scaled and have to be resolved before they are read.
+    REQUIRE_THROWS(multisampled.blit_to(resolved, 0, 0, 12, 15, 0, 0, 6, 7));
+    REQUIRE_THROWS(multisampled.blit_to(resolved, 0, 0, 12, 15, 0, 0, 12, 15, blit_mask_t::depth, filter_mode_t::linear));
+    REQUIRE_THROWS(multisampled.resolve(framebuffer_t { 6, 15 }));
+    REQUIRE_THROWS(multisampled.pixel_read<glm::vec3>(0, 0));
+    REQUIRE_THROWS(multisample_texture_t { 12, 15, 0 });
+    REQUIRE(calls_blit == 1);
+}
+
+TEST_CASE("framebuffer attachments need the same number of samples", "[core][unit]") {
+    context.enable_throw();
+
+    GLuint next_id = 60;
+    auto calls_attach = 0;
+    context.glCreateFramebuffers = [&next_id](GLsizei, GLuint* buffers) { *buffers = ++next_id; };
+    context.glDeleteFramebuffers = [](auto...){};
+    context.glCreateTextures = [&next_id](GLenum, GLsizei, GLuint* textures) { *textures = ++next_id; };
+    context.glDeleteTextures = [](auto...){};
+    context.glTextureStorage2DMultisample = [](auto...){};
+    context.glCreateRenderbuffers = [&next_id](GLsizei, GLuint* buffers) { *buffers = ++next_id; };
+    context.glDeleteRenderbuffers = [](auto...){};
+    context.glNamedRenderbufferStorageMultisample = [](auto...){};
+    context.glNamedFramebufferTexture = [&calls_attach](auto...) { ++calls_attach; };
+    context.glNamedFramebufferRenderbuffer = [&calls_attach](auto...) { ++calls_attach; };
+
+    const multisample_texture_t color { 12, 15, 4 };
+    const renderbuffer_t single_depth { 12, 15, image_format_t::d_24i, 0 };
+    const renderbuffer_t depth { 12, 15, image_format_t::d_24i, 4 };
+    framebuffer_t framebuffer { 12, 15 };
+    framebuffer.attach(color, attachment_t::color);
+    REQUIRE_THROWS(framebuffer.attach(single_depth, attachment_t::depth));
+    REQUIRE(calls_attach == 1);
+    REQUIRE(framebuffer.samples() == 4);
+
+    framebuffer.attach(depth, attachment_t::depth);
+    REQUIRE(calls_attach == 2);
+    // Replacing an attachment only compares against the others.
+    REQUIRE_THROWS(framebuffer.attach(single_depth, attachment_t::depth_stencil));
+    framebuffer.attach(depth, attachment_t::depth_stencil);
+    REQUIRE(calls_attach == 3);
+}
+
+TEST_CASE("framebuffer blit scales into the target", "[core][unit]") {
+    context.enable_throw();
+
+    auto calls_blit = 0;
+    context.glCreateFramebuffers = [](GLsizei, GLuint* buffers) { *buffers = 42; };
+    context.glDeleteFramebuffers = [](auto...){};
+    context.glBlitNamedFramebuffer = [&calls_blit](
+        GLuint, GLuint,
+        GLint, GLint, GLint src_x1, GLint src_y1,
+        GLint, GLint, GLint dst_x1, GLint dst_y1,
+        GLbitfield mask, GLenum filter
+    ) {
+        ++calls_blit;
+        REQUIRE(src_x1 == 12);
+        REQUIRE(src_y1 == 15);
+        REQUIRE(dst_x1 == 24);
+        REQUIRE(dst_y1 == 30);
+        REQUIRE(mask == GL_COLOR_BUFFER_BIT);
+        REQUIRE(filter == GL_LINEAR);
+    };
+
+    const framebuffer_t source { 12, 15 };
+    const framebuffer_t target { 24, 30 };
+    source.blit_to(target);
+    REQUIRE(calls_blit == 1);
+    REQUIRE_THROWS(source.blit_to(target, 0, 0, 12, 15, 20, 0, 12, 15));
+}
+
 /* 
  * There are no render tests for framebuffer_t since they are the key component in
  * the test context and testing them against itself would be pointless.
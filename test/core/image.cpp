@@ -398,4 +398,136 @@ TEST_CASE("image<vec3> update subimage", "[core][unit]") {
         REQUIRE(image == reference);
     }
 
-}
\ No newline at end of file
+}
+
+TEST_CASE("image mip chain dimensions", "[core][unit]") {
+    const glpp::core::object::image_t<float> image { 5, 3, 1.0f };
+    const auto chain = image.mip_chain();
+
+    REQUIRE(glpp::core::object::mip_level_count(5, 3) == 3);
+    REQUIRE(chain.size() == 3);
+    REQUIRE(chain[0].width() == 5);
+    REQUIRE(chain[0].height() == 3);
+    REQUIRE(chain[1].width() == 2);
+    REQUIRE(chain[1].height() == 1);
+    REQUIRE(chain[2].width() == 1);
+    REQUIRE(chain[2].height() == 1);
+    REQUIRE(image.mip_chain(glpp::core::object::mip_filter_t::box, glpp::core::object::color_space_t::linear, 2).size() == 2);
+}
+
+TEST_CASE("image downsample filters", "[core][unit]") {
+    using namespace glpp::core::object;
+    using ubyte = unsigned char;
+
+    SECTION("box filter averages in linear space") {
+        const image_t<ubyte> image { 2, 2, { 0, 255, 255, 0 } };
+        const auto result = image.downsample();
+        REQUIRE(result.width() == 1);
+        REQUIRE(result.height() == 1);
+        REQUIRE(result.get(0, 0) == 128);
+    }
+
+    SECTION("box filter is gamma correct for srgb") {
+        const image_t<ubyte> image { 2, 1, { 0, 255 } };
+        const auto result = image.downsample(mip_filter_t::box, color_space_t::srgb);
+        REQUIRE(result.get(0, 0) == 188);
+    }
+
+    SECTION("srgb keeps alpha linear") {
+        using ubyte2 = glm::vec<2, ubyte>;
+        const image_t<ubyte2> image { 2, 1, { ubyte2(0, 0), ubyte2(255, 255) } };
+        const auto result = image.downsample(mip_filter_t::box, color_space_t::srgb);
+        REQUIRE(result.get(0, 0) == ubyte2(188, 128));
+    }
+
+    SECTION("kaiser filter preserves constant images") {
+        const image_t<glm::vec3> image { 9, 7, glm::vec3(0.25f, 0.5f, 0.75f) };
+        for(const auto& level : image.mip_chain(mip_filter_t::kaiser)) {
+            REQUIRE((level == image_t<glm::vec3>(level.width(), level.height(), glm::vec3(0.25f, 0.5f, 0.75f))).epsilon(0.001f));
+        }
+    }
+
+    SECTION("large images produce the same result") {
+        image_t<float> image { 512, 512 };
+        for(auto y = 0u; y < image.height(); ++y) {
+            for(auto x = 0u; x < image.width(); ++x) {
+                image.get(x, y) = (x+y)%2;
+            }
+        }
+        const auto result = image.downsample();
+        REQUIRE((result == image_t<float>(256, 256, 0.5f)).epsilon(0.001f));
+    }
+}
+
+TEST_CASE("image resize filters", "[core][unit]") {
+    using namespace glpp::core::object;
+
+    SECTION("all filters preserve constant images") {
+        const image_t<glm::vec3> image { 9, 7, glm::vec3(0.25f, 0.5f, 0.75f) };
+        for(const auto filter : { mip_filter_t::box, mip_filter_t::kaiser, mip_filter_t::bilinear, mip_filter_t::bicubic, mip_filter_t::lanczos }) {
+            for(const auto& [width, height] : { std::pair<size_t, size_t>{ 4, 3 }, { 20, 13 }, { 1, 1 }, { 9, 30 } }) {
+                const auto result = image.resize(width, height, filter);
+                REQUIRE((result == image_t<glm::vec3>(width, height, glm::vec3(0.25f, 0.5f, 0.75f))).epsilon(0.001f));
+            }
+        }
+    }
+
+    SECTION("bilinear interpolates between pixel centers") {
+        const image_t<float> image { 2, 1, { 0.0f, 1.0f } };
+        const auto result = image.resize(4, 1, mip_filter_t::bilinear);
+        REQUIRE((result == image_t<float>(4, 1, { 0.0f, 0.25f, 0.75f, 1.0f })).epsilon(0.001f));
+    }
+
+    SECTION("bicubic and lanczos keep edges sharper than bilinear") {
+        image_t<float> image { 8, 1 };
+        for(auto x = 4u; x < 8; ++x) {
+            image.get(x, 0) = 1.0f;
+        }
+        const auto bilinear = image.resize(32, 1, mip_filter_t::bilinear);
+        for(const auto filter : { mip_filter_t::bicubic, mip_filter_t::lanczos }) {
+            const auto result = image.resize(32, 1, filter);
+            REQUIRE(result.get(14, 0) < bilinear.get(14, 0));
+            REQUIRE(result.get(17, 0) > bilinear.get(17, 0));
+        }
+    }
+
+    SECTION("reduction matches the box filtered mip level") {
+        image_t<float> image { 64, 48 };
+        for(auto y = 0u; y < image.height(); ++y) {
+            for(auto x = 0u; x < image.width(); ++x) {
+                image.get(x, y) = static_cast<float>((x*7+y*3)%11);
+            }
+        }
+        REQUIRE(image.resize(32, 24, mip_filter_t::box) == image.downsample());
+    }
+
+    SECTION("thumbnails keep the aspect ratio") {
+        const image_t<glm::u8vec4> image { 640, 480, glm::u8vec4(10, 20, 30, 255) };
+        const auto thumbnail = image.thumbnail(64);
+        REQUIRE(thumbnail.width() == 64);
+        REQUIRE(thumbnail.height() == 48);
+        REQUIRE(thumbnail.get(10, 10) == glm::u8vec4(10, 20, 30, 255));
+
+        const auto tall = image_t<float>(3, 300).thumbnail(100, mip_filter_t::bicubic);
+        REQUIRE(tall.width() == 1);
+        REQUIRE(tall.height() == 100);
+        REQUIRE(image.thumbnail(1000) == image);
+        REQUIRE_THROWS(image.thumbnail(0));
+        REQUIRE_THROWS(image.resize(0, 10, mip_filter_t::lanczos));
+    }
+
+    SECTION("large images are resampled on multiple threads") {
+        image_t<float> image { 1024, 1024 };
+        for(auto y = 0u; y < image.height(); ++y) {
+            for(auto x = 0u; x < image.width(); ++x) {
+                image.get(x, y) = static_cast<float>(x+y)/2046.0f;
+            }
+        }
+        const auto result = image.resize(256, 512, mip_filter_t::lanczos);
+        for(auto y = 8u; y < result.height()-8; y += 7) {
+            for(auto x = 8u; x < result.width()-8; x += 5) {
+                REQUIRE(result.get(x, y) == Catch::Approx((x*4.0f+1.5f+y*2.0f+0.5f)/2046.0f).margin(0.0001f));
+            }
+        }
+    }
+}
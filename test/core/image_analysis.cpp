@@ -0,0 +1,126 @@
+#include <catch2/catch_all.hpp>
+#include <glpp/core/object/image_analysis.hpp>
+#include <glpp/core/object/image_conversion.hpp>
+#include <cmath>
+#include <random>
+
+using namespace glpp::core::object;
+
+namespace {
+
+using rgb_t = glm::vec<3, std::uint8_t>;
+
+image_t<rgb_t> gradient(size_t width, size_t height) {
+    image_t<rgb_t> image { width, height };
+    for(size_t y = 0; y < height; ++y) {
+        for(size_t x = 0; x < width; ++x) {
+            image.get(x, y) = rgb_t(x*255/width, y*255/height, (x*y)%251);
+        }
+    }
+    return image;
+}
+
+image_t<rgb_t> with_noise(const image_t<rgb_t>& image, int amplitude) {
+    std::mt19937 random { 7 };
+    std::uniform_int_distribution<int> distribution { -amplitude, amplitude };
+    auto result = image;
+    for(auto& pixel : result) {
+        for(int c = 0; c < 3; ++c) {
+            pixel[c] = static_cast<std::uint8_t>(std::clamp(pixel[c]+distribution(random), 0, 255));
+        }
+    }
+    return result;
+}
+
+}
+
+TEST_CASE("image comparison measures the difference", "[core][unit]") {
+    const auto reference = gradient(333, 97);
+    const auto identical = compare(reference, reference);
+    REQUIRE(identical.identical());
+    REQUIRE(identical.max_error == 0.0);
+    REQUIRE(std::isinf(identical.psnr));
+    REQUIRE(ssim(reference, reference) == Catch::Approx(1.0));
+
+    auto changed = reference;
+    changed.get(5, 7) = rgb_t(0);
+    changed.get(300, 90).y -= 51;
+    const auto difference = compare(reference, changed);
+    REQUIRE(difference.different_pixels == 2);
+    REQUIRE(difference.max_error == Catch::Approx(51/255.0));
+
+    const auto noisy = with_noise(reference, 8);
+    const auto very_noisy = with_noise(reference, 64);
+    const auto small = compare(reference, noisy);
+    const auto large = compare(reference, very_noisy);
+    REQUIRE(small.psnr > large.psnr);
+    REQUIRE(small.mean_error < large.mean_error);
+    REQUIRE(small.mean_squared_error == Catch::Approx(std::pow(10.0, -small.psnr/10.0)));
+    REQUIRE(ssim(reference, noisy) > ssim(reference, very_noisy));
+    REQUIRE(ssim(reference, noisy) < 1.0);
+
+    // Float images give the same results on normalized channels.
+    const image_t<glm::vec3> reference_float { reference };
+    const image_t<glm::vec3> noisy_float { noisy };
+    const auto float_difference = compare(reference_float, noisy_float);
+    REQUIRE(float_difference.mean_squared_error == Catch::Approx(small.mean_squared_error).epsilon(0.0001));
+    REQUIRE(float_difference.different_pixels == small.different_pixels);
+    REQUIRE(ssim(reference_float, noisy_float) == Catch::Approx(ssim(reference, noisy)).epsilon(0.0001));
+
+    // Other channel types are compared as floats.
+    const image_t<glm::vec<3, std::uint16_t>> wide { reference };
+    REQUIRE(compare(wide, wide).identical());
+
+    REQUIRE_THROWS(compare(reference, gradient(333, 96)));
+    // Smaller than one window.
+    REQUIRE(ssim(gradient(5, 3), gradient(5, 3)) == Catch::Approx(1.0));
+}
+
+TEST_CASE("image analysis kernels match on all instruction sets", "[core][unit]") {
+    const auto reference = gradient(1021, 77);
+    const auto noisy = with_noise(reference, 20);
+    const auto best = conversion::simd_level();
+    conversion::set_simd_level(simd_level_t::scalar);
+    const auto expected = compare(reference, noisy);
+    const auto expected_difference = absolute_difference(reference, noisy);
+    for(const auto level : { simd_level_t::sse2, simd_level_t::avx2, simd_level_t::neon }) {
+        if(!conversion::simd_supported(level)) continue;
+        conversion::set_simd_level(level);
+        const auto result = compare(reference, noisy);
+        REQUIRE(result.mean_squared_error == expected.mean_squared_error);
+        REQUIRE(result.mean_error == expected.mean_error);
+        REQUIRE(result.max_error == expected.max_error);
+        REQUIRE(result.different_pixels == expected.different_pixels);
+        REQUIRE(absolute_difference(reference, noisy) == expected_difference);
+    }
+    conversion::set_simd_level(best);
+
+    const auto& pixel = expected_difference.get(17, 3);
+    const auto& lhs = reference.get(17, 3);
+    const auto& rhs = noisy.get(17, 3);
+    REQUIRE(pixel.x == std::abs(lhs.x-rhs.x));
+    REQUIRE(pixel.z == std::abs(lhs.z-rhs.z));
+}
+
+TEST_CASE("image histograms and flips", "[core][unit]") {
+    const auto image = gradient(256, 4);
+    const auto bins = histogram(image);
+    REQUIRE(bins.size() == 3);
+    REQUIRE(bins[0][0] == 8);
+    REQUIRE(bins[0][254] == 4);
+    REQUIRE(bins[0][255] == 0);
+    REQUIRE(bins[1][0] == 256);
+    REQUIRE(bins[1][63] == 256);
+    REQUIRE(bins[1][64] == 0);
+
+    auto flipped = image;
+    flip_vertical(flipped);
+    REQUIRE(flipped.get(9, 0) == image.get(9, 3));
+    REQUIRE(flipped.get(9, 1) == image.get(9, 2));
+    flip_vertical(flipped);
+    REQUIRE(flipped == image);
+
+    image_t<float> odd { 1, 3, { 1.0f, 2.0f, 3.0f } };
+    flip_vertical(odd);
+    REQUIRE(odd == image_t<float>(1, 3, { 3.0f, 2.0f, 1.0f }));
+}
@@ -0,0 +1,283 @@
+#include <catch2/catch_all.hpp>
+#include <glpp/core/object/image.hpp>
+#include <glpp/core/object/image_conversion.hpp>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace glpp::core::object;
+
+namespace {
+
+const std::vector<simd_level_t> all_levels { simd_level_t::scalar, simd_level_t::sse2, simd_level_t::avx2, simd_level_t::neon };
+
+// Runs functor with every instruction set of the CPU and compares the results with the scalar kernels.
+template <class Functor>
+void require_same_on_all_levels(Functor&& functor) {
+    const auto best = conversion::simd_level();
+    conversion::set_simd_level(simd_level_t::scalar);
+    const auto reference = functor();
+    for(const auto level : all_levels) {
+        if(!conversion::simd_supported(level)) {
+            REQUIRE_THROWS(conversion::set_simd_level(level));
+            continue;
+        }
+        conversion::set_simd_level(level);
+        REQUIRE(functor() == reference);
+    }
+    conversion::set_simd_level(best);
+}
+
+std::vector<std::uint8_t> bytes(size_t count) {
+    std::vector<std::uint8_t> result(count);
+    for(size_t i = 0; i < count; ++i) {
+        result[i] = static_cast<std::uint8_t>(i*7+i/256);
+    }
+    return result;
+}
+
+std::vector<float> floats(size_t count) {
+    std::mt19937 random { 42 };
+    std::uniform_real_distribution<float> distribution { -0.25f, 1.25f };
+    std::vector<float> result(count);
+    for(auto& v : result) {
+        v = distribution(random);
+    }
+    // Halfway cases of the rounding.
+    for(size_t i = 0; i < 256; ++i) {
+        result[i] = (static_cast<float>(i)+0.5f)/255.0f;
+    }
+    result[256] = std::numeric_limits<float>::quiet_NaN();
+    result[257] = std::numeric_limits<float>::infinity();
+    return result;
+}
+
+}
+
+TEST_CASE("conversion between normalized channel types", "[core][unit]") {
+    // Odd sizes exercise the scalar tails of the vector kernels.
+    const auto u8 = bytes(1027);
+
+    std::vector<float> f(u8.size());
+    conversion::convert(std::span<const std::uint8_t>(u8), std::span(f));
+    for(size_t i = 0; i < u8.size(); ++i) {
+        REQUIRE(f[i] == static_cast<float>(u8[i])/255.0f);
+    }
+
+    std::vector<std::uint8_t> back(u8.size());
+    conversion::convert(std::span<const float>(f), std::span(back));
+    REQUIRE(back == u8);
+
+    std::vector<std::uint16_t> u16(u8.size());
+    conversion::convert(std::span<const std::uint8_t>(u8), std::span(u16));
+    REQUIRE(u16[1] == 7*257);
+
+    std::vector<std::uint16_t> all_u16(65536);
+    std::vector<std::uint8_t> narrowed(all_u16.size());
+    for(size_t i = 0; i < all_u16.size(); ++i) {
+        all_u16[i] = static_cast<std::uint16_t>(i);
+    }
+    conversion::convert(std::span<const std::uint16_t>(all_u16), std::span(narrowed));
+    for(size_t i = 0; i < all_u16.size(); ++i) {
+        REQUIRE(narrowed[i] == static_cast<std::uint8_t>(std::lround(static_cast<double>(i)/257.0)));
+    }
+
+    const std::vector<float> special { -1.0f, 0.0f, 0.5f, 0.3f, 1.0f, 2.0f, std::numeric_limits<float>::quiet_NaN() };
+    std::vector<std::uint8_t> rounded(special.size());
+    conversion::convert(std::span<const float>(special), std::span(rounded));
+    REQUIRE(rounded == std::vector<std::uint8_t>{ 0, 0, 128, 77, 255, 255, 0 });
+
+    REQUIRE_THROWS(conversion::convert(std::span<const std::uint8_t>(u8), std::span(f).subspan(1)));
+}
+
+TEST_CASE("conversion kernels match on all instruction sets", "[core][unit]") {
+    const auto u8 = bytes(4099);
+    const auto f = floats(4099);
+
+    require_same_on_all_levels([&] {
+        std::vector<float> result(u8.size());
+        conversion::convert(std::span<const std::uint8_t>(u8), std::span(result));
+        return result;
+    });
+    require_same_on_all_levels([&] {
+        std::vector<std::uint8_t> result(f.size());
+        conversion::convert(std::span<const float>(f), std::span(result));
+        return result;
+    });
+    require_same_on_all_levels([&] {
+        std::vector<std::uint16_t> result(u8.size());
+        conversion::convert(std::span<const std::uint8_t>(u8), std::span(result));
+        std::vector<std::uint8_t> back(result.size());
+        conversion::convert(std::span<const std::uint16_t>(result), std::span(back));
+        return std::make_pair(result, back);
+    });
+    require_same_on_all_levels([&] {
+        std::vector<std::uint8_t> rgba(u8.size()/3*4);
+        conversion::rgb_to_rgba(std::span(u8).first(rgba.size()/4*3), std::span(rgba), 200);
+        std::vector<std::uint8_t> rgb(u8.size()/3*3);
+        conversion::rgba_to_rgb(std::span<const std::uint8_t>(rgba), std::span(rgb));
+        return std::make_pair(rgba, rgb);
+    });
+    require_same_on_all_levels([&] {
+        std::vector<std::uint8_t> result(u8.size()/4*4);
+        conversion::swizzle(std::span(u8).first(result.size()), std::span(result), { 2, 1, 0, 3 });
+        return result;
+    });
+    require_same_on_all_levels([&] {
+        std::vector<std::uint8_t> result(u8.begin(), u8.begin()+u8.size()/4*4);
+        conversion::premultiply_alpha(std::span(result));
+        return result;
+    });
+}
+
+TEST_CASE("resampling kernels match on all instruction sets", "[core][unit]") {
+    const auto f = floats(4099);
+    require_same_on_all_levels([&] {
+        std::vector<float> result(f.begin(), f.end());
+        conversion::accumulate(std::span(f), std::span(result), 0.37f);
+        return std::vector<std::uint32_t>(reinterpret_cast<const std::uint32_t*>(result.data()), reinterpret_cast<const std::uint32_t*>(result.data()+result.size()));
+    });
+
+    // Odd sizes exercise the scalar tails of the vertical pass, NaN and infinity are skipped.
+    image_t<glm::vec4> rgba { 67, 45 };
+    image_t<glm::vec3> rgb { 67, 45 };
+    const auto channels = floats(258+rgba.width()*rgba.height()*4);
+    for(size_t y = 0; y < rgba.height(); ++y) {
+        for(size_t x = 0; x < rgba.width(); ++x) {
+            const auto i = 258+(y*rgba.width()+x)*4;
+            rgba.get(x, y) = glm::vec4(channels[i], channels[i+1], channels[i+2], channels[i+3]);
+            rgb.get(x, y) = glm::vec3(channels[i], channels[i+1], channels[i+2]);
+        }
+    }
+    for(const auto filter : { mip_filter_t::box, mip_filter_t::lanczos }) {
+        require_same_on_all_levels([&] {
+            const auto smaller = rgba.resize(29, 13, filter);
+            const auto larger = rgba.resize(101, 77, filter);
+            return std::make_pair(std::vector(smaller.begin(), smaller.end()), std::vector(larger.begin(), larger.end()));
+        });
+        require_same_on_all_levels([&] {
+            const auto smaller = rgb.resize(29, 13, filter);
+            return std::vector(smaller.begin(), smaller.end());
+        });
+    }
+
+    std::vector<float> pixels(8);
+    const std::vector<size_t> offset { 0, 2 };
+    const std::vector<size_t> index { 0, 1 };
+    const std::vector<float> weight { 0.5f, 0.5f };
+    REQUIRE_THROWS(conversion::filter_rgba(std::span(f).first(8), std::span(pixels), offset, index, weight));
+    conversion::filter_rgba(std::span(f).first(8), std::span(pixels).first(4), offset, index, weight);
+    REQUIRE(pixels[0] == 0.5f*f[0]+0.5f*f[4]);
+}
+
+TEST_CASE("conversion of half floats", "[core][unit]") {
+    const std::vector<float> values {
+        0.0f, -0.0f, 1.0f, -2.5f, 65504.0f, 65520.0f, 65519.0f,
+        std::ldexp(1.0f, -24), std::ldexp(1.0f, -25), std::ldexp(1.5f, -25), std::ldexp(1.0f, -14),
+        1.0f+std::ldexp(1.0f, -11), 1.0f+std::ldexp(3.0f, -11),
+        std::numeric_limits<float>::infinity(), 1e-30f
+    };
+    const std::vector<std::uint16_t> expected {
+        0x0000, 0x8000, 0x3c00, 0xc100, 0x7bff, 0x7c00, 0x7bff,
+        0x0001, 0x0000, 0x0001, 0x0400,
+        0x3c00, 0x3c02,
+        0x7c00, 0x0000
+    };
+    std::vector<std::uint16_t> half(values.size());
+    conversion::float_to_half(std::span<const float>(values), std::span(half));
+    REQUIRE(half == expected);
+
+    // Every half converts to a float and back without loss.
+    std::vector<std::uint16_t> all(65536);
+    for(size_t i = 0; i < all.size(); ++i) {
+        all[i] = static_cast<std::uint16_t>(i);
+    }
+    require_same_on_all_levels([&] {
+        std::vector<float> widened(all.size());
+        conversion::half_to_float(std::span<const std::uint16_t>(all), std::span(widened));
+        std::vector<std::uint16_t> narrowed(all.size());
+        conversion::float_to_half(std::span<const float>(widened), std::span(narrowed));
+        for(size_t i = 0; i < all.size(); ++i) {
+            if(std::isnan(widened[i])) {
+                REQUIRE((narrowed[i] & 0x7c00) == 0x7c00);
+                REQUIRE((narrowed[i] & 0x3ff) != 0);
+                narrowed[i] = 0x7e00;
+                widened[i] = 0.0f;
+            } else {
+                REQUIRE(narrowed[i] == all[i]);
+            }
+        }
+        std::vector<std::uint32_t> bits(widened.size());
+        std::transform(widened.begin(), widened.end(), bits.begin(), [](float v) { return std::bit_cast<std::uint32_t>(v); });
+        return std::make_pair(bits, narrowed);
+    });
+
+    // Rounding of floats between two halfs matches on all instruction sets.
+    std::mt19937 random { 7 };
+    std::uniform_int_distribution<std::uint32_t> distribution { 0x30000000, 0x47ffffff };
+    std::vector<float> random_floats(4001);
+    for(auto& v : random_floats) {
+        v = std::bit_cast<float>(distribution(random));
+    }
+    require_same_on_all_levels([&] {
+        std::vector<std::uint16_t> result(random_floats.size());
+        conversion::float_to_half(std::span<const float>(random_floats), std::span(result));
+        return result;
+    });
+}
+
+TEST_CASE("conversion of color spaces and alpha", "[core][unit]") {
+    std::vector<std::uint8_t> all(256);
+    for(size_t i = 0; i < all.size(); ++i) {
+        all[i] = static_cast<std::uint8_t>(i);
+    }
+    std::vector<float> linear(all.size());
+    conversion::srgb_to_linear(std::span<const std::uint8_t>(all), std::span(linear), 1);
+    REQUIRE(linear[0] == 0.0f);
+    REQUIRE(linear[255] == Catch::Approx(1.0f));
+    REQUIRE(linear[188] == Catch::Approx(0.5029f).margin(0.001f));
+
+    std::vector<std::uint8_t> srgb(all.size());
+    conversion::linear_to_srgb(std::span<const float>(linear), std::span(srgb), 1);
+    REQUIRE(srgb == all);
+
+    // Alpha stays linear.
+    const std::vector<std::uint8_t> gray_alpha { 128, 128 };
+    std::vector<float> gray_alpha_linear(2);
+    conversion::srgb_to_linear(std::span<const std::uint8_t>(gray_alpha), std::span(gray_alpha_linear), 2);
+    REQUIRE(gray_alpha_linear[0] == Catch::Approx(0.2158f).margin(0.001f));
+    REQUIRE(gray_alpha_linear[1] == 128.0f/255.0f);
+
+    std::vector<std::uint8_t> pixels { 255, 128, 0, 128, 10, 20, 30, 0, 1, 2, 3, 255 };
+    conversion::premultiply_alpha(std::span(pixels));
+    REQUIRE(pixels == std::vector<std::uint8_t>{ 128, 64, 0, 128, 0, 0, 0, 0, 1, 2, 3, 255 });
+    conversion::unpremultiply_alpha(std::span(pixels));
+    REQUIRE(pixels == std::vector<std::uint8_t>{ 255, 128, 0, 128, 0, 0, 0, 0, 1, 2, 3, 255 });
+
+    std::vector<std::uint8_t> bgra(4);
+    conversion::swizzle(std::span(pixels).first(4), std::span(bgra), { 2, 1, 0, 3 });
+    REQUIRE(bgra == std::vector<std::uint8_t>{ 0, 128, 255, 128 });
+    REQUIRE_THROWS(conversion::swizzle(std::span(pixels).first(4), std::span(bgra), { 4, 1, 0, 3 }));
+    REQUIRE_THROWS(conversion::premultiply_alpha(std::span(pixels).first(5)));
+}
+
+TEST_CASE("image conversion uses the conversion kernels", "[core][unit]") {
+    image_t<glm::u8vec4> image { 1024, 512 };
+    for(size_t y = 0; y < image.height(); ++y) {
+        for(size_t x = 0; x < image.width(); ++x) {
+            image.get(x, y) = glm::u8vec4(x, y, x+y, 255);
+        }
+    }
+
+    const image_t<glm::vec4> converted { image };
+    REQUIRE(converted.get(3, 5) == glm::vec4(3.0f/255.0f, 5.0f/255.0f, 8.0f/255.0f, 1.0f));
+
+    const image_t<glm::u8vec4> back { converted };
+    REQUIRE(back == image);
+
+    const image_t<glm::vec<4, std::uint16_t>> wide { image };
+    REQUIRE(wide.get(1, 2) == glm::vec<4, std::uint16_t>(257, 514, 771, 65535));
+    REQUIRE(image_t<glm::u8vec4>(wide) == image);
+}
@@ -0,0 +1,110 @@
+#include <catch2/catch_all.hpp>
+#include <glpp/core/object/image_pipeline.hpp>
+#include <glpp/gl/context.hpp>
+#include <glpp/testing/context.hpp>
+#include <glpp/testing/mock_gl.hpp>
+
+using namespace glpp::core::object;
+using namespace glpp::gl;
+
+namespace {
+
+struct readback_t {
+    GLuint buffer;
+    GLint level;
+    GLsizei size;
+    std::intptr_t offset;
+};
+
+// Records the compute dispatches and texture readbacks of a processor.
+struct recorded_compute_t {
+    std::vector<glm::uvec2> dispatches;
+    std::vector<readback_t> readbacks;
+    int mipmaps_generated = 0;
+
+    explicit recorded_compute_t(glpp::test::mock_gl_t& mock) {
+        context.glGetIntegerv = [](GLenum, GLint* value) { *value = 16; };
+        context.glDispatchCompute = [this](GLuint x, GLuint y, GLuint z) {
+            REQUIRE(z == 1);
+            dispatches.emplace_back(x, y);
+        };
+        context.glGetTextureImage = [this, &mock](GLuint, GLint level, GLenum format, GLenum type, GLsizei size, void* pixels) {
+            REQUIRE(format == GL_RGBA);
+            REQUIRE(type == GL_UNSIGNED_BYTE);
+            readbacks.push_back({ mock.bound(GL_PIXEL_PACK_BUFFER), level, size, reinterpret_cast<std::intptr_t>(pixels) });
+        };
+        context.glGenerateTextureMipmap = [this](GLuint) { ++mipmaps_generated; };
+    }
+};
+
+}
+
+TEST_CASE("image pipeline validates its operations", "[core][unit]") {
+    image_pipeline_t pipeline;
+    REQUIRE(pipeline.empty());
+    REQUIRE_THROWS(pipeline.resample(0, 4));
+    REQUIRE_THROWS(pipeline.blur(0.0f));
+    pipeline.blur(1.5f).convert(color_conversion_t::grayscale).generate_mipmaps();
+    REQUIRE(pipeline.size() == 3);
+    REQUIRE_THROWS(pipeline.sharpen(0.5f));
+}
+
+TEST_CASE("gpu image processor dispatches passes and reuses textures", "[core][unit]") {
+    glpp::test::mock_gl_t gl;
+    recorded_compute_t mock { gl };
+    gpu_image_processor_t processor;
+    const image_t<glm::u8vec4> image { 40, 20, glm::u8vec4(1, 2, 3, 4) };
+
+    image_pipeline_t pipeline;
+    pipeline.resample(20, 10, mip_filter_t::lanczos).blur(1.0f);
+    const auto first = processor.submit(image, pipeline);
+
+    // Two resample passes, two blur passes with 16x16 work groups.
+    REQUIRE(mock.dispatches.size() == 4);
+    REQUIRE(mock.dispatches[0] == glm::uvec2(2, 2));
+    REQUIRE(mock.dispatches[1] == glm::uvec2(2, 1));
+    REQUIRE(mock.readbacks.size() == 1);
+    REQUIRE(mock.readbacks[0].offset == 0);
+    REQUIRE(mock.readbacks[0].size == 20*10*4);
+    REQUIRE(mock.readbacks[0].buffer != 0);
+    REQUIRE(gl.bound(GL_PIXEL_PACK_BUFFER) == 0);
+
+    const auto textures = gl.texture_names;
+    const auto pooled = processor.pooled_textures();
+    const auto second = processor.submit(image, pipeline);
+    REQUIRE(gl.texture_names == textures);
+    REQUIRE(processor.pooled_textures() == pooled);
+
+    auto& staging = gl.storage(mock.readbacks.back().buffer);
+    std::fill(staging.begin(), staging.end(), std::byte{ 9 });
+    REQUIRE(second.ready());
+    const auto result = second.get();
+    REQUIRE(result.width() == 20);
+    REQUIRE(result.height() == 10);
+    REQUIRE(result.get(19, 9) == glm::u8vec4(9, 9, 9, 9));
+
+    processor.clear_pool();
+    REQUIRE(processor.pooled_textures() == 0);
+}
+
+TEST_CASE("gpu image processor reads back the mip chain", "[core][unit]") {
+    glpp::test::mock_gl_t gl;
+    recorded_compute_t mock { gl };
+    gpu_image_processor_t processor;
+    const image_t<glm::u8vec4> image { 8, 4, glm::u8vec4(0) };
+
+    image_pipeline_t pipeline;
+    pipeline.convert(color_conversion_t::srgb_to_linear).generate_mipmaps();
+    const auto job = processor.submit(image, pipeline);
+    REQUIRE(mock.mipmaps_generated == 1);
+    REQUIRE(mock.readbacks.size() == 4);
+    REQUIRE(mock.readbacks[1].offset == 8*4*4);
+    REQUIRE(mock.readbacks[3].offset == (32+8+2)*4);
+
+    const auto chain = job.mip_chain();
+    REQUIRE(chain.size() == 4);
+    REQUIRE(chain[1].width() == 4);
+    REQUIRE(chain[1].height() == 2);
+    REQUIRE(chain[3].width() == 1);
+    REQUIRE(chain[3].height() == 1);
+}
@@ -0,0 +1,159 @@
+#include <catch2/catch_all.hpp>
+#include <glpp/core/object/texture.hpp>
+#include <glpp/core/object/texture_upload_queue.hpp>
+#include <glpp/gl/context.hpp>
+#include <glpp/testing/context.hpp>
+#include <glpp/testing/mock_gl.hpp>
+
+using namespace glpp::core::object;
+using namespace glpp::gl;
+
+namespace {
+
+struct upload_t {
+    GLint xoffset;
+    GLint yoffset;
+    GLsizei width;
+    GLsizei height;
+    const void* pixels;
+    GLint alignment;
+    GLint row_length;
+};
+
+// Records uploads with the unpack parameters at the time of the upload.
+void record_uploads(glpp::test::mock_gl_t& mock, std::vector<upload_t>& uploads) {
+    context.glTextureSubImage2D = [&](GLuint, GLint, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum, GLenum, const void* pixels) {
+        uploads.push_back({ xoffset, yoffset, width, height, pixels, mock.pixel_store[GL_UNPACK_ALIGNMENT], mock.pixel_store[GL_UNPACK_ROW_LENGTH] });
+    };
+}
+
+image_t<glm::u8vec4> numbered(size_t width, size_t height) {
+    image_t<glm::u8vec4> image { width, height };
+    for(size_t y = 0; y < height; ++y) {
+        for(size_t x = 0; x < width; ++x) {
+            image.get(x, y) = glm::u8vec4(x, y, 0, 255);
+        }
+    }
+    return image;
+}
+
+}
+
+TEST_CASE("image views refer to regions of an image", "[core][unit]") {
+    auto image = numbered(16, 8);
+    const auto view = image.view(3, 2, 5, 4);
+    REQUIRE(view.width() == 5);
+    REQUIRE(view.height() == 4);
+    REQUIRE(view.row_stride() == 16*sizeof(glm::u8vec4));
+    REQUIRE(!view.contiguous());
+    REQUIRE(view.get(0, 0) == glm::u8vec4(3, 2, 0, 255));
+    REQUIRE(view.subview(1, 1, 2, 2).get(1, 1) == glm::u8vec4(5, 4, 0, 255));
+    const image_t<glm::u8vec4> copy { view };
+    REQUIRE(copy.width() == 5);
+    REQUIRE(copy.get(4, 3) == glm::u8vec4(7, 5, 0, 255));
+    REQUIRE_THROWS(image.view(12, 0, 5, 1));
+    REQUIRE_THROWS(view.at(5, 0));
+
+    image.view(0, 0, 2, 2).get(1, 1) = glm::u8vec4(9);
+    REQUIRE(image.get(1, 1) == glm::u8vec4(9));
+
+    image_t<glm::u8vec4> target { 4, 4, glm::u8vec4(0) };
+    target.update(2, 1, view);
+    REQUIRE(target.get(2, 1) == glm::u8vec4(3, 2, 0, 255));
+    REQUIRE(target.get(3, 3) == glm::u8vec4(4, 4, 0, 255));
+    REQUIRE(target.get(1, 1) == glm::u8vec4(0));
+
+    // Foreign memory with padded rows.
+    std::vector<std::uint8_t> buffer(4*8, 7);
+    const image_view_t<const glm::vec<3, std::uint8_t>> padded { reinterpret_cast<const glm::vec<3, std::uint8_t>*>(buffer.data()), 2, 4, 8 };
+    REQUIRE(image_t<glm::vec<3, std::uint8_t>>(padded).size() == 8);
+}
+
+TEST_CASE("texture uploads views without copying", "[core][unit]") {
+    glpp::test::mock_gl_t mock;
+    std::vector<upload_t> uploads;
+    record_uploads(mock, uploads);
+    texture_t texture { 64, 64, image_format_t::rgba_8 };
+    const auto image = numbered(256, 128);
+
+    texture.update(image.view(10, 20, 32, 16), 4, 8);
+    REQUIRE(uploads.size() == 1);
+    const auto& upload = uploads.back();
+    REQUIRE(upload.pixels == &image.get(10, 20));
+    REQUIRE(upload.xoffset == 4);
+    REQUIRE(upload.yoffset == 8);
+    REQUIRE(upload.width == 32);
+    REQUIRE(upload.height == 16);
+    REQUIRE(upload.row_length == 256);
+    REQUIRE(upload.alignment == 8);
+
+    // Whole images reset the row length.
+    texture.update(numbered(64, 64));
+    REQUIRE(uploads.back().row_length == 0);
+    REQUIRE(uploads.back().alignment == 8);
+
+    // The old overload uploads the top left region of the image.
+    texture.update(image, 0, 0, 16, 16);
+    REQUIRE(uploads.back().row_length == 256);
+    REQUIRE(uploads.back().pixels == image.data());
+    REQUIRE_THROWS(texture.update(image, 0, 0, 300, 16));
+}
+
+TEST_CASE("texture uploads pick the alignment of the row stride", "[core][unit]") {
+    glpp::test::mock_gl_t mock;
+    std::vector<upload_t> uploads;
+    record_uploads(mock, uploads);
+    texture_t texture { 64, 64, image_format_t::rgb_8 };
+    using rgb_t = glm::vec<3, std::uint8_t>;
+    alignas(8) std::array<std::uint8_t, 256> buffer {};
+    const auto* pixels = reinterpret_cast<const rgb_t*>(buffer.data());
+
+    // Tightly packed rows of 15 bytes.
+    texture.update(image_view_t<const rgb_t>(pixels, 5, 3));
+    REQUIRE(uploads.back().alignment == 1);
+    REQUIRE(uploads.back().row_length == 0);
+
+    // Rows padded to 4 bytes like many decoders produce.
+    texture.update(image_view_t<const rgb_t>(pixels, 5, 3, 16));
+    REQUIRE(uploads.back().alignment == 8);
+    REQUIRE(uploads.back().row_length == 0);
+    texture.update(image_view_t<const rgb_t>(reinterpret_cast<const rgb_t*>(buffer.data()+4), 5, 3, 16));
+    REQUIRE(uploads.back().alignment == 4);
+    REQUIRE(uploads.back().row_length == 0);
+
+    // Strides of whole pixels use the row length.
+    texture.update(image_view_t<const rgb_t>(pixels, 5, 3, 21));
+    REQUIRE(uploads.back().alignment == 1);
+    REQUIRE(uploads.back().row_length == 7);
+
+    // Other strides are uploaded row by row.
+    uploads.clear();
+    texture.update(image_view_t<const rgb_t>(pixels, 5, 3, 19), 1, 2);
+    REQUIRE(uploads.size() == 3);
+    REQUIRE(uploads[2].yoffset == 4);
+    REQUIRE(uploads[2].height == 1);
+    REQUIRE(uploads[2].pixels == buffer.data()+38);
+}
+
+TEST_CASE("texture upload queue stages only the pixels of a view", "[core][unit]") {
+    glpp::test::mock_gl_t mock;
+    std::vector<upload_t> uploads;
+    record_uploads(mock, uploads);
+    std::vector<std::byte> staging(1024);
+    context.glMapNamedBufferRange = [&](auto...) -> void* {
+        return staging.data();
+    };
+    context.glFenceSync = [](GLenum, GLbitfield) { return GLsync{ 1 }; };
+
+    texture_upload_queue_t queue { staging.size() };
+    texture_t texture { 64, 64, image_format_t::rgba_8 };
+    const auto image = numbered(64, 64);
+    queue.enqueue(texture, image.view(8, 4, 2, 3), 0, 1, 1);
+    REQUIRE(queue.process() == 2*3*sizeof(glm::u8vec4));
+
+    const auto* staged = reinterpret_cast<const glm::u8vec4*>(staging.data());
+    REQUIRE(staged[0] == glm::u8vec4(8, 4, 0, 255));
+    REQUIRE(staged[1] == glm::u8vec4(9, 4, 0, 255));
+    REQUIRE(staged[2] == glm::u8vec4(8, 5, 0, 255));
+    REQUIRE(uploads.back().row_length == 0);
+}
@@ -0,0 +1,181 @@
+#include <catch2/catch_all.hpp>
+#include <glpp/core/object/buffer.hpp>
+#include <glpp/core/object/framebuffer.hpp>
+#include <glpp/core/object/texture.hpp>
+#include <glpp/gl/context.hpp>
+#include <glpp/testing/context.hpp>
+#include <glpp/testing/mock_gl.hpp>
+#include <cstring>
+
+using namespace glpp::core::object;
+using namespace glpp::gl;
+
+namespace {
+
+struct pack_t {
+    GLuint buffer;
+    GLint alignment;
+    const void* pixels;
+};
+
+}
+
+TEST_CASE("framebuffer readback queues the copy without waiting", "[core][unit]") {
+    glpp::test::mock_gl_t mock { glpp::test::mock_gl_t::fence_mode_t::on_wait };
+    std::vector<pack_t> packs;
+    GLuint bound_read_framebuffer = 0;
+    context.glBindFramebuffer = [&](GLenum target, GLuint framebuffer) {
+        REQUIRE(target == GL_READ_FRAMEBUFFER);
+        bound_read_framebuffer = framebuffer;
+    };
+    context.glReadPixels = [&](GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void* pixels) {
+        REQUIRE(x == 2);
+        REQUIRE(y == 1);
+        REQUIRE(width == 3);
+        REQUIRE(height == 2);
+        REQUIRE(format == GL_RGBA);
+        REQUIRE(type == GL_UNSIGNED_BYTE);
+        packs.push_back({ mock.bound(GL_PIXEL_PACK_BUFFER), mock.pixel_store[GL_PACK_ALIGNMENT], pixels });
+    };
+
+    const framebuffer_t framebuffer { 8, 4 };
+    const auto readback = framebuffer.async_pixel_read<glm::u8vec4>(2, 1, 3, 2);
+    REQUIRE(bound_read_framebuffer == framebuffer.id());
+    REQUIRE(packs.size() == 1);
+    REQUIRE(packs[0].buffer == mock.buffer_names);
+    REQUIRE(packs[0].alignment == 1);
+    REQUIRE(packs[0].pixels == nullptr);
+    REQUIRE(mock.bound(GL_PIXEL_PACK_BUFFER) == 0);
+    REQUIRE(mock.pixel_store[GL_PACK_ALIGNMENT] == 4);
+    auto& staging = mock.storage(packs[0].buffer);
+    REQUIRE(staging.size() == 3*2*4);
+    REQUIRE(mock.maps == 0);
+
+    REQUIRE_FALSE(readback.ready());
+    for(size_t i = 0; i < staging.size(); ++i) {
+        staging[i] = static_cast<std::byte>(i);
+    }
+    const auto image = readback.get();
+    REQUIRE(readback.ready());
+    REQUIRE(mock.maps == 1);
+    REQUIRE(image.width() == 3);
+    REQUIRE(image.height() == 2);
+    REQUIRE(image.get(1, 1) == glm::u8vec4(16, 17, 18, 19));
+
+    REQUIRE_THROWS(framebuffer.async_pixel_read<glm::u8vec4>(6, 0, 3, 1));
+
+    // The pack alignment of the caller is restored.
+    mock.pixel_store[GL_PACK_ALIGNMENT] = 8;
+    framebuffer.async_pixel_read<glm::u8vec4>(2, 1, 3, 2);
+    REQUIRE(packs.back().alignment == 1);
+    REQUIRE(mock.pixel_store[GL_PACK_ALIGNMENT] == 8);
+}
+
+TEST_CASE("framebuffer depth readback reads single floats", "[core][unit]") {
+    glpp::test::mock_gl_t mock { glpp::test::mock_gl_t::fence_mode_t::on_wait };
+    context.glReadPixels = [&](GLint, GLint, GLsizei width, GLsizei height, GLenum format, GLenum type, void*) {
+        REQUIRE(width == 1);
+        REQUIRE(height == 1);
+        REQUIRE(format == GL_DEPTH_COMPONENT);
+        REQUIRE(type == GL_FLOAT);
+    };
+
+    const framebuffer_t framebuffer { 8, 4 };
+    const auto readback = framebuffer.async_depth_read(7, 3);
+    const float depth = 0.25f;
+    std::memcpy(mock.storage(mock.buffer_names).data(), &depth, sizeof(depth));
+    REQUIRE(readback.get().get(0, 0) == 0.25f);
+}
+
+TEST_CASE("texture readback reads a mip level", "[core][unit]") {
+    glpp::test::mock_gl_t mock { glpp::test::mock_gl_t::fence_mode_t::on_wait };
+    std::vector<pack_t> packs;
+    context.glGetTextureImage = [&](GLuint texture, GLint level, GLenum format, GLenum type, GLsizei size, void* pixels) {
+        REQUIRE(texture == mock.texture_names);
+        REQUIRE(level == 1);
+        REQUIRE(format == GL_RGB);
+        REQUIRE(type == GL_FLOAT);
+        REQUIRE(size == 4*2*sizeof(glm::vec3));
+        packs.push_back({ mock.bound(GL_PIXEL_PACK_BUFFER), mock.pixel_store[GL_PACK_ALIGNMENT], pixels });
+    };
+
+    const texture_t texture { 8, 4, image_format_t::rgb_32f, clamp_mode_t::repeat, filter_mode_t::linear, mipmap_mode_t::linear };
+    const auto readback = texture.async_read<glm::vec3>(1);
+    REQUIRE(packs.size() == 1);
+    REQUIRE(packs[0].buffer == mock.buffer_names);
+    REQUIRE(readback.width() == 4);
+    REQUIRE(readback.height() == 2);
+    REQUIRE_THROWS(texture.async_read<glm::vec3>(texture.levels()));
+}
+
+TEST_CASE("integer textures and framebuffers are read with the integer pixel formats", "[core][unit]") {
+    glpp::test::mock_gl_t mock { glpp::test::mock_gl_t::fence_mode_t::on_wait };
+    std::vector<GLenum> formats;
+    context.glGetTextureImage = [&](GLuint, GLint, GLenum format, GLenum type, GLsizei, void*) {
+        REQUIRE(type == GL_UNSIGNED_INT);
+        formats.push_back(format);
+    };
+    context.glReadPixels = [&](GLint, GLint, GLsizei, GLsizei, GLenum format, GLenum type, void*) {
+        REQUIRE(type == GL_UNSIGNED_BYTE);
+        formats.push_back(format);
+    };
+
+    const texture_t ids { 8, 4, image_format_t::r_32ui };
+    const auto texture_readback = ids.async_read<std::uint32_t>();
+    const texture_t colors { 8, 4, image_format_t::rgba_8ui };
+    framebuffer_t framebuffer { { colors, attachment_t::color } };
+    const auto framebuffer_readback = framebuffer.async_pixel_read<glm::u8vec4>();
+    REQUIRE(formats == std::vector<GLenum>{ GL_RED_INTEGER, GL_RGBA_INTEGER });
+
+    // Normalized color attachments are read with the plain formats again.
+    const texture_t normalized { 8, 4, image_format_t::rgba_8 };
+    framebuffer.attach(normalized, attachment_t::color);
+    const auto normalized_readback = framebuffer.async_pixel_read<glm::u8vec4>();
+    REQUIRE(formats.back() == GL_RGBA);
+}
+
+TEST_CASE("buffer readback copies into a staging buffer", "[core][unit]") {
+    glpp::test::mock_gl_t mock { glpp::test::mock_gl_t::fence_mode_t::on_wait };
+    context.glGetNamedBufferSubData = [](auto...) {
+        FAIL("The readback must not read the buffer synchronously.");
+    };
+
+    const std::array<int, 4> data { 1, 2, 3, 4 };
+    const buffer_t buffer { buffer_target_t::shader_storage_buffer, data.data(), sizeof(data), buffer_usage_t::dynamic_read };
+    const auto readback = buffer.async_read();
+    REQUIRE(readback.size() == sizeof(data));
+    REQUIRE(mock.storage(mock.buffer_names).size() == sizeof(data));
+
+    REQUIRE(readback.wait(std::chrono::milliseconds(1)));
+    REQUIRE(readback.get() == std::vector<int>(data.begin(), data.end()));
+}
+
+TEST_CASE("readbacks reuse the staging buffers of finished reads", "[core][unit]") {
+    glpp::test::mock_gl_t mock { glpp::test::mock_gl_t::fence_mode_t::on_wait };
+    const framebuffer_t framebuffer { 8, 4 };
+
+    auto first = framebuffer.async_pixel_read<glm::u8vec4>();
+    // Polling does not flush, the readback flushes its fence.
+    REQUIRE(mock.flushes == 1);
+    const auto staging = mock.buffer_names;
+    {
+        const auto second = framebuffer.async_pixel_read<glm::u8vec4>(0, 0, 2, 2);
+        REQUIRE(mock.buffer_names == staging+1);
+    }
+
+    // The smaller buffer of the dropped handle is reused, the first one is still read.
+    framebuffer.async_pixel_read<glm::u8vec4>(0, 0, 1, 1);
+    REQUIRE(mock.buffer_names == staging+1);
+    first = framebuffer.async_pixel_read<glm::u8vec4>(0, 0, 2, 2);
+    REQUIRE(mock.buffer_names == staging+1);
+    REQUIRE(first.get().width() == 2);
+
+    // At most max_buffers buffers are kept, reads beyond them use buffers of their own.
+    std::vector<pixel_readback_t<glm::u8vec4>> held;
+    for(size_t i = 0; i < detail::readback_pool_t::max_buffers; ++i) {
+        held.push_back(framebuffer.async_pixel_read<glm::u8vec4>());
+    }
+    REQUIRE(mock.buffers.size() == detail::readback_pool_t::max_buffers+1);
+    held.clear();
+    REQUIRE(mock.buffers.size() == detail::readback_pool_t::max_buffers);
+}
@@ -0,0 +1,69 @@
+#include <catch2/catch_all.hpp>
+#include <glpp/core/object/shader_template.hpp>
+#include <glm/glm.hpp>
+
+using namespace glpp::core::object;
+
+TEST_CASE("shader_template_t parsing", "[core][unit]") {
+
+    SECTION("without placeholders") {
+        const shader_template_t code_template("if(a < b && c > d) {}");
+        REQUIRE(code_template.segments().size() == 1);
+        REQUIRE(code_template.placeholders().empty());
+        REQUIRE(code_template.render({}) == "if(a < b && c > d) {}");
+    }
+
+    SECTION("with placeholders") {
+        const shader_template_t code_template("<a> + <b_1>*<a>;");
+        REQUIRE(code_template.segments().size() == 6);
+        REQUIRE(code_template.placeholders() == std::vector<std::string_view>{ "<a>", "<b_1>" });
+        REQUIRE(code_template.text(code_template.segments()[2]) == "<b_1>");
+    }
+
+    SECTION("at compile time") {
+        static constexpr std::string_view code = "for(int i = 0; i < <count>; ++i) {}";
+        static constexpr shader_template_t<count_shader_template_segments(code)> code_template { code };
+        static_assert(code_template.segments().size() == 3);
+        static_assert(code_template.text(code_template.segments()[1]) == "<count>");
+        REQUIRE(code_template.render(shader_bindings_t{}.set("<count>", 4)) == "for(int i = 0; i < 4; ++i) {}");
+    }
+}
+
+TEST_CASE("shader_template_t::render()", "[core][unit]") {
+    const shader_template_t code_template("<var> = <value>; <var>++;");
+
+    SECTION("with all placeholders bound") {
+        shader_bindings_t bindings;
+        bindings.set("<var>", "x").set("<value>", glm::vec2(1.0f, 0.5f));
+        REQUIRE(code_template.render(bindings) == "x = vec2( 1.000000, 0.500000); x++;");
+        REQUIRE(code_template.unbound(bindings).empty());
+        REQUIRE(code_template.unused(bindings).empty());
+    }
+
+    SECTION("with rebinding") {
+        shader_bindings_t bindings;
+        bindings.set("<var>", "x").set("<value>", 1).set("<var>", "y");
+        REQUIRE(bindings.size() == 2);
+        REQUIRE(code_template.render(bindings) == "y = 1; y++;");
+    }
+
+    SECTION("into a reused buffer") {
+        std::string output = "previous content";
+        code_template.render(shader_bindings_t{}.set("<var>", "a").set("<value>", "b"), output);
+        REQUIRE(output == "a = b; a++;");
+    }
+
+    SECTION("with unbound placeholder") {
+        shader_bindings_t bindings;
+        bindings.set("<var>", "x");
+        REQUIRE(code_template.unbound(bindings) == std::vector<std::string_view>{ "<value>" });
+        REQUIRE_THROWS(code_template.render(bindings));
+    }
+
+    SECTION("with unused binding") {
+        shader_bindings_t bindings;
+        bindings.set("<var>", "x").set("<value>", "1").set("<other>", "2");
+        REQUIRE(code_template.unused(bindings) == std::vector<std::string_view>{ "<other>" });
+        REQUIRE(code_template.render(bindings) == "x = 1; x++;");
+    }
+}
@@ -0,0 +1,133 @@
+#include <catch2/catch_all.hpp>
+#include <glpp/core/object/shared_frame.hpp>
+#include <glpp/gl/context.hpp>
+#include <glpp/testing/context.hpp>
+#include <filesystem>
+#include <future>
+#include <thread>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace glpp::core::object;
+using namespace glpp::gl;
+
+namespace {
+
+std::string socket_path(const char* name) {
+    return (std::filesystem::temp_directory_path()/name).string();
+}
+
+std::vector<std::byte> frame(size_t size, std::uint8_t value) {
+    return std::vector<std::byte>(size, std::byte{ value });
+}
+
+// The source waits in its constructor, until the sink accepts it.
+std::unique_ptr<shared_frame_source_t> connect(shared_frame_sink_t& sink, const std::string& path) {
+    const auto consumers = sink.consumers();
+    auto source = std::async(std::launch::async, [&] { return std::make_unique<shared_frame_source_t>(path); });
+    REQUIRE(sink.accept(std::chrono::seconds(5)) == consumers+1);
+    return source.get();
+}
+
+}
+
+TEST_CASE("shared frames are read in place by a consumer", "[core][unit]") {
+    context = mock_context_t{};
+    const auto path = socket_path("glpp_shared_frame_read.sock");
+    shared_frame_sink_t sink { path, 4, 2 };
+    REQUIRE(sink.frame_size() == 4*2*4);
+    REQUIRE_THROWS(sink.publish(frame(3, 0)));
+
+    const auto source = connect(sink, path);
+    REQUIRE(sink.consumers() == 1);
+    REQUIRE(source->width() == 4);
+    REQUIRE(source->height() == 2);
+
+    REQUIRE(sink.publish(frame(sink.frame_size(), 42)));
+    REQUIRE(source->wait(std::chrono::seconds(1)));
+    {
+        const auto acquired = source->acquire();
+        REQUIRE(acquired);
+        REQUIRE(acquired->sequence() == sink.published());
+        REQUIRE(acquired->width() == 4);
+        REQUIRE(acquired->pixels().size() == sink.frame_size());
+        REQUIRE(acquired->pixels()[5] == std::byte{ 42 });
+        REQUIRE(acquired->age() >= std::chrono::nanoseconds(0));
+        // Each frame is only acquired once.
+        REQUIRE_FALSE(source->acquire());
+    }
+    REQUIRE_FALSE(source->wait(std::chrono::milliseconds(0)));
+}
+
+TEST_CASE("shared frames are not overwritten while they are read", "[core][unit]") {
+    context = mock_context_t{};
+    const auto path = socket_path("glpp_shared_frame_slots.sock");
+    shared_frame_sink_t sink { path, 2, 2, 2 };
+    const auto source = connect(sink, path);
+
+    REQUIRE(sink.publish(frame(sink.frame_size(), 1)));
+    auto held = source->acquire();
+    REQUIRE(held);
+    // One slot holds the newest frame, the other one is read by the consumer.
+    REQUIRE(sink.publish(frame(sink.frame_size(), 2)));
+    const auto dropped = sink.dropped();
+    REQUIRE_FALSE(sink.publish(frame(sink.frame_size(), 3)));
+    REQUIRE(sink.dropped() == dropped+1);
+    REQUIRE(held->pixels()[0] == std::byte{ 1 });
+
+    held.reset();
+    REQUIRE(sink.publish(frame(sink.frame_size(), 4)));
+    const auto newest = source->acquire();
+    REQUIRE(newest);
+    REQUIRE(newest->pixels()[0] == std::byte{ 4 });
+}
+
+TEST_CASE("shared frame sinks forget disconnected consumers", "[core][unit]") {
+    context = mock_context_t{};
+    const auto path = socket_path("glpp_shared_frame_disconnect.sock");
+    shared_frame_sink_t sink { path, 1, 1 };
+    auto source = connect(sink, path);
+    REQUIRE(sink.consumers() == 1);
+    source.reset();
+    REQUIRE(sink.accept() == 0);
+    REQUIRE(sink.published() == 0);
+
+    REQUIRE_THROWS(shared_frame_sink_t { path, 0, 1 });
+    REQUIRE_THROWS(shared_frame_sink_t { path, 1, 1, 1 });
+}
+
+TEST_CASE("shared frame sinks release the slots of crashed consumers", "[core][unit]") {
+    context = mock_context_t{};
+    const auto path = socket_path("glpp_shared_frame_crash.sock");
+    shared_frame_sink_t sink { path, 1, 1, 2 };
+    REQUIRE(sink.publish(frame(sink.frame_size(), 1)));
+
+    // The consumer exits while it reads the first frame, without running any destructors.
+    const auto consumer = fork();
+    if(consumer == 0) {
+        shared_frame_source_t source { path };
+        auto held = source.acquire();
+        _exit(held ? 0 : 1);
+    }
+    REQUIRE(sink.accept(std::chrono::seconds(5)) == 1);
+    int status = 0;
+    REQUIRE(waitpid(consumer, &status, 0) == consumer);
+    REQUIRE(WIFEXITED(status));
+    REQUIRE(WEXITSTATUS(status) == 0);
+
+    // One slot holds the newest frame, the other one was read by the crashed consumer.
+    REQUIRE(sink.publish(frame(sink.frame_size(), 2)));
+    REQUIRE(sink.publish(frame(sink.frame_size(), 3)));
+    REQUIRE(sink.consumers() == 0);
+    REQUIRE(sink.dropped() == 0);
+}
+
+TEST_CASE("shared frame sources time out without a producer", "[core][unit]") {
+    context = mock_context_t{};
+    const auto path = socket_path("glpp_shared_frame_timeout.sock");
+    REQUIRE_THROWS(shared_frame_source_t { path, std::chrono::milliseconds(20) });
+
+    // A producer, which never accepts, is not waited for either.
+    shared_frame_sink_t sink { path, 1, 1 };
+    REQUIRE_THROWS(shared_frame_source_t { path, std::chrono::milliseconds(20) });
+}
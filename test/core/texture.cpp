@@ -109,6 +109,7 @@ TEST_CASE("texture construction from image_t", "[core][unit]") {
         REQUIRE(width == 17);
         REQUIRE(height == 53);
     };
+    context.glPixelStorei = [](auto...){};
     context.glTextureSubImage2D = [&calls_subimg](
         GLuint tex, 
         GLint level, 
@@ -145,6 +146,110 @@ TEST_CASE("texture construction from image_t", "[core][unit]") {
     REQUIRE(calls_subimg == 1);
 }
 
+TEST_CASE("texture allocates full mip chain", "[core][unit]") {
+    context.enable_throw();
+
+    auto calls_subimg = 0;
+    std::vector<GLint> levels;
+
+    context.glCreateTextures = [](GLenum, GLsizei, GLuint* tex){
+        *tex = 42;
+    };
+    context.glDeleteTextures = [](auto...){};
+    context.glTextureParameteri = [](GLuint, GLenum name, GLint param){
+        if(name == GL_TEXTURE_MAG_FILTER) {
+            REQUIRE(param == GL_LINEAR);
+        }
+        if(name == GL_TEXTURE_MIN_FILTER) {
+            REQUIRE(param == GL_LINEAR_MIPMAP_LINEAR);
+        }
+    };
+    context.glTextureStorage2D = [](GLuint, GLsizei lod, GLenum, GLsizei, GLsizei){
+        REQUIRE(lod == 4);
+    };
+    context.glPixelStorei = [](auto...){};
+    context.glTextureSubImage2D = [&](GLuint, GLint level, GLint, GLint, GLsizei width, GLsizei height, GLenum, GLenum, const void*){
+        ++calls_subimg;
+        levels.push_back(level);
+        REQUIRE(width == std::max(13 >> level, 1));
+        REQUIRE(height == std::max(8 >> level, 1));
+    };
+
+    texture_t texture{ 13, 8, image_format_t::rgb_8, clamp_mode_t::repeat, filter_mode_t::linear, mipmap_mode_t::linear };
+    REQUIRE(texture.levels() == 4);
+
+    const image_t<glm::vec3> image(13, 8, glm::vec3(0.5f));
+    texture.update_mip_chain(image.mip_chain());
+    REQUIRE(calls_subimg == 4);
+    REQUIRE(levels == std::vector<GLint>{ 0, 1, 2, 3 });
+    REQUIRE_THROWS(texture.update_level(4, image_t<glm::vec3>(1, 1)));
+}
+
+TEST_CASE("texture construction from compressed image", "[core][unit]") {
+    context.enable_throw();
+
+    std::vector<std::pair<GLint, GLsizei>> uploads;
+    context.glCreateTextures = [](GLenum, GLsizei, GLuint* tex){
+        *tex = 42;
+    };
+    context.glDeleteTextures = [](auto...){};
+    context.glTextureParameteri = [](auto...){};
+    context.glTextureStorage2D = [](GLuint, GLsizei lod, GLenum internal, GLsizei width, GLsizei height){
+        REQUIRE(lod == 3);
+        REQUIRE(internal == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT);
+        REQUIRE(width == 8);
+        REQUIRE(height == 6);
+    };
+    context.glGenerateTextureMipmap = [](auto...){
+        throw std::runtime_error("Compressed textures can not generate mipmaps.");
+    };
+    context.glCompressedTextureSubImage2D = [&](GLuint, GLint level, GLint, GLint, GLsizei width, GLsizei height, GLenum format, GLsizei size, const void*){
+        REQUIRE(format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT);
+        uploads.emplace_back(level, size);
+        REQUIRE(size == static_cast<GLsizei>(compressed_image_size(image_format_t::bc3, width, height)));
+    };
+
+    std::vector<compressed_image_t::level_t> levels;
+    levels.push_back({ 8, 6, std::vector<std::byte>(64) });
+    levels.push_back({ 4, 3, std::vector<std::byte>(16) });
+    levels.push_back({ 2, 1, std::vector<std::byte>(16) });
+    const compressed_image_t image { image_format_t::bc3, std::move(levels) };
+
+    texture_t texture { image };
+    REQUIRE(texture.levels() == 3);
+    REQUIRE(uploads == std::vector<std::pair<GLint, GLsizei>>{ {0, 64}, {1, 16}, {2, 16} });
+
+    texture.generate_mipmaps();
+    REQUIRE_THROWS(compressed_image_t{ image_format_t::bc1_rgb, { { 4, 4, std::vector<std::byte>(16) } } });
+    REQUIRE_THROWS(compressed_image_t{ image_format_t::rgba_8, { { 4, 4, std::vector<std::byte>(64) } } });
+}
+
+TEST_CASE("texture copy region", "[core][unit]") {
+    context.enable_throw();
+
+    GLuint next_id = 1;
+    std::vector<std::array<GLint, 8>> copies;
+    context.glCreateTextures = [&](GLenum, GLsizei, GLuint* tex){
+        *tex = next_id++;
+    };
+    context.glDeleteTextures = [](auto...){};
+    context.glTextureParameteri = [](auto...){};
+    context.glTextureStorage2D = [](auto...){};
+    context.glCopyImageSubData = [&](GLuint src, GLenum src_target, GLint, GLint src_x, GLint src_y, GLint, GLuint dst, GLenum dst_target, GLint, GLint dst_x, GLint dst_y, GLint, GLsizei width, GLsizei height, GLsizei depth){
+        REQUIRE(src_target == GL_TEXTURE_2D);
+        REQUIRE(dst_target == GL_TEXTURE_2D);
+        REQUIRE(depth == 1);
+        copies.push_back({ static_cast<GLint>(src), src_x, src_y, static_cast<GLint>(dst), dst_x, dst_y, width, height });
+    };
+
+    const texture_t source { 8, 8 };
+    texture_t target { 16, 4 };
+    target.copy(source, 2, 4, 10, 0, 6, 4);
+    REQUIRE(copies == std::vector<std::array<GLint, 8>>{ { 1, 2, 4, 2, 10, 0, 6, 4 } });
+    REQUIRE_THROWS(target.copy(source, 4, 4, 0, 0, 8, 4));
+    REQUIRE_THROWS(target.copy(source, 0, 0, 12, 0, 8, 4));
+}
+
 TEST_CASE("texture bind to slot", "[core][unit]") {
     context.enable_throw();
 
@@ -156,6 +261,7 @@ TEST_CASE("texture bind to slot", "[core][unit]") {
     context.glDeleteTextures = [](auto...){};
     context.glTextureParameteri = [](auto...){};
     context.glTextureStorage2D = [](auto...){};
+    context.glPixelStorei = [](auto...){};
     context.glTextureSubImage2D = [](auto...){};
     context.glGetIntegerv = [](GLenum name, GLint* data){ 
         if(name == GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS) {
@@ -3,6 +3,9 @@
 #include <glpp/core.hpp>
 #include <glpp/gl/context.hpp>
 #include <glpp/testing/context.hpp>
+#include <glpp/testing/mock_gl.hpp>
+
+#include <cstring>
 
 #include <tuple>
 
@@ -12,6 +15,8 @@ template <class Functor>
 void for_each_allocation_policy(Functor f) {
     f(texture_atlas::multi_policy_t{});
     f(texture_atlas::grid_policy_t{3, 3, 2, 2});
+    f(texture_atlas::array_policy_t{2, 2});
+    f(texture_atlas::packed_policy_t{16, 16});
 }
 #include <iostream>
 
@@ -105,6 +110,303 @@ TEST_CASE("texture_atlas_t fetch", "[core][unit]") {
     REQUIRE(entries[2].fetch("binding", "uv") == "texture(binding[2], uv)");
 }
 
+TEST_CASE("texture_atlas_t array policy fetch", "[core][unit]") {
+    glpp::gl::context = glpp::gl::mock_context_t{};
+
+    array_atlas_t texture_atlas { 4, 4 };
+    const auto entry = texture_atlas.insert();
+    REQUIRE(texture_atlas.declaration("binding") == "uniform sampler2DArray binding");
+    REQUIRE(entry.fetch("binding", "uv") == "texture(binding, vec3(uv, 0))");
+    REQUIRE(texture_atlas.dynamic_fetch("binding", "tex_id", "uv") == "texture(binding, vec3(uv, tex_id))");
+}
+
+TEST_CASE("texture_atlas_t array policy grows and reuses layers", "[core][unit]") {
+    glpp::gl::context = glpp::gl::mock_context_t{};
+    auto& context = glpp::gl::context;
+
+    GLuint next_texture = 0;
+    std::vector<GLsizei> allocated_layers;
+    std::vector<std::tuple<GLuint, GLuint, GLint, GLsizei>> copies;
+    std::vector<GLint> uploaded_layers;
+    context.glGetIntegerv = [](GLenum name, GLint* data) {
+        REQUIRE(name == GL_MAX_ARRAY_TEXTURE_LAYERS);
+        *data = 256;
+    };
+    context.glCreateTextures = [&](GLenum target, GLsizei, GLuint* texture) {
+        REQUIRE(target == GL_TEXTURE_2D_ARRAY);
+        *texture = ++next_texture;
+    };
+    context.glTextureStorage3D = [&](GLuint, GLsizei, GLenum, GLsizei width, GLsizei height, GLsizei depth) {
+        REQUIRE(width == 4);
+        REQUIRE(height == 4);
+        allocated_layers.push_back(depth);
+    };
+    context.glCopyImageSubData = [&](GLuint src, GLenum, GLint, GLint, GLint, GLint src_z, GLuint dst, GLenum, GLint, GLint, GLint, GLint dst_z, GLsizei, GLsizei, GLsizei depth) {
+        REQUIRE(src_z == dst_z);
+        copies.emplace_back(src, dst, src_z, depth);
+    };
+    context.glTextureSubImage3D = [&](GLuint, GLint, GLint, GLint, GLint layer, GLsizei width, GLsizei height, GLsizei depth, GLenum, GLenum, const void*) {
+        REQUIRE(width == 4);
+        REQUIRE(height == 4);
+        REQUIRE(depth == 1);
+        uploaded_layers.push_back(layer);
+    };
+
+    array_atlas_t texture_atlas { 4, 4, 2, image_format_t::rgba_8 };
+    const image_t<glm::vec4> image(4, 4, glm::vec4(1.0f));
+    for(auto i = 0; i < 3; ++i) {
+        REQUIRE(texture_atlas.insert(image).key() == static_cast<std::uint32_t>(i));
+    }
+    REQUIRE(allocated_layers == std::vector<GLsizei>{ 2, 4 });
+    REQUIRE(copies == std::vector<std::tuple<GLuint, GLuint, GLint, GLsizei>>{ { 1, 2, 0, 2 } });
+    REQUIRE(texture_atlas.size() == 3);
+
+    texture_atlas.erase(1);
+    REQUIRE(texture_atlas.insert(image_t<glm::vec4>(8, 8)).key() == 1);
+    REQUIRE(uploaded_layers == std::vector<GLint>{ 0, 1, 2, 1 });
+
+    // Explicit keys beyond the allocated range leave the skipped layers free.
+    REQUIRE(texture_atlas.insert(6, image).key() == 6);
+    REQUIRE(allocated_layers.back() == 8);
+    REQUIRE(texture_atlas.keys() == std::vector<std::uint32_t>{ 0, 1, 2, 6 });
+    REQUIRE(texture_atlas.insert(image).key() != 6);
+    REQUIRE(texture_atlas.size() == 5);
+}
+
+TEST_CASE("rect_packer_t packs without overlap and reuses freed space", "[core][unit]") {
+    texture_atlas::rect_packer_t packer { 64, 64 };
+    const auto overlap = [](const texture_atlas::rect_t& a, const texture_atlas::rect_t& b) {
+        return a.x < b.x+b.width && b.x < a.x+a.width && a.y < b.y+b.height && b.y < a.y+a.height;
+    };
+
+    std::vector<texture_atlas::rect_t> rects;
+    const std::array<std::pair<std::uint32_t, std::uint32_t>, 6> sizes {{ {20, 10}, {8, 30}, {33, 5}, {12, 12}, {40, 20}, {7, 3} }};
+    for(auto i = 0; i < 4; ++i) {
+        for(const auto& [width, height] : sizes) {
+            const auto rect = packer.alloc(width, height);
+            if(!rect) continue;
+            REQUIRE(rect->x+rect->width <= 64);
+            REQUIRE(rect->y+rect->height <= 64);
+            for(const auto& other : rects) {
+                REQUIRE_FALSE(overlap(*rect, other));
+            }
+            rects.push_back(*rect);
+        }
+    }
+    REQUIRE(rects.size() > 6);
+    REQUIRE_FALSE(packer.alloc(65, 1));
+
+    // Two freed neighbours are merged and can hold an entry neither fits alone.
+    texture_atlas::rect_packer_t small { 16, 8 };
+    const auto left = small.alloc(8, 8);
+    const auto right = small.alloc(8, 8);
+    REQUIRE_FALSE(small.alloc(1, 1));
+    small.free(*left);
+    small.free(*right);
+    REQUIRE(small.alloc(16, 8) == texture_atlas::rect_t{ 0, 0, 16, 8 });
+}
+
+TEST_CASE("texture_atlas_t packed policy", "[core][unit]") {
+    glpp::gl::context = glpp::gl::mock_context_t{};
+    std::vector<std::array<GLsizei, 4>> uploads;
+    glpp::gl::context.glTextureSubImage2D = [&](GLuint, GLint, GLint x, GLint y, GLsizei width, GLsizei height, GLenum, GLenum, const void*) {
+        uploads.push_back({ x, y, width, height });
+    };
+
+    packed_atlas_t texture_atlas { 32, 16, 1, image_format_t::rgba_8 };
+    const std::vector images {
+        image_t<glm::vec4>(4, 4),
+        image_t<glm::vec4>(10, 6),
+        image_t<glm::vec4>(2, 12)
+    };
+    const auto entries = texture_atlas.insert(images);
+    REQUIRE(entries.size() == 3);
+    REQUIRE(texture_atlas.size() == 3);
+
+    // The tallest image is placed first.
+    REQUIRE(entries[2].key() == 0);
+    REQUIRE(uploads.front() == std::array<GLsizei, 4>{ 0, 0, 4, 14 });
+
+    REQUIRE(texture_atlas.fetch("binding", entries[1].key(), "uv") == "glpp_fetch_binding(uv, 1)");
+    REQUIRE(texture_atlas.declaration("binding").find("uniform sampler2D binding;") == 0);
+
+    REQUIRE_THROWS(texture_atlas.insert(image_t<glm::vec4>(40, 4)));
+    REQUIRE(texture_atlas.size() == 3);
+
+    texture_atlas.erase(entries[1]);
+    REQUIRE(texture_atlas.insert(image_t<glm::vec4>(10, 6)).key() == 1);
+}
+
+TEST_CASE("texture_atlas_t packed policy entry rectangles", "[core][unit]") {
+    glpp::gl::context = glpp::gl::mock_context_t{};
+
+    texture_atlas::packed_policy_t policy { 32, 16, 2 };
+    policy.alloc(0, image_t<glm::vec3>(4, 8));
+    REQUIRE(policy.rect(0) == texture_atlas::rect_t{ 2, 2, 4, 8 });
+    REQUIRE(policy.uv_rect(0) == glm::vec4(2.0f/32, 2.0f/16, 4.0f/32, 8.0f/16));
+
+    // Updating with another size moves the entry and keeps its key.
+    policy.alloc(1, image_t<glm::vec3>(4, 4));
+    policy.update(0, image_t<glm::vec3>(12, 4));
+    REQUIRE(policy.rect(0).width == 12);
+    REQUIRE(policy.contains(0));
+    REQUIRE_THROWS(policy.update(1, image_t<glm::vec3>(64, 4)));
+    REQUIRE(policy.rect(1).width == 4);
+}
+
+TEST_CASE("texture_atlas_t packed policy reads rectangles from a storage buffer", "[core][unit]") {
+    glpp::test::mock_gl_t mock;
+
+    texture_atlas::packed_policy_t policy { 32, 16, 0 };
+    policy.alloc(2, image_t<glm::vec3>(8, 4));
+    const auto declaration = policy.declaration("atlas");
+    REQUIRE(declaration.find("binding = 3) readonly buffer glpp_atlas_rects_block") != std::string::npos);
+
+    const auto rects = [&] {
+        const auto buffer = mock.indexed_buffers.at({ GL_SHADER_STORAGE_BUFFER, 3 });
+        const auto& bytes = mock.storage(buffer);
+        std::vector<glm::vec4> result(bytes.size()/sizeof(glm::vec4));
+        std::memcpy(result.data(), bytes.data(), bytes.size());
+        return result;
+    };
+    policy.slots();
+    REQUIRE(rects().size() == 3);
+    REQUIRE(rects()[0] == glm::vec4(0.0f));
+    REQUIRE(rects()[2] == policy.uv_rect(2));
+
+    // New entries update the buffer in place as long as it is large enough, never the shader.
+    policy.alloc(1, image_t<glm::vec3>(4, 4));
+    const auto buffers = mock.buffer_names;
+    policy.slots();
+    REQUIRE(mock.buffer_names == buffers);
+    REQUIRE(rects()[1] == policy.uv_rect(1));
+    REQUIRE(policy.declaration("atlas") == declaration);
+
+    policy.alloc(5, image_t<glm::vec3>(4, 4));
+    policy.slots();
+    REQUIRE(rects()[5] == policy.uv_rect(5));
+    REQUIRE(rects()[2] == policy.uv_rect(2));
+
+    policy.set_rect_binding(6);
+    policy.slots();
+    REQUIRE(mock.indexed_buffers.at({ GL_SHADER_STORAGE_BUFFER, 6 }) == mock.indexed_buffers.at({ GL_SHADER_STORAGE_BUFFER, 3 }));
+}
+
+TEST_CASE("texture_atlas_t grid policy allocates non square cells", "[core][unit]") {
+    glpp::gl::context = glpp::gl::mock_context_t{};
+    std::pair<GLsizei, GLsizei> size;
+    glpp::gl::context.glTextureStorage2D = [&](GLuint, GLsizei, GLenum, GLsizei width, GLsizei height) {
+        size = { width, height };
+    };
+
+    const grid_atlas_t texture_atlas { 2, 3, 4, 2 };
+    REQUIRE(size == std::pair<GLsizei, GLsizei>{ 12, 12 });
+}
+
+TEST_CASE("texture_atlas_t grid policy grows up to max rows", "[core][unit]") {
+    glpp::gl::context = glpp::gl::mock_context_t{};
+    std::vector<std::pair<GLsizei, GLsizei>> copies;
+    glpp::gl::context.glCopyImageSubData = [&](GLuint, GLenum, GLint, GLint, GLint, GLint, GLuint, GLenum, GLint, GLint, GLint, GLint, GLsizei width, GLsizei height, GLsizei) {
+        copies.emplace_back(width, height);
+    };
+
+    grid_atlas_t texture_atlas { 2, 1, 4, 4 };
+    texture_atlas.policy().set_max_rows(3);
+    std::vector<std::vector<std::uint32_t>> relocated;
+    texture_atlas.policy().relocations().subscribe([&](const auto& keys) {
+        relocated.push_back(keys);
+    });
+
+    const auto first = texture_atlas.insert(image_t<glm::vec3>(4, 4));
+    texture_atlas.insert(image_t<glm::vec3>(4, 4));
+    REQUIRE(copies.empty());
+
+    const auto third = texture_atlas.insert(image_t<glm::vec3>(4, 4));
+    REQUIRE(third.key() == 2);
+    REQUIRE(first.valid());
+    REQUIRE(texture_atlas.policy().rows() == 2);
+    REQUIRE(copies == std::vector<std::pair<GLsizei, GLsizei>>{ { 12, 6 } });
+    REQUIRE(relocated == std::vector<std::vector<std::uint32_t>>{ { 0, 1 } });
+
+    texture_atlas.insert(image_t<glm::vec3>(4, 4));
+    texture_atlas.insert(image_t<glm::vec3>(4, 4));
+    texture_atlas.insert(image_t<glm::vec3>(4, 4));
+    REQUIRE(texture_atlas.policy().rows() == 3);
+    REQUIRE_THROWS(texture_atlas.insert(image_t<glm::vec3>(4, 4)));
+}
+
+TEST_CASE("texture_atlas_t packed policy grows up to max size", "[core][unit]") {
+    glpp::gl::context = glpp::gl::mock_context_t{};
+    std::vector<std::pair<GLsizei, GLsizei>> copies;
+    glpp::gl::context.glCopyImageSubData = [&](GLuint, GLenum, GLint, GLint, GLint, GLint, GLuint, GLenum, GLint, GLint, GLint, GLint, GLsizei width, GLsizei height, GLsizei) {
+        copies.emplace_back(width, height);
+    };
+
+    packed_atlas_t texture_atlas { 16, 16, 0 };
+    auto& policy = texture_atlas.policy();
+    policy.set_max_size(32, 32);
+    std::vector<std::uint32_t> relocated;
+    policy.relocations().subscribe([&](const auto& keys) {
+        relocated.insert(relocated.end(), keys.begin(), keys.end());
+    });
+
+    texture_atlas.insert(image_t<glm::vec3>(16, 16));
+    texture_atlas.insert(image_t<glm::vec3>(8, 8));
+    REQUIRE(policy.width() == 32);
+    REQUIRE(policy.height() == 16);
+    REQUIRE(copies == std::vector<std::pair<GLsizei, GLsizei>>{ { 16, 16 } });
+    REQUIRE(relocated == std::vector<std::uint32_t>{ 0 });
+    REQUIRE(policy.rect(0) == texture_atlas::rect_t{ 0, 0, 16, 16 });
+    REQUIRE(policy.uv_rect(0) == glm::vec4(0.0f, 0.0f, 0.5f, 1.0f));
+
+    texture_atlas.insert(image_t<glm::vec3>(32, 16));
+    REQUIRE(policy.height() == 32);
+    REQUIRE_THROWS(texture_atlas.insert(image_t<glm::vec3>(32, 16)));
+}
+
+TEST_CASE("texture_atlas_t packed policy defragments incrementally", "[core][unit]") {
+    glpp::gl::context = glpp::gl::mock_context_t{};
+    auto copies = 0;
+    glpp::gl::context.glCopyImageSubData = [&](auto...) {
+        ++copies;
+    };
+
+    texture_atlas::packed_policy_t policy { 32, 8, 0 };
+    for(auto key = 0u; key < 4; ++key) {
+        policy.alloc(key, image_t<glm::vec3>(8, 8));
+    }
+    policy.free(0);
+    policy.free(2);
+    REQUIRE(policy.fragmentation() == 0.5f);
+
+    std::vector<std::uint32_t> relocated;
+    policy.relocations().subscribe([&](const auto& keys) {
+        relocated = keys;
+    });
+
+    // A budget of zero still copies a single entry per call.
+    REQUIRE_FALSE(policy.defragment(std::chrono::nanoseconds(0)));
+    REQUIRE(policy.defragmenting());
+    REQUIRE(copies == 1);
+    REQUIRE(policy.rect(3) == texture_atlas::rect_t{ 24, 0, 8, 8 });
+
+    REQUIRE(policy.defragment(std::chrono::nanoseconds(0)));
+    REQUIRE_FALSE(policy.defragmenting());
+    REQUIRE(copies == 2);
+    REQUIRE(relocated == std::vector<std::uint32_t>{ 3 });
+    REQUIRE(policy.rect(3) == texture_atlas::rect_t{ 0, 0, 8, 8 });
+    REQUIRE(policy.rect(1) == texture_atlas::rect_t{ 8, 0, 8, 8 });
+    REQUIRE(policy.fragmentation() == 0.0f);
+
+    // Modifications cancel a running defragmentation.
+    policy.alloc(0, image_t<glm::vec3>(8, 8));
+    policy.free(1);
+    REQUIRE_FALSE(policy.defragment(std::chrono::nanoseconds(0)));
+    policy.alloc(1, image_t<glm::vec3>(4, 4));
+    REQUIRE_FALSE(policy.defragmenting());
+    REQUIRE(policy.rect(3) == texture_atlas::rect_t{ 0, 0, 8, 8 });
+}
+
 struct null_t {};
 template <class UniformDescription = null_t>
 class texture_atlas_renderer_t : public glpp::core::render::renderer_t<UniformDescription> {
@@ -204,6 +204,8 @@ void test(const image_format_t image_format, const clamp_mode_t clamp_mode, cons
     auto atlas = [&](){
         if constexpr(std::is_same_v<TextureAtlas, grid_atlas_t>) {
             return grid_atlas_t(3, 3, 2, 2, image_format, clamp_mode, filter_mode, mipmap_mode, swizzle_mask);
+        } else if constexpr(std::is_same_v<TextureAtlas, array_atlas_t>) {
+            return array_atlas_t(2, 2, 1, image_format, clamp_mode, filter_mode, mipmap_mode, swizzle_mask);
         } else {
             return TextureAtlas(image_format, clamp_mode, filter_mode, mipmap_mode, swizzle_mask);
         }
@@ -283,4 +285,18 @@ TEST_CASE("texture_atlas render test using grid policy", "[core][system]") {
             }
         }
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("texture_atlas render test using array policy", "[core][system]") {
+    for(const auto image_format : image_formats) {
+        for(const auto clamp_mode : clamp_modes) {
+            for(const auto filter_mode : filter_modes) {
+                for(const auto mipmap_mode : mipmap_modes) {
+                    for(const auto swizzle_mask : swizzle_masks) {
+                        test<array_atlas_t>(image_format, clamp_mode, filter_mode, mipmap_mode, swizzle_mask);
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,130 @@
+#include <catch2/catch_all.hpp>
+#include <glpp/core/object/texture_atlas_table.hpp>
+#include <glpp/gl/context.hpp>
+#include <glpp/testing/context.hpp>
+#include <glpp/testing/mock_gl.hpp>
+#include <cstring>
+
+using namespace glpp::core::object;
+
+namespace {
+
+// Records in the storage buffer of the table, the newest buffer of the tests.
+std::vector<texture_atlas::table_record_t> records(glpp::test::mock_gl_t& mock) {
+    const auto& bytes = mock.storage(mock.buffer_names);
+    std::vector<texture_atlas::table_record_t> records(bytes.size()/sizeof(texture_atlas::table_record_t));
+    std::memcpy(records.data(), bytes.data(), records.size()*sizeof(texture_atlas::table_record_t));
+    return records;
+}
+
+}
+
+TEST_CASE("texture atlas table publishes packed entries", "[core][unit]") {
+    glpp::test::mock_gl_t mock;
+
+    packed_atlas_t atlas { 32, 16, 0, image_format_t::rgb_8, clamp_mode_t::clamp_to_edge };
+    texture_atlas_table_t table { atlas };
+    REQUIRE(table.size() == 0);
+    const auto initial = records(mock);
+    REQUIRE(initial.size() == 1);
+    REQUIRE(initial[0].valid == 0);
+
+    const auto declaration = table.declaration("atlas");
+    atlas.insert(image_t<glm::vec3>(8, 16));
+    atlas.insert(3, image_t<glm::vec3>(16, 8));
+    table.update();
+
+    // The shader code does not change with the contents of the atlas.
+    REQUIRE(table.declaration("atlas") == declaration);
+    REQUIRE(declaration.find("uniform sampler2D atlas;") == 0);
+    REQUIRE(declaration.find("binding = 2") != std::string::npos);
+    REQUIRE(table.fetch("atlas", "key", "uv") == "glpp_lookup_atlas(uv, uint(key))");
+
+    REQUIRE(table.size() == 4);
+    const auto published = records(mock);
+    REQUIRE(published.size() == 4);
+    REQUIRE(published[0].uv_rect == glm::vec4(0.0f, 0.0f, 0.25f, 1.0f));
+    REQUIRE(published[0].clamp_mode == 2);
+    REQUIRE(published[0].valid == 1);
+    REQUIRE(published[1].valid == 0);
+    REQUIRE(published[3].uv_rect == glm::vec4(0.25f, 0.0f, 0.5f, 0.5f));
+
+    table.bind(5);
+    REQUIRE(mock.indexed_buffers.at({ GL_SHADER_STORAGE_BUFFER, 5 }) == mock.buffer_names);
+}
+
+TEST_CASE("texture atlas table follows a growing grid", "[core][unit]") {
+    glpp::test::mock_gl_t mock;
+
+    grid_atlas_t atlas { 2, 1, 4, 4 };
+    atlas.policy().set_max_rows(2);
+    texture_atlas_table_t table { atlas };
+    const auto declaration = table.declaration("atlas", 3);
+
+    for(auto i = 0; i < 3; ++i) {
+        atlas.insert(image_t<glm::vec3>(4, 4));
+    }
+    table.update();
+    REQUIRE(table.declaration("atlas", 3) == declaration);
+
+    // Cells are 6 pixels wide including the border of a single pixel. The buffer doubled while the
+    // grid grew, records past the last key are invalid.
+    REQUIRE(table.size() == 3);
+    const auto published = records(mock);
+    REQUIRE(published.size() == 4);
+    REQUIRE(published[3].valid == 0);
+    REQUIRE(published[0].uv_rect == glm::vec4(1.0f/12, 1.0f/12, 4.0f/12, 4.0f/12));
+    REQUIRE(published[2].uv_rect == glm::vec4(1.0f/12, 7.0f/12, 4.0f/12, 4.0f/12));
+    REQUIRE(published[1].clamp_mode == 0);
+}
+
+TEST_CASE("texture atlas table publishes array layers", "[core][unit]") {
+    glpp::test::mock_gl_t mock;
+    glpp::gl::context.glGetIntegerv = [](GLenum, GLint* data) {
+        *data = 16;
+    };
+
+    array_atlas_t atlas { 4, 4, 2 };
+    texture_atlas_table_t table { atlas };
+    atlas.insert(image_t<glm::vec3>(4, 4));
+    atlas.insert(image_t<glm::vec3>(4, 4));
+    table.update();
+
+    REQUIRE(table.declaration("atlas").find("uniform sampler2DArray atlas;") == 0);
+    const auto published = records(mock);
+    REQUIRE(published.size() == 2);
+    REQUIRE(published[1].layer == 1);
+    REQUIRE(published[1].uv_rect == glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
+}
+
+TEST_CASE("texture atlas table updates in place and follows relocations", "[core][unit]") {
+    glpp::test::mock_gl_t mock;
+
+    packed_atlas_t atlas { 16, 16, 0 };
+    texture_atlas_table_t table { atlas };
+    atlas.insert(image_t<glm::vec3>(8, 8));
+    atlas.insert(image_t<glm::vec3>(8, 8));
+    table.update();
+    table.bind(5);
+    const auto buffer = mock.buffer_names;
+    REQUIRE(records(mock)[1].uv_rect == glm::vec4(0.5f, 0.0f, 0.5f, 0.5f));
+
+    // Growing the atlas changes the texture coordinates of all entries without an update().
+    atlas.policy().grow(32, 16);
+    REQUIRE(mock.buffer_names == buffer);
+    REQUIRE(records(mock)[1].uv_rect == glm::vec4(0.25f, 0.0f, 0.25f, 0.5f));
+
+    // Erased entries are written in place, too.
+    atlas.policy().free(1);
+    table.update();
+    REQUIRE(mock.buffer_names == buffer);
+    REQUIRE(records(mock)[1].valid == 0);
+
+    // A key past the capacity grows the buffer, which is bound to the previous binding again.
+    atlas.insert(7, image_t<glm::vec3>(4, 4));
+    table.update();
+    REQUIRE(mock.buffer_names != buffer);
+    REQUIRE(table.size() == 8);
+    REQUIRE(records(mock)[7].valid == 1);
+    REQUIRE(mock.indexed_buffers.at({ GL_SHADER_STORAGE_BUFFER, 5 }) == mock.buffer_names);
+}
@@ -0,0 +1,175 @@
+#include <catch2/catch_all.hpp>
+#include <glpp/core/object/texture_streamer.hpp>
+#include <glpp/gl/context.hpp>
+#include <glpp/testing/context.hpp>
+#include <glpp/testing/mock_gl.hpp>
+#include <numbers>
+
+using namespace glpp::core::object;
+using namespace glpp::gl;
+
+namespace {
+
+struct storage_t {
+    GLuint texture;
+    GLsizei levels;
+    GLsizei width;
+    GLsizei height;
+
+    bool operator==(const storage_t&) const = default;
+};
+
+// Records the storage, copies and uploads of the textures of a streamer.
+struct recorded_levels_t {
+    std::vector<storage_t> storages;
+    std::vector<std::pair<GLint, GLint>> copies;
+    std::vector<std::pair<GLint, GLsizei>> uploads;
+
+    recorded_levels_t() {
+        context.glTextureStorage2D = [this](GLuint texture, GLsizei levels, GLenum, GLsizei width, GLsizei height) {
+            storages.push_back({ texture, levels, width, height });
+        };
+        context.glCopyImageSubData = [this](GLuint, GLenum, GLint src_level, GLint, GLint, GLint, GLuint, GLenum, GLint dst_level, GLint, GLint, GLint, GLsizei, GLsizei, GLsizei) {
+            copies.emplace_back(src_level, dst_level);
+        };
+        context.glTextureSubImage2D = [this](GLuint, GLint level, GLint, GLint, GLsizei width, GLsizei, GLenum, GLenum, const void*) {
+            uploads.emplace_back(level, width);
+        };
+    }
+};
+
+// Resident size of a 256x256 rgba texture from level 2 down to 1x1.
+constexpr size_t coarse_size = 5461*4;
+constexpr size_t level_1_size = 128*128*4;
+constexpr size_t level_0_size = 256*256*4;
+
+}
+
+TEST_CASE("texture streamer maps projected sizes to mip levels", "[core][unit]") {
+    REQUIRE(texture_streamer_t::level_for_screen_size(256, 256, 1000.0f) == 0);
+    REQUIRE(texture_streamer_t::level_for_screen_size(256, 256, 256.0f) == 0);
+    REQUIRE(texture_streamer_t::level_for_screen_size(256, 256, 100.0f) == 1);
+    REQUIRE(texture_streamer_t::level_for_screen_size(256, 64, 1.0f) == 8);
+    REQUIRE(texture_streamer_t::level_for_screen_size(256, 64, 0.0f) == 8);
+    REQUIRE(texture_streamer_t::screen_size(2.0f, 2.0f, std::numbers::pi_v<float>/2.0f, 512) == Catch::Approx(256.0f));
+}
+
+TEST_CASE("texture streamer loads coarse levels first and streams finer levels", "[core][unit]") {
+    glpp::test::mock_gl_t gl;
+    recorded_levels_t mock;
+    texture_streamer_t streamer;
+
+    const auto handle = streamer.add(image_t<glm::u8vec4>(256, 256));
+    REQUIRE(mock.storages == std::vector<storage_t>{ { 1, 7, 64, 64 } });
+    REQUIRE(mock.uploads.size() == 7);
+    REQUIRE(mock.uploads.front() == std::pair<GLint, GLsizei>{ 0, 64 });
+    REQUIRE(streamer.levels(handle) == 9);
+    REQUIRE(streamer.resident_level(handle) == 2);
+    REQUIRE(streamer.usage() == coarse_size);
+
+    streamer.request(handle, 1000.0f);
+    streamer.request(handle, 10.0f);
+    REQUIRE(streamer.requested_level(handle) == 0);
+    REQUIRE(streamer.update(1) == 1);
+    REQUIRE(streamer.resident_level(handle) == 1);
+    REQUIRE(streamer.texture(handle).width() == 128);
+    REQUIRE(mock.storages.back() == storage_t{ 2, 8, 128, 128 });
+    REQUIRE(mock.copies.size() == 7);
+    REQUIRE(mock.copies.front() == std::pair<GLint, GLint>{ 0, 1 });
+    REQUIRE(mock.uploads.back() == std::pair<GLint, GLsizei>{ 0, 128 });
+    REQUIRE(streamer.usage() == coarse_size+level_1_size);
+
+    // Textures not requested in a frame are not streamed.
+    REQUIRE(streamer.update() == 0);
+    REQUIRE(streamer.resident_level(handle) == 1);
+
+    streamer.request(handle, 256.0f);
+    REQUIRE(streamer.update() == 1);
+    REQUIRE(streamer.resident_level(handle) == 0);
+    REQUIRE(streamer.usage() == coarse_size+level_1_size+level_0_size);
+
+    REQUIRE_THROWS(streamer.add(image_t<glm::u8vec4>(16, 16), image_format_t::preferred, clamp_mode_t::repeat, filter_mode_t::linear, mipmap_mode_t::none));
+    REQUIRE_THROWS(streamer.texture(5));
+}
+
+TEST_CASE("texture streamer budgets the texture format instead of the source pixels", "[core][unit]") {
+    glpp::test::mock_gl_t gl;
+    recorded_levels_t mock;
+    texture_streamer_t streamer;
+
+    const image_t<glm::vec4> image { 256, 256 };
+    streamer.add(image, image_format_t::rgba_8);
+    REQUIRE(streamer.usage() == coarse_size);
+
+    // Block compressed levels take 8 bytes per 4x4 block, levels smaller than a block a full block.
+    std::vector<compressed_image_t::level_t> levels;
+    for(size_t size = 256; size > 0; size /= 2) {
+        levels.push_back({ size, size, std::vector<std::byte>(compressed_image_size(image_format_t::bc1_rgb, size, size)) });
+    }
+    const auto compressed = streamer.add(compressed_image_t{ image_format_t::bc1_rgb, levels });
+    REQUIRE(streamer.usage() == coarse_size+2048+512+128+32+8+8+8);
+    streamer.remove(compressed);
+    levels.pop_back();
+    REQUIRE_THROWS(streamer.add(compressed_image_t{ image_format_t::bc1_rgb, levels }));
+
+    streamer.add(image, image_format_t::rgb_8);
+    REQUIRE(streamer.usage() == 2*coarse_size);
+}
+
+TEST_CASE("texture streamer prefers the coarsest missing level", "[core][unit]") {
+    glpp::test::mock_gl_t gl;
+    recorded_levels_t mock;
+    texture_streamer_t streamer;
+
+    const auto large = streamer.add(image_t<glm::u8vec4>(256, 256));
+    const auto small = streamer.add(image_t<glm::u8vec4>(96, 96));
+    REQUIRE(streamer.resident_level(small) == 1);
+
+    streamer.request(large, 256.0f);
+    streamer.request(small, 96.0f);
+    REQUIRE(streamer.update(1) == 1);
+    REQUIRE(streamer.resident_level(small) == 0);
+    REQUIRE(streamer.resident_level(large) == 2);
+
+    streamer.request(large, 256.0f);
+    streamer.request(small, 96.0f);
+    REQUIRE(streamer.update(1) == 1);
+    REQUIRE(streamer.resident_level(large) == 1);
+}
+
+TEST_CASE("texture streamer evicts least recently used levels to stay in budget", "[core][unit]") {
+    glpp::test::mock_gl_t gl;
+    recorded_levels_t mock;
+    texture_streamer_t streamer { 2*coarse_size+level_1_size+level_0_size };
+
+    const auto first = streamer.add(image_t<glm::u8vec4>(256, 256));
+    const auto second = streamer.add(image_t<glm::u8vec4>(256, 256));
+    streamer.request(first, 128.0f);
+    streamer.request(second, 128.0f);
+    REQUIRE(streamer.update() == 2);
+    REQUIRE(streamer.resident_level(first) == 1);
+    REQUIRE(streamer.resident_level(second) == 1);
+
+    // The second texture is not used anymore and gives up its finest level.
+    streamer.request(first, 256.0f);
+    REQUIRE(streamer.update() == 1);
+    REQUIRE(streamer.resident_level(first) == 0);
+    REQUIRE(streamer.resident_level(second) == 2);
+    REQUIRE(streamer.usage() == streamer.budget());
+
+    // Levels in use are kept, if no other level can be evicted.
+    streamer.request(first, 256.0f);
+    streamer.request(second, 256.0f);
+    REQUIRE(streamer.update() == 0);
+    REQUIRE(streamer.resident_level(second) == 2);
+
+    // Lowering the budget evicts down to the coarse levels, which always stay resident.
+    streamer.set_budget(0);
+    REQUIRE(streamer.update() == 0);
+    REQUIRE(streamer.resident_level(first) == 2);
+    REQUIRE(streamer.usage() == 2*coarse_size);
+
+    streamer.remove(first);
+    REQUIRE(streamer.size() == 1);
+    REQUIRE(streamer.usage() == coarse_size);
+}
@@ -0,0 +1,144 @@
+#include <catch2/catch_all.hpp>
+#include <glpp/core/object/texture_unit_cache.hpp>
+#include <glpp/gl/context.hpp>
+#include <glpp/testing/context.hpp>
+#include <glpp/testing/mock_gl.hpp>
+#include <thread>
+
+using namespace glpp::core::object;
+using namespace glpp::gl;
+
+using bind_call_t = glpp::test::mock_gl_t::bind_call_t;
+
+TEST_CASE("texture unit cache binds sets at once and keeps them resident", "[core][unit]") {
+    glpp::test::mock_gl_t mock;
+    texture_unit_cache_t cache { 8 };
+
+    const std::vector<texture_binding_t> material { { 10 }, { 11 }, { 12, 5 } };
+    REQUIRE(cache.bind(material) == std::vector<GLuint>{ 0, 1, 2 });
+    REQUIRE(mock.texture_binds == std::vector<bind_call_t>{ { 0, { 10, 11, 12 } } });
+    REQUIRE(mock.sampler_binds == std::vector<bind_call_t>{ { 2, { 5 } } });
+
+    REQUIRE(cache.bind(material) == std::vector<GLuint>{ 0, 1, 2 });
+    REQUIRE(cache.bind(texture_binding_t{ 11 }) == 1);
+    REQUIRE(mock.texture_binds.size() == 1);
+    REQUIRE(mock.sampler_binds.size() == 1);
+
+    // The same texture with another sampler needs a unit of its own.
+    REQUIRE(cache.bind(texture_binding_t{ 10, 6 }) == 3);
+    REQUIRE(mock.texture_binds.back() == bind_call_t{ 3, { 10 } });
+    REQUIRE(mock.sampler_binds.back() == bind_call_t{ 3, { 6 } });
+}
+
+TEST_CASE("texture unit cache reuses the least recently used unit", "[core][unit]") {
+    glpp::test::mock_gl_t mock;
+    texture_unit_cache_t cache { 3 };
+
+    const std::vector<texture_binding_t> first { { 1 }, { 2 }, { 3 } };
+    cache.bind(first);
+    cache.bind(texture_binding_t{ 1 });
+    REQUIRE(cache.bind(texture_binding_t{ 4 }) == 1);
+    REQUIRE_FALSE(cache.resident({ 2 }));
+    REQUIRE(cache.resident({ 1 }));
+
+    // Units used by the batch itself are never evicted by it.
+    const std::vector<texture_binding_t> too_many { { 5 }, { 6 }, { 7 }, { 8 } };
+    REQUIRE_THROWS(cache.bind(too_many));
+    REQUIRE(mock.texture_binds.size() == 2);
+
+    // After a failed batch the touched units are rebound on their next use.
+    REQUIRE_FALSE(cache.resident({ 1 }));
+    cache.bind(texture_binding_t{ 1 });
+    REQUIRE(mock.texture_binds.size() == 3);
+    REQUIRE(mock.texture_binds.back().names == std::vector<GLuint>{ 1 });
+}
+
+TEST_CASE("texture unit cache keeps units of texture slots locked", "[core][unit]") {
+    glpp::test::mock_gl_t mock;
+    texture_unit_cache_t cache { 2 };
+
+    auto slot = cache.acquire(texture_binding_t{ 1 });
+    REQUIRE(slot.id() == 0);
+    {
+        const std::vector<texture_binding_t> bindings { { 2 } };
+        const auto slots = cache.acquire(bindings);
+        REQUIRE(slots.at(0).id() == 1);
+        REQUIRE_THROWS(cache.bind(texture_binding_t{ 3 }));
+    }
+    REQUIRE(cache.bind(texture_binding_t{ 3 }) == 1);
+
+    auto moved = std::move(slot);
+    const auto other = cache.acquire(texture_binding_t{ 3 });
+    REQUIRE(moved.id() == 0);
+    REQUIRE(other.id() == 1);
+    REQUIRE_THROWS(cache.bind(texture_binding_t{ 4 }));
+    moved = cache.acquire(texture_binding_t{ 3 });
+    REQUIRE(cache.bind(texture_binding_t{ 4 }) == 0);
+}
+
+TEST_CASE("texture unit cache forgets evicted and invalidated bindings", "[core][unit]") {
+    glpp::test::mock_gl_t mock;
+    texture_unit_cache_t cache { 4 };
+
+    const std::vector<texture_binding_t> bindings { { 1 }, { 2, 7 } };
+    cache.bind(bindings);
+    cache.evict_texture(1);
+    cache.evict_sampler(7);
+    REQUIRE_FALSE(cache.resident({ 1 }));
+    REQUIRE(cache.resident({ 2 }));
+
+    cache.invalidate();
+    REQUIRE_FALSE(cache.resident({ 2 }));
+    mock.texture_binds.clear();
+    mock.sampler_binds.clear();
+    REQUIRE(cache.bind(texture_binding_t{ 2 }) == 0);
+    REQUIRE(mock.texture_binds == std::vector<bind_call_t>{ { 0, { 2 } } });
+    REQUIRE(mock.sampler_binds == std::vector<bind_call_t>{ { 0, { 0 } } });
+}
+
+TEST_CASE("texture unit cache keeps one texture per target on each unit", "[core][unit]") {
+    glpp::test::mock_gl_t mock;
+    texture_unit_cache_t cache { 2 };
+
+    REQUIRE(cache.bind(texture_binding_t{ 1 }) == 0);
+    REQUIRE(cache.bind(texture_binding_t{ 2, 0, GL_TEXTURE_2D_ARRAY }) == 1);
+    REQUIRE(cache.bind(texture_binding_t{ 3, 0, GL_TEXTURE_2D_ARRAY }) == 0);
+    // Binding the array texture to unit 0 did not unbind the 2D texture.
+    REQUIRE(cache.resident({ 1 }));
+    REQUIRE_FALSE(cache.resident({ 1, 0, GL_TEXTURE_2D_ARRAY }));
+    mock.texture_binds.clear();
+    REQUIRE(cache.bind(texture_binding_t{ 1 }) == 0);
+    REQUIRE(mock.texture_binds.empty());
+
+    // A draw call samples only one target per unit, so a batch does not share units across targets.
+    const std::vector<texture_binding_t> batch { { 1 }, { 3, 0, GL_TEXTURE_2D_ARRAY } };
+    REQUIRE(cache.bind(batch) == std::vector<GLuint>{ 0, 1 });
+    REQUIRE(mock.texture_binds == std::vector<bind_call_t>{ { 1, { 3 } } });
+}
+
+TEST_CASE("texture unit caches belong to contexts", "[core][unit]") {
+    glpp::test::mock_gl_t mock;
+    int first_context, second_context;
+
+    auto& fallback = texture_unit_cache_t::current();
+    texture_unit_cache_t::make_current(&first_context);
+    auto& first = texture_unit_cache_t::current();
+    REQUIRE(&first != &fallback);
+    texture_unit_cache_t::make_current(&second_context);
+    auto& second = texture_unit_cache_t::current();
+    REQUIRE(&second != &first);
+    texture_unit_cache_t::make_current(&first_context);
+    REQUIRE(&texture_unit_cache_t::current() == &first);
+
+    // The cache follows the context to other threads.
+    const texture_unit_cache_t* other_thread = nullptr;
+    std::thread([&] {
+        texture_unit_cache_t::make_current(&first_context);
+        other_thread = &texture_unit_cache_t::current();
+    }).join();
+    REQUIRE(other_thread == &first);
+
+    texture_unit_cache_t::release(&first_context);
+    REQUIRE(&texture_unit_cache_t::current() == &fallback);
+    texture_unit_cache_t::release(&second_context);
+}
@@ -0,0 +1,176 @@
+#include <catch2/catch_all.hpp>
+#include <glpp/core/object/texture_upload_queue.hpp>
+#include <glpp/gl/context.hpp>
+#include <glpp/testing/context.hpp>
+#include <glpp/testing/mock_gl.hpp>
+#include <optional>
+
+using namespace glpp::core::object;
+using namespace glpp::gl;
+
+namespace {
+
+// Records the ring offsets and the staged pixels of uploads from the pixel unpack buffer.
+struct staged_uploads_t {
+    std::vector<std::intptr_t> offsets;
+    std::vector<std::uint8_t> pixels;
+};
+
+void record_uploads(glpp::test::mock_gl_t& mock, staged_uploads_t& uploads) {
+    context.glTextureSubImage2D = [&](GLuint, GLint, GLint, GLint, GLsizei width, GLsizei height, GLenum, GLenum, const void* pixels) {
+        const auto offset = reinterpret_cast<std::intptr_t>(pixels);
+        const auto& staging = mock.storage(mock.bound(GL_PIXEL_UNPACK_BUFFER));
+        uploads.offsets.push_back(offset);
+        const auto* begin = reinterpret_cast<const std::uint8_t*>(staging.data()+offset);
+        uploads.pixels.insert(uploads.pixels.end(), begin, begin+width*height);
+    };
+}
+
+}
+
+TEST_CASE("texture upload queue stages uploads and respects the frame budget", "[core][unit]") {
+    glpp::test::mock_gl_t mock { glpp::test::mock_gl_t::fence_mode_t::on_wait };
+    staged_uploads_t uploaded;
+    record_uploads(mock, uploaded);
+    {
+        texture_t texture { 8, 8, image_format_t::red_8 };
+        texture_upload_queue_t queue { 256, 64 };
+
+        const auto first = queue.enqueue(texture, image_t<std::uint8_t>(8, 8, 1));
+        const auto second = queue.enqueue(texture, image_t<std::uint8_t>(8, 8, 2));
+        REQUIRE(queue.pending() == 2);
+        REQUIRE_FALSE(first.issued());
+        REQUIRE_THROWS(first.wait());
+
+        REQUIRE(queue.process() == 64);
+        REQUIRE(queue.pending() == 1);
+        REQUIRE(mock.bound(GL_PIXEL_UNPACK_BUFFER) == 0);
+        REQUIRE(first.issued());
+        REQUIRE_FALSE(first.done());
+        REQUIRE_FALSE(second.issued());
+
+        REQUIRE(queue.process() == 64);
+        REQUIRE(queue.pending() == 0);
+        REQUIRE(queue.in_flight() == 2);
+        REQUIRE(uploaded.offsets == std::vector<std::intptr_t>{ 0, 64 });
+        REQUIRE(std::count(uploaded.pixels.begin(), uploaded.pixels.begin()+64, 1) == 64);
+        REQUIRE(std::count(uploaded.pixels.begin()+64, uploaded.pixels.end(), 2) == 64);
+
+        second.wait();
+        REQUIRE(second.done());
+        REQUIRE_FALSE(first.done());
+    }
+    REQUIRE(mock.fences_deleted == 2);
+}
+
+TEST_CASE("texture upload queue reuses the ring after fences signal", "[core][unit]") {
+    glpp::test::mock_gl_t mock { glpp::test::mock_gl_t::fence_mode_t::on_wait };
+    staged_uploads_t uploaded;
+    record_uploads(mock, uploaded);
+    texture_t texture { 8, 8, image_format_t::red_8 };
+    texture_upload_queue_t queue { 128, 1024 };
+
+    std::vector<texture_upload_t> uploads;
+    for(auto i = 0; i < 3; ++i) {
+        uploads.push_back(queue.enqueue(texture, image_t<std::uint8_t>(8, 8, i)));
+    }
+
+    REQUIRE(queue.process() == 128);
+    REQUIRE(queue.pending() == 1);
+
+    queue.flush();
+    REQUIRE(queue.pending() == 0);
+    REQUIRE(uploaded.offsets == std::vector<std::intptr_t>{ 0, 64, 0 });
+    REQUIRE(std::all_of(uploads.begin(), uploads.end(), [](const auto& upload){ return upload.issued(); }));
+    REQUIRE(std::count(uploaded.pixels.begin()+128, uploaded.pixels.end(), 2) == 64);
+}
+
+TEST_CASE("texture upload queue uploads oversized images directly", "[core][unit]") {
+    glpp::test::mock_gl_t mock { glpp::test::mock_gl_t::fence_mode_t::on_wait };
+    auto direct_uploads = 0;
+    context.glTextureSubImage2D = [&](GLuint, GLint, GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, const void* pixels) {
+        REQUIRE(mock.bound(GL_PIXEL_UNPACK_BUFFER) == 0);
+        REQUIRE(*reinterpret_cast<const std::uint8_t*>(pixels) == 5);
+        ++direct_uploads;
+    };
+
+    texture_t texture { 8, 8, image_format_t::red_8 };
+    texture_upload_queue_t queue { 16, 16 };
+    const auto upload = queue.enqueue(texture, image_t<std::uint8_t>(8, 8, 5));
+    queue.process();
+
+    REQUIRE(direct_uploads == 1);
+    REQUIRE(upload.done());
+}
+
+TEST_CASE("texture upload queue stages into the ring at enqueue time", "[core][unit]") {
+    glpp::test::mock_gl_t mock { glpp::test::mock_gl_t::fence_mode_t::on_wait };
+    staged_uploads_t uploaded;
+    record_uploads(mock, uploaded);
+    texture_upload_queue_t queue { 128, 1024 };
+    const auto& staging = mock.storage(queue.id());
+
+    texture_t texture { 8, 8, image_format_t::red_8 };
+    queue.enqueue(texture, image_t<std::uint8_t>(8, 8, 3));
+    REQUIRE(std::count(staging.begin(), staging.begin()+64, std::byte{ 3 }) == 64);
+
+    // The ring is full, the second image is copied into the ring once the first one is done.
+    queue.enqueue(texture, image_t<std::uint8_t>(8, 8, 4));
+    const auto third = queue.enqueue(texture, image_t<std::uint8_t>(8, 8, 5));
+    REQUIRE(std::count(staging.begin()+64, staging.end(), std::byte{ 4 }) == 64);
+    REQUIRE(queue.in_flight() == 2);
+    queue.flush();
+    REQUIRE(third.issued());
+    REQUIRE(uploaded.offsets == std::vector<std::intptr_t>{ 0, 64, 0 });
+    REQUIRE(std::count(uploaded.pixels.begin()+128, uploaded.pixels.end(), 5) == 64);
+}
+
+TEST_CASE("texture upload queue drops uploads into destroyed textures", "[core][unit]") {
+    glpp::test::mock_gl_t mock { glpp::test::mock_gl_t::fence_mode_t::on_wait };
+    staged_uploads_t uploaded;
+    record_uploads(mock, uploaded);
+    texture_upload_queue_t queue { 64, 1024 };
+    auto moved = std::move(queue);
+
+    std::optional<texture_t> staged { std::in_place, 8, 8, image_format_t::red_8 };
+    std::optional<texture_t> copied { std::in_place, 8, 8, image_format_t::red_8 };
+    const auto first = moved.enqueue(*staged, image_t<std::uint8_t>(8, 8, 1));
+    const auto second = moved.enqueue(*copied, image_t<std::uint8_t>(8, 8, 2));
+    staged.reset();
+    copied.reset();
+
+    moved.flush();
+    REQUIRE(uploaded.offsets.empty());
+    REQUIRE(first.issued());
+    REQUIRE(second.issued());
+    // The ring space of the dropped upload is released like the one of an issued upload.
+    REQUIRE(moved.in_flight() == 1);
+    first.wait();
+    moved.process();
+    REQUIRE(moved.in_flight() == 0);
+}
+
+TEST_CASE("texture upload queue stages into the ring in enqueue order", "[core][unit]") {
+    glpp::test::mock_gl_t mock { glpp::test::mock_gl_t::fence_mode_t::on_wait };
+    staged_uploads_t uploaded;
+    record_uploads(mock, uploaded);
+    texture_t texture { 10, 10, image_format_t::red_8 };
+    texture_upload_queue_t queue { 100, 1024 };
+
+    const auto x = queue.enqueue(texture, image_t<std::uint8_t>(10, 9, 1));
+    REQUIRE(queue.process() == 90);
+    // No room next to the first upload, the second one waits in client memory.
+    const auto b = queue.enqueue(texture, image_t<std::uint8_t>(10, 6, 2));
+    x.wait();
+    // The ring has room again, but the third upload must not take the space the second one waits for.
+    const auto c = queue.enqueue(texture, image_t<std::uint8_t>(10, 5, 3));
+    REQUIRE(queue.in_flight() == 1);
+
+    queue.flush();
+    REQUIRE(queue.pending() == 0);
+    REQUIRE(b.issued());
+    REQUIRE(c.issued());
+    REQUIRE(uploaded.offsets == std::vector<std::intptr_t>{ 0, 0, 0 });
+    REQUIRE(std::count(uploaded.pixels.begin()+90, uploaded.pixels.begin()+150, 2) == 60);
+    REQUIRE(std::count(uploaded.pixels.begin()+150, uploaded.pixels.end(), 3) == 50);
+}
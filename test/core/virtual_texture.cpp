@@ -0,0 +1,225 @@
+#include <catch2/catch_all.hpp>
+#include <glpp/core/object/virtual_texture.hpp>
+#include <glpp/gl/context.hpp>
+#include <glpp/testing/context.hpp>
+#include <glpp/testing/mock_gl.hpp>
+#include <cstring>
+#include <map>
+
+using namespace glpp::core::object;
+using namespace glpp::gl;
+
+namespace {
+
+constexpr GLuint cache_id = 1;
+constexpr GLuint page_table_id = 2;
+
+// Records the loaded pages and the uploads into the cache and the page table.
+struct recorded_pages_t {
+    std::vector<virtual_page_t> loaded;
+    std::vector<std::pair<GLint, GLint>> cache_offsets;
+    std::map<GLint, std::vector<glm::u8vec4>> page_table;
+
+    recorded_pages_t() {
+        context.glTextureSubImage2D = [this](GLuint texture, GLint level, GLint x, GLint y, GLsizei width, GLsizei height, GLenum, GLenum, const void* pixels) {
+            if(texture == cache_id) {
+                cache_offsets.emplace_back(x, y);
+            } else if(texture == page_table_id) {
+                const auto* begin = static_cast<const glm::u8vec4*>(pixels);
+                page_table[level] = std::vector<glm::u8vec4>(begin, begin+width*height);
+            }
+        };
+    }
+
+    virtual_texture_t::page_loader_t loader() {
+        return [this](const virtual_page_t& page) {
+            loaded.push_back(page);
+            return image_t<glm::u8vec4>(66, 66);
+        };
+    }
+};
+
+}
+
+TEST_CASE("virtual texture keeps the coarsest page resident", "[core][unit]") {
+    glpp::test::mock_gl_t gl;
+    recorded_pages_t mock;
+    virtual_texture_t texture { 512, 256, 4, mock.loader(), 64 };
+
+    REQUIRE(texture.levels() == 4);
+    REQUIRE(texture.pages_x(1) == 4);
+    REQUIRE(texture.pages_y(3) == 1);
+    REQUIRE(texture.cache().width() == 132);
+    REQUIRE(mock.loaded == std::vector<virtual_page_t>{ { 0, 0, 3 } });
+    REQUIRE(texture.resident_pages() == 1);
+
+    REQUIRE(mock.page_table.size() == 4);
+    REQUIRE(mock.page_table[0].size() == 32);
+    REQUIRE(std::all_of(mock.page_table[0].begin(), mock.page_table[0].end(), [](const auto& entry) {
+        return entry == glm::u8vec4(0, 0, 3, 255);
+    }));
+
+    REQUIRE_THROWS(virtual_texture_t{ 384, 256, 4, mock.loader(), 64 });
+    REQUIRE_THROWS(virtual_texture_t{ 512, 256, 1, mock.loader(), 64 });
+    REQUIRE_THROWS(virtual_texture_t{ 512, 256, 4, [](const auto&) { return image_t<glm::u8vec4>(64, 64); }, 64 });
+}
+
+TEST_CASE("virtual texture loads requested pages coarse first", "[core][unit]") {
+    glpp::test::mock_gl_t gl;
+    recorded_pages_t mock;
+    virtual_texture_t texture { 512, 256, 4, mock.loader(), 64 };
+    mock.loaded.clear();
+
+    texture.request({ 5, 2, 0 });
+    texture.request({ 9, 0, 0 });
+    // Pages are loaded on the worker thread and uploaded by the next update.
+    REQUIRE(texture.update() == 0);
+    REQUIRE(texture.loading_pages() == 3);
+    texture.wait_for_pages();
+    REQUIRE(texture.update() == 3);
+    REQUIRE(texture.loading_pages() == 0);
+    REQUIRE(mock.loaded == std::vector<virtual_page_t>{ { 1, 0, 2 }, { 2, 1, 1 }, { 5, 2, 0 } });
+    REQUIRE(mock.cache_offsets.back() == std::pair<GLint, GLint>{ 66, 66 });
+
+    // Pages without a resident copy point to their closest resident ancestor.
+    const auto& level_0 = mock.page_table[0];
+    REQUIRE(level_0[5+2*8] == glm::u8vec4(1, 1, 0, 255));
+    REQUIRE(level_0[4+2*8] == glm::u8vec4(0, 1, 1, 255));
+    REQUIRE(level_0[6+3*8] == glm::u8vec4(1, 0, 2, 255));
+    REQUIRE(level_0[0] == glm::u8vec4(0, 0, 3, 255));
+
+    // Resident pages are not loaded again.
+    texture.request({ 5, 2, 0 });
+    REQUIRE(texture.update() == 0);
+    REQUIRE(texture.loading_pages() == 0);
+    REQUIRE(mock.loaded.size() == 3);
+}
+
+TEST_CASE("virtual texture evicts least recently used pages", "[core][unit]") {
+    glpp::test::mock_gl_t gl;
+    recorded_pages_t mock;
+    virtual_texture_t texture { 512, 256, 4, mock.loader(), 64 };
+
+    const auto load = [&](std::vector<virtual_page_t> pages, size_t max_pages = 16) {
+        for(const auto& page : pages) texture.request(page);
+        texture.update(max_pages);
+        texture.wait_for_pages();
+        // The renderer keeps requesting the pages, until they are resident.
+        for(const auto& page : pages) texture.request(page);
+        return texture.update(max_pages);
+    };
+
+    REQUIRE(load({ { 7, 3, 0 } }) == 3);
+
+    REQUIRE(load({ { 0, 0, 1 } }) == 2);
+    REQUIRE(texture.resident({ 0, 0, 1 }));
+    REQUIRE(texture.resident({ 0, 0, 2 }));
+    REQUIRE(texture.resident({ 7, 3, 0 }));
+    REQUIRE_FALSE(texture.resident({ 1, 0, 2 }));
+    REQUIRE_FALSE(texture.resident({ 3, 1, 1 }));
+
+    // Pages requested in the same frame are never evicted for each other, the budget limits uploads.
+    REQUIRE(load({ { 0, 0, 0 }, { 4, 0, 0 } }, 1) == 1);
+    REQUIRE(texture.resident({ 1, 0, 2 }));
+    REQUIRE(texture.resident({ 0, 0, 1 }));
+    REQUIRE(texture.resident({ 0, 0, 2 }));
+    REQUIRE(texture.resident_pages() == 4);
+}
+
+TEST_CASE("virtual texture reads feedback asynchronously", "[core][unit]") {
+    glpp::test::mock_gl_t gl { glpp::test::mock_gl_t::fence_mode_t::on_wait };
+    recorded_pages_t mock;
+    auto reads = 0;
+    context.glReadPixels = [&](GLint, GLint, GLsizei width, GLsizei height, GLenum format, GLenum type, void* pixels) {
+        REQUIRE(pixels == nullptr);
+        REQUIRE(width*height == 2);
+        REQUIRE(format == GL_RGBA);
+        REQUIRE(type == GL_UNSIGNED_BYTE);
+        const std::array<glm::u8vec4, 2> texels { glm::u8vec4(2, 1, 1, 255), glm::u8vec4(0, 0, 0, 0) };
+        auto& staging = gl.storage(gl.bound(GL_PIXEL_PACK_BUFFER));
+        REQUIRE(staging.size() == sizeof(texels));
+        std::memcpy(staging.data(), texels.data(), sizeof(texels));
+        ++reads;
+    };
+
+    virtual_texture_t texture { 512, 256, 4, mock.loader(), 64 };
+    const framebuffer_t feedback { 2, 1 };
+
+    texture.read_feedback(feedback);
+    texture.read_feedback(feedback);
+    texture.read_feedback(feedback);
+    REQUIRE(reads == 2);
+    REQUIRE(gl.bound(GL_PIXEL_PACK_BUFFER) == 0);
+    REQUIRE(texture.pending_readbacks() == 2);
+
+    REQUIRE(texture.update() == 0);
+    REQUIRE(texture.pending_readbacks() == 2);
+
+    for(GLsync fence = 1; fence <= gl.fences; ++fence) {
+        gl.signaled.insert(fence);
+    }
+    REQUIRE(texture.update() == 0);
+    REQUIRE(texture.pending_readbacks() == 0);
+    texture.wait_for_pages();
+    REQUIRE(texture.update() == 2);
+    REQUIRE(texture.resident({ 2, 1, 1 }));
+    REQUIRE(texture.resident({ 1, 0, 2 }));
+
+    // The staging buffers are reused, until the feedback pass changes its size.
+    const auto buffers = gl.buffer_names;
+    texture.read_feedback(feedback);
+    REQUIRE(gl.buffer_names == buffers);
+    REQUIRE(reads == 3);
+}
+
+TEST_CASE("virtual texture passes loader errors to update", "[core][unit]") {
+    glpp::test::mock_gl_t gl;
+    recorded_pages_t mock;
+    auto fail = false;
+    virtual_texture_t texture { 512, 256, 4, [&](const virtual_page_t&) {
+        if(fail) throw std::runtime_error("Page not found.");
+        return image_t<glm::u8vec4>(66, 66);
+    }, 64 };
+
+    fail = true;
+    texture.request({ 0, 0, 2 });
+    texture.update();
+    texture.wait_for_pages();
+    REQUIRE_THROWS_WITH(texture.update(), "Page not found.");
+    REQUIRE(texture.loading_pages() == 0);
+    REQUIRE_FALSE(texture.resident({ 0, 0, 2 }));
+}
+
+TEST_CASE("virtual texture image loader cuts pages with border", "[core][unit]") {
+    image_t<glm::u8vec4> image(128, 64);
+    for(size_t y = 0; y < image.height(); ++y) {
+        for(size_t x = 0; x < image.width(); ++x) {
+            image.get(x, y) = glm::u8vec4(x, y, 0, 255);
+        }
+    }
+    const auto loader = virtual_texture_t::image_loader(image, 64, 1);
+
+    const auto page = loader({ 1, 0, 0 });
+    REQUIRE(page.width() == 66);
+    REQUIRE(page.get(0, 0) == glm::u8vec4(63, 0, 0, 255));
+    REQUIRE(page.get(1, 1) == glm::u8vec4(64, 0, 0, 255));
+    REQUIRE(page.get(65, 65) == glm::u8vec4(127, 63, 0, 255));
+
+    // The coarsest level is smaller than a page and gets stretched.
+    const auto level = image.mip_chain()[1];
+    const auto root = loader({ 0, 0, 1 });
+    REQUIRE(root.get(1, 1) == level.get(0, 0));
+    REQUIRE(root.get(1, 3) == level.get(0, 1));
+    REQUIRE(root.get(64, 64) == level.get(63, 31));
+}
+
+TEST_CASE("virtual texture declaration", "[core][unit]") {
+    glpp::test::mock_gl_t gl;
+    recorded_pages_t mock;
+    const virtual_texture_t texture { 512, 256, 4, mock.loader(), 64 };
+    const auto declaration = texture.declaration("terrain");
+    REQUIRE(declaration.find("uniform sampler2D terrain_cache;") != std::string::npos);
+    REQUIRE(declaration.find("uniform sampler2D terrain_pages;") != std::string::npos);
+    REQUIRE(declaration.find("vec4 glpp_vt_terrain(in vec2 uv)") != std::string::npos);
+    REQUIRE(declaration.find("vec4 glpp_vt_feedback_terrain(in vec2 uv, in float bias)") != std::string::npos);
+}
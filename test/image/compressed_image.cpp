@@ -0,0 +1,129 @@
+#include <catch2/catch_all.hpp>
+
+#include <glpp/core.hpp>
+#include <cstring>
+#include <limits>
+
+using namespace glpp::core::object;
+
+namespace {
+
+template <class T>
+void write(std::vector<std::byte>& data, size_t offset, T value) {
+    if(data.size() < offset+sizeof(T)) data.resize(offset+sizeof(T));
+    std::memcpy(data.data()+offset, &value, sizeof(T));
+}
+
+std::vector<std::byte> make_ktx2(std::uint32_t vk_format, std::uint32_t width, std::uint32_t height, const std::vector<size_t>& level_sizes) {
+    std::vector<std::byte> data(80+24*level_sizes.size());
+    constexpr std::array<std::uint8_t, 12> identifier { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+    std::memcpy(data.data(), identifier.data(), identifier.size());
+    write<std::uint32_t>(data, 12, vk_format);
+    write<std::uint32_t>(data, 20, width);
+    write<std::uint32_t>(data, 24, height);
+    write<std::uint32_t>(data, 36, 1);
+    write<std::uint32_t>(data, 40, level_sizes.size());
+    // Store the smallest level first, as the KTX2 specification recommends.
+    auto offset = data.size();
+    for(auto i = level_sizes.size(); i-- > 0;) {
+        write<std::uint64_t>(data, 80+i*24, offset);
+        write<std::uint64_t>(data, 80+i*24+8, level_sizes[i]);
+        data.resize(offset+level_sizes[i], std::byte(i));
+        offset = data.size();
+    }
+    return data;
+}
+
+std::vector<std::byte> make_dds(const char* four_cc, std::uint32_t width, std::uint32_t height, std::uint32_t levels, size_t payload) {
+    std::vector<std::byte> data(128);
+    std::memcpy(data.data(), "DDS ", 4);
+    write<std::uint32_t>(data, 4, 124);
+    write<std::uint32_t>(data, 12, height);
+    write<std::uint32_t>(data, 16, width);
+    write<std::uint32_t>(data, 28, levels);
+    write<std::uint32_t>(data, 80, 0x4);
+    std::memcpy(data.data()+84, four_cc, 4);
+    data.resize(data.size()+payload, std::byte{ 7 });
+    return data;
+}
+
+}
+
+TEST_CASE("compressed image size calculation", "[image][unit]") {
+    REQUIRE(compressed_image_size(image_format_t::bc1_rgb, 4, 4) == 8);
+    REQUIRE(compressed_image_size(image_format_t::bc1_rgb, 5, 5) == 32);
+    REQUIRE(compressed_image_size(image_format_t::bc3, 1, 1) == 16);
+    REQUIRE(compressed_image_size(image_format_t::bc7, 16, 8) == 128);
+    REQUIRE_FALSE(is_block_compressed(image_format_t::rgba_8));
+    REQUIRE(is_block_compressed(image_format_t::etc2_rgb));
+}
+
+TEST_CASE("compressed image loading from KTX2", "[image][unit]") {
+    const auto data = make_ktx2(145, 8, 4, { 32, 16, 16, 16 });
+    const auto image = compressed_image_t::from_memory(data);
+
+    REQUIRE(image.format() == image_format_t::bc7);
+    REQUIRE(image.width() == 8);
+    REQUIRE(image.height() == 4);
+    REQUIRE(image.levels().size() == 4);
+    REQUIRE(image.level(1).width == 4);
+    REQUIRE(image.level(1).height == 2);
+    REQUIRE(image.level(3).width == 1);
+    REQUIRE(image.level(3).height == 1);
+    REQUIRE(image.level(0).data.size() == 32);
+    REQUIRE(image.level(2).data.front() == std::byte{ 2 });
+
+    auto supercompressed = data;
+    write<std::uint32_t>(supercompressed, 44, 2);
+    REQUIRE_THROWS(compressed_image_t::from_ktx2(supercompressed));
+
+    auto truncated = data;
+    truncated.resize(truncated.size()-1);
+    REQUIRE_THROWS(compressed_image_t::from_ktx2(truncated));
+}
+
+TEST_CASE("compressed image loading from DDS", "[image][unit]") {
+    SECTION("four cc header") {
+        const auto image = compressed_image_t::from_memory(make_dds("DXT5", 8, 8, 4, 64+16+16+16));
+        REQUIRE(image.format() == image_format_t::bc3);
+        REQUIRE(image.levels().size() == 4);
+        REQUIRE(image.level(0).data.size() == 64);
+        REQUIRE(image.level(3).data.size() == 16);
+    }
+
+    SECTION("dx10 header") {
+        auto data = make_dds("DX10", 4, 4, 1, 0);
+        write<std::uint32_t>(data, 128, 80);
+        data.resize(148+8, std::byte{ 1 });
+        const auto image = compressed_image_t::from_dds(data);
+        REQUIRE(image.format() == image_format_t::bc4);
+        REQUIRE(image.level(0).data.size() == 8);
+    }
+
+    SECTION("invalid data") {
+        REQUIRE_THROWS(compressed_image_t::from_memory(std::vector<std::byte>(16)));
+        REQUIRE_THROWS(compressed_image_t::from_dds(make_dds("DXT1", 8, 8, 1, 8)));
+    }
+}
+
+TEST_CASE("compressed image loading rejects malformed headers", "[image][unit]") {
+    SECTION("level offsets which overflow") {
+        auto data = make_ktx2(145, 4, 4, { 16 });
+        write<std::uint64_t>(data, 80, std::numeric_limits<std::uint64_t>::max()-7);
+        REQUIRE_THROWS(compressed_image_t::from_ktx2(data));
+        write<std::uint64_t>(data, 80, 8);
+        write<std::uint64_t>(data, 88, std::numeric_limits<std::uint64_t>::max()-7);
+        REQUIRE_THROWS(compressed_image_t::from_ktx2(data));
+    }
+
+    SECTION("more levels than the mip chain") {
+        auto ktx2 = make_ktx2(145, 8, 4, { 32, 16, 16, 16 });
+        write<std::uint32_t>(ktx2, 40, 5);
+        REQUIRE_THROWS(compressed_image_t::from_ktx2(ktx2));
+        write<std::uint32_t>(ktx2, 40, 64);
+        REQUIRE_THROWS(compressed_image_t::from_ktx2(ktx2));
+
+        REQUIRE_THROWS(compressed_image_t::from_dds(make_dds("DXT1", 8, 8, 5, 4096)));
+        REQUIRE_THROWS(compressed_image_t::from_dds(make_dds("DXT1", 1, 1, 40, 4096)));
+    }
+}
@@ -0,0 +1,192 @@
+#include <catch2/catch_all.hpp>
+
+#include <glpp/core.hpp>
+#include <glpp/image.hpp>
+#include <glpp/gl/context.hpp>
+#include <glpp/testing/context.hpp>
+#include <glpp/testing/mock_gl.hpp>
+#include <array>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <string>
+
+using namespace glpp::core::object;
+using namespace glpp::gl;
+
+namespace {
+
+// Renders frame k with the color (k, 2k, 3k) in the bottom row and white above.
+void render_frames(glpp::test::mock_gl_t& mock, size_t& frame) {
+    context.glReadPixels = [&](GLint, GLint, GLsizei width, GLsizei, GLenum format, GLenum type, void* pixels) {
+        REQUIRE(format == GL_RGB);
+        REQUIRE(type == GL_UNSIGNED_BYTE);
+        REQUIRE(pixels == nullptr);
+        auto& buffer = mock.storage(mock.bound(GL_PIXEL_PACK_BUFFER));
+        std::fill(buffer.begin(), buffer.end(), std::byte{ 255 });
+        for(GLsizei x = 0; x < width; ++x) {
+            buffer[3*x] = static_cast<std::byte>(frame);
+            buffer[3*x+1] = static_cast<std::byte>(2*frame);
+            buffer[3*x+2] = static_cast<std::byte>(3*frame);
+        }
+        ++frame;
+    };
+}
+
+std::string as_string(const std::vector<std::byte>& data, size_t offset, size_t size) {
+    return std::string(reinterpret_cast<const char*>(data.data())+offset, size);
+}
+
+}
+
+TEST_CASE("frame recorder streams y4m in capture order", "[image][unit]") {
+    glpp::test::mock_gl_t mock;
+    size_t frame = 0;
+    render_frames(mock, frame);
+    const framebuffer_t framebuffer { 4, 2 };
+    std::vector<std::byte> stream;
+    {
+        frame_recorder_t recorder {
+            [&](std::span<const std::byte> data) { stream.insert(stream.end(), data.begin(), data.end()); },
+            4, 2, video_format_t::y4m, 30, frame_overflow_t::block, 2, 3
+        };
+        for(int i = 0; i < 10; ++i) {
+            recorder.capture(framebuffer);
+        }
+        recorder.finish();
+        REQUIRE(recorder.captured() == 10);
+        REQUIRE(recorder.written() == 10);
+        REQUIRE(recorder.dropped() == 0);
+        REQUIRE_THROWS(recorder.capture(framebuffer_t { 2, 2 }));
+    }
+
+    const std::string header = "YUV4MPEG2 W4 H2 F30:1 Ip A1:1 C420jpeg\n";
+    REQUIRE(as_string(stream, 0, header.size()) == header);
+    const size_t frame_size = 6+4*2+2*2*1;
+    REQUIRE(stream.size() == header.size()+10*frame_size);
+    for(size_t k = 0; k < 10; ++k) {
+        const auto offset = header.size()+k*frame_size;
+        REQUIRE(as_string(stream, offset, 6) == "FRAME\n");
+        const auto* y_plane = reinterpret_cast<const std::uint8_t*>(stream.data()+offset+6);
+        // The top row is white, the bottom row holds the frame number.
+        REQUIRE(y_plane[0] == 255);
+        REQUIRE(y_plane[4] == (77*k+150*2*k+29*3*k+128)/256);
+    }
+}
+
+TEST_CASE("frame recorder converts primary colors to y4m", "[image][unit]") {
+    glpp::test::mock_gl_t mock;
+    size_t frame = 0;
+    render_frames(mock, frame);
+    const std::array<std::array<std::uint8_t, 3>, 3> primaries {{ { 255, 0, 0 }, { 0, 255, 0 }, { 0, 0, 255 } }};
+    context.glReadPixels = [&](GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, void*) {
+        auto& buffer = mock.storage(mock.bound(GL_PIXEL_PACK_BUFFER));
+        for(size_t i = 0; i < buffer.size(); ++i) {
+            buffer[i] = static_cast<std::byte>(primaries[frame][i%3]);
+        }
+        ++frame;
+    };
+
+    const framebuffer_t framebuffer { 2, 2 };
+    std::vector<std::byte> stream;
+    frame_recorder_t recorder {
+        [&](std::span<const std::byte> data) { stream.insert(stream.end(), data.begin(), data.end()); },
+        2, 2, video_format_t::y4m, 30, frame_overflow_t::block, 4, 1
+    };
+    for(size_t i = 0; i < primaries.size(); ++i) {
+        recorder.capture(framebuffer);
+    }
+    recorder.finish();
+
+    const size_t header_size = std::string("YUV4MPEG2 W2 H2 F30:1 Ip A1:1 C420jpeg\n").size();
+    const size_t frame_size = 6+2*2+2;
+    REQUIRE(stream.size() == header_size+3*frame_size);
+    // Expected Y, Cb and Cr of red, green and blue, saturated chroma must not wrap around.
+    const std::array<std::array<int, 3>, 3> expected {{ { 77, 85, 255 }, { 149, 43, 21 }, { 29, 255, 107 } }};
+    for(size_t k = 0; k < expected.size(); ++k) {
+        const auto* planes = reinterpret_cast<const std::uint8_t*>(stream.data()+header_size+k*frame_size+6);
+        REQUIRE(planes[0] == expected[k][0]);
+        REQUIRE(planes[3] == expected[k][0]);
+        REQUIRE(planes[4] == expected[k][1]);
+        REQUIRE(planes[5] == expected[k][2]);
+    }
+}
+
+TEST_CASE("frame recorder writes raw rgb top down", "[image][unit]") {
+    glpp::test::mock_gl_t mock;
+    size_t frame = 0;
+    render_frames(mock, frame);
+    const framebuffer_t framebuffer { 3, 2 };
+    std::vector<std::byte> stream;
+    frame_recorder_t recorder {
+        [&](std::span<const std::byte> data) { stream.insert(stream.end(), data.begin(), data.end()); },
+        3, 2, video_format_t::raw_rgb
+    };
+    frame = 40;
+    recorder.capture(framebuffer);
+    recorder.finish();
+    REQUIRE(stream.size() == 3*2*3);
+    REQUIRE(stream[0] == std::byte{ 255 });
+    REQUIRE(stream[9] == std::byte{ 40 });
+    REQUIRE(stream[10] == std::byte{ 80 });
+    REQUIRE(stream[11] == std::byte{ 120 });
+}
+
+TEST_CASE("frame recorder drops frames when the encoders fall behind", "[image][unit]") {
+    glpp::test::mock_gl_t mock;
+    size_t frame = 0;
+    render_frames(mock, frame);
+    const framebuffer_t framebuffer { 2, 2 };
+    std::mutex mutex;
+    std::condition_variable released;
+    bool release = false;
+    size_t frames = 0;
+    frame_recorder_t recorder {
+        [&](std::span<const std::byte>) {
+            std::unique_lock lock(mutex);
+            released.wait(lock, [&] { return release; });
+            ++frames;
+        },
+        2, 2, video_format_t::raw_rgb, 60, frame_overflow_t::drop, 1, 1
+    };
+    for(int i = 0; i < 6; ++i) {
+        recorder.capture(framebuffer);
+    }
+    // Each capture collects the copy of the previous one, the first collected frame blocks the encoder.
+    REQUIRE(recorder.dropped() == 4);
+    {
+        std::lock_guard lock(mutex);
+        release = true;
+    }
+    released.notify_all();
+    recorder.finish();
+    REQUIRE(recorder.captured() == 6);
+    REQUIRE(recorder.written() == 2);
+    REQUIRE(frames == 2);
+}
+
+TEST_CASE("frame recorder writes numbered image sequences", "[image][unit][filesystem]") {
+    glpp::test::mock_gl_t mock;
+    size_t frame = 0;
+    render_frames(mock, frame);
+    const framebuffer_t framebuffer { 5, 3 };
+    const auto directory = std::filesystem::temp_directory_path()/"glpp_frame_recorder";
+    std::filesystem::create_directories(directory);
+    {
+        frame_recorder_t recorder { (directory/"frame_{:03}.qoi").string(), 5, 3, video_format_t::qoi_sequence };
+        for(int i = 0; i < 4; ++i) {
+            recorder.capture(framebuffer);
+        }
+        recorder.finish();
+    }
+    for(size_t k = 0; k < 4; ++k) {
+        const auto filename = directory/fmt::format("frame_{:03}.qoi", k);
+        REQUIRE(std::filesystem::exists(filename));
+        image_t<glm::u8vec3> image;
+        image.load(filename.c_str());
+        REQUIRE(image.width() == 5);
+        REQUIRE(image.get(0, 0) == glm::u8vec3(255));
+        REQUIRE(image.get(4, 2) == glm::u8vec3(k, 2*k, 3*k));
+    }
+    std::filesystem::remove_all(directory);
+}
@@ -18,7 +18,8 @@ TEST_CASE("Reading and Writing of images", "[image][unit][filesystem]") {
         "jpg",
         "jpeg",
         "bmp",
-        "tga"
+        "tga",
+        "qoi"
     };
 
     const std::string seed = "xIk7gTNKCOX3G8GlwPR0-";
@@ -40,4 +41,67 @@ TEST_CASE("Reading and Writing of images", "[image][unit][filesystem]") {
             REQUIRE((write == load).epsilon(0.05));
         }
     }
-}
\ No newline at end of file
+}
+namespace {
+
+// 2x1 grayscale PNG with 16 bit channels holding 0x1234 and 0xffff.
+constexpr std::array<unsigned char, 70> png_16_bit {
+    0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+    0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x01, 0x10, 0x00, 0x00, 0x00, 0x00, 0x81, 0xd9, 0xfc,
+    0x15, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0x10, 0x32, 0xf9, 0xff,
+    0x1f, 0x00, 0x03, 0xe6, 0x02, 0x45, 0xf1, 0x1c, 0x84, 0x65, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45,
+    0x4e, 0x44, 0xae, 0x42, 0x60, 0x82
+};
+
+// 2x1 Radiance HDR image holding (2, 1, 0.5) and (0.5, 0.5, 0.5).
+const std::string hdr = std::string("#?RADIANCE\nFORMAT=32-bit_rle_rgbe\n\n-Y 1 +X 2\n")+
+    "\x80\x40\x20\x82"+
+    "\x80\x80\x80\x80";
+
+std::span<const std::byte> bytes(std::string_view data) {
+    return std::as_bytes(std::span(data.data(), data.size()));
+}
+
+}
+
+TEST_CASE("image_t decodes from memory with the precision of the source", "[image][unit]") {
+    using glpp::core::object::image_t;
+    const auto png = std::as_bytes(std::span(png_16_bit));
+
+    const auto wide = image_t<std::uint16_t>::from_memory(png);
+    REQUIRE(wide == image_t<std::uint16_t>(2, 1, { 0x1234, 0xffff }));
+
+    const auto narrow = image_t<std::uint8_t>::from_memory(png);
+    REQUIRE(narrow == image_t<std::uint8_t>(2, 1, { 0x12, 0xff }));
+
+    const auto normalized = image_t<float>::from_memory(png);
+    REQUIRE(normalized.get(0, 0) == 0x1234/65535.0f);
+
+    const auto radiance = image_t<glm::vec3>::from_memory(bytes(hdr));
+    REQUIRE(radiance == image_t<glm::vec3>(2, 1, { glm::vec3(2.0f, 1.0f, 0.5f), glm::vec3(0.5f) }));
+    REQUIRE(image_t<glm::vec4>::from_memory(bytes(hdr)).get(0, 0) == glm::vec4(2.0f, 1.0f, 0.5f, 1.0f));
+
+    REQUIRE_THROWS(image_t<glm::vec3>::from_memory(bytes("not an image")));
+}
+
+TEST_CASE("image_t loads memory mapped files", "[image][unit][filesystem]") {
+    using glpp::core::object::image_t;
+    const auto filename = std::filesystem::temp_directory_path()/"glpp_image_io_mapped.png";
+
+    image_t<glm::u8vec4> write { 3, 2 };
+    for(auto y = 0u; y < write.height(); ++y) {
+        for(auto x = 0u; x < write.width(); ++x) {
+            write.get(x, y) = glm::u8vec4(x*80, y*200, 7, 255-x);
+        }
+    }
+    write.write(filename.c_str());
+
+    image_t<glm::u8vec4> load { 8, 8 };
+    load.load(filename.c_str());
+    REQUIRE(load == write);
+    REQUIRE(image_t<glm::vec<4, std::uint16_t>>(filename.c_str()).get(1, 1) == glm::vec<4, std::uint16_t>(80*257, 200*257, 7*257, 254*257));
+
+    std::filesystem::resize_file(filename, 0);
+    REQUIRE_THROWS(image_t<glm::u8vec4>(filename.c_str()));
+    std::filesystem::remove(filename);
+}
@@ -0,0 +1,82 @@
+#include <catch2/catch_all.hpp>
+
+#include <glpp/core.hpp>
+#include <glpp/image.hpp>
+#include <filesystem>
+#include <set>
+
+using namespace glpp::core::object;
+
+namespace {
+
+struct image_files_t {
+    std::vector<std::string> filenames;
+
+    explicit image_files_t(size_t count) {
+        for(size_t i = 0; i < count; ++i) {
+            const auto path = std::filesystem::temp_directory_path()/("glpp_image_loader_"+std::to_string(i)+".png");
+            image_t<glm::u8vec4>(4+i, 3, glm::u8vec4(i, 2*i, 3*i, 255)).write(path.c_str());
+            filenames.push_back(path.string());
+        }
+    }
+
+    ~image_files_t() {
+        for(const auto& filename : filenames) {
+            std::filesystem::remove(filename);
+        }
+    }
+};
+
+}
+
+TEST_CASE("image loader decodes batches on worker threads", "[image][unit][filesystem]") {
+    const image_files_t files { 12 };
+    image_loader_t<glm::u8vec4> loader { 4, 3 };
+    REQUIRE(loader.threads() == 4);
+    REQUIRE(loader.max_in_flight() == 3);
+
+    REQUIRE(loader.enqueue(files.filenames) == 0);
+    const auto missing = loader.enqueue("glpp_image_loader_missing.png");
+    REQUIRE(missing == 12);
+
+    std::set<size_t> finished;
+    while(auto result = loader.pop()) {
+        REQUIRE(loader.in_flight() <= loader.max_in_flight());
+        if(result->index == missing) {
+            REQUIRE(result->error);
+            REQUIRE_THROWS(std::rethrow_exception(result->error));
+        } else {
+            REQUIRE(!result->error);
+            REQUIRE(result->filename == files.filenames[result->index]);
+            REQUIRE(result->image == image_t<glm::u8vec4>(4+result->index, 3, glm::u8vec4(result->index, 2*result->index, 3*result->index, 255)));
+        }
+        finished.insert(result->index);
+    }
+    REQUIRE(finished.size() == 13);
+    REQUIRE(loader.pending() == 0);
+    REQUIRE(!loader.try_pop());
+}
+
+TEST_CASE("image loader hands finished images to the calling thread", "[image][unit][filesystem]") {
+    const image_files_t files { 5 };
+    image_loader_t<glm::vec4> loader { 2 };
+    loader.enqueue(files.filenames);
+
+    const auto caller = std::this_thread::get_id();
+    std::vector<size_t> widths;
+    while(loader.pending() > 0) {
+        loader.process([&](image_loader_t<glm::vec4>::result_t&& result) {
+            REQUIRE(std::this_thread::get_id() == caller);
+            widths.push_back(result.image.width());
+        }, 2);
+    }
+    std::sort(widths.begin(), widths.end());
+    REQUIRE(widths == std::vector<size_t>{ 4, 5, 6, 7, 8 });
+}
+
+TEST_CASE("image loader stops with pending files", "[image][unit][filesystem]") {
+    const image_files_t files { 8 };
+    image_loader_t<glm::u8vec4> loader { 2, 1 };
+    loader.enqueue(files.filenames);
+    REQUIRE(loader.pop());
+}
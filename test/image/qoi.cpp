@@ -0,0 +1,93 @@
+#include <catch2/catch_all.hpp>
+
+#include <glpp/core.hpp>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+using glpp::core::object::image_t;
+
+namespace {
+
+// 4x2 image using every chunk type, encoded by the reference implementation.
+constexpr std::array<unsigned char, 37> reference {
+    0x71, 0x6f, 0x69, 0x66, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x02, 0x04, 0x00, 0xc1, 0xfe,
+    0x0a, 0x14, 0x1e, 0x76, 0xab, 0x67, 0x09, 0xff, 0x0a, 0x14, 0x1e, 0x80, 0xc0, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x01
+};
+
+const image_t<glm::u8vec4> reference_image { 4, 2, {
+    glm::u8vec4(0, 0, 0, 255), glm::u8vec4(0, 0, 0, 255), glm::u8vec4(10, 20, 30, 255), glm::u8vec4(11, 19, 30, 255),
+    glm::u8vec4(20, 30, 40, 255), glm::u8vec4(10, 20, 30, 255), glm::u8vec4(10, 20, 30, 128), glm::u8vec4(10, 20, 30, 128)
+}};
+
+std::vector<unsigned char> read_file(const std::filesystem::path& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    return { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+}
+
+template <class T>
+image_t<T> roundtrip(const image_t<T>& image) {
+    const auto filename = std::filesystem::temp_directory_path()/"glpp_qoi_roundtrip.qoi";
+    image.write(filename.string().c_str());
+    image_t<T> load(filename.string().c_str());
+    std::filesystem::remove(filename);
+    return load;
+}
+
+}
+
+TEST_CASE("qoi images match the reference implementation", "[image][unit][filesystem]") {
+    const auto decoded = image_t<glm::u8vec4>::from_memory(std::as_bytes(std::span(reference)));
+    REQUIRE(decoded == reference_image);
+
+    const auto filename = std::filesystem::temp_directory_path()/"glpp_qoi_reference.qoi";
+    reference_image.write(filename.string().c_str());
+    const auto written = read_file(filename);
+    std::filesystem::remove(filename);
+    REQUIRE(written == std::vector<unsigned char>(reference.begin(), reference.end()));
+
+    // Channels are converted on load.
+    const auto rgb = image_t<glm::vec<3, std::uint8_t>>::from_memory(std::as_bytes(std::span(reference)));
+    REQUIRE(rgb.get(3, 0) == glm::vec<3, std::uint8_t>(11, 19, 30));
+    REQUIRE(image_t<glm::vec4>::from_memory(std::as_bytes(std::span(reference))).get(3, 1).w == Catch::Approx(128/255.0f));
+}
+
+TEST_CASE("qoi images are lossless", "[image][unit][filesystem]") {
+    // Large enough to be encoded in several bands on multiple threads.
+    image_t<glm::u8vec4> noise { 1024, 777 };
+    std::uint32_t state = 12345;
+    for(size_t y = 0; y < noise.height(); ++y) {
+        for(size_t x = 0; x < noise.width(); ++x) {
+            state = state*1664525u+1013904223u;
+            const auto random = static_cast<std::uint8_t>(state >> 24);
+            // Mix runs, small differences and random pixels.
+            if(x%64 < 16) {
+                noise.get(x, y) = glm::u8vec4(0, 0, 0, 0);
+            } else if(x%64 < 40) {
+                noise.get(x, y) = glm::u8vec4(x, y, x+y, 255);
+            } else {
+                noise.get(x, y) = glm::u8vec4(random, random/2, 255-random, random%3 ? 255 : random);
+            }
+        }
+    }
+    REQUIRE(roundtrip(noise) == noise);
+
+    image_t<std::uint8_t> gray { 300, 200 };
+    for(size_t i = 0; i < gray.size(); ++i) {
+        gray.data()[i] = static_cast<std::uint8_t>(i*7%251);
+    }
+    REQUIRE(roundtrip(gray) == gray);
+
+    const image_t<glm::vec<2, std::uint8_t>> gray_alpha { 2, 1, { glm::vec<2, std::uint8_t>(17, 200), glm::vec<2, std::uint8_t>(255, 0) } };
+    REQUIRE(roundtrip(gray_alpha) == gray_alpha);
+}
+
+TEST_CASE("corrupt qoi images throw", "[image][unit]") {
+    auto truncated = std::vector<unsigned char>(reference.begin(), reference.begin()+20);
+    REQUIRE_THROWS(image_t<glm::u8vec4>::from_memory(std::as_bytes(std::span(truncated))));
+
+    auto empty = std::vector<unsigned char>(reference.begin(), reference.end());
+    empty[7] = 0;
+    REQUIRE_THROWS(image_t<glm::u8vec4>::from_memory(std::as_bytes(std::span(empty))));
+}